@@ -0,0 +1,446 @@
+import sys
+import json
+import re
+
+#
+# compile the constants, data, and print files into
+# the tables of the constant db, the data maps, and
+# the value maps; each table has a perfect hash index
+# and is used instead of reading a file that has the
+# same length and fnv-1a hash as at build time
+#
+# a file that the json path would reject is left out
+# so that the error is still reported at runtime
+#
+
+FNV_OFFSET = 14695981039346656037
+FNV_PRIME = 1099511628211
+MASK = 0xFFFFFFFFFFFFFFFF
+MAX_ARGUMENT = 32
+
+CATEGORIES = [
+	'elements',
+	'races',
+	'classes',
+	'locations',
+	'mapflags',
+	'gettimes',
+	'readparam',
+	'sizes',
+	'jobs',
+	'effects',
+	'itemgroups',
+	'options',
+	'announces',
+	'sc_end',
+	'sc_start',
+	'vip_status'
+]
+
+def fnv1a(data, hash = FNV_OFFSET):
+	for byte in bytearray(data):
+		hash ^= byte
+		hash = (hash * FNV_PRIME) & MASK
+	return hash
+
+def mix(hash):
+	hash ^= hash >> 33
+	hash = (hash * 0xff51afd7ed558ccd) & MASK
+	hash ^= hash >> 33
+	hash = (hash * 0xc4ceb9fe1a85ec53) & MASK
+	hash ^= hash >> 33
+	return hash
+
+# string keys are compared without case like
+# i2d_rbt_cmp_str, which only folds ascii
+def fold(string):
+	return string.encode('utf-8').lower()
+
+def hash_string(string):
+	return fnv1a(fold(string))
+
+def hash_number(number):
+	return mix(number & MASK)
+
+def literal(string):
+	result = '"'
+	for byte in bytearray(string.encode('utf-8')):
+		if byte == 0x22 or byte == 0x5C or byte == 0x3F:
+			result += '\\' + chr(byte)
+		elif byte < 0x20 or byte > 0x7E:
+			result += '\\%03o' % byte
+		else:
+			result += chr(byte)
+	return result + '"'
+
+def string(value):
+	if value is None:
+		return '{ NULL, 0 }'
+	return '{ %s, %d }' % (literal(value), len(value.encode('utf-8')))
+
+class Number(str):
+	pass
+
+class Object(list):
+	pass
+
+class Invalid(Exception):
+	pass
+
+def unique(pairs, key = lambda key: key):
+	# a duplicate key keeps the position and the
+	# name of the first key and the value of the
+	# last key
+	result = {}
+	for name, value in pairs:
+		if key(name) in result:
+			result[key(name)] = (result[key(name)][0], value)
+		else:
+			result[key(name)] = (name, value)
+	return list(result.values())
+
+def number(value):
+	if not isinstance(value, Number) or not re.match(r'^[+-]?[0-9]+$', value):
+		raise Invalid('invalid number object')
+	result = int(value)
+	if result < -(1 << 63) or result >= (1 << 63):
+		raise Invalid('integer underflow or overflow')
+	return result
+
+def text(value):
+	if isinstance(value, Object) or isinstance(value, list) or isinstance(value, Number) or not isinstance(value, str):
+		raise Invalid('invalid string object')
+	if not value:
+		raise Invalid('empty string object')
+	return value
+
+def boolean(value):
+	if value is not True and value is not False:
+		raise Invalid('invalid boolean object')
+	return value
+
+def array(value):
+	if isinstance(value, Object) or not isinstance(value, list) or not value:
+		raise Invalid('empty array')
+	if len(value) > MAX_ARGUMENT:
+		raise Invalid('array exceeded %d elements' % MAX_ARGUMENT)
+	return value
+
+def ranges(value):
+	result = []
+	for element in array(value):
+		if not isinstance(element, Object):
+			raise Invalid('invalid range object')
+		bound = dict(element)
+		if 'min' not in bound or 'max' not in bound:
+			raise Invalid('failed to get number object')
+		result.append((number(bound['min']), number(bound['max'])))
+	return result
+
+def events(value, depth, result):
+	if isinstance(value, Object):
+		result.append((0, depth, None))
+		for key, element in value:
+			result.append((4, depth + 1, key))
+			events(element, depth + 1, result)
+		result.append((1, depth, None))
+	elif isinstance(value, list):
+		result.append((2, depth, None))
+		for element in value:
+			events(element, depth + 1, result)
+		result.append((3, depth, None))
+	elif isinstance(value, Number):
+		result.append((6, depth, value))
+	elif value is True:
+		result.append((7, depth, 'true'))
+	elif value is False:
+		result.append((8, depth, 'false'))
+	elif value is None:
+		result.append((9, depth, 'null'))
+	else:
+		result.append((5, depth, value))
+
+# the hash of the events below an entry, which is
+# what i2d_data_load_event folds into the entry
+def entry_hash(value):
+	result = []
+	events(value, 0, result)
+	hash = FNV_OFFSET
+	for type, depth, value in result:
+		if depth > 0:
+			hash = fnv1a(bytearray([type]), hash)
+			if value is not None:
+				hash = fnv1a(value.encode('utf-8'), hash)
+	return hash
+
+# hash and displace; the keys hash to buckets and the
+# largest bucket is placed first with the first seed
+# that moves all of its keys to free slots
+def index(keys):
+	size = len(keys)
+	buckets = size // 2 + 1
+	seeds = [0] * buckets
+	slots = [None] * size
+	groups = [[] for i in range(buckets)]
+	for position, hash in enumerate(keys):
+		groups[hash % buckets].append((hash, position))
+
+	for bucket in sorted(range(buckets), key = lambda i: -len(groups[i])):
+		group = groups[bucket]
+		if not group:
+			break
+		seed = 0
+		while True:
+			taken = set()
+			for hash, position in group:
+				slot = mix(hash ^ seed) % size
+				if slots[slot] is not None or slot in taken:
+					break
+				taken.add(slot)
+			else:
+				break
+			seed += 1
+			if seed > 0xFFFFFFFF:
+				raise Invalid('failed to find a seed')
+		seeds[bucket] = seed
+		for hash, position in group:
+			slots[mix(hash ^ seed) % size] = position
+
+	return seeds, buckets, slots
+
+class Output:
+	def __init__(self, output):
+		self.output = output
+		self.count = 0
+
+	def name(self, prefix):
+		self.count += 1
+		return 'i2d_json_table_%s_%d' % (prefix, self.count)
+
+	def write(self, string):
+		self.output.write(string)
+
+	def list(self, type, prefix, elements):
+		if not elements:
+			return 'NULL'
+		name = self.name(prefix)
+		self.write('static const %s %s[] = {\n' % (type, name))
+		for element in elements:
+			self.write('    %s,\n' % element)
+		self.write('};\n\n')
+		return name
+
+	# keys are (key, hash, position) and the first
+	# position of a key is kept like a static tree
+	def index(self, keys):
+		hashes = []
+		positions = []
+		seen = {}
+		for key, hash, position in keys:
+			if hash not in seen:
+				seen[hash] = key
+				hashes.append(hash)
+				positions.append(position)
+			elif seen[hash] != key:
+				raise Invalid('hash collision -- %s' % key)
+		if not hashes:
+			return '{ NULL, 0, NULL, 0 }'
+		seeds, buckets, slots = index(hashes)
+		seeds = self.list('uint32_t', 'seeds', ['%d' % seed for seed in seeds])
+		slots = self.list('uint32_t', 'slots', ['%d' % positions[slot] for slot in slots])
+		return '{ %s, %d, %s, %d }' % (seeds, buckets, slots, len(hashes))
+
+	def ranges(self, value):
+		return self.list('i2d_json_table_range', 'range', ['{ %d, %d }' % bound for bound in value])
+
+	def strings(self, value):
+		return self.list('i2d_json_table_string', 'strings', [string(element) for element in value])
+
+def constants_table(output, root):
+	constants = []
+	categories = {}
+	for key, value in root:
+		if key == 'constants':
+			if not isinstance(value, Object):
+				raise Invalid('invalid constants object')
+			for macro, fields in value:
+				if not isinstance(fields, Object):
+					raise Invalid('invalid constant object')
+				fields = dict(fields)
+				if 'value' not in fields:
+					raise Invalid('failed to get value number -- %s' % macro)
+				constant = {
+					'macro' : macro,
+					'name' : text(fields['name']) if 'name' in fields else None,
+					'value' : number(fields['value']),
+					'range' : ranges(fields['range']) if 'range' in fields else []
+				}
+				if not constant['range']:
+					constant['range'] = [(constant['value'], constant['value'])]
+				constants.append(constant)
+		elif key in CATEGORIES:
+			if isinstance(value, Object) or not isinstance(value, list):
+				raise Invalid('invalid string object')
+			categories.setdefault(key, []).extend(text(element) for element in value)
+
+	if not constants:
+		raise Invalid('failed to get constants object')
+
+	macros = {}
+	for position, constant in enumerate(constants):
+		macros.setdefault(fold(constant['macro']), position)
+
+	elements = []
+	for constant in constants:
+		elements.append('{ %s, %s, %d, %s, %d }' % (string(constant['macro']), string(constant['name']), constant['value'], output.ranges(constant['range']), len(constant['range'])))
+	entries = output.list('i2d_json_table_constant', 'constant', elements)
+
+	elements = []
+	for category in CATEGORIES:
+		if category not in categories:
+			raise Invalid('failed to get %s key value' % category)
+		keys = []
+		for macro in categories[category]:
+			if fold(macro) not in macros:
+				raise Invalid('failed to find constant -- %s' % macro)
+			value = constants[macros[fold(macro)]]['value']
+			keys.append((value, hash_number(value), macros[fold(macro)]))
+		elements.append('{ "%s", %s }' % (category, output.index(keys)))
+	category = output.list('i2d_json_table_category', 'category', elements)
+
+	keys = [(fold(constant['macro']), hash_string(constant['macro']), position) for position, constant in enumerate(constants)]
+	index = output.index(keys)
+	name = output.name('constants')
+	output.write('static const i2d_json_table_constants %s = {\n' % name)
+	output.write('    %s,\n    %d,\n    %s,\n    %s,\n    %d\n' % (entries, len(constants), index, category, len(CATEGORIES)))
+	output.write('};\n\n')
+
+	return name, dict((fold(constant['macro']), constant['value']) for constant in reversed(constants))
+
+def data_entry(output, key, value, macros):
+	if not isinstance(value, Object):
+		raise Invalid('invalid data object')
+	fields = dict(value)
+	entry = []
+	entry.append(string(key))
+	entry.append('%d' % macros.get(fold(key), 0))
+	if 'range' in fields:
+		bounds = ranges(fields['range'])
+		entry.append('%s, %d' % (output.ranges(bounds), len(bounds)))
+	else:
+		entry.append('NULL, 0')
+	for field in ['description', 'handler']:
+		entry.append(string(text(fields[field]) if field in fields else None))
+	for field in ['argument_type', 'argument_default']:
+		if field in fields:
+			strings = [text(element) for element in array(fields[field])]
+			entry.append('%s, %d' % (output.strings(strings), len(strings)))
+		else:
+			entry.append('NULL, 0')
+	if 'argument_order' in fields:
+		numbers = [number(element) for element in array(fields['argument_order'])]
+		entry.append('%s, %d' % (output.list('long', 'order', ['%d' % element for element in numbers]), len(numbers)))
+	else:
+		entry.append('NULL, 0')
+	for field in ['required', 'optional']:
+		entry.append('%d' % (number(fields[field]) if field in fields else 0))
+	for field in ['positive', 'negative', 'zero']:
+		entry.append(string(text(fields[field]) if field in fields else None))
+	for field in ['empty_description_on_zero', 'empty_description_on_empty_string', 'dump_stack_instead_of_description']:
+		entry.append('%d' % (1 if field in fields and boolean(fields[field]) else 0))
+	entry.append('0x%016xULL' % entry_hash(value))
+	return '{ %s }' % ', '.join(entry)
+
+def data_section(output, key, value, macros):
+	pairs = unique(value, fold)
+	if not pairs:
+		raise Invalid('failed to create data array -- %s' % key)
+	elements = [data_entry(output, name, fields, macros) for name, fields in pairs]
+	entries = output.list('i2d_json_table_data', 'data', elements)
+	names = output.index([(fold(name), hash_string(name), position) for position, (name, fields) in enumerate(pairs)])
+	numbers = output.index([(macros.get(fold(name), 0), hash_number(macros.get(fold(name), 0)), position) for position, (name, fields) in enumerate(pairs)])
+	return '{ %s, %s, %d, %s, %s, NULL, 0, { NULL, 0, NULL, 0 } }' % (literal(key) if key else 'NULL', entries, len(pairs), names, numbers)
+
+def value_section(output, key, value):
+	pairs = unique(value)
+	elements = []
+	keys = []
+	for position, (number, element) in enumerate(pairs):
+		if not re.match(r'^[+-]?[0-9]+$', number):
+			raise Invalid('failed to convert value string')
+		number = int(number)
+		if isinstance(element, Object) or not isinstance(element, list):
+			elements.append('{ %dLL, %s, NULL, 0 }' % (number, string(text(element))))
+		else:
+			strings = [text(item) for item in array(element)]
+			elements.append('{ %dLL, { NULL, 0 }, %s, %d }' % (number, output.strings(strings), len(strings)))
+		keys.append((number, hash_number(number), position))
+	entries = output.list('i2d_json_table_value', 'value', elements)
+	return '{ %s, NULL, 0, { NULL, 0, NULL, 0 }, { NULL, 0, NULL, 0 }, %s, %d, %s }' % (literal(key), entries, len(pairs), output.index(keys))
+
+def is_data_map(value):
+	return isinstance(value, Object) and all(isinstance(element, Object) for key, element in value)
+
+def is_value_map(value):
+	return isinstance(value, Object) and all(re.match(r'^[+-]?[0-9]+$', key) for key, element in value)
+
+def sections_table(output, root, macros):
+	elements = []
+	if root and all(is_data_map(value) or is_value_map(value) for key, value in root):
+		for key, value in unique(root):
+			if is_data_map(value) and value:
+				elements.append(data_section(output, key, value, macros))
+			else:
+				elements.append(value_section(output, key, value))
+	else:
+		elements.append(data_section(output, None, root, macros))
+	return output.list('i2d_json_table_section', 'section', elements), len(elements)
+
+def table(output, path, macros):
+	data = open(path, 'rb').read()
+	text = data.decode('utf-8')
+	decoder = json.JSONDecoder(object_pairs_hook = Object, parse_int = Number, parse_float = Number)
+	root, end = decoder.raw_decode(text, len(text) - len(text.lstrip()))
+	if not isinstance(root, Object):
+		raise Invalid('invalid root object')
+
+	constants = 'NULL'
+	sections = ('NULL', 0)
+	if any(key == 'constants' for key, value in root):
+		constants, macros = constants_table(output, root)
+	else:
+		sections = sections_table(output, root, macros)
+
+	entry = '{ "%s", %d, 0x%016xULL, %s, %s, %d }' % (path.replace('\\', '/').split('/')[-1], len(data), fnv1a(data), '&' + constants if constants != 'NULL' else 'NULL', sections[0], sections[1])
+	return entry, macros
+
+if __name__ == '__main__':
+	if len(sys.argv) < 3:
+		print('Usage: python json_table.py <output.c> <file.json> ...')
+	else:
+		output = Output(open(sys.argv[1], 'w'))
+		output.write('/* generated by data/json_table.py; do not edit */\n')
+		output.write('#include "i2d_json.h"\n\n')
+
+		# the constants file is compiled first so that a
+		# data map can be indexed by the constant values
+		paths = sorted(sys.argv[2:], key = lambda path: not path.endswith('constants.json'))
+		macros = {}
+		files = []
+		for path in paths:
+			try:
+				entry, result = table(output, path, macros)
+				if result is not macros:
+					macros = result
+				files.append(entry)
+			except (Invalid, ValueError) as error:
+				sys.stderr.write('json_table.py: %s is read at runtime -- %s\n' % (path, error))
+
+		output.write('const i2d_json_table i2d_json_tables[] = {\n')
+		for entry in files:
+			output.write('    %s,\n' % entry)
+		if not files:
+			output.write('    { NULL, 0, 0, NULL, NULL, 0 },\n')
+		output.write('};\n\n')
+		output.write('const size_t i2d_json_table_size = %d;\n' % len(files))
+		output.output.close()
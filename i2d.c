@@ -1,24 +1,99 @@
 #include "i2d_json.h"
 #include "i2d_script.h"
 #include "i2d_print.h"
+#include "i2d_depend.h"
+#include "i2d_watch.h"
+
+struct i2d_stream {
+    i2d_script * script;
+    i2d_print * print;
+};
+
+typedef struct i2d_stream i2d_stream;
+
+static int i2d_option(int, char **, int *, const char **);
+static int i2d_stream_item(i2d_item *, void *);
+
+/*
+ * the allocator is selected on the command line
+ * since it must be set before the config is read
+ */
+static int i2d_option(int argc, char * argv[], int * is_watch, const char ** allocator) {
+    int status = I2D_OK;
+    int i;
+
+    for(i = 1; i < argc - 1 && !status; i++) {
+        if(!strcmp(argv[i], "--watch")) {
+            *is_watch = 1;
+        } else if(!strcmp(argv[i], "--allocator") && i + 1 < argc - 1) {
+            *allocator = argv[++i];
+            if(strcmp(*allocator, "malloc") && strcmp(*allocator, "pool"))
+                status = I2D_FAIL;
+        } else {
+            status = I2D_FAIL;
+        }
+    }
+
+    return status;
+}
+
+/*
+ * a streamed item refers to the line of the item
+ * db, so it is written before the next is read
+ */
+static int i2d_stream_item(i2d_item * item, void * data) {
+    int status = I2D_OK;
+    i2d_stream * stream = data;
+
+    if(i2d_script_compile_item(stream->script, item)) {
+        status = i2d_panic("failed to get compile item -- %ld", item->id);
+    } else if(i2d_print_format(stream->print, item)) {
+        status = i2d_panic("failed to print item -- %ld", item->id);
+    } else if(i2d_print_flush(stream->print)) {
+        status = i2d_panic("failed to write item -- %ld", item->id);
+    }
+
+    return status;
+}
 
 int main(int argc, char * argv[]) {
     int status = I2D_OK;
+    int is_watch = 0;
+    const char * allocator = "malloc";
+    i2d_pool * pool = NULL;
     i2d_string path;
     i2d_json * json = NULL;
     i2d_script * script = NULL;
     i2d_print * print = NULL;
     i2d_item * item = NULL;
+    i2d_depend * depend = NULL;
+    i2d_select * select = NULL;
+    i2d_print_cache * cache = NULL;
+    i2d_string string;
+    i2d_watch * watch = NULL;
+    i2d_stream stream;
+    size_t i;
+    uint64_t start;
 
-    if(argc < 2) {
-        status = i2d_panic("%s <config.json>", argv[0]);
-    } else if(i2d_string_vprintf(&path, argv[1])) {
+    if(argc < 2 || i2d_option(argc, argv, &is_watch, &allocator)) {
+        status = i2d_panic("%s [--watch] [--allocator malloc|pool] <config.json>", argv[0]);
+    } else if(!strcmp(allocator, "pool") && (i2d_pool_init(&pool) || i2d_allocator_init(&pool->allocator))) {
+        status = i2d_panic("failed to create pool allocator");
+    } else if(i2d_string_vprintf(I2D_TAG_UTIL, &path, argv[argc - 1])) {
         status = i2d_panic("failed to create string object");
     } else {
+        start = i2d_trace_time();
+
         if(i2d_json_init(&json, &path)) {
             status = i2d_panic("failed to create json object");
         } else {
-            if(i2d_script_init(&script, json)) {
+            if(json->config->trace_path.string && i2d_trace_init("i2d_json_init", start)) {
+                status = i2d_panic("failed to create trace");
+            } else if(is_watch && json->config->stream) {
+                status = i2d_panic("stream is not supported in watch mode");
+            } else if(is_watch && i2d_watch_init(&watch, json->config)) {
+                status = i2d_panic("failed to create watch object");
+            } else if(i2d_script_init(&script, json)) {
                 status = i2d_panic("failed to create script object");
             } else {
                 if(i2d_print_init(&print, json)) {
@@ -34,25 +109,121 @@ int main(int argc, char * argv[]) {
                                 status = i2d_panic("failed to print item -- %ld", item->id);
                             }
                         }
+                    } else if(json->config->select) {
+                        if(i2d_select_resolve(json->config->select, script->db->item_db, script->db->item_combo_db)) {
+                            status = i2d_panic("failed to select items");
+                        } else {
+                            for(i = 0; i < json->config->select->size; i++) {
+                                item = json->config->select->list[i];
+                                if(i2d_script_compile_item(script, item)) {
+                                    status = i2d_panic("failed to get compile item -- %ld", item->id);
+                                } else if(i2d_print_format(print, item)) {
+                                    status = i2d_panic("failed to print item -- %ld", item->id);
+                                }
+                            }
+                        }
+                    } else if(json->config->depend_path.string) {
+                        if(i2d_depend_init(&depend)) {
+                            status = i2d_panic("failed to create depend object");
+                        } else if(i2d_depend_collect(depend, json->config, script)) {
+                            status = i2d_panic("failed to collect depend");
+                        } else if(i2d_depend_select(depend, json->config, script->index, script->db->item_db, &select)) {
+                            status = i2d_panic("failed to select items");
+                        } else if(i2d_print_record(print)) {
+                            status = i2d_panic("failed to record print");
+                        } else if(!select) {
+                            for(i = 0; i < script->db->item_db->store.size; i++) {
+                                item = script->db->item_db->store.items[i];
+                                if(i2d_script_compile_item(script, item)) {
+                                    status = i2d_panic("failed to get compile item -- %ld", item->id);
+                                } else if(i2d_print_format(print, item)) {
+                                    status = i2d_panic("failed to print item -- %ld", item->id);
+                                }
+                            }
+                        } else if(i2d_select_resolve(select, script->db->item_db, script->db->item_combo_db)) {
+                            status = i2d_panic("failed to select items");
+                        } else if(i2d_print_cache_init(&cache, &json->config->cache_path)) {
+                            status = i2d_panic("failed to read cache -- %s", json->config->cache_path.string);
+                        } else {
+                            i2d_index_remove(script->index, select->list, select->size);
+
+                            /* the items that did not change are written from the cache */
+                            for(i = 0; i < script->db->item_db->store.size; i++) {
+                                item = script->db->item_db->store.items[i];
+                                if(i2d_select_search(select, item) && !i2d_print_cache_search(cache, item->id, &string)) {
+                                    if(i2d_print_replay(print, item->id, &string))
+                                        status = i2d_panic("failed to print item -- %ld", item->id);
+                                } else if(i2d_script_compile_item(script, item)) {
+                                    status = i2d_panic("failed to get compile item -- %ld", item->id);
+                                } else if(i2d_print_format(print, item)) {
+                                    status = i2d_panic("failed to print item -- %ld", item->id);
+                                }
+                            }
+                        }
+                    } else if(script->db->item_db->is_stream) {
+                        stream.script = script;
+                        stream.print = print;
+
+                        if(i2d_item_db_stream(script->db->item_db, i2d_stream_item, &stream))
+                            status = i2d_panic("failed to stream items");
                     } else {
-                        item = script->db->item_db->list;
-                        do {
+                        for(i = 0; i < script->db->item_db->store.size; i++) {
+                            item = script->db->item_db->store.items[i];
                             if(i2d_script_compile_item(script, item)) {
                                 status = i2d_panic("failed to get compile item -- %ld", item->id);
                             } else if(i2d_print_format(print, item)) {
                                 status = i2d_panic("failed to print item -- %ld", item->id);
                             }
-                            item = item->next;
-                        } while(item != script->db->item_db->list);
+                        }
                     }
-                    i2d_print_deit(&print);
+
+                    if(i2d_print_flush(print))
+                        status = i2d_panic("failed to write items");
+
+                    /* the index is only complete when every item is written */
+                    if(!status && !json->config->item_id && !json->config->select && json->config->index_path.string && i2d_index_write(script->index, &json->config->index_path))
+                        status = i2d_panic("failed to write index -- %s", json->config->index_path.string);
+
+                    if(!status && depend && i2d_depend_write(depend, &json->config->depend_path))
+                        status = i2d_panic("failed to write depend -- %s", json->config->depend_path.string);
+
+                    if(!status && depend && i2d_print_write_cache(print, &json->config->cache_path))
+                        status = i2d_panic("failed to write cache -- %s", json->config->cache_path.string);
+
+                    if(!status && script->ir_output && json_dump_file(script->ir_output, json->config->ir_path.string, JSON_COMPACT))
+                        status = i2d_panic("failed to write ir -- %s", json->config->ir_path.string);
+
+                    if(!status && json->config->trace_path.string && i2d_trace_write(&json->config->trace_path))
+                        status = i2d_panic("failed to write trace -- %s", json->config->trace_path.string);
+
+                    if(!status && json->config->memory_path.string && i2d_allocator_write(json->config->memory_path.string))
+                        status = i2d_panic("failed to write memory -- %s", json->config->memory_path.string);
+
+                    if(!status && watch && i2d_watch_run(watch, &path, &json, &script, &print))
+                        status = i2d_panic("failed to watch -- %s", path.string);
+                    i2d_deit(cache, i2d_print_cache_deit);
+                    i2d_deit(select, i2d_select_deit);
+                    i2d_deit(depend, i2d_depend_deit);
+                    i2d_deit(print, i2d_print_deit);
                 }
-                i2d_script_deit(&script);
+                i2d_deit(script, i2d_script_deit);
             }
-            i2d_json_deit(&json);
+            i2d_deit(watch, i2d_watch_deit);
+            i2d_deit(json, i2d_json_deit);
+            i2d_trace_deit();
+            i2d_intern_deit();
         }
         i2d_string_destroy(&path);
     }
 
+    /* the pool is kept if there is memory left in it */
+    if(pool) {
+        if(i2d_allocator_init(NULL)) {
+            status = i2d_panic("failed to reset allocator");
+        } else {
+            i2d_pool_deit(&pool);
+        }
+    }
+
     return status;
 }
@@ -0,0 +1,723 @@
+#include "i2d_util.h"
+#include "i2d_range.h"
+#include "i2d_logic.h"
+#include "i2d_rbt.h"
+
+/*
+ * minimum time of a measurement in nanoseconds
+ */
+#define I2D_BENCH_TIME 100000000ULL
+
+/*
+ * the allocations are counted by wrapping malloc,
+ * calloc, and realloc at link time (i.e. --wrap)
+ */
+void * __real_malloc(size_t);
+void * __real_calloc(size_t, size_t);
+void * __real_realloc(void *, size_t);
+void * __wrap_malloc(size_t);
+void * __wrap_calloc(size_t, size_t);
+void * __wrap_realloc(void *, size_t);
+
+static size_t i2d_bench_allocs;
+
+struct i2d_bench_run {
+    size_t size;
+    size_t count;
+    size_t ops;
+    uint64_t start;
+    uint64_t time;
+    size_t allocs;
+};
+
+typedef struct i2d_bench_run i2d_bench_run;
+
+typedef int (* i2d_bench_cb) (i2d_bench_run *);
+
+struct i2d_bench {
+    const char * name;
+    i2d_bench_cb cb;
+    size_t sizes[5];
+};
+
+typedef struct i2d_bench i2d_bench;
+
+static uint64_t i2d_bench_time(void);
+static void i2d_bench_start(i2d_bench_run *);
+static void i2d_bench_stop(i2d_bench_run *);
+static int i2d_bench_measure(i2d_bench *, size_t);
+static int i2d_bench_ranges(i2d_range *, size_t, long, long);
+static int i2d_bench_range_or(i2d_bench_run *);
+static int i2d_bench_range_and(i2d_bench_run *);
+static int i2d_bench_range_not(i2d_bench_run *);
+static int i2d_bench_range_compute(i2d_bench_run *);
+static int i2d_bench_logics(i2d_logic **, size_t, const char *);
+static int i2d_bench_logic_or(i2d_bench_run *);
+static int i2d_bench_logic_and(i2d_bench_run *);
+static int i2d_bench_logic_not(i2d_bench_run *);
+static int i2d_bench_keys(long **, size_t);
+static int i2d_bench_tree(i2d_rbt **, long *, size_t, int);
+static int i2d_bench_rbt_insert(i2d_bench_run *);
+static int i2d_bench_rbt_search(i2d_bench_run *);
+static int i2d_bench_rbt_search_static(i2d_bench_run *);
+static int i2d_bench_rbt_copy(i2d_bench_run *);
+static int i2d_bench_buffer_printf(i2d_bench_run *);
+static int i2d_bench_buffer_putc(i2d_bench_run *);
+static int i2d_bench_buffer_memcpy(i2d_bench_run *);
+static int i2d_bench_string_stack_format(i2d_bench_run *);
+
+static i2d_bench benches[] = {
+    { "range_or", i2d_bench_range_or, { 1, 16, 256, 4096 } },
+    { "range_and", i2d_bench_range_and, { 1, 16, 256, 4096 } },
+    { "range_not", i2d_bench_range_not, { 1, 16, 256, 4096 } },
+    { "range_compute", i2d_bench_range_compute, { 1, 16, 256, 4096 } },
+    { "logic_or", i2d_bench_logic_or, { 1, 4, 16, 64 } },
+    { "logic_and", i2d_bench_logic_and, { 1, 4, 16, 64 } },
+    { "logic_not", i2d_bench_logic_not, { 1, 4, 16, 64 } },
+    { "rbt_insert", i2d_bench_rbt_insert, { 16, 1024, 65536 } },
+    { "rbt_search", i2d_bench_rbt_search, { 16, 1024, 65536 } },
+    { "rbt_search_static", i2d_bench_rbt_search_static, { 16, 1024, 65536 } },
+    { "rbt_copy", i2d_bench_rbt_copy, { 16, 1024, 65536 } },
+    { "buffer_printf", i2d_bench_buffer_printf, { 1 } },
+    { "buffer_putc", i2d_bench_buffer_putc, { 1 } },
+    { "buffer_memcpy", i2d_bench_buffer_memcpy, { 16, 256, 4096 } },
+    { "string_stack_format", i2d_bench_string_stack_format, { 1, 4, 16, 64 } }
+};
+
+int main(int argc, char * argv[]) {
+    int status = I2D_OK;
+    size_t i;
+    size_t j;
+
+    for(i = 0; i < i2d_size(benches) && !status; i++)
+        if(argc < 2 || !strncmp(benches[i].name, argv[1], strlen(argv[1])))
+            for(j = 0; j < i2d_size(benches[i].sizes) && benches[i].sizes[j] && !status; j++)
+                if(i2d_bench_measure(&benches[i], benches[i].sizes[j]))
+                    status = i2d_panic("failed to measure %s -- %lu", benches[i].name, (unsigned long) benches[i].sizes[j]);
+
+    return status;
+}
+
+void * __wrap_malloc(size_t size) {
+    i2d_bench_allocs++;
+    return __real_malloc(size);
+}
+
+void * __wrap_calloc(size_t count, size_t size) {
+    i2d_bench_allocs++;
+    return __real_calloc(count, size);
+}
+
+void * __wrap_realloc(void * pointer, size_t size) {
+    i2d_bench_allocs++;
+    return __real_realloc(pointer, size);
+}
+
+/* monotonic time in nanoseconds */
+static uint64_t i2d_bench_time(void) {
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000 + (uint64_t) time.tv_nsec;
+}
+
+/*
+ * the setup and the teardown of a benchmark are
+ * outside of the start and the stop
+ */
+static void i2d_bench_start(i2d_bench_run * run) {
+    run->allocs = i2d_bench_allocs;
+    run->start = i2d_bench_time();
+}
+
+static void i2d_bench_stop(i2d_bench_run * run) {
+    run->time = i2d_bench_time() - run->start;
+    run->allocs = i2d_bench_allocs - run->allocs;
+}
+
+/*
+ * the number of iterations grows until a run
+ * takes at least I2D_BENCH_TIME
+ */
+static int i2d_bench_measure(i2d_bench * bench, size_t size) {
+    int status = I2D_OK;
+    i2d_bench_run run;
+    uint64_t count = 1;
+    uint64_t ops;
+
+    do {
+        i2d_zero(run);
+        run.size = size;
+        run.count = count;
+        run.ops = 1;
+
+        if(bench->cb(&run)) {
+            status = i2d_panic("failed to run benchmark");
+        } else if(run.time < I2D_BENCH_TIME) {
+            count = run.time ? count * I2D_BENCH_TIME * 6 / 5 / run.time : count * 100;
+            if(count > run.count * 100)
+                count = run.count * 100;
+            if(count <= run.count)
+                count = run.count + 1;
+        }
+    } while(!status && run.time < I2D_BENCH_TIME);
+
+    if(!status) {
+        ops = (uint64_t) run.count * run.ops;
+        fprintf(stdout, "%-20s %8lu %12" PRIu64 " %12.1f ns/op %10.2f allocs/op\n", bench->name, (unsigned long) size, ops, (double) run.time / ops, (double) run.allocs / ops);
+        fflush(stdout);
+    }
+
+    return status;
+}
+
+/* size intervals of width that start at offset and are 4 apart */
+static int i2d_bench_ranges(i2d_range * range, size_t size, long offset, long width) {
+    int status = I2D_OK;
+    size_t i;
+
+    if(i2d_range_create(range)) {
+        status = i2d_panic("failed to create range object");
+    } else {
+        for(i = 0; i < size && !status; i++)
+            if(i2d_range_add(range, (long) i * 4 + offset, (long) i * 4 + offset + width))
+                status = i2d_panic("failed to add range object");
+
+        if(status)
+            i2d_range_destroy(range);
+    }
+
+    return status;
+}
+
+static int i2d_bench_range_or(i2d_bench_run * run) {
+    int status = I2D_OK;
+    i2d_range left;
+    i2d_range right;
+    i2d_range result;
+    size_t i;
+
+    if(i2d_bench_ranges(&left, run->size, 0, 1)) {
+        status = i2d_panic("failed to create ranges");
+    } else {
+        if(i2d_bench_ranges(&right, run->size, 2, 0)) {
+            status = i2d_panic("failed to create ranges");
+        } else {
+            i2d_bench_start(run);
+            for(i = 0; i < run->count && !status; i++) {
+                if(i2d_range_or(&result, &left, &right)) {
+                    status = i2d_panic("failed to or range");
+                } else {
+                    i2d_range_destroy(&result);
+                }
+            }
+            i2d_bench_stop(run);
+            i2d_range_destroy(&right);
+        }
+        i2d_range_destroy(&left);
+    }
+
+    return status;
+}
+
+static int i2d_bench_range_and(i2d_bench_run * run) {
+    int status = I2D_OK;
+    i2d_range left;
+    i2d_range right;
+    i2d_range result;
+    size_t i;
+
+    if(i2d_bench_ranges(&left, run->size, 0, 2)) {
+        status = i2d_panic("failed to create ranges");
+    } else {
+        if(i2d_bench_ranges(&right, run->size, 1, 2)) {
+            status = i2d_panic("failed to create ranges");
+        } else {
+            i2d_bench_start(run);
+            for(i = 0; i < run->count && !status; i++) {
+                if(i2d_range_and(&result, &left, &right)) {
+                    status = i2d_panic("failed to and range");
+                } else {
+                    i2d_range_destroy(&result);
+                }
+            }
+            i2d_bench_stop(run);
+            i2d_range_destroy(&right);
+        }
+        i2d_range_destroy(&left);
+    }
+
+    return status;
+}
+
+static int i2d_bench_range_not(i2d_bench_run * run) {
+    int status = I2D_OK;
+    i2d_range range;
+    i2d_range result;
+    size_t i;
+
+    if(i2d_bench_ranges(&range, run->size, 0, 1)) {
+        status = i2d_panic("failed to create ranges");
+    } else {
+        i2d_bench_start(run);
+        for(i = 0; i < run->count && !status; i++) {
+            if(i2d_range_not(&result, &range)) {
+                status = i2d_panic("failed to not range");
+            } else {
+                i2d_range_destroy(&result);
+            }
+        }
+        i2d_bench_stop(run);
+        i2d_range_destroy(&range);
+    }
+
+    return status;
+}
+
+/* != is an and, a not, and an and */
+static int i2d_bench_range_compute(i2d_bench_run * run) {
+    int status = I2D_OK;
+    i2d_range left;
+    i2d_range right;
+    i2d_range result;
+    size_t i;
+
+    if(i2d_bench_ranges(&left, run->size, 0, 2)) {
+        status = i2d_panic("failed to create ranges");
+    } else {
+        if(i2d_bench_ranges(&right, run->size, 1, 0)) {
+            status = i2d_panic("failed to create ranges");
+        } else {
+            i2d_bench_start(run);
+            for(i = 0; i < run->count && !status; i++) {
+                if(i2d_range_compute(&result, &left, &right, '!' + '=')) {
+                    status = i2d_panic("failed to compute range");
+                } else {
+                    i2d_range_destroy(&result);
+                }
+            }
+            i2d_bench_stop(run);
+            i2d_range_destroy(&right);
+        }
+        i2d_range_destroy(&left);
+    }
+
+    return status;
+}
+
+/* an or of size conditions on distinct variables */
+static int i2d_bench_logics(i2d_logic ** result, size_t size, const char * prefix) {
+    int status = I2D_OK;
+    i2d_string name;
+    i2d_range range;
+    i2d_logic * logic = NULL;
+    i2d_logic * condition = NULL;
+    i2d_logic * merge = NULL;
+    size_t i;
+
+    for(i = 0; i < size && !status; i++) {
+        if(i2d_string_vprintf(I2D_TAG_UTIL, &name, "%s%lu", prefix, (unsigned long) i)) {
+            status = i2d_panic("failed to create string object");
+        } else {
+            if(i2d_range_create_add(&range, 0, (long) i + 1)) {
+                status = i2d_panic("failed to create range object");
+            } else {
+                if(i2d_logic_init(&condition, &name, &range)) {
+                    status = i2d_panic("failed to create logic object");
+                } else {
+                    if(!logic) {
+                        logic = condition;
+                        condition = NULL;
+                    } else if(i2d_logic_or(&merge, logic, condition)) {
+                        status = i2d_panic("failed to or logic object");
+                    } else {
+                        i2d_logic_deit(&logic);
+                        logic = merge;
+                        merge = NULL;
+                    }
+                    i2d_deit(condition, i2d_logic_deit);
+                }
+                i2d_range_destroy(&range);
+            }
+            i2d_string_destroy(&name);
+        }
+    }
+
+    if(status) {
+        i2d_deit(logic, i2d_logic_deit);
+    } else {
+        *result = logic;
+    }
+
+    return status;
+}
+
+static int i2d_bench_logic_or(i2d_bench_run * run) {
+    int status = I2D_OK;
+    i2d_logic * left = NULL;
+    i2d_logic * right = NULL;
+    i2d_logic * result = NULL;
+    size_t i;
+
+    if(i2d_bench_logics(&left, run->size, "left")) {
+        status = i2d_panic("failed to create logics");
+    } else {
+        if(i2d_bench_logics(&right, run->size, "right")) {
+            status = i2d_panic("failed to create logics");
+        } else {
+            i2d_bench_start(run);
+            for(i = 0; i < run->count && !status; i++) {
+                if(i2d_logic_or(&result, left, right)) {
+                    status = i2d_panic("failed to or logic");
+                } else {
+                    i2d_logic_deit(&result);
+                }
+            }
+            i2d_bench_stop(run);
+            i2d_logic_deit(&right);
+        }
+        i2d_logic_deit(&left);
+    }
+
+    return status;
+}
+
+/* the and of an or and a condition distributes over the or */
+static int i2d_bench_logic_and(i2d_bench_run * run) {
+    int status = I2D_OK;
+    i2d_logic * left = NULL;
+    i2d_logic * right = NULL;
+    i2d_logic * result = NULL;
+    size_t i;
+
+    if(i2d_bench_logics(&left, run->size, "left")) {
+        status = i2d_panic("failed to create logics");
+    } else {
+        if(i2d_bench_logics(&right, 1, "right")) {
+            status = i2d_panic("failed to create logics");
+        } else {
+            i2d_bench_start(run);
+            for(i = 0; i < run->count && !status; i++) {
+                if(i2d_logic_and(&result, left, right)) {
+                    status = i2d_panic("failed to and logic");
+                } else {
+                    i2d_logic_deit(&result);
+                }
+            }
+            i2d_bench_stop(run);
+            i2d_logic_deit(&right);
+        }
+        i2d_logic_deit(&left);
+    }
+
+    return status;
+}
+
+static int i2d_bench_logic_not(i2d_bench_run * run) {
+    int status = I2D_OK;
+    i2d_logic * logic = NULL;
+    i2d_logic * result = NULL;
+    size_t i;
+
+    if(i2d_bench_logics(&logic, run->size, "logic")) {
+        status = i2d_panic("failed to create logics");
+    } else {
+        i2d_bench_start(run);
+        for(i = 0; i < run->count && !status; i++) {
+            if(i2d_logic_not(&result, logic)) {
+                status = i2d_panic("failed to not logic");
+            } else {
+                i2d_logic_deit(&result);
+            }
+        }
+        i2d_bench_stop(run);
+        i2d_logic_deit(&logic);
+    }
+
+    return status;
+}
+
+/* distinct keys in a shuffled order */
+static int i2d_bench_keys(long ** result, size_t size) {
+    int status = I2D_OK;
+    long * keys;
+    long key;
+    size_t i;
+    size_t j;
+
+    keys = i2d_malloc(I2D_TAG_UTIL, size * sizeof(*keys));
+    if(!keys) {
+        status = i2d_panic("out of memory");
+    } else {
+        srand(size);
+        for(i = 0; i < size; i++)
+            keys[i] = (long) i * 7;
+
+        for(i = size - 1; i > 0; i--) {
+            j = (size_t) rand() % (i + 1);
+            key = keys[i];
+            keys[i] = keys[j];
+            keys[j] = key;
+        }
+
+        *result = keys;
+    }
+
+    return status;
+}
+
+static int i2d_bench_tree(i2d_rbt ** result, long * keys, size_t size, int is_static) {
+    int status = I2D_OK;
+    i2d_rbt * tree = NULL;
+    size_t i;
+
+    if(is_static ? i2d_rbt_init_static(&tree, i2d_rbt_cmp_long) : i2d_rbt_init(&tree, i2d_rbt_cmp_long)) {
+        status = i2d_panic("failed to create red black tree object");
+    } else {
+        for(i = 0; i < size && !status; i++)
+            if(i2d_rbt_insert(tree, &keys[i], &keys[i]))
+                status = i2d_panic("failed to insert red black tree");
+
+        if(!status && is_static && i2d_rbt_build(tree))
+            status = i2d_panic("failed to build red black tree");
+
+        if(status)
+            i2d_rbt_deit(&tree);
+        else
+            *result = tree;
+    }
+
+    return status;
+}
+
+/* an iteration is size inserts into an empty tree */
+static int i2d_bench_rbt_insert(i2d_bench_run * run) {
+    int status = I2D_OK;
+    long * keys = NULL;
+    i2d_rbt * tree = NULL;
+    size_t i;
+
+    if(i2d_bench_keys(&keys, run->size)) {
+        status = i2d_panic("failed to create keys");
+    } else {
+        run->ops = run->size;
+
+        i2d_bench_start(run);
+        for(i = 0; i < run->count && !status; i++) {
+            if(i2d_bench_tree(&tree, keys, run->size, 0)) {
+                status = i2d_panic("failed to create tree");
+            } else {
+                i2d_rbt_deit(&tree);
+            }
+        }
+        i2d_bench_stop(run);
+        i2d_free(keys);
+    }
+
+    return status;
+}
+
+static int i2d_bench_rbt_search(i2d_bench_run * run) {
+    int status = I2D_OK;
+    long * keys = NULL;
+    i2d_rbt * tree = NULL;
+    void * value;
+    size_t i;
+
+    if(i2d_bench_keys(&keys, run->size)) {
+        status = i2d_panic("failed to create keys");
+    } else {
+        if(i2d_bench_tree(&tree, keys, run->size, 0)) {
+            status = i2d_panic("failed to create tree");
+        } else {
+            i2d_bench_start(run);
+            for(i = 0; i < run->count && !status; i++)
+                if(i2d_rbt_search(tree, &keys[i % run->size], &value))
+                    status = i2d_panic("failed to search red black tree");
+            i2d_bench_stop(run);
+            i2d_rbt_deit(&tree);
+        }
+        i2d_free(keys);
+    }
+
+    return status;
+}
+
+static int i2d_bench_rbt_search_static(i2d_bench_run * run) {
+    int status = I2D_OK;
+    long * keys = NULL;
+    i2d_rbt * tree = NULL;
+    void * value;
+    size_t i;
+
+    if(i2d_bench_keys(&keys, run->size)) {
+        status = i2d_panic("failed to create keys");
+    } else {
+        if(i2d_bench_tree(&tree, keys, run->size, 1)) {
+            status = i2d_panic("failed to create tree");
+        } else {
+            i2d_bench_start(run);
+            for(i = 0; i < run->count && !status; i++)
+                if(i2d_rbt_search(tree, &keys[i % run->size], &value))
+                    status = i2d_panic("failed to search red black tree");
+            i2d_bench_stop(run);
+            i2d_rbt_deit(&tree);
+        }
+        i2d_free(keys);
+    }
+
+    return status;
+}
+
+static int i2d_bench_rbt_copy(i2d_bench_run * run) {
+    int status = I2D_OK;
+    long * keys = NULL;
+    i2d_rbt * tree = NULL;
+    i2d_rbt * copy = NULL;
+    size_t i;
+
+    if(i2d_bench_keys(&keys, run->size)) {
+        status = i2d_panic("failed to create keys");
+    } else {
+        if(i2d_bench_tree(&tree, keys, run->size, 0)) {
+            status = i2d_panic("failed to create tree");
+        } else {
+            i2d_bench_start(run);
+            for(i = 0; i < run->count && !status; i++) {
+                if(i2d_rbt_copy(&copy, tree)) {
+                    status = i2d_panic("failed to copy red black tree");
+                } else {
+                    i2d_rbt_deit(&copy);
+                }
+            }
+            i2d_bench_stop(run);
+            i2d_rbt_deit(&tree);
+        }
+        i2d_free(keys);
+    }
+
+    return status;
+}
+
+/* the buffers are cleared before they grow past the small size */
+static int i2d_bench_buffer_printf(i2d_bench_run * run) {
+    int status = I2D_OK;
+    i2d_buffer buffer;
+    size_t i;
+
+    if(i2d_buffer_create(I2D_TAG_UTIL, &buffer, BUFFER_SIZE_SMALL)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        i2d_bench_start(run);
+        for(i = 0; i < run->count && !status; i++) {
+            if(buffer.offset > BUFFER_SIZE_SMALL / 2)
+                i2d_buffer_clear(&buffer);
+            if(i2d_buffer_printf(&buffer, "%s %ld", "value", (long) i))
+                status = i2d_panic("failed to write buffer object");
+        }
+        i2d_bench_stop(run);
+        i2d_buffer_destroy(&buffer);
+    }
+
+    return status;
+}
+
+static int i2d_bench_buffer_putc(i2d_bench_run * run) {
+    int status = I2D_OK;
+    i2d_buffer buffer;
+    size_t i;
+
+    if(i2d_buffer_create(I2D_TAG_UTIL, &buffer, BUFFER_SIZE_SMALL)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        i2d_bench_start(run);
+        for(i = 0; i < run->count && !status; i++) {
+            if(buffer.offset > BUFFER_SIZE_SMALL / 2)
+                i2d_buffer_clear(&buffer);
+            if(i2d_buffer_putc(&buffer, 'a' + i % 26))
+                status = i2d_panic("failed to write buffer object");
+        }
+        i2d_bench_stop(run);
+        i2d_buffer_destroy(&buffer);
+    }
+
+    return status;
+}
+
+static int i2d_bench_buffer_memcpy(i2d_bench_run * run) {
+    int status = I2D_OK;
+    i2d_buffer buffer;
+    char * string;
+    size_t i;
+
+    string = i2d_malloc(I2D_TAG_UTIL, run->size);
+    if(!string) {
+        status = i2d_panic("out of memory");
+    } else {
+        memset(string, 'a', run->size);
+
+        if(i2d_buffer_create(I2D_TAG_UTIL, &buffer, BUFFER_SIZE_SMALL)) {
+            status = i2d_panic("failed to create buffer object");
+        } else {
+            i2d_bench_start(run);
+            for(i = 0; i < run->count && !status; i++) {
+                if(buffer.offset > run->size * 4)
+                    i2d_buffer_clear(&buffer);
+                if(i2d_buffer_memcpy(&buffer, string, run->size))
+                    status = i2d_panic("failed to write buffer object");
+            }
+            i2d_bench_stop(run);
+            i2d_buffer_destroy(&buffer);
+        }
+        i2d_free(string);
+    }
+
+    return status;
+}
+
+/* a format of size placeholders, i.e. {0} {1} ... */
+static int i2d_bench_string_stack_format(i2d_bench_run * run) {
+    int status = I2D_OK;
+    i2d_string_stack stack;
+    i2d_buffer format;
+    i2d_string string;
+    i2d_buffer buffer;
+    size_t i;
+
+    if(i2d_string_stack_create(I2D_TAG_UTIL, &stack, run->size)) {
+        status = i2d_panic("failed to create string stack object");
+    } else {
+        if(i2d_buffer_create(I2D_TAG_UTIL, &format, BUFFER_SIZE_SMALL)) {
+            status = i2d_panic("failed to create buffer object");
+        } else {
+            for(i = 0; i < run->size && !status; i++) {
+                if(i2d_string_stack_push(&stack, "value", 5)) {
+                    status = i2d_panic("failed to push string stack");
+                } else if(i2d_buffer_printf(&format, "%s{%lu}", i ? " " : "", (unsigned long) i)) {
+                    status = i2d_panic("failed to write buffer object");
+                }
+            }
+
+            if(!status) {
+                i2d_buffer_get(&format, &string.string, &string.length);
+
+                if(i2d_buffer_create(I2D_TAG_UTIL, &buffer, BUFFER_SIZE_SMALL)) {
+                    status = i2d_panic("failed to create buffer object");
+                } else {
+                    i2d_bench_start(run);
+                    for(i = 0; i < run->count && !status; i++) {
+                        i2d_buffer_clear(&buffer);
+                        if(i2d_string_stack_format(&stack, &string, &buffer))
+                            status = i2d_panic("failed to format string stack");
+                    }
+                    i2d_bench_stop(run);
+                    i2d_buffer_destroy(&buffer);
+                }
+            }
+            i2d_buffer_destroy(&format);
+        }
+        i2d_string_stack_destroy(&stack);
+    }
+
+    return status;
+}
@@ -1,165 +1,457 @@
 #include "i2d_constant.h"
 
-static int i2d_constant_db_index(i2d_constant_db *, json_t *, const char *, i2d_rbt **);
+struct i2d_constant_category {
+    const char * key;
+    i2d_constant_map * map;
+    char ** list;
+    size_t size;
+    size_t length;
+    int exist;
+};
+
+typedef struct i2d_constant_category i2d_constant_category;
+
+struct i2d_constant_load {
+    i2d_constant_db * constant_db;
+    size_t length;
+    i2d_constant * constant;
+    const char * field;
+    const char * bound;
+    int is_constant;
+    int is_value;
+    size_t range_size;
+    long min;
+    long max;
+    int is_min;
+    int is_max;
+    i2d_constant_category * category;
+    i2d_constant_category categories[16];
+};
+
+typedef struct i2d_constant_load i2d_constant_load;
+
+static void i2d_constant_load_init(i2d_constant_load *, i2d_constant_db *);
+static void i2d_constant_load_deit(i2d_constant_load *);
+static int i2d_constant_load_event(i2d_json_event *, void *);
+static int i2d_constant_load_section(i2d_constant_load *, i2d_json_event *);
+static int i2d_constant_load_constant(i2d_constant_load *, i2d_json_event *);
+static int i2d_constant_load_field(i2d_constant_load *, i2d_json_event *);
+static int i2d_constant_load_range(i2d_constant_load *);
+static int i2d_constant_load_end(i2d_constant_load *);
+static int i2d_constant_load_category(i2d_constant_load *, i2d_json_event *);
+static int i2d_constant_db_index(i2d_constant_db *, i2d_constant_category *);
+static int i2d_constant_db_table(i2d_constant_db *, i2d_constant_load *, const i2d_json_table_constants *);
+static int i2d_constant_get_by_value(i2d_constant_db *, i2d_constant_map *, const long, i2d_constant **);
+
+/* the name and macro are interned */
+void i2d_constant_destroy(i2d_constant * result) {
+    i2d_range_destroy(&result->range);
+}
+
+static void i2d_constant_load_init(i2d_constant_load * load, i2d_constant_db * constant_db) {
+    size_t i;
+    i2d_constant_category categories[] = {
+        { "elements", &constant_db->elements },
+        { "races", &constant_db->races },
+        { "classes", &constant_db->classes },
+        { "locations", &constant_db->locations },
+        { "mapflags", &constant_db->mapflags },
+        { "gettimes", &constant_db->gettimes },
+        { "readparam", &constant_db->readparam },
+        { "sizes", &constant_db->sizes },
+        { "jobs", &constant_db->jobs },
+        { "effects", &constant_db->effects },
+        { "itemgroups", &constant_db->itemgroups },
+        { "options", &constant_db->options },
+        { "announces", &constant_db->announces },
+        { "sc_end", &constant_db->sc_end },
+        { "sc_start", &constant_db->sc_start },
+        { "vip_status", &constant_db->vip_status }
+    };
+
+    memset(load, 0, sizeof(*load));
+    load->constant_db = constant_db;
+    for(i = 0; i < i2d_size(categories); i++)
+        load->categories[i] = categories[i];
+}
+
+static void i2d_constant_load_deit(i2d_constant_load * load) {
+    size_t i;
 
-int i2d_constant_create(i2d_constant * result, const char * key, json_t * json) {
+    for(i = 0; i < i2d_size(load->categories); i++)
+        i2d_free(load->categories[i].list);
+}
+
+/*
+ * constants.json is read as a stream of events; the
+ * constants are copied out as they are seen, but the
+ * category arrays can precede the constants object so
+ * they are kept as pointers into the source and are
+ * resolved when the root object ends
+ */
+static int i2d_constant_load_event(i2d_json_event * event, void * data) {
     int status = I2D_OK;
-    json_t * name;
-    json_t * range;
-    json_t * value;
+    i2d_constant_load * load = data;
+
+    switch(event->depth) {
+        case 0:
+            if(i2d_json_object_end == event->type) {
+                status = i2d_constant_load_end(load);
+            } else if(i2d_json_object_start != event->type) {
+                status = i2d_panic("invalid constants object");
+            }
+            break;
+        case 1:
+            if(i2d_json_key == event->type)
+                status = i2d_constant_load_section(load, event);
+            break;
+        case 2:
+            if(load->is_constant) {
+                if(i2d_json_key == event->type) {
+                    status = i2d_constant_load_constant(load, event);
+                } else if(i2d_json_object_end == event->type) {
+                    if(!load->is_value) {
+                        status = i2d_panic("failed to get value number -- %s", load->constant->macro.string);
+                    } else if(!load->range_size && i2d_range_create_add(&load->constant->range, load->constant->value, load->constant->value)) {
+                        status = i2d_panic("failed to create range");
+                    }
+                }
+            } else if(load->category) {
+                status = i2d_constant_load_category(load, event);
+            }
+            break;
+        case 3:
+            if(load->is_constant) {
+                if(i2d_json_key == event->type) {
+                    load->field = event->string;
+                } else {
+                    status = i2d_constant_load_field(load, event);
+                }
+            }
+            break;
+        case 4:
+            if(load->is_constant && !strcmp(load->field, "range")) {
+                if(i2d_json_object_start == event->type) {
+                    load->bound = "";
+                    load->is_min = 0;
+                    load->is_max = 0;
+                } else if(i2d_json_object_end == event->type) {
+                    status = i2d_constant_load_range(load);
+                }
+            }
+            break;
+        case 5:
+            if(load->is_constant && !strcmp(load->field, "range")) {
+                if(i2d_json_key == event->type) {
+                    load->bound = event->string;
+                } else if(!strcmp(load->bound, "min")) {
+                    if(i2d_event_get_number(event, &load->min)) {
+                        status = i2d_panic("failed to get number object");
+                    } else {
+                        load->is_min = 1;
+                    }
+                } else if(!strcmp(load->bound, "max")) {
+                    if(i2d_event_get_number(event, &load->max)) {
+                        status = i2d_panic("failed to get number object");
+                    } else {
+                        load->is_max = 1;
+                    }
+                }
+            }
+            break;
+    }
 
-    if(i2d_string_create(&result->macro, key, strlen(key))) {
-        status = i2d_panic("failed to copy macro string");
-    } else {
-        name = json_object_get(json, "name");
-        range = json_object_get(json, "range");
-        value = json_object_get(json, "value");
+    return status;
+}
 
-        if(name && i2d_object_get_string(name, &result->name)) {
-            status = i2d_panic("failed to copy name string");
+static int i2d_constant_load_section(i2d_constant_load * load, i2d_json_event * event) {
+    int status = I2D_OK;
+    size_t i;
+
+    load->is_constant = !strcmp(event->string, "constants");
+    load->category = NULL;
+
+    for(i = 0; i < i2d_size(load->categories) && !load->category; i++)
+        if(!strcmp(event->string, load->categories[i].key))
+            load->category = &load->categories[i];
+
+    if(load->category)
+        load->category->exist = 1;
+
+    return status;
+}
+
+static int i2d_constant_load_constant(i2d_constant_load * load, i2d_json_event * event) {
+    int status = I2D_OK;
+    i2d_constant_db * constant_db = load->constant_db;
+    i2d_constant * constants;
+    size_t length;
+
+    if(constant_db->size == load->length) {
+        length = load->length ? load->length * 2 : BUFFER_SIZE_LARGE;
+        constants = i2d_realloc(I2D_TAG_DB, constant_db->constants, length * sizeof(*constants));
+        if(!constants) {
+            status = i2d_panic("out of memory");
         } else {
-            if(!value || i2d_object_get_number(value, &result->value)) {
-                status = i2d_panic("failed to get value number");
-            } else if( range ?
-                i2d_object_get_range_array(range, &result->range) :
-                i2d_range_create_add(&result->range, result->value, result->value) ) {
-                status = i2d_panic("failed to create range");
-            }
-            if(status)
-                i2d_string_destroy(&result->name);
+            memset(constants + load->length, 0, (length - load->length) * sizeof(*constants));
+            constant_db->constants = constants;
+            load->length = length;
+        }
+    }
+
+    if(!status) {
+        load->constant = &constant_db->constants[constant_db->size];
+        load->field = "";
+        load->is_value = 0;
+        load->range_size = 0;
+
+        if(i2d_intern_get(event->string, event->length, &load->constant->macro)) {
+            status = i2d_panic("failed to copy macro string");
+        } else {
+            constant_db->size++;
         }
-        if(status)
-            i2d_string_destroy(&result->macro);
     }
 
     return status;
 }
 
-void i2d_constant_destroy(i2d_constant * result) {
-    i2d_range_destroy(&result->range);
-    i2d_string_destroy(&result->name);
-    i2d_string_destroy(&result->macro);
+static int i2d_constant_load_field(i2d_constant_load * load, i2d_json_event * event) {
+    int status = I2D_OK;
+
+    if(!strcmp(load->field, "name")) {
+        if(i2d_event_get_intern(event, &load->constant->name))
+            status = i2d_panic("failed to copy name string");
+    } else if(!strcmp(load->field, "value")) {
+        if(i2d_event_get_number(event, &load->constant->value)) {
+            status = i2d_panic("failed to get value number");
+        } else {
+            load->is_value = 1;
+        }
+    } else if(!strcmp(load->field, "range")) {
+        if(i2d_json_array_end == event->type && !load->range_size) {
+            status = i2d_panic("empty array");
+        } else if(i2d_json_array_start != event->type && i2d_json_array_end != event->type) {
+            status = i2d_panic("invalid range array");
+        }
+    }
+
+    return status;
 }
 
-static int i2d_constant_db_index(i2d_constant_db * constant_db, json_t * json, const char * key, i2d_rbt ** result) {
+static int i2d_constant_load_range(i2d_constant_load * load) {
     int status = I2D_OK;
-    i2d_rbt * map = NULL;
 
-    json_t * array;
-    size_t index;
-    json_t * value;
+    if(!load->is_min || !load->is_max) {
+        status = i2d_panic("failed to get number object");
+    } else if(!load->range_size) {
+        if(i2d_range_create_add(&load->constant->range, load->min, load->max))
+            status = i2d_panic("failed to create range object");
+    } else {
+        if(i2d_range_add(&load->constant->range, load->min, load->max))
+            status = i2d_panic("failed to add range object");
+    }
+
+    if(!status)
+        load->range_size++;
 
-    const char * string;
+    return status;
+}
+
+static int i2d_constant_load_category(i2d_constant_load * load, i2d_json_event * event) {
+    int status = I2D_OK;
+    i2d_constant_category * category = load->category;
+    char ** list;
     size_t length;
-    i2d_constant * constant;
 
-    if(i2d_rbt_init(&map, i2d_rbt_cmp_long)) {
-        status = i2d_panic("failed to create red black tree object");
-    } else {
-        array = json_object_get(json, key);
-        if(!array) {
-            status = i2d_panic("failed to get %s key value", key);
+    if(i2d_json_string == event->type) {
+        if(!event->length) {
+            status = i2d_panic("empty string object");
         } else {
-            json_array_foreach(array, index, value) {
-                string = json_string_value(value);
-                if(!string) {
-                    status = i2d_panic("invalid string object");
+            if(category->size == category->length) {
+                length = category->length ? category->length * 2 : BUFFER_SIZE_SMALL;
+                list = i2d_realloc(I2D_TAG_DB, category->list, length * sizeof(*list));
+                if(!list) {
+                    status = i2d_panic("out of memory");
                 } else {
-                    length = json_string_length(value);
-                    if(!length) {
-                        status = i2d_panic("empty string object");
-                    } else if(i2d_constant_get_by_macro(constant_db, string, &constant)) {
-                        status = i2d_panic("failed to find constant -- %s", string);
-                    } else if(i2d_rbt_insert(map, &constant->value, constant)) {
-                        status = i2d_panic("failed to map constant object");
-                    }
+                    category->list = list;
+                    category->length = length;
                 }
             }
+
+            if(!status)
+                category->list[category->size++] = event->string;
         }
+    } else if(i2d_json_array_start != event->type && i2d_json_array_end != event->type) {
+        status = i2d_panic("invalid string object");
+    }
+
+    return status;
+}
+
+static int i2d_constant_load_end(i2d_constant_load * load) {
+    int status = I2D_OK;
+    i2d_constant_db * constant_db = load->constant_db;
+    i2d_constant * constants;
+    size_t i;
+
+    if(!constant_db->size) {
+        status = i2d_panic("failed to get constants object");
+    } else {
+        constants = i2d_realloc(I2D_TAG_DB, constant_db->constants, constant_db->size * sizeof(*constants));
+        if(!constants) {
+            status = i2d_panic("out of memory");
+        } else {
+            constant_db->constants = constants;
+            load->length = constant_db->size;
+
+            if(i2d_rbt_init_static(&constant_db->macros.map, i2d_rbt_cmp_str)) {
+                status = i2d_panic("failed to create macro map");
+            } else {
+                for(i = 0; i < constant_db->size && !status; i++)
+                    if(i2d_rbt_insert(constant_db->macros.map, constant_db->constants[i].macro.string, &constant_db->constants[i]))
+                        status = i2d_panic("failed to map constant object");
+
+                if(!status && i2d_rbt_build(constant_db->macros.map))
+                    status = i2d_panic("failed to build macro map");
+
+                for(i = 0; i < i2d_size(load->categories) && !status; i++)
+                    if(i2d_constant_db_index(constant_db, &load->categories[i]))
+                        status = i2d_panic("failed to index categories");
+            }
+        }
+    }
+
+    return status;
+}
+
+static int i2d_constant_db_index(i2d_constant_db * constant_db, i2d_constant_category * category) {
+    int status = I2D_OK;
+    i2d_rbt * map = NULL;
+    i2d_constant * constant;
+    size_t i;
+
+    if(!category->exist) {
+        status = i2d_panic("failed to get %s key value", category->key);
+    } else if(i2d_rbt_init_static(&map, i2d_rbt_cmp_long)) {
+        status = i2d_panic("failed to create red black tree object");
+    } else {
+        for(i = 0; i < category->size && !status; i++) {
+            if(i2d_constant_get_by_macro(constant_db, category->list[i], &constant)) {
+                status = i2d_panic("failed to find constant -- %s", category->list[i]);
+            } else if(i2d_rbt_insert(map, &constant->value, constant)) {
+                status = i2d_panic("failed to map constant object");
+            }
+        }
+
+        if(!status && i2d_rbt_build(map))
+            status = i2d_panic("failed to build red black tree object");
+
         if(status)
             i2d_rbt_deit(&map);
         else
-            *result = map;
+            category->map->map = map;
     }
 
     return status;
 }
 
-int i2d_constant_db_init(i2d_constant_db ** result, json_t * json) {
+/*
+ * a constants file that has a table is copied from
+ * the table and is indexed by the perfect hash of
+ * the table instead of the red black trees
+ */
+static int i2d_constant_db_table(i2d_constant_db * constant_db, i2d_constant_load * load, const i2d_json_table_constants * table) {
     int status = I2D_OK;
-    i2d_constant_db * object;
-    json_t * consts;
+    const i2d_json_table_constant * entry;
+    i2d_constant * constant;
+    i2d_constant_category * category;
+    size_t i;
+    size_t j;
 
-    size_t i = 0;
-    const char * key;
-    json_t * value;
+    constant_db->constants = i2d_calloc(I2D_TAG_DB, table->size, sizeof(*constant_db->constants));
+    if(!constant_db->constants) {
+        status = i2d_panic("out of memory");
+    } else {
+        for(i = 0; i < table->size && !status; i++) {
+            entry = &table->list[i];
+            constant = &constant_db->constants[i];
+            constant->value = entry->value;
+
+            if(i2d_intern_get(entry->macro.string, entry->macro.length, &constant->macro)) {
+                status = i2d_panic("failed to copy macro string");
+            } else if(entry->name.string && i2d_intern_get(entry->name.string, entry->name.length, &constant->name)) {
+                status = i2d_panic("failed to copy name string");
+            } else if(i2d_range_create_add(&constant->range, entry->range[0].min, entry->range[0].max)) {
+                status = i2d_panic("failed to create range object");
+            } else {
+                constant_db->size++;
 
-    if(i2d_is_invalid(result)) {
+                for(j = 1; j < entry->range_size && !status; j++)
+                    if(i2d_range_add(&constant->range, entry->range[j].min, entry->range[j].max))
+                        status = i2d_panic("failed to add range object");
+            }
+        }
+
+        if(!status) {
+            constant_db->macros.index = &table->macros;
+
+            for(i = 0; i < i2d_size(load->categories) && !status; i++) {
+                category = &load->categories[i];
+                for(j = 0; j < table->category_size && !category->map->index; j++)
+                    if(!strcmp(category->key, table->categories[j].key))
+                        category->map->index = &table->categories[j].index;
+
+                if(!category->map->index)
+                    status = i2d_panic("failed to get %s key value", category->key);
+            }
+        }
+    }
+
+    return status;
+}
+
+int i2d_constant_db_init(i2d_constant_db ** result, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_constant_db * object;
+    i2d_constant_load load;
+    const i2d_json_table * table;
+
+    if(i2d_is_invalid(result) || !path) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            consts = json_object_get(json, "constants");
-            if(!consts) {
-                status = i2d_panic("failed to get constants object");
-            } else if(i2d_object_get_list(consts, sizeof(*object->constants), (void **) &object->constants, &object->size)) {
-                status = i2d_panic("failed to create constants array");
-            } else if(i2d_rbt_init(&object->macros, i2d_rbt_cmp_str)) {
-                status = i2d_panic("failed to create macro map");
-            } else {
-                json_object_foreach(consts, key, value) {
-                    if(i2d_constant_create(&object->constants[i], key, value)) {
-                        status = i2d_panic("failed to create constant object");
-                    } else if(i2d_rbt_insert(object->macros, object->constants[i].macro.string, &object->constants[i])) {
-                        status = i2d_panic("failed to map constant object");
-                    } else {
-                        i++;
-                    }
-                    if(status)
-                        break;
-                }
-                if(!status) {
-                    if( i2d_constant_db_index(object, json, "elements", &object->elements) ||
-                        i2d_constant_db_index(object, json, "races", &object->races) ||
-                        i2d_constant_db_index(object, json, "classes", &object->classes) ||
-                        i2d_constant_db_index(object, json, "locations", &object->locations) ||
-                        i2d_constant_db_index(object, json, "mapflags", &object->mapflags) ||
-                        i2d_constant_db_index(object, json, "gettimes", &object->gettimes) ||
-                        i2d_constant_db_index(object, json, "readparam", &object->readparam) ||
-                        i2d_constant_db_index(object, json, "sizes", &object->sizes) ||
-                        i2d_constant_db_index(object, json, "jobs", &object->jobs) ||
-                        i2d_constant_db_index(object, json, "effects", &object->effects) ||
-                        i2d_constant_db_index(object, json, "itemgroups", &object->itemgroups) ||
-                        i2d_constant_db_index(object, json, "options", &object->options) ||
-                        i2d_constant_db_index(object, json, "announces", &object->announces) ||
-                        i2d_constant_db_index(object, json, "sc_end", &object->sc_end) ||
-                        i2d_constant_db_index(object, json, "sc_start", &object->sc_start) ||
-                        i2d_constant_db_index(object, json, "vip_status", &object->vip_status) ) {
-                        status = i2d_panic("failed to index categories");
-                    } else {
-                        if( i2d_constant_get_by_macro(object, "BF_SHORT", &object->BF_SHORT) ||
-                            i2d_constant_get_by_macro(object, "BF_LONG", &object->BF_LONG) ||
-                            i2d_constant_get_by_macro(object, "BF_WEAPON", &object->BF_WEAPON) ||
-                            i2d_constant_get_by_macro(object, "BF_MAGIC", &object->BF_MAGIC) ||
-                            i2d_constant_get_by_macro(object, "BF_MISC", &object->BF_MISC) ||
-                            i2d_constant_get_by_macro(object, "BF_NORMAL", &object->BF_NORMAL) ||
-                            i2d_constant_get_by_macro(object, "BF_SKILL", &object->BF_SKILL) ) {
-                            status = i2d_panic("failed to load bf constants");
-                        } else {
-                            if( i2d_constant_get_by_macro(object, "ATF_SELF", &object->ATF_SELF) ||
-                                i2d_constant_get_by_macro(object, "ATF_TARGET", &object->ATF_TARGET) ||
-                                i2d_constant_get_by_macro(object, "ATF_SHORT", &object->ATF_SHORT) ||
-                                i2d_constant_get_by_macro(object, "ATF_LONG", &object->ATF_LONG) ||
-                                i2d_constant_get_by_macro(object, "ATF_WEAPON", &object->ATF_WEAPON) ||
-                                i2d_constant_get_by_macro(object, "ATF_MAGIC", &object->ATF_MAGIC) ||
-                                i2d_constant_get_by_macro(object, "ATF_MISC", &object->ATF_MISC) )
-                                status = i2d_panic("failed to load atf constants");
-                        }
-                    }
+            i2d_constant_load_init(&load, object);
+            if(!i2d_json_table_get(path, &table) && table->constants) {
+                if(i2d_constant_db_table(object, &load, table->constants))
+                    status = i2d_panic("failed to load constants table -- %s", table->name);
+            } else if(i2d_json_stream(path, i2d_constant_load_event, &load)) {
+                status = i2d_panic("failed to load constants file -- %s", path->string);
+            }
+
+            if(!status) {
+                if( i2d_constant_get_by_macro(object, "BF_SHORT", &object->BF_SHORT) ||
+                    i2d_constant_get_by_macro(object, "BF_LONG", &object->BF_LONG) ||
+                    i2d_constant_get_by_macro(object, "BF_WEAPON", &object->BF_WEAPON) ||
+                    i2d_constant_get_by_macro(object, "BF_MAGIC", &object->BF_MAGIC) ||
+                    i2d_constant_get_by_macro(object, "BF_MISC", &object->BF_MISC) ||
+                    i2d_constant_get_by_macro(object, "BF_NORMAL", &object->BF_NORMAL) ||
+                    i2d_constant_get_by_macro(object, "BF_SKILL", &object->BF_SKILL) ) {
+                    status = i2d_panic("failed to load bf constants");
+                } else {
+                    if( i2d_constant_get_by_macro(object, "ATF_SELF", &object->ATF_SELF) ||
+                        i2d_constant_get_by_macro(object, "ATF_TARGET", &object->ATF_TARGET) ||
+                        i2d_constant_get_by_macro(object, "ATF_SHORT", &object->ATF_SHORT) ||
+                        i2d_constant_get_by_macro(object, "ATF_LONG", &object->ATF_LONG) ||
+                        i2d_constant_get_by_macro(object, "ATF_WEAPON", &object->ATF_WEAPON) ||
+                        i2d_constant_get_by_macro(object, "ATF_MAGIC", &object->ATF_MAGIC) ||
+                        i2d_constant_get_by_macro(object, "ATF_MISC", &object->ATF_MISC) )
+                        status = i2d_panic("failed to load atf constants");
                 }
             }
+            i2d_constant_load_deit(&load);
 
             if(status)
                 i2d_constant_db_deit(&object);
@@ -176,24 +468,24 @@ void i2d_constant_db_deit(i2d_constant_db ** result) {
     size_t i;
 
     object = *result;
-    i2d_deit(object->mob_races, i2d_rbt_deit);
-    i2d_deit(object->vip_status, i2d_rbt_deit);
-    i2d_deit(object->sc_start, i2d_rbt_deit);
-    i2d_deit(object->sc_end, i2d_rbt_deit);
-    i2d_deit(object->announces, i2d_rbt_deit);
-    i2d_deit(object->options, i2d_rbt_deit);
-    i2d_deit(object->itemgroups, i2d_rbt_deit);
-    i2d_deit(object->effects, i2d_rbt_deit);
-    i2d_deit(object->jobs, i2d_rbt_deit);
-    i2d_deit(object->sizes, i2d_rbt_deit);
-    i2d_deit(object->readparam, i2d_rbt_deit);
-    i2d_deit(object->gettimes, i2d_rbt_deit);
-    i2d_deit(object->mapflags, i2d_rbt_deit);
-    i2d_deit(object->locations, i2d_rbt_deit);
-    i2d_deit(object->classes, i2d_rbt_deit);
-    i2d_deit(object->races, i2d_rbt_deit);
-    i2d_deit(object->elements, i2d_rbt_deit);
-    i2d_deit(object->macros, i2d_rbt_deit);
+    i2d_deit(object->mob_races.map, i2d_rbt_deit);
+    i2d_deit(object->vip_status.map, i2d_rbt_deit);
+    i2d_deit(object->sc_start.map, i2d_rbt_deit);
+    i2d_deit(object->sc_end.map, i2d_rbt_deit);
+    i2d_deit(object->announces.map, i2d_rbt_deit);
+    i2d_deit(object->options.map, i2d_rbt_deit);
+    i2d_deit(object->itemgroups.map, i2d_rbt_deit);
+    i2d_deit(object->effects.map, i2d_rbt_deit);
+    i2d_deit(object->jobs.map, i2d_rbt_deit);
+    i2d_deit(object->sizes.map, i2d_rbt_deit);
+    i2d_deit(object->readparam.map, i2d_rbt_deit);
+    i2d_deit(object->gettimes.map, i2d_rbt_deit);
+    i2d_deit(object->mapflags.map, i2d_rbt_deit);
+    i2d_deit(object->locations.map, i2d_rbt_deit);
+    i2d_deit(object->classes.map, i2d_rbt_deit);
+    i2d_deit(object->races.map, i2d_rbt_deit);
+    i2d_deit(object->elements.map, i2d_rbt_deit);
+    i2d_deit(object->macros.map, i2d_rbt_deit);
     if(object->constants)
         for(i = 0; i < object->size; i++)
             i2d_constant_destroy(&object->constants[i]);
@@ -208,18 +500,21 @@ int i2d_constant_index_mob_races(i2d_constant_db * constant_db, i2d_mob_race_db
     i2d_mob_race * mob_race;
     i2d_constant * constant;
 
-    if(i2d_rbt_init(&constant_db->mob_races, i2d_rbt_cmp_long)) {
+    if(i2d_rbt_init_static(&constant_db->mob_races.map, i2d_rbt_cmp_long)) {
         status = i2d_panic("failed to create red black tree object");
     } else if(mob_race_db->list) {
         mob_race = mob_race_db->list;
         do {
             if(i2d_constant_get_by_macro(constant_db, mob_race->macro.string, &constant)) {
                 status = i2d_panic("failed to get mob race by macro -- %s", mob_race->macro.string);
-            } else if(i2d_rbt_insert(constant_db->mob_races, &constant->value, constant)) {
+            } else if(i2d_rbt_insert(constant_db->mob_races.map, &constant->value, constant)) {
                 status = i2d_panic("failed to map constant object");
             }
             mob_race = mob_race->next;
         } while(mob_race != mob_race_db->list);
+
+        if(!status && i2d_rbt_build(constant_db->mob_races.map))
+            status = i2d_panic("failed to build red black tree object");
     }
 
     return status;
@@ -237,73 +532,99 @@ int i2d_constant_get_by_macro_value(i2d_constant_db * constant_db, const char *
 }
 
 int i2d_constant_get_by_macro(i2d_constant_db * constant_db, const char * key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->macros, key, (void **) result);
+    int status = I2D_OK;
+    size_t index;
+
+    if(!constant_db->macros.index) {
+        status = i2d_rbt_search(constant_db->macros.map, key, (void **) result);
+    } else if(i2d_json_index_string(constant_db->macros.index, key, strlen(key), &index) || i2d_rbt_cmp_str(key, constant_db->constants[index].macro.string)) {
+        status = I2D_FAIL;
+    } else {
+        *result = &constant_db->constants[index];
+    }
+
+    return status;
+}
+
+static int i2d_constant_get_by_value(i2d_constant_db * constant_db, i2d_constant_map * map, const long key, i2d_constant ** result) {
+    int status = I2D_OK;
+    size_t index;
+
+    if(!map->index) {
+        status = i2d_rbt_search(map->map, &key, (void **) result);
+    } else if(i2d_json_index_number(map->index, key, &index) || key != constant_db->constants[index].value) {
+        status = I2D_FAIL;
+    } else {
+        *result = &constant_db->constants[index];
+    }
+
+    return status;
 }
 
 int i2d_constant_get_by_element(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->elements, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->elements, key, result);
 }
 
 int i2d_constant_get_by_race(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->races, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->races, key, result);
 }
 
 int i2d_constant_get_by_class(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->classes, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->classes, key, result);
 }
 
 int i2d_constant_get_by_location(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->locations, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->locations, key, result);
 }
 
 int i2d_constant_get_by_mapflag(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->mapflags, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->mapflags, key, result);
 }
 
 int i2d_constant_get_by_gettime(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->gettimes, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->gettimes, key, result);
 }
 
 int i2d_constant_get_by_readparam(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->readparam, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->readparam, key, result);
 }
 
 int i2d_constant_get_by_size(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->sizes, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->sizes, key, result);
 }
 
 int i2d_constant_get_by_job(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->jobs, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->jobs, key, result);
 }
 
 int i2d_constant_get_by_effect(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->effects, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->effects, key, result);
 }
 
 int i2d_constant_get_by_itemgroups(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->itemgroups, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->itemgroups, key, result);
 }
 
 int i2d_constant_get_by_options(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->options, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->options, key, result);
 }
 
 int i2d_constant_get_by_announces(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->announces, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->announces, key, result);
 }
 
 int i2d_constant_get_by_sc_end(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->sc_end, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->sc_end, key, result);
 }
 
 int i2d_constant_get_by_sc_start(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->sc_start, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->sc_start, key, result);
 }
 
 int i2d_constant_get_by_vip_status(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->vip_status, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->vip_status, key, result);
 }
 
 int i2d_constant_get_by_mob_races(i2d_constant_db * constant_db, const long key, i2d_constant ** result) {
-    return i2d_rbt_search(constant_db->mob_races, &key, (void **) result);
+    return i2d_constant_get_by_value(constant_db, &constant_db->mob_races, key, result);
 }
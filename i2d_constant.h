@@ -16,31 +16,42 @@ struct i2d_constant {
 
 typedef struct i2d_constant i2d_constant;
 
-int i2d_constant_create(i2d_constant *, const char *, json_t *);
 void i2d_constant_destroy(i2d_constant *);
 
+/*
+ * a map is either a red black tree or the index of
+ * a table, which maps to the constant at the same
+ * position as the constant of the table
+ */
+struct i2d_constant_map {
+    i2d_rbt * map;
+    const i2d_json_index * index;
+};
+
+typedef struct i2d_constant_map i2d_constant_map;
+
 struct i2d_constant_db {
     i2d_constant * constants;
     size_t size;
 
-    i2d_rbt * macros;
-    i2d_rbt * elements;
-    i2d_rbt * races;
-    i2d_rbt * classes;
-    i2d_rbt * locations;
-    i2d_rbt * mapflags;
-    i2d_rbt * gettimes;
-    i2d_rbt * readparam;
-    i2d_rbt * sizes;
-    i2d_rbt * jobs;
-    i2d_rbt * effects;
-    i2d_rbt * itemgroups;
-    i2d_rbt * options;
-    i2d_rbt * announces;
-    i2d_rbt * sc_end;
-    i2d_rbt * sc_start;
-    i2d_rbt * vip_status;
-    i2d_rbt * mob_races;
+    i2d_constant_map macros;
+    i2d_constant_map elements;
+    i2d_constant_map races;
+    i2d_constant_map classes;
+    i2d_constant_map locations;
+    i2d_constant_map mapflags;
+    i2d_constant_map gettimes;
+    i2d_constant_map readparam;
+    i2d_constant_map sizes;
+    i2d_constant_map jobs;
+    i2d_constant_map effects;
+    i2d_constant_map itemgroups;
+    i2d_constant_map options;
+    i2d_constant_map announces;
+    i2d_constant_map sc_end;
+    i2d_constant_map sc_start;
+    i2d_constant_map vip_status;
+    i2d_constant_map mob_races;
 
     i2d_constant * BF_SHORT;
     i2d_constant * BF_LONG;
@@ -61,7 +72,7 @@ struct i2d_constant_db {
 
 typedef struct i2d_constant_db i2d_constant_db;
 
-int i2d_constant_db_init(i2d_constant_db **, json_t *);
+int i2d_constant_db_init(i2d_constant_db **, i2d_string *);
 void i2d_constant_db_deit(i2d_constant_db **);
 int i2d_constant_index_mob_races(i2d_constant_db *, i2d_mob_race_db *);
 int i2d_constant_get_by_macro_value(i2d_constant_db *, const char *, long *);
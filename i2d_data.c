@@ -1,6 +1,39 @@
 #include "i2d_data.h"
 
-int i2d_data_create(i2d_data * result, const char * key, json_t * json, i2d_constant_db * constant_db) {
+struct i2d_data_load {
+    i2d_data_section * sections;
+    size_t size;
+    size_t depth;
+    i2d_data_map * data_map;
+    size_t length;
+    i2d_data * data;
+    const char * field;
+    const char * bound;
+    i2d_json_event events[MAX_ARGUMENT];
+    size_t count;
+    size_t range_size;
+    long min;
+    long max;
+    int is_min;
+    int is_max;
+};
+
+typedef struct i2d_data_load i2d_data_load;
+
+static int i2d_data_load_event(i2d_json_event *, void *);
+static int i2d_data_load_data(i2d_data_load *, i2d_json_event *);
+static int i2d_data_load_field(i2d_data_load *, i2d_json_event *);
+static int i2d_data_load_element(i2d_data_load *, i2d_json_event *);
+static int i2d_data_load_string_stack(i2d_data_load *, i2d_json_event *, i2d_string_stack *);
+static int i2d_data_load_number_array(i2d_data_load *, i2d_json_event *, long **, size_t *);
+static int i2d_data_map_unique(i2d_data_map *);
+static int i2d_data_table(i2d_data *, const i2d_json_table_data *);
+static int i2d_data_table_string_stack(const i2d_json_table_string *, size_t, i2d_string_stack *);
+static int i2d_data_map_table(i2d_data_map *, const i2d_json_table_section *);
+static int i2d_value_map_table(i2d_value_map *, const i2d_json_table_section *);
+static int i2d_value_map_get(i2d_value_map *, long long, i2d_value **);
+
+int i2d_data_create(i2d_data * result, const char * key, json_t * json) {
     int status = I2D_OK;
     json_t * range;
     json_t * description;
@@ -31,16 +64,14 @@ int i2d_data_create(i2d_data * result, const char * key, json_t * json, i2d_cons
     empty_description_on_zero = json_object_get(json, "empty_description_on_zero");
     empty_description_on_empty_string = json_object_get(json, "empty_description_on_empty_string");
     dump_stack_instead_of_description = json_object_get(json, "dump_stack_instead_of_description");
-    if(constant_db)
-        i2d_constant_get_by_macro_value(constant_db, key, &result->constant);
 
-    if(i2d_string_create(&result->name, key, strlen(key))) {
+    if(i2d_intern_get(key, strlen(key), &result->name)) {
         status = i2d_panic("failed to copy name string");
     } else if(range && i2d_object_get_range_array(range, &result->range)) {
         status = i2d_panic("failed to create range");
-    } else if(description && i2d_object_get_string(description, &result->description)) {
+    } else if(description && i2d_object_get_intern(description, &result->description)) {
         status = i2d_panic("failed to create string");
-    } else if(handler && i2d_object_get_string(handler, &result->handler)) {
+    } else if(handler && i2d_object_get_intern(handler, &result->handler)) {
         status = i2d_panic("failed to create string");
     } else if(argument_type && i2d_object_get_string_stack(argument_type, &result->argument_type)) {
         status = i2d_panic("failed to create string stack");
@@ -52,11 +83,11 @@ int i2d_data_create(i2d_data * result, const char * key, json_t * json, i2d_cons
         status = i2d_panic("failed to create number");
     } else if(optional && i2d_object_get_number(optional, &result->optional)) {
         status = i2d_panic("failed to create number");
-    } else if(positive && i2d_object_get_string(positive, &result->positive)) {
+    } else if(positive && i2d_object_get_intern(positive, &result->positive)) {
         status = i2d_panic("failed to create string");
-    } else if(negative && i2d_object_get_string(negative, &result->negative)) {
+    } else if(negative && i2d_object_get_intern(negative, &result->negative)) {
         status = i2d_panic("failed to create string");
-    } else if(zero && i2d_object_get_string(zero, &result->zero)) {
+    } else if(zero && i2d_object_get_intern(zero, &result->zero)) {
         status = i2d_panic("failed to create string");
     } else if(empty_description_on_zero && i2d_object_get_boolean(empty_description_on_zero, &result->empty_description_on_zero)) {
         status = i2d_panic("failed to create boolean");
@@ -69,80 +100,559 @@ int i2d_data_create(i2d_data * result, const char * key, json_t * json, i2d_cons
     return status;
 }
 
+static int i2d_data_table(i2d_data * result, const i2d_json_table_data * data) {
+    int status = I2D_OK;
+    size_t i;
+
+    result->required = data->required;
+    result->optional = data->optional;
+    result->empty_description_on_zero = data->empty_description_on_zero;
+    result->empty_description_on_empty_string = data->empty_description_on_empty_string;
+    result->dump_stack_instead_of_description = data->dump_stack_instead_of_description;
+    result->hash = data->hash;
+
+    if(i2d_intern_get(data->name.string, data->name.length, &result->name)) {
+        status = i2d_panic("failed to copy name string");
+    } else if(data->range_size && i2d_range_create_add(&result->range, data->range[0].min, data->range[0].max)) {
+        status = i2d_panic("failed to create range");
+    } else if(data->description.string && i2d_intern_get(data->description.string, data->description.length, &result->description)) {
+        status = i2d_panic("failed to create string");
+    } else if(data->handler.string && i2d_intern_get(data->handler.string, data->handler.length, &result->handler)) {
+        status = i2d_panic("failed to create string");
+    } else if(data->argument_type && i2d_data_table_string_stack(data->argument_type, data->argument_type_size, &result->argument_type)) {
+        status = i2d_panic("failed to create string stack");
+    } else if(data->argument_default && i2d_data_table_string_stack(data->argument_default, data->argument_default_size, &result->argument_default)) {
+        status = i2d_panic("failed to create string stack");
+    } else if(data->positive.string && i2d_intern_get(data->positive.string, data->positive.length, &result->positive)) {
+        status = i2d_panic("failed to create string");
+    } else if(data->negative.string && i2d_intern_get(data->negative.string, data->negative.length, &result->negative)) {
+        status = i2d_panic("failed to create string");
+    } else if(data->zero.string && i2d_intern_get(data->zero.string, data->zero.length, &result->zero)) {
+        status = i2d_panic("failed to create string");
+    } else {
+        for(i = 1; i < data->range_size && !status; i++)
+            if(i2d_range_add(&result->range, data->range[i].min, data->range[i].max))
+                status = i2d_panic("failed to add range object");
+
+        if(!status && data->argument_order) {
+            result->argument_order.list = i2d_calloc(I2D_TAG_JSON, data->argument_order_size, sizeof(*result->argument_order.list));
+            if(!result->argument_order.list) {
+                status = i2d_panic("out of memory");
+            } else {
+                memcpy(result->argument_order.list, data->argument_order, data->argument_order_size * sizeof(*result->argument_order.list));
+                result->argument_order.size = data->argument_order_size;
+            }
+        }
+    }
+
+    return status;
+}
+
+static int i2d_data_table_string_stack(const i2d_json_table_string * list, size_t size, i2d_string_stack * result) {
+    int status = I2D_OK;
+    size_t i;
+
+    if(i2d_string_stack_create(I2D_TAG_JSON, result, size)) {
+        status = I2D_FAIL;
+    } else {
+        for(i = 0; i < size && !status; i++)
+            if(i2d_string_stack_push(result, list[i].string, list[i].length))
+                status = i2d_panic("failed to push string stack");
+    }
+
+    return status;
+}
+
+/* the strings are interned */
 void i2d_data_destroy(i2d_data * result) {
-    i2d_string_destroy(&result->zero);
-    i2d_string_destroy(&result->negative);
-    i2d_string_destroy(&result->positive);
     i2d_free(result->argument_order.list);
     i2d_string_stack_destroy(&result->argument_default);
     i2d_string_stack_destroy(&result->argument_type);
-    i2d_string_destroy(&result->handler);
-    i2d_string_destroy(&result->description);
     i2d_range_destroy(&result->range);
-    i2d_string_destroy(&result->name);
 }
 
-int i2d_data_map_init(i2d_data_map ** result, enum i2d_data_map_type type, json_t * json, i2d_constant_db * constant_db) {
+int i2d_data_map_init(i2d_data_map ** result, enum i2d_data_map_type type, i2d_json_section * section, i2d_constant_db * constant_db) {
     int status = I2D_OK;
     i2d_data_map * object;
-    i2d_rbt_cmp cmp = NULL;
 
     size_t i = 0;
     const char * key;
+    json_t * json;
     json_t * value;
 
-    if(i2d_is_invalid(result)) {
+    if(i2d_is_invalid(result) || !section) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_JSON, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
+            json = section->json;
+            if(section->table) {
+                if(i2d_data_map_table(object, section->table)) {
+                    status = i2d_panic("failed to create data array");
+                } else if(i2d_data_map_index(object, type, constant_db)) {
+                    status = i2d_panic("failed to index data map");
+                }
+            } else if(i2d_object_get_list(json, sizeof(*object->list), (void **) &object->list, &object->size)) {
+                status = i2d_panic("failed to create data array");
+            } else {
+                json_object_foreach(json, key, value) {
+                    if(i2d_data_create(&object->list[i], key, value)) {
+                        status = i2d_panic("failed to create data object");
+                        break;
+                    }
+                    i++;
+                }
+
+                if(!status && i2d_data_map_index(object, type, constant_db))
+                    status = i2d_panic("failed to index data map");
+            }
+
+            if(status)
+                i2d_data_map_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+int i2d_data_map_index(i2d_data_map * data_map, enum i2d_data_map_type type, i2d_constant_db * constant_db) {
+    int status = I2D_OK;
+    i2d_rbt_cmp cmp = NULL;
+    size_t i;
+
+    switch(type) {
+        case data_map_by_constant:
+            cmp = i2d_rbt_cmp_long;
+            break;
+        case data_map_by_name:
+            cmp = i2d_rbt_cmp_str;
+            break;
+        default:
+            status = i2d_panic("invalid data map type");
+            break;
+    }
+
+    if(!status) {
+        data_map->type = type;
+
+        if(constant_db)
+            for(i = 0; i < data_map->size; i++)
+                i2d_constant_get_by_macro_value(constant_db, data_map->list[i].name.string, &data_map->list[i].constant);
+
+        /* the constants of a table are the constants at build time */
+        if(data_map->table) {
             switch(type) {
                 case data_map_by_constant:
-                    cmp = i2d_rbt_cmp_long;
+                    data_map->index = &data_map->table->constants;
+                    for(i = 0; i < data_map->size && data_map->index; i++)
+                        if(data_map->list[i].constant != data_map->table->data[i].constant)
+                            data_map->index = NULL;
                     break;
                 case data_map_by_name:
-                    cmp = i2d_rbt_cmp_str;
-                    break;
-                default:
-                    status = i2d_panic("invalid data map type");
+                    data_map->index = &data_map->table->names;
                     break;
             }
+        }
+    }
 
-            if(!status) {
-                if(i2d_rbt_init(&object->map, cmp)) {
-                    status = i2d_panic("failed to create red black tree object");
-                } else if(i2d_object_get_list(json, sizeof(*object->list), (void **) &object->list, &object->size)) {
-                    status = i2d_panic("failed to create data array");
+    if(!status && !data_map->index) {
+        if(i2d_rbt_init_static(&data_map->map, cmp)) {
+            status = i2d_panic("failed to create red black tree object");
+        } else {
+            for(i = 0; i < data_map->size && !status; i++) {
+                switch(type) {
+                    case data_map_by_constant:
+                        if(i2d_rbt_insert(data_map->map, &data_map->list[i].constant, &data_map->list[i]))
+                            status = i2d_panic("failed to map data object");
+                        break;
+                    case data_map_by_name:
+                        if(i2d_rbt_insert(data_map->map, data_map->list[i].name.string, &data_map->list[i]))
+                            status = i2d_panic("failed to map data object");
+                        break;
+                }
+            }
+
+            if(!status && i2d_rbt_build(data_map->map))
+                status = i2d_panic("failed to build red black tree object");
+        }
+    }
+
+    return status;
+}
+
+/*
+ * a data file is read as a stream of events; either
+ * the root object is the data map (a single section
+ * without a key) or each key of the root object that
+ * matches a section is a data map; the arrays inside
+ * an entry are collected until the array ends since
+ * a string stack must be created with its final size
+ */
+static int i2d_data_load_event(i2d_json_event * event, void * data) {
+    int status = I2D_OK;
+    i2d_data_load * load = data;
+    size_t i;
+    char type;
+
+    if(event->depth + 1 == load->depth) {
+        if(1 == load->depth) {
+            if(i2d_json_object_start == event->type) {
+                load->data_map = *load->sections[0].map;
+                load->length = 0;
+            } else if(i2d_json_object_end != event->type) {
+                status = i2d_panic("invalid data object");
+            }
+        } else if(i2d_json_key == event->type) {
+            load->data_map = NULL;
+            for(i = 0; i < load->size && !load->data_map; i++) {
+                if(!strcmp(event->string, load->sections[i].key)) {
+                    load->data_map = *load->sections[i].map;
+                    load->length = load->data_map->size;
+                }
+            }
+        }
+    } else if(event->depth >= load->depth && load->data_map) {
+        if(event->depth > load->depth) {
+            type = (char) event->type;
+            load->data->hash = i2d_fnv1a(load->data->hash, &type, 1);
+            if(event->string)
+                load->data->hash = i2d_fnv1a(load->data->hash, event->string, event->length);
+        }
+
+        if(event->depth == load->depth) {
+            if(i2d_json_key == event->type)
+                status = i2d_data_load_data(load, event);
+        } else if(event->depth == load->depth + 1) {
+            if(i2d_json_key == event->type) {
+                load->field = event->string;
+            } else {
+                status = i2d_data_load_field(load, event);
+            }
+        } else if(event->depth == load->depth + 2) {
+            status = i2d_data_load_element(load, event);
+        } else if(event->depth == load->depth + 3) {
+            if(i2d_json_key == event->type) {
+                load->bound = event->string;
+            } else if(!strcmp(load->field, "range")) {
+                if(!strcmp(load->bound, "min")) {
+                    if(i2d_event_get_number(event, &load->min)) {
+                        status = i2d_panic("failed to get number object");
+                    } else {
+                        load->is_min = 1;
+                    }
+                } else if(!strcmp(load->bound, "max")) {
+                    if(i2d_event_get_number(event, &load->max)) {
+                        status = i2d_panic("failed to get number object");
+                    } else {
+                        load->is_max = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    return status;
+}
+
+static int i2d_data_load_data(i2d_data_load * load, i2d_json_event * event) {
+    int status = I2D_OK;
+    i2d_data_map * data_map = load->data_map;
+    i2d_data * list;
+    size_t length;
+
+    if(data_map->size == load->length) {
+        length = load->length ? load->length * 2 : BUFFER_SIZE_SMALL;
+        list = i2d_realloc(I2D_TAG_JSON, data_map->list, length * sizeof(*list));
+        if(!list) {
+            status = i2d_panic("out of memory");
+        } else {
+            memset(list + load->length, 0, (length - load->length) * sizeof(*list));
+            data_map->list = list;
+            load->length = length;
+        }
+    }
+
+    if(!status) {
+        load->data = &data_map->list[data_map->size];
+        load->data->hash = I2D_FNV_OFFSET;
+        load->field = "";
+
+        if(i2d_intern_get(event->string, event->length, &load->data->name)) {
+            status = i2d_panic("failed to copy name string");
+        } else {
+            data_map->size++;
+        }
+    }
+
+    return status;
+}
+
+static int i2d_data_load_field(i2d_data_load * load, i2d_json_event * event) {
+    int status = I2D_OK;
+    i2d_data * data = load->data;
+    const char * field = load->field;
+
+    if(i2d_json_array_start == event->type) {
+        load->count = 0;
+        load->range_size = 0;
+    } else if(!strcmp(field, "description")) {
+        if(i2d_event_get_intern(event, &data->description))
+            status = i2d_panic("failed to create string");
+    } else if(!strcmp(field, "handler")) {
+        if(i2d_event_get_intern(event, &data->handler))
+            status = i2d_panic("failed to create string");
+    } else if(!strcmp(field, "argument_type")) {
+        if(i2d_data_load_string_stack(load, event, &data->argument_type))
+            status = i2d_panic("failed to create string stack");
+    } else if(!strcmp(field, "argument_default")) {
+        if(i2d_data_load_string_stack(load, event, &data->argument_default))
+            status = i2d_panic("failed to create string stack");
+    } else if(!strcmp(field, "argument_order")) {
+        if(i2d_data_load_number_array(load, event, &data->argument_order.list, &data->argument_order.size))
+            status = i2d_panic("failed to create number array");
+    } else if(!strcmp(field, "range")) {
+        if(i2d_json_array_end != event->type || !load->range_size)
+            status = i2d_panic("failed to create range");
+    } else if(!strcmp(field, "required")) {
+        if(i2d_event_get_number(event, &data->required))
+            status = i2d_panic("failed to create number");
+    } else if(!strcmp(field, "optional")) {
+        if(i2d_event_get_number(event, &data->optional))
+            status = i2d_panic("failed to create number");
+    } else if(!strcmp(field, "positive")) {
+        if(i2d_event_get_intern(event, &data->positive))
+            status = i2d_panic("failed to create string");
+    } else if(!strcmp(field, "negative")) {
+        if(i2d_event_get_intern(event, &data->negative))
+            status = i2d_panic("failed to create string");
+    } else if(!strcmp(field, "zero")) {
+        if(i2d_event_get_intern(event, &data->zero))
+            status = i2d_panic("failed to create string");
+    } else if(!strcmp(field, "empty_description_on_zero")) {
+        if(i2d_event_get_boolean(event, &data->empty_description_on_zero))
+            status = i2d_panic("failed to create boolean");
+    } else if(!strcmp(field, "empty_description_on_empty_string")) {
+        if(i2d_event_get_boolean(event, &data->empty_description_on_empty_string))
+            status = i2d_panic("failed to create boolean");
+    } else if(!strcmp(field, "dump_stack_instead_of_description")) {
+        if(i2d_event_get_boolean(event, &data->dump_stack_instead_of_description))
+            status = i2d_panic("failed to create boolean");
+    }
+
+    return status;
+}
+
+static int i2d_data_load_element(i2d_data_load * load, i2d_json_event * event) {
+    int status = I2D_OK;
+
+    if(!strcmp(load->field, "range")) {
+        if(i2d_json_object_start == event->type) {
+            load->bound = "";
+            load->is_min = 0;
+            load->is_max = 0;
+        } else if(i2d_json_object_end == event->type) {
+            if(!load->is_min || !load->is_max) {
+                status = i2d_panic("failed to get number object");
+            } else if(!load->range_size) {
+                if(i2d_range_create_add(&load->data->range, load->min, load->max))
+                    status = i2d_panic("failed to create range object");
+            } else {
+                if(i2d_range_add(&load->data->range, load->min, load->max))
+                    status = i2d_panic("failed to add range object");
+            }
+            load->range_size++;
+        } else {
+            status = i2d_panic("invalid range object");
+        }
+    } else if(load->count >= MAX_ARGUMENT) {
+        status = i2d_panic("array exceeded %d elements", MAX_ARGUMENT);
+    } else {
+        load->events[load->count++] = *event;
+    }
+
+    return status;
+}
+
+static int i2d_data_load_string_stack(i2d_data_load * load, i2d_json_event * event, i2d_string_stack * result) {
+    int status = I2D_OK;
+    size_t i;
+
+    if(i2d_json_array_end != event->type || !load->count) {
+        status = i2d_panic("empty array");
+    } else if(i2d_string_stack_create(I2D_TAG_JSON, result, load->count)) {
+        status = I2D_FAIL;
+    } else {
+        for(i = 0; i < load->count && !status; i++) {
+            if(i2d_json_string != load->events[i].type || !load->events[i].length) {
+                status = i2d_panic("failed to get string object");
+            } else if(i2d_string_stack_push(result, load->events[i].string, load->events[i].length)) {
+                status = i2d_panic("failed to push string stack");
+            }
+        }
+    }
+
+    return status;
+}
+
+static int i2d_data_load_number_array(i2d_data_load * load, i2d_json_event * event, long ** result, size_t * result_size) {
+    int status = I2D_OK;
+    long * list;
+    size_t i;
+
+    if(i2d_json_array_end != event->type || !load->count) {
+        status = i2d_panic("empty array");
+    } else {
+        list = i2d_calloc(I2D_TAG_JSON, load->count, sizeof(*list));
+        if(!list) {
+            status = i2d_panic("out of memory");
+        } else {
+            for(i = 0; i < load->count && !status; i++)
+                if(i2d_event_get_number(&load->events[i], &list[i]))
+                    status = i2d_panic("failed to get number object");
+
+            if(status) {
+                i2d_free(list);
+            } else {
+                *result = list;
+                *result_size = load->count;
+            }
+        }
+    }
+
+    return status;
+}
+
+/*
+ * a duplicate key replaces the value of the first
+ * key in place, which is what jansson does
+ */
+static int i2d_data_map_unique(i2d_data_map * data_map) {
+    int status = I2D_OK;
+    i2d_rbt * names = NULL;
+    i2d_data * data;
+    i2d_data swap;
+    i2d_string name;
+    size_t i;
+    size_t size = 0;
+
+    if(i2d_rbt_init(&names, i2d_rbt_cmp_str)) {
+        status = i2d_panic("failed to create red black tree object");
+    } else {
+        for(i = 0; i < data_map->size && !status; i++) {
+            if(i2d_rbt_search(names, data_map->list[i].name.string, (void **) &data)) {
+                if(size != i)
+                    data_map->list[size] = data_map->list[i];
+                if(i2d_rbt_insert(names, data_map->list[size].name.string, &data_map->list[size])) {
+                    status = i2d_panic("failed to map data object");
+                } else {
+                    size++;
+                }
+            } else {
+                swap = *data;
+                *data = data_map->list[i];
+                data_map->list[i] = swap;
+
+                name = data->name;
+                data->name = data_map->list[i].name;
+                data_map->list[i].name = name;
+
+                i2d_data_destroy(&data_map->list[i]);
+            }
+        }
+
+        if(!status)
+            data_map->size = size;
+
+        i2d_rbt_deit(&names);
+    }
+
+    return status;
+}
+
+static int i2d_data_map_table(i2d_data_map * data_map, const i2d_json_table_section * section) {
+    int status = I2D_OK;
+    size_t i;
+
+    if(!section->data_size) {
+        status = i2d_panic("failed to create data array -- %s", section->key ? section->key : "table");
+    } else {
+        data_map->list = i2d_calloc(I2D_TAG_JSON, section->data_size, sizeof(*data_map->list));
+        if(!data_map->list) {
+            status = i2d_panic("out of memory");
+        } else {
+            data_map->table = section;
+
+            for(i = 0; i < section->data_size && !status; i++) {
+                if(i2d_data_table(&data_map->list[i], &section->data[i])) {
+                    status = i2d_panic("failed to create data object");
                 } else {
-                    json_object_foreach(json, key, value) {
-                        if(i2d_data_create(&object->list[i], key, value, constant_db)) {
-                            status = i2d_panic("failed to create data object");
+                    data_map->size++;
+                }
+            }
+        }
+    }
+
+    return status;
+}
+
+/*
+ * the caller owns the maps, including on failure
+ */
+int i2d_data_map_load(i2d_string * path, i2d_data_section * sections, size_t size) {
+    int status = I2D_OK;
+    i2d_data_load load;
+    i2d_data * list;
+    const i2d_json_table * table;
+    const i2d_json_table_section * section;
+    size_t i;
+
+    if(!path || !sections || !size) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        memset(&load, 0, sizeof(load));
+        load.sections = sections;
+        load.size = size;
+        load.depth = sections[0].key ? 2 : 1;
+
+        for(i = 0; i < size && !status; i++) {
+            if(i2d_is_invalid(sections[i].map)) {
+                status = i2d_panic("invalid paramater");
+            } else {
+                *sections[i].map = i2d_calloc(I2D_TAG_JSON, 1, sizeof(**sections[i].map));
+                if(!*sections[i].map)
+                    status = i2d_panic("out of memory");
+            }
+        }
+
+        if(!status) {
+            if(!i2d_json_table_get(path, &table) && table->sections) {
+                for(i = 0; i < size && !status; i++)
+                    if(!i2d_json_table_get_section(table, sections[i].key, &section) && i2d_data_map_table(*sections[i].map, section))
+                        status = i2d_panic("failed to load data table -- %s", table->name);
+            } else if(i2d_json_stream(path, i2d_data_load_event, &load)) {
+                status = i2d_panic("failed to load data file -- %s", path->string);
+            }
+
+            if(!status) {
+                for(i = 0; i < size && !status; i++) {
+                    if(!(*sections[i].map)->size) {
+                        status = i2d_panic("failed to create data array -- %s", sections[i].key ? sections[i].key : path->string);
+                    } else if(!(*sections[i].map)->table) {
+                        /* a table has no duplicates and is not grown */
+                        if(i2d_data_map_unique(*sections[i].map)) {
+                            status = i2d_panic("failed to remove duplicate data");
                         } else {
-                            switch(type) {
-                                case data_map_by_constant:
-                                    if(i2d_rbt_insert(object->map, &object->list[i].constant, &object->list[i]))
-                                        status = i2d_panic("failed to map data object");
-                                    break;
-                                case data_map_by_name:
-                                    if(i2d_rbt_insert(object->map, object->list[i].name.string, &object->list[i]))
-                                        status = i2d_panic("failed to map data object");
-                                    break;
-                                default:
-                                    status = i2d_panic("invalid data map type");
-                                    break;
-                            }
-                            i++;
+                            list = i2d_realloc(I2D_TAG_JSON, (*sections[i].map)->list, (*sections[i].map)->size * sizeof(*list));
+                            if(list)
+                                (*sections[i].map)->list = list;
                         }
                     }
                 }
             }
-
-            if(status)
-                i2d_data_map_deit(&object);
-            else
-                *result = object;
         }
     }
 
@@ -165,26 +675,93 @@ void i2d_data_map_deit(i2d_data_map ** result) {
 }
 
 int i2d_data_map_get(i2d_data_map * data_map, void * key, i2d_data ** result) {
-    return i2d_rbt_search(data_map->map, key, (void **) result);
+    int status = I2D_OK;
+    size_t index;
+
+    if(!data_map->index) {
+        status = i2d_rbt_search(data_map->map, key, (void **) result);
+    } else {
+        switch(data_map->type) {
+            case data_map_by_constant:
+                if(i2d_json_index_number(data_map->index, *(long *) key, &index) || *(long *) key != data_map->list[index].constant)
+                    status = I2D_FAIL;
+                break;
+            case data_map_by_name:
+                if(i2d_json_index_string(data_map->index, key, strlen(key), &index) || i2d_rbt_cmp_str(key, data_map->list[index].name.string))
+                    status = I2D_FAIL;
+                break;
+        }
+
+        if(!status)
+            *result = &data_map->list[index];
+    }
+
+    return status;
 }
 
-int i2d_value_map_init(i2d_value_map ** result, json_t * json, enum i2d_value_type type) {
+static int i2d_value_map_table(i2d_value_map * value_map, const i2d_json_table_section * section) {
+    int status = I2D_OK;
+    const i2d_json_table_value * entry;
+    i2d_value * value;
+    size_t i;
+
+    if(!section->value_size) {
+        status = i2d_panic("empty object");
+    } else {
+        value_map->list = i2d_calloc(I2D_TAG_JSON, section->value_size, sizeof(*value_map->list));
+        if(!value_map->list) {
+            status = i2d_panic("out of memory");
+        } else {
+            value_map->size = section->value_size;
+            value_map->index = &section->numbers;
+
+            for(i = 0; i < section->value_size && !status; i++) {
+                entry = &section->values[i];
+                value = &value_map->list[i];
+                value->value = entry->value;
+
+                switch(value_map->type) {
+                    case i2d_value_string:
+                        if(!entry->string.string || i2d_intern_get(entry->string.string, entry->string.length, &value->string))
+                            status = i2d_panic("failed to copy string");
+                        break;
+                    case i2d_value_string_stack:
+                        if(!entry->stack || i2d_data_table_string_stack(entry->stack, entry->stack_size, &value->stack))
+                            status = i2d_panic("failed to copy string stack");
+                        break;
+                    default:
+                        status = i2d_panic("invalid value type -- %d", value_map->type);
+                        break;
+                }
+            }
+        }
+    }
+
+    return status;
+}
+
+int i2d_value_map_init(i2d_value_map ** result, i2d_json_section * section, enum i2d_value_type type) {
     int status = I2D_OK;
     i2d_value_map * object;
 
     size_t i = 0;
     const char * key;
+    json_t * json;
     json_t * value;
 
-    if(i2d_is_invalid(result)) {
+    if(i2d_is_invalid(result) || !section) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_JSON, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
             object->type = type;
-            if(i2d_rbt_init(&object->map, i2d_rbt_cmp_long)) {
+            json = section->json;
+            if(section->table) {
+                if(i2d_value_map_table(object, section->table))
+                    status = i2d_panic("failed to create value array");
+            } else if(i2d_rbt_init_static(&object->map, i2d_rbt_cmp_long)) {
                 status = i2d_panic("failed to create value map");
             } else if(i2d_object_get_list(json, sizeof(*object->list), (void **) &object->list, &object->size)) {
                 status = i2d_panic("failed to create value array");
@@ -195,7 +772,7 @@ int i2d_value_map_init(i2d_value_map ** result, json_t * json, enum i2d_value_ty
                     } else {
                         switch(object->type) {
                             case i2d_value_string:
-                                if(i2d_object_get_string(value, &object->list[i].string))
+                                if(i2d_object_get_intern(value, &object->list[i].string))
                                     status = i2d_panic("failed to copy string");
                                 break;
                             case i2d_value_string_stack:
@@ -218,6 +795,9 @@ int i2d_value_map_init(i2d_value_map ** result, json_t * json, enum i2d_value_ty
                         }
                     }
                 }
+
+                if(!status && i2d_rbt_build(object->map))
+                    status = i2d_panic("failed to build value map");
             }
 
             if(status)
@@ -239,7 +819,7 @@ void i2d_value_map_deit(i2d_value_map ** result) {
         for(i = 0; i < object->size; i++) {
             switch(object->type) {
                 case i2d_value_string:
-                    i2d_string_destroy(&object->list[i].string);
+                    /* string is interned */
                     break;
                 case i2d_value_string_stack:
                     i2d_string_stack_destroy(&object->list[i].stack);
@@ -253,11 +833,26 @@ void i2d_value_map_deit(i2d_value_map ** result) {
     *result = NULL;
 }
 
+static int i2d_value_map_get(i2d_value_map * value_map, long long key, i2d_value ** result) {
+    int status = I2D_OK;
+    size_t index;
+
+    if(!value_map->index) {
+        status = i2d_rbt_search(value_map->map, &key, (void **) result);
+    } else if(i2d_json_index_number(value_map->index, key, &index) || key != value_map->list[index].value) {
+        status = I2D_FAIL;
+    } else {
+        *result = &value_map->list[index];
+    }
+
+    return status;
+}
+
 int i2d_value_map_get_string(i2d_value_map * value_map, long long key, i2d_string * result) {
     int status = I2D_OK;
     i2d_value * value;
 
-    if(!i2d_rbt_search(value_map->map, &key, (void **) &value))
+    if(!i2d_value_map_get(value_map, key, &value))
         *result = value->string;
 
     return status;
@@ -267,7 +862,7 @@ int i2d_value_map_get_string_stack(i2d_value_map * value_map, long long key, i2d
     int status = I2D_OK;
     i2d_value * value;
 
-    if(!i2d_rbt_search(value_map->map, &key, (void **) &value))
+    if(!i2d_value_map_get(value_map, key, &value))
         *result = value->stack;
 
     return status;
@@ -5,6 +5,14 @@
 #include "i2d_json.h"
 #include "i2d_constant.h"
 
+struct i2d_node;
+
+/*
+ * argument_nodes are the argument_default that
+ * are compiled once by the script, which owns them;
+ * hash is the fnv-1a hash of the events of the
+ * entry when it is loaded from a data file
+ */
 struct i2d_data {
     long constant;
     i2d_string name;
@@ -13,6 +21,7 @@ struct i2d_data {
     i2d_string handler;
     i2d_string_stack argument_type;
     i2d_string_stack argument_default;
+    struct i2d_node ** argument_nodes;
     struct {
         long * list;
         size_t size;
@@ -25,11 +34,12 @@ struct i2d_data {
     int empty_description_on_zero;
     int empty_description_on_empty_string;
     int dump_stack_instead_of_description;
+    uint64_t hash;
 };
 
 typedef struct i2d_data i2d_data;
 
-int i2d_data_create(i2d_data *, const char *, json_t *, i2d_constant_db *);
+int i2d_data_create(i2d_data *, const char *, json_t *);
 void i2d_data_destroy(i2d_data *);
 
 enum i2d_data_map_type {
@@ -37,18 +47,36 @@ enum i2d_data_map_type {
     data_map_by_name
 };
 
+/*
+ * a data map that is copied from a table is indexed
+ * by the perfect hash of the table instead of a red
+ * black tree if the constants are the same
+ */
 struct i2d_data_map {
+    enum i2d_data_map_type type;
     i2d_rbt * map;
+    const i2d_json_table_section * table;
+    const i2d_json_index * index;
     i2d_data * list;
     size_t size;
 };
 
 typedef struct i2d_data_map i2d_data_map;
 
-int i2d_data_map_init(i2d_data_map **, enum i2d_data_map_type, json_t *, i2d_constant_db *);
+int i2d_data_map_init(i2d_data_map **, enum i2d_data_map_type, i2d_json_section *, i2d_constant_db *);
 void i2d_data_map_deit(i2d_data_map **);
+int i2d_data_map_index(i2d_data_map *, enum i2d_data_map_type, i2d_constant_db *);
 int i2d_data_map_get(i2d_data_map *, void *, i2d_data **);
 
+struct i2d_data_section {
+    const char * key;
+    i2d_data_map ** map;
+};
+
+typedef struct i2d_data_section i2d_data_section;
+
+int i2d_data_map_load(i2d_string *, i2d_data_section *, size_t);
+
 enum i2d_value_type {
     i2d_value_string,
     i2d_value_string_stack
@@ -65,13 +93,14 @@ typedef struct i2d_value i2d_value;
 struct i2d_value_map {
     enum i2d_value_type type;
     i2d_rbt * map;
+    const i2d_json_index * index;
     i2d_value * list;
     size_t size;
 };
 
 typedef struct i2d_value_map i2d_value_map;
 
-int i2d_value_map_init(i2d_value_map **, json_t *, enum i2d_value_type);
+int i2d_value_map_init(i2d_value_map **, i2d_json_section *, enum i2d_value_type);
 void i2d_value_map_deit(i2d_value_map **);
 int i2d_value_map_get_string(i2d_value_map *, long long, i2d_string *);
 int i2d_value_map_get_string_stack(i2d_value_map *, long long, i2d_string_stack *);
@@ -1,32 +1,168 @@
 #include "i2d_db.h"
 
+struct i2d_db_load {
+    i2d_db * db;
+    i2d_config * config;
+};
+
+typedef struct i2d_db_load i2d_db_load;
+
+static int i2d_db_load_item_db(void *);
+static int i2d_db_load_skill_db(void *);
+static int i2d_db_load_mob_db(void *);
+static int i2d_db_load_mob_race2_db(void *);
+static int i2d_db_load_produce_db(void *);
+static int i2d_db_load_mercenary_db(void *);
+static int i2d_db_load_pet_db(void *);
+static int i2d_db_load_item_combo_db(void *);
+
+static int i2d_db_load_item_db(void * data) {
+    int status = I2D_OK;
+    i2d_db_load * load = data;
+
+    i2d_trace_begin("i2d_item_db_init", 0);
+
+    if(i2d_item_db_init(&load->db->item_db, &load->config->item_db_path, load->config->stream))
+        status = i2d_panic("failed to create item db object");
+
+    i2d_trace_end("i2d_item_db_init");
+
+    return status;
+}
+
+static int i2d_db_load_skill_db(void * data) {
+    int status = I2D_OK;
+    i2d_db_load * load = data;
+
+    i2d_trace_begin("i2d_skill_db_init", 0);
+
+    if(i2d_skill_db_init(&load->db->skill_db, &load->config->skill_db_path))
+        status = i2d_panic("failed to create skill db object");
+
+    i2d_trace_end("i2d_skill_db_init");
+
+    return status;
+}
+
+static int i2d_db_load_mob_db(void * data) {
+    int status = I2D_OK;
+    i2d_db_load * load = data;
+
+    i2d_trace_begin("i2d_mob_db_init", 0);
+
+    if(i2d_mob_db_init(&load->db->mob_db, &load->config->mob_db_path))
+        status = i2d_panic("failed to create mob db object");
+
+    i2d_trace_end("i2d_mob_db_init");
+
+    return status;
+}
+
+static int i2d_db_load_mob_race2_db(void * data) {
+    int status = I2D_OK;
+    i2d_db_load * load = data;
+
+    i2d_trace_begin("i2d_mob_race_db_init", 0);
+
+    if(i2d_mob_race_db_init(&load->db->mob_race2_db, &load->config->mob_race2_db_path))
+        status = i2d_panic("failed to create mob race2 db object");
+
+    i2d_trace_end("i2d_mob_race_db_init");
+
+    return status;
+}
+
+static int i2d_db_load_produce_db(void * data) {
+    int status = I2D_OK;
+    i2d_db_load * load = data;
+
+    i2d_trace_begin("i2d_produce_db_init", 0);
+
+    if(i2d_produce_db_init(&load->db->produce_db, &load->config->produce_db_path))
+        status = i2d_panic("failed to create produce db object");
+
+    i2d_trace_end("i2d_produce_db_init");
+
+    return status;
+}
+
+static int i2d_db_load_mercenary_db(void * data) {
+    int status = I2D_OK;
+    i2d_db_load * load = data;
+
+    i2d_trace_begin("i2d_mercenary_db_init", 0);
+
+    if(i2d_mercenary_db_init(&load->db->mercenary_db, &load->config->mercenary_db_path))
+        status = i2d_panic("failed to create mercenary db object");
+
+    i2d_trace_end("i2d_mercenary_db_init");
+
+    return status;
+}
+
+static int i2d_db_load_pet_db(void * data) {
+    int status = I2D_OK;
+    i2d_db_load * load = data;
+
+    i2d_trace_begin("i2d_pet_db_init", 0);
+
+    if(i2d_pet_db_init(&load->db->pet_db, &load->config->pet_db_path))
+        status = i2d_panic("failed to create pet db object");
+
+    i2d_trace_end("i2d_pet_db_init");
+
+    return status;
+}
+
+static int i2d_db_load_item_combo_db(void * data) {
+    int status = I2D_OK;
+    i2d_db_load * load = data;
+
+    i2d_trace_begin("i2d_item_combo_db_init", 0);
+
+    if(i2d_item_combo_db_init(&load->db->item_combo_db, &load->config->item_combo_db_path))
+        status = i2d_panic("failed to create item combo db object");
+
+    i2d_trace_end("i2d_item_combo_db_init");
+
+    return status;
+}
+
 int i2d_db_init(i2d_db ** result, i2d_config * config) {
     int status = I2D_OK;
     i2d_db * object;
+    i2d_db_load load;
+    i2d_task tasks[] = {
+        { i2d_db_load_item_db, &load, I2D_OK },
+        { i2d_db_load_mob_db, &load, I2D_OK },
+        { i2d_db_load_skill_db, &load, I2D_OK },
+        { i2d_db_load_item_combo_db, &load, I2D_OK },
+        { i2d_db_load_produce_db, &load, I2D_OK },
+        { i2d_db_load_mercenary_db, &load, I2D_OK },
+        { i2d_db_load_pet_db, &load, I2D_OK },
+        { i2d_db_load_mob_race2_db, &load, I2D_OK }
+    };
 
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_item_db_init(&object->item_db, &config->item_db_path)) {
-                status = i2d_panic("failed to create item db object");
-            } else if(i2d_skill_db_init(&object->skill_db, &config->skill_db_path)) {
-                status = i2d_panic("failed to create skill db object");
-            } else if(i2d_mob_db_init(&object->mob_db, &config->mob_db_path)) {
-                status = i2d_panic("failed to create mob db object");
-            } else if(i2d_mob_race_db_init(&object->mob_race2_db, &config->mob_race2_db_path)) {
-                status = i2d_panic("failed to create mob race2 db object");
-            } else if(i2d_produce_db_init(&object->produce_db, &config->produce_db_path)) {
-                status = i2d_panic("failed to create produce db object");
-            } else if(i2d_mercenary_db_init(&object->mercenary_db, &config->mercenary_db_path)) {
-                status = i2d_panic("failed to create mercenary db object");
-            } else if(i2d_pet_db_init(&object->pet_db, &config->pet_db_path)) {
-                status = i2d_panic("failed to create pet db object");
-            } else if(i2d_item_combo_db_init(&object->item_combo_db, &config->item_combo_db_path)) {
-                status = i2d_panic("failed to create item combo db object");
+            /*
+             * each database only writes its own
+             * field so the loads run concurrently
+             */
+            load.db = object;
+            load.config = config;
+
+            if(i2d_task_run(tasks, i2d_size(tasks))) {
+                status = i2d_panic("failed to load database files");
+            } else if(i2d_pet_db_resolve(object->pet_db, object->mob_db, object->item_db)) {
+                status = i2d_panic("failed to resolve pet db");
+            } else if(i2d_produce_db_resolve(object->produce_db, object->item_db, object->skill_db)) {
+                status = i2d_panic("failed to resolve produce db");
             }
 
             if(status)
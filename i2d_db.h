@@ -8,6 +8,7 @@
 #include "i2d_produce.h"
 #include "i2d_mercenary.h"
 #include "i2d_pet.h"
+#include "i2d_trace.h"
 
 struct i2d_db {
     i2d_item_db * item_db;
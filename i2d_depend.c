@@ -0,0 +1,667 @@
+#include "i2d_depend.h"
+
+static int i2d_depend_entry_init(i2d_depend_entry **, const char *, size_t);
+static void i2d_depend_entry_deit(i2d_depend_entry **);
+static int i2d_depend_entry_cmp(const void *, const void *);
+static int i2d_depend_get(i2d_depend *, const char *, i2d_depend_entry **);
+static int i2d_depend_load_file(i2d_depend *, const char *, i2d_string *);
+static int i2d_depend_load_data(i2d_depend *, const char *, size_t, i2d_string *);
+static int i2d_depend_load_data_cb(i2d_json_event *, void *);
+static int i2d_depend_fold(i2d_depend *, uint64_t, const char *, ...);
+static int i2d_depend_collect_data(i2d_depend *, const char *, i2d_data_map *);
+static int i2d_depend_collect_db(i2d_depend *, i2d_db *);
+static int i2d_depend_collect_file(i2d_depend *, const char *, i2d_string *);
+static int i2d_depend_read_cb(char *, size_t, void *);
+static int i2d_depend_exist(i2d_string *);
+static int i2d_depend_add(i2d_depend_entry *, i2d_index *, i2d_item_db *, i2d_select *);
+
+static int i2d_depend_entry_init(i2d_depend_entry ** result, const char * key, size_t length) {
+    int status = I2D_OK;
+    i2d_depend_entry * object;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_DEPEND, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            object->hash = I2D_FNV_OFFSET;
+
+            if(i2d_string_create(I2D_TAG_DEPEND, &object->key, key, length))
+                status = i2d_panic("failed to create string object");
+
+            if(status)
+                i2d_depend_entry_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+static void i2d_depend_entry_deit(i2d_depend_entry ** result) {
+    i2d_depend_entry * object;
+
+    object = *result;
+    i2d_string_destroy(&object->key);
+    i2d_free(object);
+    *result = NULL;
+}
+
+static int i2d_depend_entry_cmp(const void * left, const void * right) {
+    const i2d_depend_entry * const * x = left;
+    const i2d_depend_entry * const * y = right;
+
+    return i2d_rbt_cmp_str((*x)->key.string, (*y)->key.string);
+}
+
+int i2d_depend_init(i2d_depend ** result) {
+    int status = I2D_OK;
+    i2d_depend * object;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_DEPEND, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            if(i2d_rbt_init(&object->map, i2d_rbt_cmp_str)) {
+                status = i2d_panic("failed to create red black tree object");
+            } else if(i2d_buffer_create(I2D_TAG_DEPEND, &object->buffer, BUFFER_SIZE_SMALL)) {
+                status = i2d_panic("failed to create buffer object");
+            }
+
+            if(status)
+                i2d_depend_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+void i2d_depend_deit(i2d_depend ** result) {
+    i2d_depend * object;
+    size_t i;
+
+    object = *result;
+    i2d_buffer_destroy(&object->buffer);
+    for(i = 0; i < object->size; i++)
+        i2d_depend_entry_deit(&object->list[i]);
+    i2d_free(object->list);
+    i2d_deit(object->map, i2d_rbt_deit);
+    i2d_free(object);
+    *result = NULL;
+}
+
+static int i2d_depend_get(i2d_depend * depend, const char * key, i2d_depend_entry ** result) {
+    int status = I2D_OK;
+    i2d_depend_entry * entry = NULL;
+    i2d_depend_entry ** list;
+    size_t capacity;
+
+    if(i2d_rbt_search(depend->map, key, (void **) result)) {
+        if(depend->size == depend->capacity) {
+            capacity = depend->capacity ? depend->capacity * 2 : 64;
+            list = i2d_realloc(I2D_TAG_DEPEND, depend->list, capacity * sizeof(*depend->list));
+            if(!list) {
+                status = i2d_panic("out of memory");
+            } else {
+                depend->list = list;
+                depend->capacity = capacity;
+            }
+        }
+
+        if(!status && i2d_depend_entry_init(&entry, key, strlen(key))) {
+            status = i2d_panic("failed to create depend entry object");
+        } else if(!status) {
+            if(i2d_rbt_insert(depend->map, entry->key.string, entry)) {
+                status = i2d_panic("failed to map depend entry -- %s", entry->key.string);
+                i2d_depend_entry_deit(&entry);
+            } else {
+                depend->list[depend->size++] = entry;
+                *result = entry;
+            }
+        }
+    }
+
+    return status;
+}
+
+/*
+ * files that are not tracked per entry; a change
+ * to any of them rebuilds every item
+ */
+static int i2d_depend_load_file(i2d_depend * depend, const char * name, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_buffer buffer;
+    i2d_depend_entry * entry;
+
+    i2d_buffer_clear(&depend->buffer);
+
+    if(i2d_buffer_printf(&depend->buffer, "file:%s", name)) {
+        status = i2d_panic("failed to write buffer object");
+    } else if(i2d_depend_get(depend, depend->buffer.buffer, &entry)) {
+        status = i2d_panic("failed to get depend entry -- %s", depend->buffer.buffer);
+    } else if(i2d_buffer_create(I2D_TAG_DEPEND, &buffer, BUFFER_SIZE_LARGE)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        if(i2d_fd_read_file(path, &buffer)) {
+            status = i2d_panic("failed to read file -- %s", path->string);
+        } else {
+            entry->hash = i2d_fnv1a(entry->hash, buffer.buffer, buffer.offset);
+        }
+        i2d_buffer_destroy(&buffer);
+    }
+
+    return status;
+}
+
+/*
+ * the entries of a data file are the keys at
+ * depth, i.e. 2 for the sections of bonus.json,
+ * and every event below a key is hashed into the
+ * entry of the key
+ */
+static int i2d_depend_load_data(i2d_depend * depend, const char * prefix, size_t depth, i2d_string * path) {
+    int status = I2D_OK;
+
+    depend->entry = NULL;
+    depend->depth = depth;
+    depend->prefix = prefix;
+
+    if(i2d_json_stream(path, i2d_depend_load_data_cb, depend))
+        status = i2d_panic("failed to stream file -- %s", path->string);
+
+    return status;
+}
+
+static int i2d_depend_load_data_cb(i2d_json_event * event, void * data) {
+    int status = I2D_OK;
+    i2d_depend * depend = data;
+    char type;
+
+    if(event->depth < depend->depth) {
+        depend->entry = NULL;
+    } else if(event->depth == depend->depth && event->type == i2d_json_key) {
+        i2d_buffer_clear(&depend->buffer);
+
+        if(i2d_buffer_printf(&depend->buffer, "%s:%s", depend->prefix, event->string)) {
+            status = i2d_panic("failed to write buffer object");
+        } else if(i2d_depend_get(depend, depend->buffer.buffer, &depend->entry)) {
+            status = i2d_panic("failed to get depend entry -- %s", depend->buffer.buffer);
+        }
+    } else if(depend->entry) {
+        type = (char) event->type;
+        depend->entry->hash = i2d_fnv1a(depend->entry->hash, &type, 1);
+        if(event->string)
+            depend->entry->hash = i2d_fnv1a(depend->entry->hash, event->string, event->length);
+    }
+
+    return status;
+}
+
+/*
+ * read the files to find the entries that changed
+ * before the files are loaded again, i.e. watch
+ */
+int i2d_depend_load(i2d_depend * depend, i2d_config * config) {
+    int status = I2D_OK;
+
+    if(i2d_depend_load_data(depend, "bonus", 2, &config->bonus_path)) {
+        status = i2d_panic("failed to load bonus");
+    } else if(i2d_depend_load_data(depend, "sc_start", 2, &config->sc_start_path)) {
+        status = i2d_panic("failed to load sc_start");
+    } else if(i2d_depend_load_data(depend, "statement", 1, &config->statements_path)) {
+        status = i2d_panic("failed to load statements");
+    } else if(i2d_depend_load_data(depend, "function", 1, &config->functions_path)) {
+        status = i2d_panic("failed to load functions");
+    } else if(i2d_depend_load_data(depend, "argument", 1, &config->arguments_path)) {
+        status = i2d_panic("failed to load arguments");
+    } else if(i2d_depend_load_file(depend, "constants", &config->constants_path)) {
+        status = i2d_panic("failed to load constants");
+    } else if(i2d_depend_load_file(depend, "data", &config->data_path)) {
+        status = i2d_panic("failed to load data");
+    } else if(i2d_depend_load_file(depend, "print", &config->print_path)) {
+        status = i2d_panic("failed to load print");
+    } else if(i2d_depend_load_file(depend, "item_db", &config->item_db_path)) {
+        status = i2d_panic("failed to load item db");
+    } else if(i2d_depend_load_file(depend, "skill_db", &config->skill_db_path)) {
+        status = i2d_panic("failed to load skill db");
+    } else if(i2d_depend_load_file(depend, "mob_db", &config->mob_db_path)) {
+        status = i2d_panic("failed to load mob db");
+    } else if(i2d_depend_load_file(depend, "mob_race2_db", &config->mob_race2_db_path)) {
+        status = i2d_panic("failed to load mob race2 db");
+    } else if(i2d_depend_load_file(depend, "produce_db", &config->produce_db_path)) {
+        status = i2d_panic("failed to load produce db");
+    } else if(i2d_depend_load_file(depend, "mercenary_db", &config->mercenary_db_path)) {
+        status = i2d_panic("failed to load mercenary db");
+    } else if(i2d_depend_load_file(depend, "pet_db", &config->pet_db_path)) {
+        status = i2d_panic("failed to load pet db");
+    } else if(i2d_depend_load_file(depend, "item_combo_db", &config->item_combo_db_path)) {
+        status = i2d_panic("failed to load item combo db");
+    } else if(config->locale_path.string && i2d_depend_load_file(depend, "locale", &config->locale_path)) {
+        status = i2d_panic("failed to load locale");
+    }
+
+    return status;
+}
+
+/*
+ * fold hash into the entry of the key; several
+ * records can share a key (i.e. the combos of an
+ * item) and are folded in the order of the db
+ */
+static int i2d_depend_fold(i2d_depend * depend, uint64_t hash, const char * format, ...) {
+    int status = I2D_OK;
+    va_list args;
+    i2d_depend_entry * entry;
+
+    i2d_buffer_clear(&depend->buffer);
+
+    va_start(args, format);
+    if(i2d_buffer_vprintf(&depend->buffer, format, args)) {
+        status = i2d_panic("failed to write buffer object");
+    } else if(i2d_depend_get(depend, depend->buffer.buffer, &entry)) {
+        status = i2d_panic("failed to get depend entry -- %s", depend->buffer.buffer);
+    } else {
+        entry->hash = i2d_fnv1a(entry->hash, (char *) &hash, sizeof(hash));
+    }
+    va_end(args);
+
+    return status;
+}
+
+static int i2d_depend_collect_data(i2d_depend * depend, const char * prefix, i2d_data_map * data_map) {
+    int status = I2D_OK;
+    size_t i;
+
+    for(i = 0; i < data_map->size && !status; i++)
+        if(i2d_depend_fold(depend, data_map->list[i].hash, "%s:%s", prefix, data_map->list[i].name.string))
+            status = i2d_panic("failed to fold depend entry -- %s", data_map->list[i].name.string);
+
+    return status;
+}
+
+/*
+ * a combo is an input of the items of the combo
+ * and so are the names of the items, and the
+ * produce description of an item level has the
+ * names of its items and skills
+ */
+static int i2d_depend_collect_db(i2d_depend * depend, i2d_db * db) {
+    int status = I2D_OK;
+    i2d_item * item;
+    i2d_item_entry * entry;
+    i2d_item_combo_list * item_combo_list;
+    i2d_item_combo * item_combo;
+    i2d_skill * skill;
+    i2d_mob * mob;
+    i2d_produce_list * produce_list;
+    uint64_t hash;
+    size_t i;
+    size_t j;
+
+    for(i = 0; i < db->item_db->store.size && !status; i++) {
+        item = db->item_db->store.items[i];
+        if(i2d_depend_fold(depend, item->hash, "item:%ld", item->id))
+            status = i2d_panic("failed to fold item -- %ld", item->id);
+    }
+
+    if(!status && db->item_combo_db->combo_list) {
+        item_combo_list = db->item_combo_db->combo_list;
+        do {
+            for(i = 0; i < item_combo_list->size && !status; i++) {
+                item_combo = item_combo_list->list[i];
+                hash = item_combo->hash;
+                for(j = 0; j < item_combo->size; j++)
+                    if(!i2d_item_db_search_entry_by_id(db->item_db, item_combo->list[j], &entry))
+                        hash = i2d_fnv1a(hash, entry->name.string, entry->name.length + 1);
+
+                if(i2d_depend_fold(depend, hash, "combo:%ld", item_combo_list->item_id))
+                    status = i2d_panic("failed to fold combo -- %ld", item_combo_list->item_id);
+            }
+            item_combo_list = item_combo_list->next;
+        } while(item_combo_list != db->item_combo_db->combo_list && !status);
+    }
+
+    if(!status && db->skill_db->list) {
+        skill = db->skill_db->list;
+        do {
+            if(i2d_depend_fold(depend, skill->hash, "skill:%ld", skill->id))
+                status = i2d_panic("failed to fold skill -- %ld", skill->id);
+            skill = skill->next;
+        } while(skill != db->skill_db->list && !status);
+    }
+
+    if(!status && db->mob_db->list) {
+        mob = db->mob_db->list;
+        do {
+            if(i2d_depend_fold(depend, mob->hash, "mob:%ld", mob->id))
+                status = i2d_panic("failed to fold mob -- %ld", mob->id);
+            mob = mob->next;
+        } while(mob != db->mob_db->list && !status);
+    }
+
+    if(!status && db->produce_db->produce_list) {
+        produce_list = db->produce_db->produce_list;
+        do {
+            hash = i2d_fnv1a(I2D_FNV_OFFSET, produce_list->description.string, produce_list->description.length);
+            if(i2d_depend_fold(depend, hash, "produce:%ld", produce_list->item_level))
+                status = i2d_panic("failed to fold produce -- %ld", produce_list->item_level);
+            produce_list = produce_list->next;
+        } while(produce_list != db->produce_db->produce_list && !status);
+    }
+
+    return status;
+}
+
+/*
+ * files that are not tracked per entry are hashed
+ * by size and modification time, so that a run
+ * does not read the file again
+ */
+static int i2d_depend_collect_file(i2d_depend * depend, const char * name, i2d_string * path) {
+    int status = I2D_OK;
+    struct stat info;
+    uint64_t hash;
+
+    if(stat(path->string, &info)) {
+        status = i2d_panic("failed to stat file -- %s", path->string);
+    } else {
+        hash = i2d_fnv1a(I2D_FNV_OFFSET, (char *) &info.st_size, sizeof(info.st_size));
+        hash = i2d_fnv1a(hash, (char *) &info.st_mtime, sizeof(info.st_mtime));
+#ifndef _WIN32
+        hash = i2d_fnv1a(hash, (char *) &info.st_mtim.tv_nsec, sizeof(info.st_mtim.tv_nsec));
+#endif
+        if(i2d_depend_fold(depend, hash, "file:%s", name))
+            status = i2d_panic("failed to fold file -- %s", name);
+    }
+
+    return status;
+}
+
+/*
+ * the entries of the data files and the records
+ * of the databases are hashed as they are loaded,
+ * so the depend of a run is collected from the
+ * script instead of reading the files again
+ */
+int i2d_depend_collect(i2d_depend * depend, i2d_config * config, i2d_script * script) {
+    int status = I2D_OK;
+    struct {
+        const char * prefix;
+        i2d_data_map * data_map;
+    } data[] = {
+        { "bonus", script->bonus },
+        { "bonus", script->bonus2 },
+        { "bonus", script->bonus3 },
+        { "bonus", script->bonus4 },
+        { "bonus", script->bonus5 },
+        { "sc_start", script->sc_start },
+        { "sc_start", script->sc_start2 },
+        { "sc_start", script->sc_start4 },
+        { "statement", script->statements },
+        { "function", script->functions },
+        { "argument", script->arguments }
+    };
+    size_t i;
+
+    for(i = 0; i < i2d_size(data) && !status; i++)
+        if(i2d_depend_collect_data(depend, data[i].prefix, data[i].data_map))
+            status = i2d_panic("failed to collect data -- %s", data[i].prefix);
+
+    if(status) {
+        /* failed to collect data */
+    } else if(i2d_depend_collect_db(depend, script->db)) {
+        status = i2d_panic("failed to collect db");
+    } else if(i2d_depend_collect_file(depend, "constants", &config->constants_path)) {
+        status = i2d_panic("failed to collect constants");
+    } else if(i2d_depend_collect_file(depend, "data", &config->data_path)) {
+        status = i2d_panic("failed to collect data");
+    } else if(i2d_depend_collect_file(depend, "print", &config->print_path)) {
+        status = i2d_panic("failed to collect print");
+    } else if(i2d_depend_collect_file(depend, "mob_race2_db", &config->mob_race2_db_path)) {
+        status = i2d_panic("failed to collect mob race2 db");
+    } else if(i2d_depend_collect_file(depend, "mercenary_db", &config->mercenary_db_path)) {
+        status = i2d_panic("failed to collect mercenary db");
+    } else if(i2d_depend_collect_file(depend, "pet_db", &config->pet_db_path)) {
+        status = i2d_panic("failed to collect pet db");
+    } else if(config->locale_path.string && i2d_depend_collect_file(depend, "locale", &config->locale_path)) {
+        status = i2d_panic("failed to collect locale");
+    }
+
+    return status;
+}
+
+static int i2d_depend_read_cb(char * string, size_t length, void * data) {
+    int status = I2D_OK;
+    i2d_depend * depend = data;
+    i2d_depend_entry * entry;
+    char * delimit;
+    char * end;
+    unsigned long long hash;
+
+    end = string + length - 1;
+    *end = 0;
+
+    delimit = strchr(string, '\t');
+    if(!delimit) {
+        status = i2d_panic("invalid depend line -- %s", string);
+    } else {
+        *delimit = 0;
+        hash = strtoull(delimit + 1, &delimit, 16);
+        if(delimit != end) {
+            status = i2d_panic("invalid depend hash -- %s", string);
+        } else if(i2d_depend_get(depend, string, &entry)) {
+            status = i2d_panic("failed to get depend entry -- %s", string);
+        } else {
+            entry->hash = hash;
+        }
+    }
+
+    return status;
+}
+
+int i2d_depend_read(i2d_depend * depend, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_buffer buffer;
+
+    if(i2d_buffer_create(I2D_TAG_DEPEND, &buffer, BUFFER_SIZE_LARGE)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        if(i2d_fd_read_file(path, &buffer)) {
+            status = i2d_panic("failed to read file -- %s", path->string);
+        } else if(buffer.offset && i2d_by_line(&buffer, i2d_depend_read_cb, depend)) {
+            status = i2d_panic("failed to parse file -- %s", path->string);
+        }
+        i2d_buffer_destroy(&buffer);
+    }
+
+    return status;
+}
+
+/*
+ * one key per line sorted by key, i.e.
+ *
+ *  bonus:bStr<tab>5d2b3d2d6ad6fc0e
+ */
+int i2d_depend_write(i2d_depend * depend, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_buffer buffer;
+    size_t i;
+    FILE * file;
+
+    if(i2d_buffer_create(I2D_TAG_DEPEND, &buffer, BUFFER_SIZE_LARGE)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        if(depend->size)
+            qsort(depend->list, depend->size, sizeof(*depend->list), i2d_depend_entry_cmp);
+
+        for(i = 0; i < depend->size && !status; i++)
+            if(i2d_buffer_printf(&buffer, "%s\t%016llx\n", depend->list[i]->key.string, (unsigned long long) depend->list[i]->hash))
+                status = i2d_panic("failed to write buffer object");
+
+        if(!status) {
+            file = fopen(path->string, "wb");
+            if(!file) {
+                status = i2d_panic("failed to open file -- %s", path->string);
+            } else {
+                if(buffer.offset != fwrite(buffer.buffer, 1, buffer.offset, file))
+                    status = i2d_panic("failed to write file -- %s", path->string);
+                if(fclose(file))
+                    status = i2d_panic("failed to close file -- %s", path->string);
+            }
+        }
+        i2d_buffer_destroy(&buffer);
+    }
+
+    return status;
+}
+
+static int i2d_depend_exist(i2d_string * path) {
+    int status = I2D_OK;
+    FILE * file;
+
+    file = fopen(path->string, "rb");
+    if(!file) {
+        status = I2D_FAIL;
+    } else {
+        fclose(file);
+    }
+
+    return status;
+}
+
+/*
+ * whether any entry of current that starts with
+ * prefix was added, removed, or changed
+ */
+int i2d_depend_changed(i2d_depend * current, i2d_depend * previous, const char * prefix, int * result) {
+    int status = I2D_OK;
+    i2d_depend_entry * entry;
+    size_t length;
+    size_t i;
+
+    length = strlen(prefix);
+
+    for(i = 0; i < current->size && !*result; i++)
+        if(!strncmp(current->list[i]->key.string, prefix, length))
+            if(i2d_rbt_search(previous->map, current->list[i]->key.string, (void **) &entry) || entry->hash != current->list[i]->hash)
+                *result = 1;
+
+    for(i = 0; i < previous->size && !*result; i++)
+        if(!strncmp(previous->list[i]->key.string, prefix, length))
+            if(i2d_rbt_search(current->map, previous->list[i]->key.string, (void **) &entry))
+                *result = 1;
+
+    return status;
+}
+
+/*
+ * the record and the combos of an item are also
+ * inputs of the item itself, which is not in the
+ * index if the item is new
+ */
+static int i2d_depend_add(i2d_depend_entry * depend_entry, i2d_index * index, i2d_item_db * item_db, i2d_select * select) {
+    int status = I2D_OK;
+    i2d_index_entry * entry;
+    i2d_item * item;
+    const char * key;
+    long id;
+    size_t i;
+
+    if(!i2d_index_search(index, depend_entry->key.string, &entry))
+        for(i = 0; i < entry->size && !status; i++)
+            if(!i2d_item_db_search_by_id(item_db, entry->list[i], &item) && i2d_select_add_id(select, item->id))
+                status = i2d_panic("failed to add item id -- %ld", item->id);
+
+    if(status || (strncmp(depend_entry->key.string, "item:", 5) && strncmp(depend_entry->key.string, "combo:", 6))) {
+        /* not a record of an item */
+    } else {
+        key = strchr(depend_entry->key.string, ':') + 1;
+        if(i2d_strtol(&id, key, strlen(key), 10)) {
+            status = i2d_panic("invalid item id -- %s", depend_entry->key.string);
+        } else if(!i2d_item_db_search_by_id(item_db, id, &item) && i2d_select_add_id(select, item->id)) {
+            status = i2d_panic("failed to add item id -- %ld", item->id);
+        }
+    }
+
+    return status;
+}
+
+/*
+ * select the items that refer to an entry of
+ * current that differs from previous; result is
+ * NULL if every item needs to be compiled, i.e.
+ * a file that is not tracked per entry changed
+ */
+int i2d_depend_diff(i2d_depend * current, i2d_depend * previous, i2d_index * index, i2d_item_db * item_db, i2d_select ** result) {
+    int status = I2D_OK;
+    i2d_depend_entry * entry;
+    i2d_select * select = NULL;
+    int changed = 0;
+    size_t i;
+
+    if(i2d_depend_changed(current, previous, "file:", &changed)) {
+        status = i2d_panic("failed to diff depend");
+    } else if(changed) {
+        /* rebuild every item */
+    } else if(i2d_select_init(&select, NULL)) {
+        status = i2d_panic("failed to create select object");
+    } else {
+        for(i = 0; i < current->size && !status; i++)
+            if(i2d_rbt_search(previous->map, current->list[i]->key.string, (void **) &entry) || entry->hash != current->list[i]->hash)
+                if(i2d_depend_add(current->list[i], index, item_db, select))
+                    status = i2d_panic("failed to add items -- %s", current->list[i]->key.string);
+
+        for(i = 0; i < previous->size && !status; i++)
+            if(i2d_rbt_search(current->map, previous->list[i]->key.string, (void **) &entry))
+                if(i2d_depend_add(previous->list[i], index, item_db, select))
+                    status = i2d_panic("failed to add items -- %s", previous->list[i]->key.string);
+
+        if(status)
+            i2d_select_deit(&select);
+        else
+            *result = select;
+    }
+
+    return status;
+}
+
+/*
+ * select the items that refer to an entry that
+ * was added, removed, or changed since the last
+ * run; result is NULL if every item needs to be
+ * compiled, i.e. on the first run
+ */
+int i2d_depend_select(i2d_depend * depend, i2d_config * config, i2d_index * index, i2d_item_db * item_db, i2d_select ** result) {
+    int status = I2D_OK;
+    i2d_depend * previous = NULL;
+    int changed = 0;
+
+    if(i2d_depend_exist(&config->depend_path) || i2d_depend_exist(&config->index_path) || i2d_depend_exist(&config->cache_path)) {
+        /* first run */
+    } else if(i2d_depend_init(&previous)) {
+        status = i2d_panic("failed to create depend object");
+    } else {
+        if(i2d_depend_read(previous, &config->depend_path)) {
+            status = i2d_panic("failed to read depend -- %s", config->depend_path.string);
+        } else if(i2d_depend_changed(depend, previous, "file:", &changed)) {
+            status = i2d_panic("failed to diff depend");
+        } else if(changed) {
+            /* rebuild every item */
+        } else if(i2d_index_read(index, &config->index_path)) {
+            status = i2d_panic("failed to read index -- %s", config->index_path.string);
+        } else if(i2d_depend_diff(depend, previous, index, item_db, result)) {
+            status = i2d_panic("failed to select items");
+        }
+        i2d_depend_deit(&previous);
+    }
+
+    return status;
+}
@@ -0,0 +1,48 @@
+#ifndef i2d_depend_h
+#define i2d_depend_h
+
+#include "i2d_util.h"
+#include "i2d_rbt.h"
+#include "i2d_json.h"
+#include "i2d_index.h"
+#include "i2d_select.h"
+#include "i2d_script.h"
+#include "sys/stat.h"
+
+/*
+ * key is kind:name in the same format as the
+ * index (i.e. bonus:bStr, skill:28) or file:name
+ * for the files that are not tracked per entry
+ * and hash is the fnv-1a hash of the entry, the
+ * record, or the file
+ */
+struct i2d_depend_entry {
+    i2d_string key;
+    uint64_t hash;
+};
+
+typedef struct i2d_depend_entry i2d_depend_entry;
+
+struct i2d_depend {
+    i2d_rbt * map;
+    i2d_depend_entry ** list;
+    size_t size;
+    size_t capacity;
+    i2d_depend_entry * entry;
+    size_t depth;
+    const char * prefix;
+    i2d_buffer buffer;
+};
+
+typedef struct i2d_depend i2d_depend;
+
+int i2d_depend_init(i2d_depend **);
+void i2d_depend_deit(i2d_depend **);
+int i2d_depend_load(i2d_depend *, i2d_config *);
+int i2d_depend_collect(i2d_depend *, i2d_config *, i2d_script *);
+int i2d_depend_read(i2d_depend *, i2d_string *);
+int i2d_depend_write(i2d_depend *, i2d_string *);
+int i2d_depend_changed(i2d_depend *, i2d_depend *, const char *, int *);
+int i2d_depend_diff(i2d_depend *, i2d_depend *, i2d_index *, i2d_item_db *, i2d_select **);
+int i2d_depend_select(i2d_depend *, i2d_config *, i2d_index *, i2d_item_db *, i2d_select **);
+#endif
@@ -0,0 +1,351 @@
+#include "i2d_index.h"
+
+static int i2d_index_entry_init(i2d_index_entry **, const char *, size_t);
+static void i2d_index_entry_deit(i2d_index_entry **);
+static int i2d_index_entry_add(i2d_index_entry *, long);
+static int i2d_index_entry_cmp(const void *, const void *);
+static int i2d_index_id_cmp(const void *, const void *);
+static int i2d_index_get(i2d_index *, const char *, size_t, i2d_index_entry **);
+static int i2d_index_read_cb(char *, size_t, void *);
+static int i2d_index_item_cmp(const void *, const void *);
+
+static int i2d_index_entry_init(i2d_index_entry ** result, const char * key, size_t length) {
+    int status = I2D_OK;
+    i2d_index_entry * object;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_SCRIPT, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            if(i2d_string_create(I2D_TAG_SCRIPT, &object->key, key, length))
+                status = i2d_panic("failed to create string object");
+
+            if(status)
+                i2d_index_entry_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+static void i2d_index_entry_deit(i2d_index_entry ** result) {
+    i2d_index_entry * object;
+
+    object = *result;
+    i2d_free(object->list);
+    i2d_string_destroy(&object->key);
+    i2d_free(object);
+    *result = NULL;
+}
+
+static int i2d_index_entry_add(i2d_index_entry * entry, long id) {
+    int status = I2D_OK;
+    long * list;
+    size_t capacity;
+
+    /*
+     * an item may refer to the same key several
+     * times but it is compiled in one pass, so it
+     * is enough to compare against the last id
+     */
+    if(!entry->size || entry->list[entry->size - 1] != id) {
+        if(entry->size == entry->capacity) {
+            capacity = entry->capacity ? entry->capacity * 2 : 4;
+            list = i2d_realloc(I2D_TAG_SCRIPT, entry->list, capacity * sizeof(*entry->list));
+            if(!list) {
+                status = i2d_panic("out of memory");
+            } else {
+                entry->list = list;
+                entry->capacity = capacity;
+            }
+        }
+
+        if(!status)
+            entry->list[entry->size++] = id;
+    }
+
+    return status;
+}
+
+static int i2d_index_entry_cmp(const void * left, const void * right) {
+    const i2d_index_entry * const * x = left;
+    const i2d_index_entry * const * y = right;
+
+    return i2d_rbt_cmp_str((*x)->key.string, (*y)->key.string);
+}
+
+static int i2d_index_id_cmp(const void * left, const void * right) {
+    const long * x = left;
+    const long * y = right;
+
+    return *x < *y ? -1 : *x > *y ? 1 : 0;
+}
+
+int i2d_index_init(i2d_index ** result) {
+    int status = I2D_OK;
+    i2d_index * object;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_SCRIPT, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            if(i2d_rbt_init(&object->map, i2d_rbt_cmp_str)) {
+                status = i2d_panic("failed to create red black tree object");
+            } else if(i2d_buffer_create(I2D_TAG_SCRIPT, &object->buffer, BUFFER_SIZE_SMALL)) {
+                status = i2d_panic("failed to create buffer object");
+            }
+
+            if(status)
+                i2d_index_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+void i2d_index_deit(i2d_index ** result) {
+    i2d_index * object;
+    size_t i;
+
+    object = *result;
+    i2d_buffer_destroy(&object->buffer);
+    for(i = 0; i < object->size; i++)
+        i2d_index_entry_deit(&object->list[i]);
+    i2d_free(object->list);
+    i2d_deit(object->map, i2d_rbt_deit);
+    i2d_free(object);
+    *result = NULL;
+}
+
+/*
+ * references are recorded for the item that is
+ * set, including its combo scripts and scripts
+ * compiled for its arguments (i.e. pet scripts)
+ */
+void i2d_index_set_item(i2d_index * index, long item_id) {
+    index->item_id = item_id;
+}
+
+static int i2d_index_get(i2d_index * index, const char * key, size_t length, i2d_index_entry ** result) {
+    int status = I2D_OK;
+    i2d_index_entry * entry = NULL;
+    i2d_index_entry ** list;
+    size_t capacity;
+
+    if(i2d_rbt_search(index->map, key, (void **) result)) {
+        if(index->size == index->capacity) {
+            capacity = index->capacity ? index->capacity * 2 : 64;
+            list = i2d_realloc(I2D_TAG_SCRIPT, index->list, capacity * sizeof(*index->list));
+            if(!list) {
+                status = i2d_panic("out of memory");
+            } else {
+                index->list = list;
+                index->capacity = capacity;
+            }
+        }
+
+        if(!status && i2d_index_entry_init(&entry, key, length)) {
+            status = i2d_panic("failed to create index entry object");
+        } else if(!status) {
+            if(i2d_rbt_insert(index->map, entry->key.string, entry)) {
+                status = i2d_panic("failed to map index entry -- %s", entry->key.string);
+                i2d_index_entry_deit(&entry);
+            } else {
+                index->list[index->size++] = entry;
+                *result = entry;
+            }
+        }
+    }
+
+    return status;
+}
+
+/*
+ * the keys are also appended to trace (if set)
+ * with a nul after each key, i.e. the keys of a
+ * nested script that is compiled once and reused
+ */
+int i2d_index_add(i2d_index * index, const char * format, ...) {
+    int status = I2D_OK;
+    va_list args;
+    i2d_index_entry * entry;
+
+    if(index->item_id || index->trace) {
+        i2d_buffer_clear(&index->buffer);
+
+        va_start(args, format);
+        if(i2d_buffer_vprintf(&index->buffer, format, args)) {
+            status = i2d_panic("failed to write buffer object");
+        } else if(index->trace && (i2d_buffer_memcpy(index->trace, index->buffer.buffer, index->buffer.offset) || i2d_buffer_putc(index->trace, 0))) {
+            status = i2d_panic("failed to write buffer object");
+        } else if(!index->item_id) {
+            /* trace only */
+        } else if(i2d_index_get(index, index->buffer.buffer, index->buffer.offset, &entry)) {
+            status = i2d_panic("failed to get index entry -- %s", index->buffer.buffer);
+        } else if(i2d_index_entry_add(entry, index->item_id)) {
+            status = i2d_panic("failed to add item id -- %ld", index->item_id);
+        }
+        va_end(args);
+    }
+
+    return status;
+}
+
+int i2d_index_search(i2d_index * index, const char * key, i2d_index_entry ** result) {
+    return i2d_rbt_search(index->map, key, (void **) result);
+}
+
+/*
+ * one key per line sorted by key, i.e.
+ *
+ *  bonus:bStr<tab>1201,2301
+ *
+ * the file can be binary searched without being
+ * loaded and the ids of each key are in order
+ */
+int i2d_index_write(i2d_index * index, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_buffer buffer;
+    i2d_index_entry * entry;
+    size_t i;
+    size_t j;
+    FILE * file;
+
+    if(i2d_buffer_create(I2D_TAG_SCRIPT, &buffer, BUFFER_SIZE_LARGE)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        if(index->size)
+            qsort(index->list, index->size, sizeof(*index->list), i2d_index_entry_cmp);
+
+        for(i = 0; i < index->size && !status; i++) {
+            entry = index->list[i];
+            qsort(entry->list, entry->size, sizeof(*entry->list), i2d_index_id_cmp);
+            if(!entry->size) {
+                /* all items were removed */
+            } else if(i2d_buffer_printf(&buffer, "%s\t", entry->key.string)) {
+                status = i2d_panic("failed to write buffer object");
+            } else {
+                for(j = 0; j < entry->size && !status; j++)
+                    if((!j || entry->list[j] != entry->list[j - 1]) && i2d_buffer_printf(&buffer, j ? ",%ld" : "%ld", entry->list[j]))
+                        status = i2d_panic("failed to write buffer object");
+
+                if(!status && i2d_buffer_putc(&buffer, '\n'))
+                    status = i2d_panic("failed to write buffer object");
+            }
+        }
+
+        if(!status) {
+            file = fopen(path->string, "wb");
+            if(!file) {
+                status = i2d_panic("failed to open file -- %s", path->string);
+            } else {
+                if(buffer.offset != fwrite(buffer.buffer, 1, buffer.offset, file))
+                    status = i2d_panic("failed to write file -- %s", path->string);
+                if(fclose(file))
+                    status = i2d_panic("failed to close file -- %s", path->string);
+            }
+        }
+        i2d_buffer_destroy(&buffer);
+    }
+
+    return status;
+}
+
+static int i2d_index_read_cb(char * string, size_t length, void * data) {
+    int status = I2D_OK;
+    i2d_index * index = data;
+    i2d_index_entry * entry;
+    char * delimit;
+    char * anchor;
+    char * end;
+    long id;
+
+    end = string + length - 1;
+    *end = 0;
+
+    delimit = strchr(string, '\t');
+    if(!delimit) {
+        status = i2d_panic("invalid index line -- %s", string);
+    } else {
+        *delimit = 0;
+        if(i2d_index_get(index, string, (size_t) delimit - (size_t) string, &entry)) {
+            status = i2d_panic("failed to get index entry -- %s", string);
+        } else {
+            anchor = delimit + 1;
+            while(anchor < end && !status) {
+                delimit = strchr(anchor, ',');
+                if(!delimit)
+                    delimit = end;
+
+                if(i2d_strtol(&id, anchor, (size_t) delimit - (size_t) anchor, 10)) {
+                    status = i2d_panic("failed to parse item id -- %s", anchor);
+                } else if(i2d_index_entry_add(entry, id)) {
+                    status = i2d_panic("failed to add item id -- %ld", id);
+                } else {
+                    anchor = delimit + 1;
+                }
+            }
+        }
+    }
+
+    return status;
+}
+
+/*
+ * load the file written by i2d_index_write, i.e.
+ * the references of the previous run
+ */
+int i2d_index_read(i2d_index * index, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_buffer buffer;
+
+    if(i2d_buffer_create(I2D_TAG_SCRIPT, &buffer, BUFFER_SIZE_LARGE)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        if(i2d_fd_read_file(path, &buffer)) {
+            status = i2d_panic("failed to read file -- %s", path->string);
+        } else if(buffer.offset && i2d_by_line(&buffer, i2d_index_read_cb, index)) {
+            status = i2d_panic("failed to parse file -- %s", path->string);
+        }
+        i2d_buffer_destroy(&buffer);
+    }
+
+    return status;
+}
+
+static int i2d_index_item_cmp(const void * left, const void * right) {
+    const long * x = left;
+    const i2d_item * const * y = right;
+
+    return *x < (*y)->id ? -1 : *x > (*y)->id ? 1 : 0;
+}
+
+/*
+ * remove the references of items that are about
+ * to be compiled again; list is sorted by id and
+ * is NULL if no item changed
+ */
+void i2d_index_remove(i2d_index * index, i2d_item ** list, size_t size) {
+    i2d_index_entry * entry;
+    size_t i;
+    size_t j;
+    size_t k;
+
+    for(i = 0; i < index->size && size; i++) {
+        entry = index->list[i];
+        for(j = 0, k = 0; j < entry->size; j++)
+            if(!bsearch(&entry->list[j], list, size, sizeof(*list), i2d_index_item_cmp))
+                entry->list[k++] = entry->list[j];
+        entry->size = k;
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef i2d_index_h
+#define i2d_index_h
+
+#include "i2d_util.h"
+#include "i2d_rbt.h"
+#include "i2d_item.h"
+
+/*
+ * key is kind:name (i.e. bonus:bStr, skill:28)
+ * and list is the item ids whose scripts refer
+ * to the key in the order they were compiled
+ */
+struct i2d_index_entry {
+    i2d_string key;
+    long * list;
+    size_t size;
+    size_t capacity;
+};
+
+typedef struct i2d_index_entry i2d_index_entry;
+
+struct i2d_index {
+    i2d_rbt * map;
+    i2d_index_entry ** list;
+    size_t size;
+    size_t capacity;
+    long item_id;
+    i2d_buffer buffer;
+    i2d_buffer * trace;
+};
+
+typedef struct i2d_index i2d_index;
+
+int i2d_index_init(i2d_index **);
+void i2d_index_deit(i2d_index **);
+void i2d_index_set_item(i2d_index *, long);
+int i2d_index_add(i2d_index *, const char *, ...);
+int i2d_index_search(i2d_index *, const char *, i2d_index_entry **);
+int i2d_index_write(i2d_index *, i2d_string *);
+int i2d_index_read(i2d_index *, i2d_string *);
+void i2d_index_remove(i2d_index *, i2d_item **, size_t);
+#endif
@@ -0,0 +1,191 @@
+#include "i2d_intern.h"
+
+static char * i2d_intern_string(i2d_intern *, uint32_t);
+static int i2d_intern_index(i2d_intern *);
+static int i2d_intern_add(i2d_intern *, const char *, size_t, uint32_t *);
+static int i2d_intern_search(i2d_intern *, const char *, size_t, uint32_t, i2d_string *);
+
+static i2d_intern i2d_intern_arena;
+#ifndef _WIN32
+static pthread_mutex_t i2d_intern_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/*
+ * the databases and the data files are loaded by
+ * the tasks, so the index is only changed while
+ * the lock is held; the strings are never moved
+ */
+int i2d_intern_get(const char * string, size_t length, i2d_string * result) {
+    int status = I2D_OK;
+    uint32_t hash;
+
+    hash = (uint32_t) i2d_fnv1a(I2D_FNV_OFFSET, string, length);
+
+#ifndef _WIN32
+    pthread_mutex_lock(&i2d_intern_mutex);
+#endif
+    status = i2d_intern_search(&i2d_intern_arena, string, length, hash, result);
+#ifndef _WIN32
+    pthread_mutex_unlock(&i2d_intern_mutex);
+#endif
+
+    return status;
+}
+
+void i2d_intern_deit(void) {
+    i2d_intern * arena = &i2d_intern_arena;
+    size_t i;
+
+    for(i = 0; i < arena->size; i++)
+        i2d_free(arena->blocks[i]);
+    i2d_free(arena->blocks);
+    i2d_free(arena->slots);
+    i2d_zero(*arena);
+}
+
+/* length prefix of the string at the offset */
+static char * i2d_intern_string(i2d_intern * arena, uint32_t offset) {
+    offset--;
+    return arena->blocks[offset >> I2D_INTERN_BITS] + (offset & (I2D_INTERN_BLOCK - 1));
+}
+
+/*
+ * double the index at half load and move the slots
+ * by the hash that is kept in the slot
+ */
+static int i2d_intern_index(i2d_intern * arena) {
+    int status = I2D_OK;
+    i2d_intern_slot * slots;
+    size_t capacity;
+    size_t i;
+    size_t j;
+
+    if(!arena->slots || (arena->count + 1) * 2 > arena->mask + 1) {
+        capacity = arena->slots ? (arena->mask + 1) * 2 : I2D_INTERN_SLOTS;
+        slots = i2d_calloc(I2D_TAG_INTERN, capacity, sizeof(*slots));
+        if(!slots) {
+            status = i2d_panic("out of memory");
+        } else {
+            if(arena->slots) {
+                for(i = 0; i <= arena->mask; i++) {
+                    if(arena->slots[i].offset) {
+                        j = arena->slots[i].hash & (capacity - 1);
+                        while(slots[j].offset)
+                            j = (j + 1) & (capacity - 1);
+                        slots[j] = arena->slots[i];
+                    }
+                }
+                i2d_free(arena->slots);
+            }
+            arena->slots = slots;
+            arena->mask = capacity - 1;
+        }
+    }
+
+    return status;
+}
+
+static int i2d_intern_add(i2d_intern * arena, const char * string, size_t length, uint32_t * result) {
+    int status = I2D_OK;
+    char ** blocks;
+    char * block;
+    size_t capacity;
+    size_t size;
+    size_t index = 0;
+    size_t offset = 0;
+    uint32_t prefix;
+
+    size = sizeof(prefix) + length + 1;
+
+    if(length > UINT32_MAX) {
+        status = i2d_panic("string is too long -- %zu", length);
+    } else if(arena->size == arena->capacity) {
+        capacity = arena->capacity ? arena->capacity * 2 : BUFFER_SIZE_SMALL;
+        blocks = i2d_realloc(I2D_TAG_INTERN, arena->blocks, capacity * sizeof(*blocks));
+        if(!blocks) {
+            status = i2d_panic("out of memory");
+        } else {
+            arena->blocks = blocks;
+            arena->capacity = capacity;
+        }
+    }
+
+    if(status) {
+        /* failed to grow the list of blocks */
+    } else if(size <= I2D_INTERN_BLOCK && arena->size && arena->offset + size <= I2D_INTERN_BLOCK) {
+        index = arena->block;
+        offset = arena->offset;
+        arena->offset += size;
+    } else if(arena->size >= I2D_INTERN_BLOCKS) {
+        status = i2d_panic("intern arena is full");
+    } else {
+        block = i2d_malloc(I2D_TAG_INTERN, max(size, I2D_INTERN_BLOCK));
+        if(!block) {
+            status = i2d_panic("out of memory");
+        } else {
+            index = arena->size;
+            offset = 0;
+            arena->blocks[arena->size++] = block;
+
+            /* a larger string does not replace the block */
+            if(size <= I2D_INTERN_BLOCK) {
+                arena->block = index;
+                arena->offset = size;
+            }
+        }
+    }
+
+    if(!status) {
+        block = arena->blocks[index] + offset;
+        prefix = (uint32_t) length;
+        memcpy(block, &prefix, sizeof(prefix));
+        memcpy(block + sizeof(prefix), string, length);
+        block[sizeof(prefix) + length] = 0;
+        *result = (uint32_t) ((index << I2D_INTERN_BITS) | offset) + 1;
+    }
+
+    return status;
+}
+
+static int i2d_intern_search(i2d_intern * arena, const char * string, size_t length, uint32_t hash, i2d_string * result) {
+    int status = I2D_OK;
+    i2d_intern_slot * slot;
+    char * match = NULL;
+    uint32_t prefix;
+    uint32_t offset;
+    size_t i;
+
+    if(i2d_intern_index(arena)) {
+        status = i2d_panic("failed to grow intern index");
+    } else {
+        i = hash & arena->mask;
+        while(!match && arena->slots[i].offset) {
+            slot = &arena->slots[i];
+            if(slot->hash == hash) {
+                match = i2d_intern_string(arena, slot->offset);
+                memcpy(&prefix, match, sizeof(prefix));
+                if(prefix != length || memcmp(match + sizeof(prefix), string, length))
+                    match = NULL;
+            }
+            i = (i + 1) & arena->mask;
+        }
+
+        if(match) {
+            /* string is in the arena */
+        } else if(i2d_intern_add(arena, string, length, &offset)) {
+            status = i2d_panic("failed to add string to arena");
+        } else {
+            arena->slots[i].hash = hash;
+            arena->slots[i].offset = offset;
+            arena->count++;
+            match = i2d_intern_string(arena, offset);
+        }
+
+        if(!status) {
+            result->string = match + sizeof(prefix);
+            result->length = length;
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,60 @@
+#ifndef i2d_intern_h
+#define i2d_intern_h
+
+#include "i2d_util.h"
+
+/*
+ * size of a block of the arena (power of two) and
+ * the maximum number of blocks, so that the offset
+ * of a string fits in 32 bits
+ */
+#define I2D_INTERN_BITS 20
+#define I2D_INTERN_BLOCK (1 << I2D_INTERN_BITS)
+#define I2D_INTERN_BLOCKS (1 << (32 - I2D_INTERN_BITS))
+
+/*
+ * minimum number of slots of the index
+ */
+#define I2D_INTERN_SLOTS 4096
+
+/*
+ * the offset of a string is the index of its block
+ * in the upper bits and its position in the block
+ * in the lower bits, plus one so that zero is an
+ * empty slot
+ */
+struct i2d_intern_slot {
+    uint32_t hash;
+    uint32_t offset;
+};
+
+typedef struct i2d_intern_slot i2d_intern_slot;
+
+/*
+ * the strings of the records, constants, and data
+ * maps are copied once into a single arena and
+ * equal strings share the same copy; a string is
+ * prefixed by its length in a block that is never
+ * moved, and a string that is larger than a block
+ * has a block of its own
+ *
+ * the index is open addressed (linear probing) and
+ * the arena is freed as a whole, so a string of the
+ * arena must not be freed on its own
+ */
+struct i2d_intern {
+    char ** blocks;
+    size_t size;
+    size_t capacity;
+    size_t block;
+    size_t offset;
+    i2d_intern_slot * slots;
+    size_t mask;
+    size_t count;
+};
+
+typedef struct i2d_intern i2d_intern;
+
+void i2d_intern_deit(void);
+int i2d_intern_get(const char *, size_t, i2d_string *);
+#endif
@@ -0,0 +1,297 @@
+#include "i2d_ir.h"
+
+static int i2d_ir_add(i2d_ir *, enum i2d_ir_type, i2d_ir_entry **);
+
+int i2d_ir_create(i2d_ir * result) {
+    int status = I2D_OK;
+
+    i2d_zero(*result);
+
+    if(i2d_buffer_create(I2D_TAG_SCRIPT, &result->buffer, BUFFER_SIZE_SMALL))
+        status = i2d_panic("failed to create buffer object");
+
+    return status;
+}
+
+void i2d_ir_destroy(i2d_ir * result) {
+    size_t i;
+
+    for(i = 0; i < result->size; i++)
+        i2d_deit(result->list[i].logic, i2d_logic_deit);
+    i2d_free(result->list);
+    i2d_free(result->arguments);
+    i2d_buffer_destroy(&result->buffer);
+}
+
+static int i2d_ir_add(i2d_ir * ir, enum i2d_ir_type type, i2d_ir_entry ** result) {
+    int status = I2D_OK;
+    i2d_ir_entry * list;
+    size_t capacity;
+
+    if(ir->size == ir->capacity) {
+        capacity = ir->capacity ? ir->capacity * 2 : 16;
+        list = i2d_realloc(I2D_TAG_SCRIPT, ir->list, capacity * sizeof(*ir->list));
+        if(!list) {
+            status = i2d_panic("out of memory");
+        } else {
+            ir->list = list;
+            ir->capacity = capacity;
+        }
+    }
+
+    if(!status) {
+        *result = &ir->list[ir->size];
+        memset(*result, 0, sizeof(**result));
+        (*result)->type = type;
+        (*result)->first = ir->size;
+        (*result)->parent = -1;
+        (*result)->slot = -1;
+        ir->size++;
+    }
+
+    return status;
+}
+
+/*
+ * the statements evaluated for the arguments of
+ * a statement are added before the statement is
+ * added; mark is the position before evaluation
+ */
+size_t i2d_ir_mark(i2d_ir * ir) {
+    return ir ? ir->size : 0;
+}
+
+/*
+ * ranges is null or has the range of each of the
+ * arguments that are ranges
+ */
+int i2d_ir_statement(i2d_ir * ir, size_t mark, i2d_data * data, i2d_string * list, i2d_ir_range * ranges, size_t size) {
+    int status = I2D_OK;
+    i2d_ir_entry * entry;
+    i2d_ir_argument * arguments;
+    i2d_ir_argument * argument;
+    size_t capacity;
+    size_t skip;
+    size_t i;
+
+    if(ir) {
+        if(ir->arguments_size + size > ir->arguments_capacity) {
+            capacity = ir->arguments_capacity ? ir->arguments_capacity * 2 : 16;
+            while(capacity < ir->arguments_size + size)
+                capacity *= 2;
+
+            arguments = i2d_realloc(I2D_TAG_SCRIPT, ir->arguments, capacity * sizeof(*ir->arguments));
+            if(!arguments) {
+                status = i2d_panic("out of memory");
+            } else {
+                ir->arguments = arguments;
+                ir->arguments_capacity = capacity;
+            }
+        }
+
+        if(status) {
+            /* out of memory */
+        } else if(i2d_ir_add(ir, ir_statement, &entry)) {
+            status = i2d_panic("failed to add statement");
+        } else {
+            entry->data = data;
+            entry->argument = ir->arguments_size;
+            entry->size = size;
+            entry->first = mark;
+
+            for(i = 0; i < size && !status; i++) {
+                argument = &ir->arguments[ir->arguments_size];
+                i2d_zero(*argument);
+                skip = 0;
+                if(ranges && ranges[i].format) {
+                    argument->format = ranges[i].format;
+                    argument->min = ranges[i].min;
+                    argument->max = ranges[i].max;
+                    skip = ranges[i].length;
+                }
+                argument->offset = ir->buffer.offset;
+                argument->length = list[i].length - skip;
+                if( i2d_buffer_memcpy(&ir->buffer, list[i].string + skip, list[i].length - skip) ||
+                    i2d_buffer_putc(&ir->buffer, 0) ) {
+                    status = i2d_panic("failed to write buffer object");
+                } else {
+                    ir->arguments_size++;
+                }
+            }
+
+            for(i = mark; i < ir->size - 1; i++)
+                if(ir->list[i].type == ir_statement && ir->list[i].parent < 0)
+                    ir->list[i].parent = (long) ir->size - 1;
+        }
+    }
+
+    return status;
+}
+
+/*
+ * the last statement is the argument at slot of
+ * the statement that is evaluated next
+ */
+int i2d_ir_bind(i2d_ir * ir, size_t slot) {
+    int status = I2D_OK;
+
+    if(!ir) {
+        /* not recording */
+    } else if(!ir->size || ir->list[ir->size - 1].type != ir_statement) {
+        status = i2d_panic("failed to bind statement");
+    } else {
+        ir->list[ir->size - 1].slot = (long) slot;
+    }
+
+    return status;
+}
+
+int i2d_ir_condition(i2d_ir * ir, i2d_logic * logic) {
+    int status = I2D_OK;
+    i2d_ir_entry * entry;
+
+    if(!ir) {
+        /* not recording */
+    } else if(i2d_ir_add(ir, ir_condition, &entry)) {
+        status = i2d_panic("failed to add condition");
+    } else if(i2d_logic_copy(&entry->logic, logic)) {
+        status = i2d_panic("failed to copy logic object");
+    }
+
+    return status;
+}
+
+int i2d_ir_end(i2d_ir * ir) {
+    int status = I2D_OK;
+    i2d_ir_entry * entry;
+
+    if(ir && i2d_ir_add(ir, ir_end, &entry))
+        status = i2d_panic("failed to add end");
+
+    return status;
+}
+
+/*
+ * the argument is appended to the buffer and a
+ * range is formatted before the rest of the text
+ */
+int i2d_ir_get_argument(i2d_ir * ir, i2d_ir_entry * entry, size_t index, i2d_buffer * buffer) {
+    int status = I2D_OK;
+    i2d_ir_argument * argument;
+
+    if(i2d_ir_get_value(ir, entry, index, &argument)) {
+        status = i2d_panic("failed to get argument");
+    } else if(argument->format && argument->format(argument->min, argument->max, buffer)) {
+        status = i2d_panic("failed to format argument");
+    } else if(i2d_buffer_memcpy(buffer, ir->buffer.buffer + argument->offset, argument->length)) {
+        status = i2d_panic("failed to write buffer object");
+    }
+
+    return status;
+}
+
+int i2d_ir_get_value(i2d_ir * ir, i2d_ir_entry * entry, size_t index, i2d_ir_argument ** result) {
+    int status = I2D_OK;
+
+    if(index >= entry->size) {
+        status = i2d_panic("invalid argument index -- %zu", index);
+    } else {
+        *result = &ir->arguments[entry->argument + index];
+    }
+
+    return status;
+}
+
+int i2d_ir_get_child(i2d_ir * ir, size_t index, size_t slot, i2d_ir_entry ** result) {
+    int status = I2D_FAIL;
+    size_t i;
+
+    for(i = ir->list[index].first; i < index && status; i++) {
+        if(ir->list[i].parent == (long) index && ir->list[i].slot == (long) slot) {
+            *result = &ir->list[i];
+            status = I2D_OK;
+        }
+    }
+
+    return status;
+}
+
+int i2d_locale_init(i2d_locale ** result, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_locale * object;
+    json_t * json;
+    const char * key;
+    json_t * value;
+    size_t i = 0;
+
+    if(i2d_is_invalid(result) || !path) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_SCRIPT, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            if(i2d_json_create(&json, path)) {
+                status = i2d_panic("failed to load -- %s", path->string);
+            } else {
+                object->size = json_object_size(json);
+                if(i2d_rbt_init(&object->map, i2d_rbt_cmp_str)) {
+                    status = i2d_panic("failed to create red black tree object");
+                } else if(!object->size) {
+                    /* empty locale */
+                } else {
+                    object->keys = i2d_calloc(I2D_TAG_SCRIPT, object->size, sizeof(*object->keys));
+                    object->list = i2d_calloc(I2D_TAG_SCRIPT, object->size, sizeof(*object->list));
+                    if(!object->keys || !object->list) {
+                        status = i2d_panic("out of memory");
+                    } else {
+                        json_object_foreach(json, key, value) {
+                            if(status)
+                                break;
+
+                            if(i2d_string_create(I2D_TAG_SCRIPT, &object->keys[i], key, strlen(key))) {
+                                status = i2d_panic("failed to create string object");
+                            } else if(i2d_object_get_string(value, &object->list[i])) {
+                                status = i2d_panic("failed to get description -- %s", key);
+                            } else if(i2d_rbt_insert(object->map, object->keys[i].string, &object->list[i])) {
+                                status = i2d_panic("failed to map description -- %s", key);
+                            } else {
+                                i++;
+                            }
+                        }
+                    }
+                }
+                i2d_json_destroy(json);
+            }
+
+            if(status)
+                i2d_locale_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+void i2d_locale_deit(i2d_locale ** result) {
+    i2d_locale * object;
+    size_t i;
+
+    object = *result;
+    for(i = 0; i < object->size; i++) {
+        if(object->list)
+            i2d_string_destroy(&object->list[i]);
+        if(object->keys)
+            i2d_string_destroy(&object->keys[i]);
+    }
+    i2d_free(object->list);
+    i2d_free(object->keys);
+    i2d_deit(object->map, i2d_rbt_deit);
+    i2d_free(object);
+    *result = NULL;
+}
+
+int i2d_locale_get(i2d_locale * locale, i2d_data * data, i2d_string ** result) {
+    return i2d_rbt_search(locale->map, data->name.string, (void **) result);
+}
@@ -0,0 +1,108 @@
+#ifndef i2d_ir_h
+#define i2d_ir_h
+
+#include "i2d_util.h"
+#include "i2d_rbt.h"
+#include "i2d_logic.h"
+#include "i2d_data.h"
+
+enum i2d_ir_type {
+    ir_statement,
+    ir_condition,
+    ir_end
+};
+
+/*
+ * a statement is the data (statement, bonus, or
+ * sc_start) that describes it and the arguments
+ * that were evaluated for it; a statement that
+ * is the argument of another statement has the
+ * parent and slot of the argument, otherwise the
+ * parent is -1; the children of a statement are
+ * between first and the statement
+ *
+ * a condition is the logic of an if or else and
+ * applies to the statements up to its end
+ */
+struct i2d_ir_entry {
+    enum i2d_ir_type type;
+    i2d_data * data;
+    i2d_logic * logic;
+    size_t argument;
+    size_t size;
+    size_t first;
+    long parent;
+    long slot;
+};
+
+typedef struct i2d_ir_entry i2d_ir_entry;
+
+/*
+ * an argument that is a range is formatted from
+ * min and max by the back-end and the text is
+ * the rest of the argument (i.e. the expression);
+ * otherwise, format is null and the text is the
+ * argument
+ */
+typedef int (* i2d_ir_format_cb) (long, long, i2d_buffer *);
+
+struct i2d_ir_range {
+    i2d_ir_format_cb format;
+    long min;
+    long max;
+    size_t length;
+};
+
+typedef struct i2d_ir_range i2d_ir_range;
+
+struct i2d_ir_argument {
+    i2d_ir_format_cb format;
+    long min;
+    long max;
+    size_t offset;
+    size_t length;
+};
+
+typedef struct i2d_ir_argument i2d_ir_argument;
+
+struct i2d_ir {
+    i2d_ir_entry * list;
+    size_t size;
+    size_t capacity;
+    i2d_ir_argument * arguments;
+    size_t arguments_size;
+    size_t arguments_capacity;
+    i2d_buffer buffer;
+};
+
+typedef struct i2d_ir i2d_ir;
+
+int i2d_ir_create(i2d_ir *);
+void i2d_ir_destroy(i2d_ir *);
+size_t i2d_ir_mark(i2d_ir *);
+int i2d_ir_statement(i2d_ir *, size_t, i2d_data *, i2d_string *, i2d_ir_range *, size_t);
+int i2d_ir_bind(i2d_ir *, size_t);
+int i2d_ir_condition(i2d_ir *, i2d_logic *);
+int i2d_ir_end(i2d_ir *);
+int i2d_ir_get_argument(i2d_ir *, i2d_ir_entry *, size_t, i2d_buffer *);
+int i2d_ir_get_value(i2d_ir *, i2d_ir_entry *, size_t, i2d_ir_argument **);
+int i2d_ir_get_child(i2d_ir *, size_t, size_t, i2d_ir_entry **);
+
+/*
+ * name of a statement, bonus, or sc_start to a
+ * description in the same format as the data
+ * files, i.e. { "bStr": "STR {0}" }
+ */
+struct i2d_locale {
+    i2d_rbt * map;
+    i2d_string * keys;
+    i2d_string * list;
+    size_t size;
+};
+
+typedef struct i2d_locale i2d_locale;
+
+int i2d_locale_init(i2d_locale **, i2d_string *);
+void i2d_locale_deit(i2d_locale **);
+int i2d_locale_get(i2d_locale *, i2d_data *, i2d_string **);
+#endif
@@ -1,9 +1,197 @@
 #include "i2d_item.h"
 
+/*
+ * the item that is read from the file and passed
+ * to the callback, which must write the item out
+ * since the strings of the item refer to the line
+ */
+struct i2d_item_stream {
+    i2d_item item;
+    i2d_item_scan_cb cb;
+    void * data;
+};
+
+typedef struct i2d_item_stream i2d_item_stream;
+
+struct i2d_item_yml {
+    i2d_item_db * item_db;
+    i2d_item_stream * stream;
+    i2d_buffer script_buffer;
+    i2d_buffer onequip_buffer;
+    i2d_buffer onunequip_buffer;
+    i2d_table table;
+    i2d_rbt * index;
+    i2d_string script;
+    i2d_item * item;
+    int exist;
+    int is_update;
+    int fields;
+    int buy;
+    int sell;
+    int job;
+    int upper;
+    int location;
+};
+
+typedef struct i2d_item_yml i2d_item_yml;
+
+static i2d_yaml_constant i2d_item_type_list[] = {
+    { "Healing", 0 },
+    { "Usable", 2 },
+    { "Etc", 3 },
+    { "Armor", 4 },
+    { "Weapon", 5 },
+    { "Card", 6 },
+    { "PetEgg", 7 },
+    { "PetArmor", 8 },
+    { "Ammo", 10 },
+    { "DelayConsume", 11 },
+    { "ShadowGear", 12 },
+    { "Cash", 18 }
+};
+
+static i2d_yaml_constant i2d_item_weapon_list[] = {
+    { "Fist", 0 },
+    { "Dagger", 1 },
+    { "1hSword", 2 },
+    { "2hSword", 3 },
+    { "1hSpear", 4 },
+    { "2hSpear", 5 },
+    { "1hAxe", 6 },
+    { "2hAxe", 7 },
+    { "Mace", 8 },
+    { "2hMace", 9 },
+    { "Staff", 10 },
+    { "Bow", 11 },
+    { "Knuckle", 12 },
+    { "Musical", 13 },
+    { "Whip", 14 },
+    { "Book", 15 },
+    { "Katar", 16 },
+    { "Revolver", 17 },
+    { "Rifle", 18 },
+    { "Gatling", 19 },
+    { "Shotgun", 20 },
+    { "Grenade", 21 },
+    { "Huuma", 22 },
+    { "2hStaff", 23 }
+};
+
+static i2d_yaml_constant i2d_item_ammo_list[] = {
+    { "Arrow", 1 },
+    { "Dagger", 2 },
+    { "Bullet", 3 },
+    { "Shell", 4 },
+    { "Grenade", 5 },
+    { "Shuriken", 6 },
+    { "Kunai", 7 },
+    { "CannonBall", 8 },
+    { "ThrowWeapon", 9 }
+};
+
+static i2d_yaml_constant i2d_item_job_list[] = {
+    { "All", 0xFFFFFFFF },
+    { "Novice", 0x00000001 },
+    { "SuperNovice", 0x00000001 },
+    { "Swordman", 0x00000002 },
+    { "Magician", 0x00000004 },
+    { "Archer", 0x00000008 },
+    { "Acolyte", 0x00000010 },
+    { "Merchant", 0x00000020 },
+    { "Thief", 0x00000040 },
+    { "Knight", 0x00000080 },
+    { "Priest", 0x00000100 },
+    { "Wizard", 0x00000200 },
+    { "Blacksmith", 0x00000400 },
+    { "Hunter", 0x00000800 },
+    { "Assassin", 0x00001000 },
+    { "Crusader", 0x00004000 },
+    { "Monk", 0x00008000 },
+    { "Sage", 0x00010000 },
+    { "Rogue", 0x00020000 },
+    { "Alchemist", 0x00040000 },
+    { "BardDancer", 0x00080000 },
+    { "Taekwon", 0x00200000 },
+    { "StarGladiator", 0x00400000 },
+    { "SoulLinker", 0x00800000 },
+    { "Gunslinger", 0x01000000 },
+    { "Ninja", 0x02000000 },
+    { "Gangsi", 0x04000000 },
+    { "DeathKnight", 0x08000000 },
+    { "DarkCollector", 0x10000000 },
+    { "KagerouOboro", 0x20000000 },
+    { "Rebellion", 0x40000000 },
+    { "Summoner", 0x80000000 },
+    { "SpiritHandler", 0x00000000 }
+};
+
+static i2d_yaml_constant i2d_item_class_list[] = {
+    { "All", 0x3F },
+    { "Normal", 0x01 },
+    { "Upper", 0x02 },
+    { "Baby", 0x04 },
+    { "Third", 0x08 },
+    { "Third_Upper", 0x10 },
+    { "Third_Baby", 0x20 },
+    { "Fourth", 0x40 },
+    { "All_Upper", 0x12 },
+    { "All_Baby", 0x24 },
+    { "All_Third", 0x38 }
+};
+
+static i2d_yaml_constant i2d_item_gender_list[] = {
+    { "Female", 0 },
+    { "Male", 1 },
+    { "Both", 2 }
+};
+
+static i2d_yaml_constant i2d_item_location_list[] = {
+    { "Head_Low", 0x000001 },
+    { "Right_Hand", 0x000002 },
+    { "Garment", 0x000004 },
+    { "Left_Accessory", 0x000008 },
+    { "Armor", 0x000010 },
+    { "Left_Hand", 0x000020 },
+    { "Shoes", 0x000040 },
+    { "Right_Accessory", 0x000080 },
+    { "Head_Top", 0x000100 },
+    { "Head_Mid", 0x000200 },
+    { "Costume_Head_Top", 0x000400 },
+    { "Costume_Head_Mid", 0x000800 },
+    { "Costume_Head_Low", 0x001000 },
+    { "Costume_Garment", 0x002000 },
+    { "Ammo", 0x008000 },
+    { "Shadow_Armor", 0x010000 },
+    { "Shadow_Weapon", 0x020000 },
+    { "Shadow_Shield", 0x040000 },
+    { "Shadow_Shoes", 0x080000 },
+    { "Shadow_Right_Accessory", 0x100000 },
+    { "Shadow_Left_Accessory", 0x200000 },
+    { "Both_Hand", 0x000022 },
+    { "Both_Accessory", 0x000088 }
+};
+
 static int i2d_item_parse_optional(long *, long *, char *, size_t);
-static int i2d_item_parse(i2d_item *, char *, size_t);
+static int i2d_item_parse_string(i2d_string *, char *, size_t, int);
+static int i2d_item_parse(i2d_item *, char *, size_t, int);
 static int i2d_item_db_parse(char *, size_t, void *);
+static int i2d_item_db_parse_stream(char *, size_t, void *);
+static int i2d_item_db_load(i2d_item_db *, int *);
+static int i2d_item_db_add(i2d_item_db *, i2d_item *);
+static int i2d_item_db_id_cmp(const void *, const void *);
+static int i2d_item_db_is_update(i2d_item_db *, int *);
 static int i2d_item_db_index(i2d_item_db *);
+static int i2d_item_db_store(i2d_item_db *);
+
+static int i2d_item_yml_init(i2d_item **);
+static int i2d_item_yml_search(i2d_item_yml *, long, i2d_item **);
+static int i2d_item_yml_insert(i2d_item_yml *, i2d_item *);
+static int i2d_item_parse_yml_flag(i2d_yaml_record *, i2d_yaml_constant *, size_t, unsigned long *, int *);
+static int i2d_item_parse_yml_script(i2d_item_yml *, i2d_yaml_record *, i2d_buffer *, i2d_string *);
+static int i2d_item_parse_yml(i2d_item_yml *, i2d_yaml_record *);
+static int i2d_item_db_parse_yml_end(i2d_item_yml *);
+static int i2d_item_db_parse_yml(i2d_yaml_record *, void *);
+static int i2d_item_db_load_yml(i2d_item_db *, i2d_item_stream *, int *);
 
 static int i2d_item_combo_parse_list(i2d_item_combo *, char *, size_t);
 static int i2d_item_combo_parse(i2d_item_combo *, char *, size_t);
@@ -18,11 +206,11 @@ int i2d_item_init(i2d_item ** result, char * string, size_t length) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_item_parse(object, string, length)) {
+            if(i2d_item_parse(object, string, length, 0)) {
                 status = i2d_panic("failed to load item -- %s", string);
             } else {
                 object->next = object;
@@ -43,19 +231,18 @@ void i2d_item_deit(i2d_item ** result) {
     i2d_item * object;
 
     object = *result;
-    i2d_free(object->aegis_name.string);
-    i2d_free(object->name.string);
-    i2d_free(object->script.string);
-    i2d_free(object->script_description.string);
-    i2d_free(object->onequip_script.string);
-    i2d_free(object->onequip_script_description.string);
-    i2d_free(object->onunequip_script.string);
-    i2d_free(object->onunequip_script_description.string);
-    i2d_free(object->combo_description.string);
+    i2d_item_reset_description(object);
     i2d_free(object);
     *result = NULL;
 }
 
+void i2d_item_reset_description(i2d_item * item) {
+    i2d_free(item->script_description.string);
+    i2d_free(item->onequip_script_description.string);
+    i2d_free(item->onunequip_script_description.string);
+    i2d_free(item->combo_description.string);
+}
+
 static int i2d_item_parse_optional(long * left, long * right, char * string, size_t length) {
     int status = I2D_OK;
     char * anchor;
@@ -64,12 +251,12 @@ static int i2d_item_parse_optional(long * left, long * right, char * string, siz
         *left = 0;
         *right = 0;
     } else {
-        anchor = strchr(string, ':');
+        anchor = memchr(string, ':', length);
         if(anchor) {
             *anchor = 0, anchor++;
 
-            status = i2d_strtol(left, string, strlen(string), 10) ||
-                     i2d_strtol(right, anchor, strlen(anchor), 10);
+            status = i2d_strtol(left, string, (size_t) (anchor - string) - 1, 10) ||
+                     i2d_strtol(right, anchor, length - (size_t) (anchor - string), 10);
         } else {
             status = i2d_strtol(left, string, length, 10);
         }
@@ -78,78 +265,63 @@ static int i2d_item_parse_optional(long * left, long * right, char * string, siz
     return status;
 }
 
-static int i2d_item_parse(i2d_item * item, char * string, size_t length) {
+/*
+ * the strings of an item that is streamed refer
+ * to the line instead of a copy in the arena
+ */
+static int i2d_item_parse_string(i2d_string * result, char * string, size_t length, int is_stream) {
     int status = I2D_OK;
 
-    size_t i;
-    int quote_depth = 0;
-    int brace_depth = 0;
+    if(is_stream) {
+        result->string = string;
+        result->length = length;
+    } else {
+        status = i2d_intern_get(string, length, result);
+    }
 
-    char * anchor;
-    size_t extent;
+    return status;
+}
 
-    int field = 0;
-    int last = 0;
-
-    anchor = string;
-    for(i = 0; i < length && !status && !last; i++) {
-        switch(string[i]) {
-            case '"': quote_depth = !quote_depth; break;
-            case '{': brace_depth++; break;
-            case '}': brace_depth--; break;
-            default:
-                /*
-                 * check for \t, \r, \n (exclude space)
-                 */
-                if(i2d_isspace(string[i]) && ' ' != string[i])
-                    last = 1;
+static int i2d_item_parse(i2d_item * item, char * string, size_t length, int is_stream) {
+    int status = I2D_OK;
 
-                /*
-                 * check for line comments
-                 */
-                if('/' == string[i] && i > 0 && '/' == string[i - 1]) {
-                    i -= 1;
-                    last = 1;
-                }
+    i2d_split split;
 
-                if((',' == string[i] || last) && !quote_depth && !brace_depth) {
-                    string[i] = 0;
+    char * anchor;
+    size_t extent;
 
-                    if(string + i < anchor) {
-                        status = i2d_panic("line overflow");
-                    } else {
-                        extent = (size_t) (string + i) - (size_t) anchor;
-                        switch(field) {
-                            case 0: status = i2d_strtol(&item->id, anchor, extent, 10); break;
-                            case 1: status = i2d_string_create(&item->aegis_name, anchor, extent); break;
-                            case 2: status = i2d_string_create(&item->name, anchor, extent); break;
-                            case 3: status = i2d_strtol(&item->type, anchor, extent, 10); break;
-                            case 4: status = i2d_strtol(&item->buy, anchor, extent, 10); break;
-                            case 5: status = i2d_strtol(&item->sell, anchor, extent, 10); break;
-                            case 6: status = i2d_strtol(&item->weight, anchor, extent, 10); break;
-                            case 7: status = i2d_item_parse_optional(&item->atk, &item->matk, anchor, extent); break;
-                            case 8: status = i2d_strtol(&item->def, anchor, extent, 10); break;
-                            case 9: status = i2d_strtol(&item->range, anchor, extent, 10); break;
-                            case 10: status = i2d_strtol(&item->slots, anchor, extent, 10); break;
-                            case 11: status = i2d_strtoul(&item->job, anchor, extent, 16); break;
-                            case 12: status = i2d_strtoul(&item->upper, anchor, extent, 10); break;
-                            case 13: status = i2d_strtol(&item->gender, anchor, extent, 10); break;
-                            case 14: status = i2d_strtoul(&item->location, anchor, extent, 10); break;
-                            case 15: status = i2d_strtol(&item->weapon_level, anchor, extent, 10); break;
-                            case 16: status = i2d_item_parse_optional(&item->base_level, &item->max_level, anchor, extent); break;
-                            case 17: status = i2d_strtol(&item->refineable, anchor, extent, 10); break;
-                            case 18: status = i2d_strtol(&item->view, anchor, extent, 10); break;
-                            case 19: status = i2d_string_create(&item->script, anchor, extent); break;
-                            case 20: status = i2d_string_create(&item->onequip_script, anchor, extent); break;
-                            case 21: status = i2d_string_create(&item->onunequip_script, anchor, extent); break;
-                            default: status = i2d_panic("row has too many columns"); break;
-                        }
-                        field++;
-                    }
+    int field = 0;
 
-                    anchor = (string + i + 1);
-                }
+    item->hash = i2d_fnv1a(I2D_FNV_OFFSET, string, length);
+
+    i2d_split_create(&split, string, length, I2D_SPLIT_QUOTE | I2D_SPLIT_BRACE);
+    while(!status && !i2d_split_next(&split, &anchor, &extent)) {
+        switch(field) {
+            case 0: status = i2d_strtol(&item->id, anchor, extent, 10); break;
+            case 1: status = i2d_item_parse_string(&item->aegis_name, anchor, extent, is_stream); break;
+            case 2: status = i2d_item_parse_string(&item->name, anchor, extent, is_stream); break;
+            case 3: status = i2d_strtol(&item->type, anchor, extent, 10); break;
+            case 4: status = i2d_strtol(&item->buy, anchor, extent, 10); break;
+            case 5: status = i2d_strtol(&item->sell, anchor, extent, 10); break;
+            case 6: status = i2d_strtol(&item->weight, anchor, extent, 10); break;
+            case 7: status = i2d_item_parse_optional(&item->atk, &item->matk, anchor, extent); break;
+            case 8: status = i2d_strtol(&item->def, anchor, extent, 10); break;
+            case 9: status = i2d_strtol(&item->range, anchor, extent, 10); break;
+            case 10: status = i2d_strtol(&item->slots, anchor, extent, 10); break;
+            case 11: status = i2d_strtoul(&item->job, anchor, extent, 16); break;
+            case 12: status = i2d_strtoul(&item->upper, anchor, extent, 10); break;
+            case 13: status = i2d_strtol(&item->gender, anchor, extent, 10); break;
+            case 14: status = i2d_strtoul(&item->location, anchor, extent, 10); break;
+            case 15: status = i2d_strtol(&item->weapon_level, anchor, extent, 10); break;
+            case 16: status = i2d_item_parse_optional(&item->base_level, &item->max_level, anchor, extent); break;
+            case 17: status = i2d_strtol(&item->refineable, anchor, extent, 10); break;
+            case 18: status = i2d_strtol(&item->view, anchor, extent, 10); break;
+            case 19: status = i2d_item_parse_string(&item->script, anchor, extent, is_stream); break;
+            case 20: status = i2d_item_parse_string(&item->onequip_script, anchor, extent, is_stream); break;
+            case 21: status = i2d_item_parse_string(&item->onunequip_script, anchor, extent, is_stream); break;
+            default: status = i2d_panic("row has too many columns"); break;
         }
+        field++;
     }
 
     if(!status && 22 != field)
@@ -172,23 +344,43 @@ void i2d_item_remove(i2d_item * x) {
     x->prev = x;
 }
 
-int i2d_item_db_init(i2d_item_db ** result, i2d_string * path) {
+int i2d_item_db_init(i2d_item_db ** result, i2d_string * path, int is_stream) {
     int status = I2D_OK;
     i2d_item_db * object;
+    int is_update = 0;
 
     if(i2d_is_invalid(result) || !path) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_fd_load(path, i2d_item_db_parse, object)) {
-                status = i2d_panic("failed to load item db");
-            } else if(i2d_item_db_index(object)) {
-                status = i2d_panic("failed to index item db");
+            object->is_stream = is_stream;
+
+            if(i2d_string_create(I2D_TAG_DB, &object->path, path->string, path->length)) {
+                status = i2d_panic("failed to create string object");
+            } else if(i2d_item_db_load(object, &is_update)) {
+                status = i2d_panic("failed to load item db -- %s", path->string);
+            } else if(is_update) {
+                /*
+                 * the fields of an item that is updated
+                 * by an import are in two records, so
+                 * the items are kept instead
+                 */
+                object->size = 0;
+                object->is_stream = 0;
+
+                if(i2d_item_db_load(object, &is_update))
+                    status = i2d_panic("failed to load item db -- %s", path->string);
             }
 
+            if(!status && i2d_item_db_index(object))
+                status = i2d_panic("failed to index item db");
+
+            if(!status && !object->is_stream && i2d_item_db_store(object))
+                status = i2d_panic("failed to store item db");
+
             if(status)
                 i2d_item_db_deit(&object);
             else
@@ -202,10 +394,17 @@ int i2d_item_db_init(i2d_item_db ** result, i2d_string * path) {
 void i2d_item_db_deit(i2d_item_db ** result) {
     i2d_item_db * object;
     i2d_item * item;
+    size_t i;
 
     object = *result;
+    for(i = 0; i < I2D_ITEM_FIELD_SIZE; i++)
+        i2d_free(object->store.columns[i]);
+    i2d_free(object->store.items);
     i2d_deit(object->index_by_name, i2d_rbt_deit);
+    i2d_table_destroy(&object->table_by_id);
     i2d_deit(object->index_by_id, i2d_rbt_deit);
+    i2d_free(object->entries);
+    i2d_string_destroy(&object->path);
     if(object->list) {
         while(object->list != object->list->next) {
             item = object->list->next;
@@ -222,8 +421,17 @@ static int i2d_item_db_parse(char * string, size_t length, void * data) {
     int status = I2D_OK;
     i2d_item_db * item_db = data;
     i2d_item * item = NULL;
+    i2d_item entry;
 
-    if(i2d_item_init(&item, string, length)) {
+    if(item_db->is_stream) {
+        i2d_zero(entry);
+
+        if(i2d_item_parse(&entry, string, length, 1)) {
+            status = i2d_panic("failed to load item -- %s", string);
+        } else if(i2d_item_db_add(item_db, &entry)) {
+            status = i2d_panic("failed to add item entry -- %ld", entry.id);
+        }
+    } else if(i2d_item_init(&item, string, length)) {
         status = i2d_panic("failed to create item object");
     } else {
         if(!item_db->list) {
@@ -231,39 +439,586 @@ static int i2d_item_db_parse(char * string, size_t length, void * data) {
         } else {
             i2d_item_append(item, item_db->list);
         }
+    }
+
+    return status;
+}
+
+static int i2d_item_db_parse_stream(char * string, size_t length, void * data) {
+    int status = I2D_OK;
+    i2d_item_stream * stream = data;
+    i2d_item * item = &stream->item;
+
+    i2d_item_reset_description(item);
+    i2d_zero(*item);
+    item->next = item;
+    item->prev = item;
+
+    if(i2d_item_parse(item, string, length, 1)) {
+        status = i2d_panic("failed to load item -- %s", string);
+    } else if(stream->cb(item, stream->data)) {
+        status = i2d_panic("failed to stream item -- %ld", item->id);
+    }
+
+    return status;
+}
+
+static int i2d_item_db_load(i2d_item_db * item_db, int * is_update) {
+    int status = I2D_OK;
+
+    *is_update = 0;
+
+    if(!i2d_string_suffix(&item_db->path, ".yml")) {
+        status = i2d_fd_load(&item_db->path, i2d_item_db_parse, item_db);
+    } else if(i2d_item_db_load_yml(item_db, NULL, is_update)) {
+        status = i2d_panic("failed to load yml item db");
+    } else if(item_db->is_stream && !*is_update && i2d_item_db_is_update(item_db, is_update)) {
+        status = i2d_panic("failed to check yml item db");
+    }
+
+    return status;
+}
+
+/*
+ * the names of a streamed item refer to the line,
+ * so the entry has a copy in the arena
+ */
+static int i2d_item_db_add(i2d_item_db * item_db, i2d_item * item) {
+    int status = I2D_OK;
+    i2d_item_entry * entries;
+    i2d_item_entry * entry;
+    size_t capacity;
+
+    if(item_db->size == item_db->capacity) {
+        capacity = item_db->capacity ? item_db->capacity * 2 : BUFFER_SIZE_LARGE;
+        entries = i2d_realloc(I2D_TAG_DB, item_db->entries, capacity * sizeof(*entries));
+        if(!entries) {
+            status = i2d_panic("out of memory");
+        } else {
+            item_db->entries = entries;
+            item_db->capacity = capacity;
+        }
+    }
+
+    if(!status) {
+        entry = &item_db->entries[item_db->size];
+        entry->id = item->id;
+        entry->item = item_db->is_stream ? NULL : item;
+
+        if( i2d_intern_get(item->aegis_name.string, item->aegis_name.length, &entry->aegis_name) ||
+            i2d_intern_get(item->name.string, item->name.length, &entry->name) ) {
+            status = i2d_panic("failed to intern item name -- %ld", item->id);
+        } else {
+            item_db->size++;
+        }
+    }
+
+    return status;
+}
+
+static int i2d_item_db_id_cmp(const void * left, const void * right) {
+    const long * x = left;
+    const long * y = right;
+
+    return *x < *y ? -1 : *x > *y ? 1 : 0;
+}
+
+/*
+ * an import can also update an item with all of
+ * the fields, so the ids are checked for repeats
+ */
+static int i2d_item_db_is_update(i2d_item_db * item_db, int * result) {
+    int status = I2D_OK;
+    long * ids;
+    size_t i;
+
+    *result = 0;
+
+    if(item_db->size) {
+        ids = i2d_malloc(I2D_TAG_DB, item_db->size * sizeof(*ids));
+        if(!ids) {
+            status = i2d_panic("out of memory");
+        } else {
+            for(i = 0; i < item_db->size; i++)
+                ids[i] = item_db->entries[i].id;
+
+            qsort(ids, item_db->size, sizeof(*ids), i2d_item_db_id_cmp);
+
+            for(i = 1; i < item_db->size && !*result; i++)
+                if(ids[i - 1] == ids[i])
+                    *result = 1;
+
+            i2d_free(ids);
+        }
+    }
+
+    return status;
+}
+
+/*
+ * the items are read from the file in the order
+ * of the list and the descriptions of an item
+ * must be released by the callback
+ */
+int i2d_item_db_stream(i2d_item_db * item_db, i2d_item_scan_cb cb, void * data) {
+    int status = I2D_OK;
+    i2d_item_stream * stream;
+    int is_update;
+
+    if(!item_db->is_stream) {
+        status = i2d_panic("item db is not streamed");
+    } else {
+        stream = i2d_calloc(I2D_TAG_DB, 1, sizeof(*stream));
+        if(!stream) {
+            status = i2d_panic("out of memory");
+        } else {
+            stream->cb = cb;
+            stream->data = data;
+
+            if(i2d_string_suffix(&item_db->path, ".yml")) {
+                if(i2d_item_db_load_yml(item_db, stream, &is_update))
+                    status = i2d_panic("failed to stream item db -- %s", item_db->path.string);
+            } else if(i2d_fd_load(&item_db->path, i2d_item_db_parse_stream, stream)) {
+                status = i2d_panic("failed to stream item db -- %s", item_db->path.string);
+            }
+
+            i2d_item_reset_description(&stream->item);
+            i2d_free(stream);
+        }
+    }
+
+    return status;
+}
+
+static int i2d_item_yml_init(i2d_item ** result) {
+    int status = I2D_OK;
+    i2d_item * object;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            object->type = 3;
+            object->job = 0xFFFFFFFF;
+            object->upper = 0x3F;
+            object->gender = 2;
+            object->hash = I2D_FNV_OFFSET;
+            object->next = object;
+            object->prev = object;
+
+            if(status)
+                i2d_item_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+/*
+ * the items that were loaded by id, which are
+ * updated by the items of an imported file
+ */
+static int i2d_item_yml_search(i2d_item_yml * load, long id, i2d_item ** item) {
+    return i2d_table_range(id) ?
+        i2d_table_search(&load->table, id, (void **) item) :
+        i2d_rbt_search(load->index, &id, (void **) item);
+}
+
+static int i2d_item_yml_insert(i2d_item_yml * load, i2d_item * item) {
+    return i2d_table_range(item->id) ?
+        i2d_table_insert(&load->table, item->id, item) :
+        i2d_rbt_insert(load->index, &item->id, item);
+}
+
+/*
+ * the first flag of a record replaces the mask
+ * and the rest are set or cleared on the mask,
+ * i.e. Jobs: { All: true, Novice: false }
+ */
+static int i2d_item_parse_yml_flag(i2d_yaml_record * record, i2d_yaml_constant * list, size_t size, unsigned long * mask, int * set) {
+    int status = I2D_OK;
+    const char * name;
+    long flag;
+    int boolean;
+
+    name = strchr(record->key, '.');
+    if(!name) {
+        status = i2d_panic("invalid flag -- %s", record->key);
+    } else if(i2d_yaml_get_constant(list, size, name + 1, &flag)) {
+        status = i2d_panic("failed to get flag -- %s", record->key);
+    } else if(i2d_yaml_get_boolean(record, &boolean)) {
+        status = i2d_panic("failed to get boolean -- %s", record->key);
+    } else {
+        if(!*set) {
+            *mask = 0;
+            *set = 1;
+        }
+
+        if(boolean) {
+            *mask |= (unsigned long) flag;
+        } else {
+            *mask &= ~(unsigned long) flag;
+        }
+    }
+
+    return status;
+}
+
+/*
+ * scripts in the txt databases are wrapped in
+ * braces and the compiler expects the braces;
+ * the script of a streamed item is kept in the
+ * buffer until the next item is read
+ */
+static int i2d_item_parse_yml_script(i2d_item_yml * load, i2d_yaml_record * record, i2d_buffer * buffer, i2d_string * result) {
+    int status = I2D_OK;
+
+    i2d_buffer_clear(buffer);
+
+    if( i2d_buffer_memcpy(buffer, "{ ", 2) ||
+        i2d_buffer_memcpy(buffer, record->value, record->length) ||
+        i2d_buffer_memcpy(buffer, " }", 2) ) {
+        status = i2d_panic("failed to write buffer object");
+    } else if(load->item_db->is_stream) {
+        i2d_buffer_get(buffer, &result->string, &result->length);
+    } else if(i2d_intern_get(buffer->buffer, buffer->offset, result)) {
+        status = i2d_panic("failed to intern script");
+    }
+
+    return status;
+}
+
+static int i2d_item_parse_yml(i2d_item_yml * load, i2d_yaml_record * record) {
+    int status = I2D_OK;
+    i2d_item * item = load->item;
+    i2d_item * exist = NULL;
+    const char * key = record->key;
+    int boolean;
+
+    if(!strcmp(key, "Id")) {
+        /*
+         * an imported file can update an item by
+         * id so the id must precede other fields
+         */
+        if(load->fields) {
+            status = i2d_panic("item id must be the first field");
+        } else if(i2d_yaml_get_number(record, &item->id)) {
+            status = i2d_panic("failed to get item id");
+        } else if(load->item_db->is_stream) {
+            /* an update is found once the ids are read */
+        } else if(!i2d_item_yml_search(load, item->id, &exist)) {
+            i2d_item_deit(&load->item);
+            load->item = exist;
+            load->exist = 1;
+        }
+    } else if(!load->fields) {
+        status = i2d_panic("item is missing id");
+    } else if(!strcmp(key, "AegisName")) {
+        status = i2d_intern_get(record->value, record->length, &item->aegis_name);
+    } else if(!strcmp(key, "Name")) {
+        status = i2d_intern_get(record->value, record->length, &item->name);
+    } else if(!strcmp(key, "Type")) {
+        status = i2d_yaml_get_constant(i2d_item_type_list, i2d_size(i2d_item_type_list), record->value, &item->type);
+    } else if(!strcmp(key, "SubType")) {
+        if(5 == item->type) {
+            status = i2d_yaml_get_constant(i2d_item_weapon_list, i2d_size(i2d_item_weapon_list), record->value, &item->view);
+        } else if(10 == item->type) {
+            status = i2d_yaml_get_constant(i2d_item_ammo_list, i2d_size(i2d_item_ammo_list), record->value, &item->view);
+        }
+    } else if(!strcmp(key, "Buy")) {
+        status = i2d_yaml_get_number(record, &item->buy);
+        load->buy = 1;
+    } else if(!strcmp(key, "Sell")) {
+        status = i2d_yaml_get_number(record, &item->sell);
+        load->sell = 1;
+    } else if(!strcmp(key, "Weight")) {
+        status = i2d_yaml_get_number(record, &item->weight);
+    } else if(!strcmp(key, "Attack")) {
+        status = i2d_yaml_get_number(record, &item->atk);
+    } else if(!strcmp(key, "MagicAttack")) {
+        status = i2d_yaml_get_number(record, &item->matk);
+    } else if(!strcmp(key, "Defense")) {
+        status = i2d_yaml_get_number(record, &item->def);
+    } else if(!strcmp(key, "Range")) {
+        status = i2d_yaml_get_number(record, &item->range);
+    } else if(!strcmp(key, "Slots")) {
+        status = i2d_yaml_get_number(record, &item->slots);
+    } else if(!strncmp(key, "Jobs.", 5)) {
+        status = i2d_item_parse_yml_flag(record, i2d_item_job_list, i2d_size(i2d_item_job_list), &item->job, &load->job);
+    } else if(!strncmp(key, "Classes.", 8)) {
+        status = i2d_item_parse_yml_flag(record, i2d_item_class_list, i2d_size(i2d_item_class_list), &item->upper, &load->upper);
+    } else if(!strcmp(key, "Gender")) {
+        status = i2d_yaml_get_constant(i2d_item_gender_list, i2d_size(i2d_item_gender_list), record->value, &item->gender);
+    } else if(!strncmp(key, "Locations.", 10)) {
+        status = i2d_item_parse_yml_flag(record, i2d_item_location_list, i2d_size(i2d_item_location_list), &item->location, &load->location);
+    } else if(!strcmp(key, "WeaponLevel")) {
+        status = i2d_yaml_get_number(record, &item->weapon_level);
+    } else if(!strcmp(key, "EquipLevelMin")) {
+        status = i2d_yaml_get_number(record, &item->base_level);
+    } else if(!strcmp(key, "EquipLevelMax")) {
+        status = i2d_yaml_get_number(record, &item->max_level);
+    } else if(!strcmp(key, "Refineable")) {
+        if(i2d_yaml_get_boolean(record, &boolean)) {
+            status = i2d_panic("failed to get boolean");
+        } else {
+            item->refineable = boolean;
+        }
+    } else if(!strcmp(key, "View")) {
+        status = i2d_yaml_get_number(record, &item->view);
+    } else if(!strcmp(key, "Script")) {
+        status = i2d_item_parse_yml_script(load, record, &load->script_buffer, &item->script);
+    } else if(!strcmp(key, "EquipScript")) {
+        status = i2d_item_parse_yml_script(load, record, &load->onequip_buffer, &item->onequip_script);
+    } else if(!strcmp(key, "UnEquipScript")) {
+        status = i2d_item_parse_yml_script(load, record, &load->onunequip_buffer, &item->onunequip_script);
+    }
+
+    if(!status)
+        load->fields++;
+
+    return status;
+}
+
+static int i2d_item_db_parse_yml_end(i2d_item_yml * load) {
+    int status = I2D_OK;
+    i2d_item_db * item_db = load->item_db;
+    i2d_item * item = load->item;
+
+    if(item_db->is_stream && !load->stream && (!item->aegis_name.string || !item->name.string)) {
+        /* an import that updates an item can omit the names */
+        load->is_update = 1;
+        i2d_item_deit(&load->item);
+    } else if(!item->aegis_name.string || !item->name.string) {
+        status = i2d_panic("item is missing aegis name or name -- %ld", item->id);
+    } else {
+        if(load->buy && !load->sell) {
+            item->sell = item->buy / 2;
+        } else if(!load->buy && load->sell) {
+            item->buy = item->sell * 2;
+        }
+
+        if(!item->script.string)
+            item->script = load->script;
+        if(!item->onequip_script.string)
+            item->onequip_script = load->script;
+        if(!item->onunequip_script.string)
+            item->onunequip_script = load->script;
+
+        if(load->stream) {
+            if(load->stream->cb(item, load->stream->data))
+                status = i2d_panic("failed to stream item -- %ld", item->id);
+            i2d_item_deit(&load->item);
+        } else if(item_db->is_stream) {
+            if(i2d_item_db_add(item_db, item))
+                status = i2d_panic("failed to add item entry -- %ld", item->id);
+            i2d_item_deit(&load->item);
+        } else if(!load->exist) {
+            if(!item_db->list) {
+                item_db->list = item;
+            } else {
+                i2d_item_append(item, item_db->list);
+            }
+
+            if(i2d_item_yml_insert(load, item))
+                status = i2d_panic("failed to index item by id -- %ld", item->id);
+        }
+
+        load->item = NULL;
+    }
+
+    return status;
+}
+
+static int i2d_item_db_parse_yml(i2d_yaml_record * record, void * data) {
+    int status = I2D_OK;
+    i2d_item_yml * load = data;
+
+    switch(record->type) {
+        case i2d_yaml_record_start:
+            load->exist = 0;
+            load->fields = 0;
+            load->buy = 0;
+            load->sell = 0;
+            load->job = 0;
+            load->upper = 0;
+            load->location = 0;
+
+            if(i2d_item_yml_init(&load->item))
+                status = i2d_panic("failed to create item object");
+            break;
+        case i2d_yaml_record_field:
+            if(i2d_item_parse_yml(load, record)) {
+                status = i2d_panic("failed to load item -- %ld", load->item->id);
+            } else {
+                load->item->hash = i2d_yaml_hash(record, load->item->hash);
+            }
+            break;
+        case i2d_yaml_record_end:
+            status = i2d_item_db_parse_yml_end(load);
+            break;
+    }
+
+    return status;
+}
+
+static int i2d_item_db_load_yml(i2d_item_db * item_db, i2d_item_stream * stream, int * is_update) {
+    int status = I2D_OK;
+    i2d_item_yml load;
+
+    i2d_zero(load);
+    load.item_db = item_db;
+    load.stream = stream;
+
+    if( i2d_buffer_create(I2D_TAG_DB, &load.script_buffer, BUFFER_SIZE_SMALL) ||
+        i2d_buffer_create(I2D_TAG_DB, &load.onequip_buffer, BUFFER_SIZE_SMALL) ||
+        i2d_buffer_create(I2D_TAG_DB, &load.onunequip_buffer, BUFFER_SIZE_SMALL) ) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        if(i2d_rbt_init(&load.index, i2d_rbt_cmp_long)) {
+            status = i2d_panic("failed to create red black tree object");
+        } else {
+            if(i2d_intern_get("{}", 2, &load.script)) {
+                status = i2d_panic("failed to intern script");
+            } else if(i2d_yaml_map(&item_db->path, i2d_item_db_parse_yml, &load)) {
+                status = i2d_panic("failed to map item db -- %s", item_db->path.string);
+            }
+
+            if(load.item && !load.exist)
+                i2d_item_deit(&load.item);
 
-        item_db->size++;
+            *is_update = load.is_update;
+
+            i2d_rbt_deit(&load.index);
+        }
+        i2d_table_destroy(&load.table);
     }
+    i2d_buffer_destroy(&load.onunequip_buffer);
+    i2d_buffer_destroy(&load.onequip_buffer);
+    i2d_buffer_destroy(&load.script_buffer);
 
     return status;
 }
 
+/*
+ * the entries of a streamed item db are added
+ * as the file is read and are not moved after
+ */
 static int i2d_item_db_index(i2d_item_db * item_db) {
     int status = I2D_OK;
     i2d_item * item = NULL;
+    i2d_item_entry * entry;
+    size_t i;
 
-    if( i2d_rbt_init(&item_db->index_by_id, i2d_rbt_cmp_long) ||
-        i2d_rbt_init(&item_db->index_by_name, i2d_rbt_cmp_str) ) {
-        status = i2d_panic("failed to create red black tree object");
-    } else {
+    if(!item_db->is_stream && item_db->list) {
         item = item_db->list;
         do {
-            if( i2d_rbt_insert(item_db->index_by_id, &item->id, item) ||
-                i2d_rbt_insert(item_db->index_by_name, item->name.string, item) )
-                status = i2d_panic("failed to index item by id -- %ld", item->id);
+            if(i2d_item_db_add(item_db, item))
+                status = i2d_panic("failed to add item entry -- %ld", item->id);
             item = item->next;
         } while(item != item_db->list && !status);
     }
 
+    if(status) {
+        /* skip index */
+    } else if( i2d_rbt_init_static(&item_db->index_by_id, i2d_rbt_cmp_long) ||
+               i2d_rbt_init_static(&item_db->index_by_name, i2d_rbt_cmp_str) ) {
+        status = i2d_panic("failed to create red black tree object");
+    } else {
+        for(i = 0; i < item_db->size && !status; i++) {
+            entry = &item_db->entries[i];
+            /* the ids in the range of the table are only in the table */
+            if( (i2d_table_range(entry->id) ?
+                    i2d_table_insert(&item_db->table_by_id, entry->id, entry) :
+                    i2d_rbt_insert(item_db->index_by_id, &entry->id, entry)) ||
+                i2d_rbt_insert(item_db->index_by_name, entry->name.string, entry) )
+                status = i2d_panic("failed to index item by id -- %ld", entry->id);
+        }
+
+        if(status) {
+            /* skip build */
+        } else if(i2d_rbt_build(item_db->index_by_id) || i2d_rbt_build(item_db->index_by_name)) {
+            status = i2d_panic("failed to build red black tree object");
+        }
+    }
+
     return status;
 }
 
+static int i2d_item_db_store(i2d_item_db * item_db) {
+    int status = I2D_OK;
+    i2d_item_store * store = &item_db->store;
+    i2d_item * item;
+    size_t i;
+
+    for(i = 0; i < I2D_ITEM_FIELD_SIZE && !status; i++) {
+        store->columns[i] = i2d_calloc(I2D_TAG_DB, item_db->size, sizeof(*store->columns[i]));
+        if(!store->columns[i])
+            status = i2d_panic("out of memory");
+    }
+
+    if(!status) {
+        store->items = i2d_calloc(I2D_TAG_DB, item_db->size, sizeof(*store->items));
+        if(!store->items) {
+            status = i2d_panic("out of memory");
+        } else {
+            item = item_db->list;
+            do {
+                store->columns[I2D_ITEM_FIELD_ID][store->size] = item->id;
+                store->columns[I2D_ITEM_FIELD_TYPE][store->size] = item->type;
+                store->columns[I2D_ITEM_FIELD_BUY][store->size] = item->buy;
+                store->columns[I2D_ITEM_FIELD_SELL][store->size] = item->sell;
+                store->columns[I2D_ITEM_FIELD_WEIGHT][store->size] = item->weight;
+                store->columns[I2D_ITEM_FIELD_ATK][store->size] = item->atk;
+                store->columns[I2D_ITEM_FIELD_MATK][store->size] = item->matk;
+                store->columns[I2D_ITEM_FIELD_DEF][store->size] = item->def;
+                store->columns[I2D_ITEM_FIELD_RANGE][store->size] = item->range;
+                store->columns[I2D_ITEM_FIELD_SLOTS][store->size] = item->slots;
+                store->columns[I2D_ITEM_FIELD_JOB][store->size] = (long) item->job;
+                store->columns[I2D_ITEM_FIELD_UPPER][store->size] = (long) item->upper;
+                store->columns[I2D_ITEM_FIELD_GENDER][store->size] = item->gender;
+                store->columns[I2D_ITEM_FIELD_LOCATION][store->size] = (long) item->location;
+                store->columns[I2D_ITEM_FIELD_WEAPON_LEVEL][store->size] = item->weapon_level;
+                store->columns[I2D_ITEM_FIELD_BASE_LEVEL][store->size] = item->base_level;
+                store->columns[I2D_ITEM_FIELD_MAX_LEVEL][store->size] = item->max_level;
+                store->columns[I2D_ITEM_FIELD_REFINEABLE][store->size] = item->refineable;
+                store->columns[I2D_ITEM_FIELD_VIEW][store->size] = item->view;
+                store->items[store->size] = item;
+                store->size++;
+                item = item->next;
+            } while(item != item_db->list && store->size < item_db->size);
+        }
+    }
+
+    return status;
+}
+
+/* the item of a streamed item db is not kept */
 int i2d_item_db_search_by_id(i2d_item_db * item_db, long id, i2d_item ** item) {
-    return i2d_rbt_search(item_db->index_by_id, &id, (void **) item);
+    int status = I2D_OK;
+    i2d_item_entry * entry;
+
+    if(i2d_item_db_search_entry_by_id(item_db, id, &entry) || !entry->item) {
+        status = I2D_FAIL;
+    } else {
+        *item = entry->item;
+    }
+
+    return status;
+}
+
+int i2d_item_db_search_entry_by_id(i2d_item_db * item_db, long id, i2d_item_entry ** entry) {
+    return i2d_table_range(id) ?
+        i2d_table_search(&item_db->table_by_id, id, (void **) entry) :
+        i2d_rbt_search(item_db->index_by_id, &id, (void **) entry);
 }
 
-int i2d_item_db_search_by_name(i2d_item_db * item_db, const char * name, i2d_item ** item) {
-    return i2d_rbt_search(item_db->index_by_name, name, (void **) item);
+int i2d_item_db_search_entry_by_name(i2d_item_db * item_db, const char * name, i2d_item_entry ** entry) {
+    return i2d_rbt_search(item_db->index_by_name, name, (void **) entry);
 }
 
 int i2d_item_combo_list_init(i2d_item_combo_list ** result, long item_id) {
@@ -273,7 +1028,7 @@ int i2d_item_combo_list_init(i2d_item_combo_list ** result, long item_id) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -306,7 +1061,7 @@ int i2d_item_combo_list_add(i2d_item_combo_list * item_combo_list, i2d_item_comb
     size_t size;
 
     size = item_combo_list->size + 1;
-    list = realloc(item_combo_list->list, size * sizeof(*item_combo_list->list));
+    list = i2d_realloc(I2D_TAG_DB, item_combo_list->list, size * sizeof(*item_combo_list->list));
     if(!list) {
         status = i2d_panic("out of memory");
     } else {
@@ -339,7 +1094,7 @@ int i2d_item_combo_init(i2d_item_combo ** result, char * string, size_t length)
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -386,7 +1141,7 @@ static int i2d_item_combo_parse_list(i2d_item_combo * item_combo, char * string,
             colon_count++;
 
     item_combo->size = colon_count + 1;
-    item_combo->list = calloc(item_combo->size, sizeof(*item_combo->list));
+    item_combo->list = i2d_calloc(I2D_TAG_DB, item_combo->size, sizeof(*item_combo->list));
     if(!item_combo->list) {
         status = i2d_panic("out of memory");
     } else {
@@ -429,53 +1184,23 @@ static int i2d_item_combo_parse_list(i2d_item_combo * item_combo, char * string,
 static int i2d_item_combo_parse(i2d_item_combo * item_combo, char * string, size_t length) {
     int status = I2D_OK;
 
-    size_t i;
-    int brace_depth = 0;
+    i2d_split split;
 
     char * anchor;
     size_t extent;
 
     int field = 0;
-    int last = 0;
-
-    anchor = string;
-    for(i = 0; i < length && !status && !last; i++) {
-        switch(string[i]) {
-            case '{': brace_depth++; break;
-            case '}': brace_depth--; break;
-            default:
-                /*
-                 * check for \t, \r, \n (exclude space)
-                 */
-                if(i2d_isspace(string[i]) && ' ' != string[i])
-                    last = 1;
-
-                /*
-                 * check for line comments
-                 */
-                if('/' == string[i] && i > 0 && '/' == string[i - 1]) {
-                    i -= 1;
-                    last = 1;
-                }
-
-                if((',' == string[i] || last) && !brace_depth) {
-                    string[i] = 0;
 
-                    if(string + i < anchor) {
-                        status = i2d_panic("line overflow");
-                    } else {
-                        extent = (size_t) (string + i) - (size_t) anchor;
-                        switch(field) {
-                            case 0: status = i2d_item_combo_parse_list(item_combo, anchor, extent); break;
-                            case 1: status = i2d_string_create(&item_combo->script, anchor, extent); break;
-                            default: status = i2d_panic("row has too many columns"); break;
-                        }
-                        field++;
-                    }
+    item_combo->hash = i2d_fnv1a(I2D_FNV_OFFSET, string, length);
 
-                    anchor = (string + i + 1);
-                }
+    i2d_split_create(&split, string, length, I2D_SPLIT_BRACE);
+    while(!status && !i2d_split_next(&split, &anchor, &extent)) {
+        switch(field) {
+            case 0: status = i2d_item_combo_parse_list(item_combo, anchor, extent); break;
+            case 1: status = i2d_string_create(I2D_TAG_DB, &item_combo->script, anchor, extent); break;
+            default: status = i2d_panic("row has too many columns"); break;
         }
+        field++;
     }
 
     if(!status && 2 != field)
@@ -505,19 +1230,19 @@ int i2d_item_combo_get_string(i2d_item_combo * item_combo, i2d_item_db * item_db
     i2d_buffer * buffer = NULL;
 
     size_t i;
-    i2d_item * item;
+    i2d_item_entry * entry;
     i2d_string list;
 
-    if(i2d_string_stack_init(&stack, item_combo->size)) {
+    if(i2d_string_stack_init(I2D_TAG_DB, &stack, item_combo->size)) {
         status = i2d_panic("failed to create string stack object");
     } else {
-        if(i2d_buffer_init(&buffer, BUFFER_SIZE_LARGE)) {
+        if(i2d_buffer_init(I2D_TAG_DB, &buffer, BUFFER_SIZE_LARGE)) {
             status = i2d_panic("failed to create buffer object");
         } else {
             for(i = 0; i < item_combo->size && !status; i++) {
-                if(i2d_item_db_search_by_id(item_db, item_combo->list[i], &item)) {
+                if(i2d_item_db_search_entry_by_id(item_db, item_combo->list[i], &entry)) {
                     status = i2d_panic("failed to get item by id -- %ld", item_combo->list[i]);
-                } else if(i2d_string_stack_push(stack, item->name.string, item->name.length)) {
+                } else if(i2d_string_stack_push(stack, entry->name.string, entry->name.length)) {
                     status = i2d_panic("failed to push string stack object");
                 }
             }
@@ -527,7 +1252,7 @@ int i2d_item_combo_get_string(i2d_item_combo * item_combo, i2d_item_db * item_db
                     status = i2d_panic("failed to get item list");
                 } else {
                     i2d_buffer_get(buffer, &list.string, &list.length);
-                    if(i2d_string_create(result, list.string, list.length))
+                    if(i2d_string_create(I2D_TAG_DB, result, list.string, list.length))
                         status = i2d_panic("failed to create string object");
                 }
             }
@@ -546,7 +1271,7 @@ int i2d_item_combo_db_init(i2d_item_combo_db ** result, i2d_string * path) {
     if(i2d_is_invalid(result) || !path) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -572,6 +1297,7 @@ void i2d_item_combo_db_deit(i2d_item_combo_db ** result) {
     i2d_item_combo_list * item_combo_list;
 
     object = *result;
+    i2d_table_destroy(&object->table_by_id);
     i2d_deit(object->index_by_id, i2d_rbt_deit);
     if(object->list) {
         while(object->list != object->list->next) {
@@ -633,6 +1359,8 @@ static int i2d_item_combo_db_index(i2d_item_combo_db * item_combo_db) {
                         status = i2d_panic("failed to add item combo");
                     } else if(i2d_rbt_insert(item_combo_db->index_by_id, &item_combo_list->item_id, item_combo_list)) {
                         status = i2d_panic("failed to index item combo list by id -- %d", item_combo_list->item_id);
+                    } else if(i2d_table_range(item_combo_list->item_id) && i2d_table_insert(&item_combo_db->table_by_id, item_combo_list->item_id, item_combo_list)) {
+                        status = i2d_panic("failed to index item combo list by id -- %d", item_combo_list->item_id);
                     }
                 } else if(i2d_item_combo_list_add(item_combo_list, item_combo)) {
                     status = i2d_panic("failed to add item combo");
@@ -665,5 +1393,56 @@ static int i2d_item_combo_db_create_combo_list(i2d_item_combo_db * item_combo_db
 }
 
 int i2d_item_combo_db_search_by_id(i2d_item_combo_db * item_combo_db, long id, i2d_item_combo_list ** item_combo_list) {
-    return i2d_rbt_search(item_combo_db->index_by_id, &id, (void **) item_combo_list);
+    return i2d_table_range(id) ?
+        i2d_table_search(&item_combo_db->table_by_id, id, (void **) item_combo_list) :
+        i2d_rbt_search(item_combo_db->index_by_id, &id, (void **) item_combo_list);
+}
+
+/*
+ * the items are matched a block at a time; each
+ * predicate is a loop over a column that clears
+ * the rows that do not match, then the rows that
+ * are left are passed to the callback in order
+ */
+int i2d_item_db_scan(i2d_item_db * item_db, i2d_item_predicate * predicates, size_t size, i2d_item_scan_cb cb, void * data) {
+    int status = I2D_OK;
+    i2d_item_store * store = &item_db->store;
+    unsigned char mask[I2D_ITEM_SCAN_BLOCK];
+    const long * column;
+    long value;
+    size_t count;
+    size_t i;
+    size_t j;
+    size_t k;
+
+    for(j = 0; j < size && !status; j++)
+        if((size_t) predicates[j].field >= I2D_ITEM_FIELD_SIZE)
+            status = i2d_panic("invalid item field -- %d", predicates[j].field);
+
+    for(i = 0; i < store->size && !status; i += I2D_ITEM_SCAN_BLOCK) {
+        count = min(store->size - i, I2D_ITEM_SCAN_BLOCK);
+        memset(mask, 1, count);
+
+        for(j = 0; j < size && !status; j++) {
+            column = store->columns[predicates[j].field] + i;
+            value = predicates[j].value;
+            switch(predicates[j].op) {
+                case I2D_ITEM_OP_EQ: for(k = 0; k < count; k++) mask[k] &= column[k] == value; break;
+                case I2D_ITEM_OP_NE: for(k = 0; k < count; k++) mask[k] &= column[k] != value; break;
+                case I2D_ITEM_OP_LT: for(k = 0; k < count; k++) mask[k] &= column[k] < value; break;
+                case I2D_ITEM_OP_LE: for(k = 0; k < count; k++) mask[k] &= column[k] <= value; break;
+                case I2D_ITEM_OP_GT: for(k = 0; k < count; k++) mask[k] &= column[k] > value; break;
+                case I2D_ITEM_OP_GE: for(k = 0; k < count; k++) mask[k] &= column[k] >= value; break;
+                case I2D_ITEM_OP_AND: for(k = 0; k < count; k++) mask[k] &= (column[k] & value) != 0; break;
+                default:
+                    status = i2d_panic("invalid item operator -- %d", predicates[j].op);
+            }
+        }
+
+        for(k = 0; k < count && !status; k++)
+            if(mask[k] && cb(store->items[i + k], data))
+                status = I2D_FAIL;
+    }
+
+    return status;
 }
@@ -3,7 +3,14 @@
 
 #include "i2d_util.h"
 #include "i2d_rbt.h"
-
+#include "i2d_intern.h"
+#include "i2d_yaml.h"
+
+/*
+ * hash is the fnv-1a hash of the record (i.e. the
+ * line or the fields), so an incremental run can
+ * tell which records changed since the last run
+ */
 struct i2d_item {
     long id;
     i2d_string aegis_name;
@@ -33,6 +40,7 @@ struct i2d_item {
     i2d_string onunequip_script;
     i2d_string onunequip_script_description;
     i2d_string combo_description;
+    uint64_t hash;
     struct i2d_item * next;
     struct i2d_item * prev;
 };
@@ -41,27 +49,123 @@ typedef struct i2d_item i2d_item;
 
 int i2d_item_init(i2d_item **, char *, size_t);
 void i2d_item_deit(i2d_item **);
+void i2d_item_reset_description(i2d_item *);
 void i2d_item_append(i2d_item *, i2d_item *);
 void i2d_item_remove(i2d_item *);
 
+/*
+ * the numeric fields of the items are copied
+ * into columns in the order of the item list,
+ * so a scan over a field reads contiguous
+ * memory instead of following the list
+ */
+enum i2d_item_field {
+    I2D_ITEM_FIELD_ID,
+    I2D_ITEM_FIELD_TYPE,
+    I2D_ITEM_FIELD_BUY,
+    I2D_ITEM_FIELD_SELL,
+    I2D_ITEM_FIELD_WEIGHT,
+    I2D_ITEM_FIELD_ATK,
+    I2D_ITEM_FIELD_MATK,
+    I2D_ITEM_FIELD_DEF,
+    I2D_ITEM_FIELD_RANGE,
+    I2D_ITEM_FIELD_SLOTS,
+    I2D_ITEM_FIELD_JOB,
+    I2D_ITEM_FIELD_UPPER,
+    I2D_ITEM_FIELD_GENDER,
+    I2D_ITEM_FIELD_LOCATION,
+    I2D_ITEM_FIELD_WEAPON_LEVEL,
+    I2D_ITEM_FIELD_BASE_LEVEL,
+    I2D_ITEM_FIELD_MAX_LEVEL,
+    I2D_ITEM_FIELD_REFINEABLE,
+    I2D_ITEM_FIELD_VIEW,
+    I2D_ITEM_FIELD_SIZE
+};
+
+struct i2d_item_store {
+    long * columns[I2D_ITEM_FIELD_SIZE];
+    i2d_item ** items;
+    size_t size;
+};
+
+typedef struct i2d_item_store i2d_item_store;
+
+/*
+ * number of items that are matched at a time
+ */
+#define I2D_ITEM_SCAN_BLOCK 256
+
+/*
+ * and is true when any bit of the value is set
+ */
+enum i2d_item_op {
+    I2D_ITEM_OP_EQ,
+    I2D_ITEM_OP_NE,
+    I2D_ITEM_OP_LT,
+    I2D_ITEM_OP_LE,
+    I2D_ITEM_OP_GT,
+    I2D_ITEM_OP_GE,
+    I2D_ITEM_OP_AND
+};
+
+struct i2d_item_predicate {
+    enum i2d_item_field field;
+    enum i2d_item_op op;
+    long value;
+};
+
+typedef struct i2d_item_predicate i2d_item_predicate;
+
+typedef int (* i2d_item_scan_cb) (i2d_item *, void *);
+
+/*
+ * the id and names are all that the databases
+ * and the scripts read of the other items, so
+ * an entry is kept for every item; item is null
+ * when the item db is streamed
+ */
+struct i2d_item_entry {
+    long id;
+    i2d_string aegis_name;
+    i2d_string name;
+    i2d_item * item;
+};
+
+typedef struct i2d_item_entry i2d_item_entry;
+
+/*
+ * a streamed item db keeps the entries and reads
+ * the items again from the file when the items
+ * are streamed, one item at a time
+ */
 struct i2d_item_db {
     i2d_item * list;
+    i2d_item_entry * entries;
     size_t size;
+    size_t capacity;
     i2d_rbt * index_by_id;
+    i2d_table table_by_id;
     i2d_rbt * index_by_name;
+    i2d_item_store store;
+    i2d_string path;
+    int is_stream;
 };
 
 typedef struct i2d_item_db i2d_item_db;
 
-int i2d_item_db_init(i2d_item_db **, i2d_string *);
+int i2d_item_db_init(i2d_item_db **, i2d_string *, int);
 void i2d_item_db_deit(i2d_item_db **);
 int i2d_item_db_search_by_id(i2d_item_db *, long, i2d_item **);
-int i2d_item_db_search_by_name(i2d_item_db *, const char *, i2d_item **);
+int i2d_item_db_search_entry_by_id(i2d_item_db *, long, i2d_item_entry **);
+int i2d_item_db_search_entry_by_name(i2d_item_db *, const char *, i2d_item_entry **);
+int i2d_item_db_scan(i2d_item_db *, i2d_item_predicate *, size_t, i2d_item_scan_cb, void *);
+int i2d_item_db_stream(i2d_item_db *, i2d_item_scan_cb, void *);
 
 struct i2d_item_combo {
     long * list;
     size_t size;
     i2d_string script;
+    uint64_t hash;
     struct i2d_item_combo * next;
     struct i2d_item_combo * prev;
 };
@@ -96,6 +200,7 @@ struct i2d_item_combo_db {
     i2d_item_combo_list * combo_list;
     size_t combo_size;
     i2d_rbt * index_by_id;
+    i2d_table table_by_id;
 };
 
 typedef struct i2d_item_combo_db i2d_item_combo_db;
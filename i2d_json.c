@@ -1,5 +1,42 @@
 #include "i2d_json.h"
 
+struct i2d_json_file {
+    json_t ** json;
+    i2d_string * path;
+};
+
+typedef struct i2d_json_file i2d_json_file;
+
+struct i2d_json_reader {
+    char * string;
+    size_t length;
+    size_t offset;
+    size_t line;
+    i2d_json_event_cb cb;
+    void * data;
+};
+
+typedef struct i2d_json_reader i2d_json_reader;
+
+#define MAX_JSON_DEPTH 64
+
+static void * i2d_json_malloc(size_t);
+static void i2d_json_free(void *);
+static int i2d_json_load_file(void *);
+static int i2d_json_load(i2d_json *);
+static int i2d_json_reader_emit(i2d_json_reader *, enum i2d_json_type, size_t, char *, size_t);
+static void i2d_json_reader_space(i2d_json_reader *);
+static int i2d_json_reader_value(i2d_json_reader *, size_t);
+static int i2d_json_reader_object(i2d_json_reader *, size_t);
+static int i2d_json_reader_array(i2d_json_reader *, size_t);
+static int i2d_json_reader_string(i2d_json_reader *, char **, size_t *);
+static int i2d_json_reader_escape(i2d_json_reader *, unsigned long *);
+static int i2d_json_reader_number(i2d_json_reader *, size_t);
+static int i2d_json_reader_literal(i2d_json_reader *, size_t, const char *, enum i2d_json_type);
+static uint64_t i2d_json_index_mix(uint64_t);
+static int i2d_json_index_search(const i2d_json_index *, uint64_t, size_t *);
+static void i2d_json_section_init(i2d_json_section *, json_t *, const i2d_json_table *, const char *);
+
 int i2d_json_create(json_t ** json, i2d_string * path) {
     int status = I2D_OK;
     json_error_t error;
@@ -30,7 +67,7 @@ int i2d_object_get_string_stack(json_t * json, i2d_string_stack * result) {
     size = json_array_size(json);
     if(!size) {
         status = i2d_panic("empty array");
-    } else if(i2d_string_stack_create(result, size)) {
+    } else if(i2d_string_stack_create(I2D_TAG_JSON, result, size)) {
         status = I2D_FAIL;
     } else {
         json_array_foreach(json, index, value) {
@@ -65,7 +102,27 @@ int i2d_object_get_string(json_t * json, i2d_string * result) {
         if(!length) {
             status = i2d_panic("empty string object");
         } else {
-            status = i2d_string_create(result, string, length);
+            status = i2d_string_create(I2D_TAG_JSON, result, string, length);
+        }
+    }
+
+    return status;
+}
+
+int i2d_object_get_intern(json_t * json, i2d_string * result) {
+    int status = I2D_OK;
+    const char * string;
+    size_t length;
+
+    string = json_string_value(json);
+    if(!string) {
+        status = i2d_panic("invalid string object");
+    } else {
+        length = json_string_length(json);
+        if(!length) {
+            status = i2d_panic("empty string object");
+        } else {
+            status = i2d_intern_get(string, length, result);
         }
     }
 
@@ -84,7 +141,7 @@ int i2d_object_get_number_array(json_t * json, long ** result, size_t * result_s
     if(!size) {
         status = i2d_panic("empty array");
     } else {
-        list = calloc(size, sizeof(*list));
+        list = i2d_calloc(I2D_TAG_JSON, size, sizeof(*list));
         if(!list) {
             status = i2d_panic("out of memory");
         } else {
@@ -97,7 +154,7 @@ int i2d_object_get_number_array(json_t * json, long ** result, size_t * result_s
             }
 
             if(status) {
-                free(list);
+                i2d_free(list);
             } else {
                 *result = list;
                 *result_size = size;
@@ -189,7 +246,7 @@ int i2d_object_get_list(json_t * json, size_t element, void ** result_list, size
     if(!size) {
         status = i2d_panic("empty object");
     } else {
-        list = calloc(size, element);
+        list = i2d_calloc(I2D_TAG_JSON, size, element);
         if(!list) {
             status = i2d_panic("out of memory");
         } else {
@@ -213,11 +270,506 @@ int i2d_object_get_boolean(json_t * json, int * result) {
     return status;
 }
 
+static int i2d_json_reader_emit(i2d_json_reader * reader, enum i2d_json_type type, size_t depth, char * string, size_t length) {
+    i2d_json_event event;
+
+    event.type = type;
+    event.depth = depth;
+    event.string = string;
+    event.length = length;
+
+    return reader->cb(&event, reader->data);
+}
+
+static void i2d_json_reader_space(i2d_json_reader * reader) {
+    while(reader->offset < reader->length && i2d_isspace(reader->string[reader->offset])) {
+        if('\n' == reader->string[reader->offset])
+            reader->line++;
+        reader->offset++;
+    }
+}
+
+static int i2d_json_reader_value(i2d_json_reader * reader, size_t depth) {
+    int status = I2D_OK;
+    char * string;
+    size_t length;
+
+    i2d_json_reader_space(reader);
+    if(reader->offset >= reader->length) {
+        status = i2d_panic("unexpected end of input (line %zu)", reader->line);
+    } else if(depth > MAX_JSON_DEPTH) {
+        status = i2d_panic("maximum nesting depth exceeded (line %zu)", reader->line);
+    } else {
+        switch(reader->string[reader->offset]) {
+            case '{': status = i2d_json_reader_object(reader, depth); break;
+            case '[': status = i2d_json_reader_array(reader, depth); break;
+            case '"':
+                if(i2d_json_reader_string(reader, &string, &length)) {
+                    status = I2D_FAIL;
+                } else {
+                    status = i2d_json_reader_emit(reader, i2d_json_string, depth, string, length);
+                }
+                break;
+            case 't': status = i2d_json_reader_literal(reader, depth, "true", i2d_json_true); break;
+            case 'f': status = i2d_json_reader_literal(reader, depth, "false", i2d_json_false); break;
+            case 'n': status = i2d_json_reader_literal(reader, depth, "null", i2d_json_null); break;
+            default: status = i2d_json_reader_number(reader, depth); break;
+        }
+    }
+
+    return status;
+}
+
+static int i2d_json_reader_object(i2d_json_reader * reader, size_t depth) {
+    int status = I2D_OK;
+    char * string;
+    size_t length;
+    int last = 0;
+
+    reader->offset++;
+    if(i2d_json_reader_emit(reader, i2d_json_object_start, depth, NULL, 0)) {
+        status = I2D_FAIL;
+    } else {
+        i2d_json_reader_space(reader);
+        if(reader->offset < reader->length && '}' == reader->string[reader->offset])
+            last = 1;
+
+        while(!status && !last) {
+            i2d_json_reader_space(reader);
+            if(reader->offset >= reader->length || '"' != reader->string[reader->offset]) {
+                status = i2d_panic("string or '}' expected (line %zu)", reader->line);
+            } else if(i2d_json_reader_string(reader, &string, &length)) {
+                status = I2D_FAIL;
+            } else {
+                i2d_json_reader_space(reader);
+                if(reader->offset >= reader->length || ':' != reader->string[reader->offset]) {
+                    status = i2d_panic("':' expected (line %zu)", reader->line);
+                } else {
+                    reader->offset++;
+                    if(i2d_json_reader_emit(reader, i2d_json_key, depth + 1, string, length)) {
+                        status = I2D_FAIL;
+                    } else if(i2d_json_reader_value(reader, depth + 1)) {
+                        status = I2D_FAIL;
+                    } else {
+                        i2d_json_reader_space(reader);
+                        if(reader->offset >= reader->length) {
+                            status = i2d_panic("unexpected end of input (line %zu)", reader->line);
+                        } else if('}' == reader->string[reader->offset]) {
+                            last = 1;
+                        } else if(',' == reader->string[reader->offset]) {
+                            reader->offset++;
+                        } else {
+                            status = i2d_panic("',' or '}' expected (line %zu)", reader->line);
+                        }
+                    }
+                }
+            }
+        }
+
+        if(!status) {
+            reader->offset++;
+            status = i2d_json_reader_emit(reader, i2d_json_object_end, depth, NULL, 0);
+        }
+    }
+
+    return status;
+}
+
+static int i2d_json_reader_array(i2d_json_reader * reader, size_t depth) {
+    int status = I2D_OK;
+    int last = 0;
+
+    reader->offset++;
+    if(i2d_json_reader_emit(reader, i2d_json_array_start, depth, NULL, 0)) {
+        status = I2D_FAIL;
+    } else {
+        i2d_json_reader_space(reader);
+        if(reader->offset < reader->length && ']' == reader->string[reader->offset])
+            last = 1;
+
+        while(!status && !last) {
+            if(i2d_json_reader_value(reader, depth + 1)) {
+                status = I2D_FAIL;
+            } else {
+                i2d_json_reader_space(reader);
+                if(reader->offset >= reader->length) {
+                    status = i2d_panic("unexpected end of input (line %zu)", reader->line);
+                } else if(']' == reader->string[reader->offset]) {
+                    last = 1;
+                } else if(',' == reader->string[reader->offset]) {
+                    reader->offset++;
+                } else {
+                    status = i2d_panic("',' or ']' expected (line %zu)", reader->line);
+                }
+            }
+        }
+
+        if(!status) {
+            reader->offset++;
+            status = i2d_json_reader_emit(reader, i2d_json_array_end, depth, NULL, 0);
+        }
+    }
+
+    return status;
+}
+
+/*
+ * the string is unescaped in place; the result is
+ * never longer than the source so the terminator
+ * is written over the closing quote at the latest
+ */
+static int i2d_json_reader_string(i2d_json_reader * reader, char ** result, size_t * result_length) {
+    int status = I2D_OK;
+    char * string;
+    char * write;
+    unsigned char symbol;
+    unsigned long code;
+    unsigned long low;
+    int last = 0;
+
+    reader->offset++;
+    string = reader->string + reader->offset;
+    write = string;
+
+    while(!status && !last) {
+        if(reader->offset >= reader->length) {
+            status = i2d_panic("unterminated string (line %zu)", reader->line);
+        } else {
+            symbol = (unsigned char) reader->string[reader->offset++];
+            if('"' == symbol) {
+                last = 1;
+            } else if(0x20 > symbol) {
+                status = i2d_panic("control character in string (line %zu)", reader->line);
+            } else if('\\' != symbol) {
+                *write++ = (char) symbol;
+            } else if(reader->offset >= reader->length) {
+                status = i2d_panic("unterminated string (line %zu)", reader->line);
+            } else {
+                symbol = (unsigned char) reader->string[reader->offset++];
+                switch(symbol) {
+                    case '"': *write++ = '"'; break;
+                    case '\\': *write++ = '\\'; break;
+                    case '/': *write++ = '/'; break;
+                    case 'b': *write++ = '\b'; break;
+                    case 'f': *write++ = '\f'; break;
+                    case 'n': *write++ = '\n'; break;
+                    case 'r': *write++ = '\r'; break;
+                    case 't': *write++ = '\t'; break;
+                    case 'u':
+                        /*
+                         * a \\uXXXX escape is six bytes and
+                         * encodes to at most three bytes; a
+                         * surrogate pair is twelve bytes and
+                         * encodes to four bytes
+                         */
+                        if(i2d_json_reader_escape(reader, &code)) {
+                            status = i2d_panic("invalid unicode escape (line %zu)", reader->line);
+                        } else if(0xDC00 <= code && 0xDFFF >= code) {
+                            status = i2d_panic("invalid unicode surrogate (line %zu)", reader->line);
+                        } else if(0xD800 <= code && 0xDBFF >= code) {
+                            if(reader->offset + 2 > reader->length || '\\' != reader->string[reader->offset] || 'u' != reader->string[reader->offset + 1]) {
+                                status = i2d_panic("invalid unicode surrogate (line %zu)", reader->line);
+                            } else {
+                                reader->offset += 2;
+                                if(i2d_json_reader_escape(reader, &low)) {
+                                    status = i2d_panic("invalid unicode escape (line %zu)", reader->line);
+                                } else if(0xDC00 > low || 0xDFFF < low) {
+                                    status = i2d_panic("invalid unicode surrogate (line %zu)", reader->line);
+                                } else {
+                                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                                    *write++ = (char) (0xF0 | (code >> 18));
+                                    *write++ = (char) (0x80 | ((code >> 12) & 0x3F));
+                                    *write++ = (char) (0x80 | ((code >> 6) & 0x3F));
+                                    *write++ = (char) (0x80 | (code & 0x3F));
+                                }
+                            }
+                        } else {
+                            if(0x80 > code) {
+                                *write++ = (char) code;
+                            } else if(0x800 > code) {
+                                *write++ = (char) (0xC0 | (code >> 6));
+                                *write++ = (char) (0x80 | (code & 0x3F));
+                            } else {
+                                *write++ = (char) (0xE0 | (code >> 12));
+                                *write++ = (char) (0x80 | ((code >> 6) & 0x3F));
+                                *write++ = (char) (0x80 | (code & 0x3F));
+                            }
+                        }
+                        break;
+                    default:
+                        status = i2d_panic("invalid escape '\\%c' (line %zu)", symbol, reader->line);
+                        break;
+                }
+            }
+        }
+    }
+
+    if(!status) {
+        *write = 0;
+        *result = string;
+        *result_length = (size_t) (write - string);
+    }
+
+    return status;
+}
+
+/* the four hex digits after \\u */
+static int i2d_json_reader_escape(i2d_json_reader * reader, unsigned long * result) {
+    int status = I2D_OK;
+    unsigned char symbol;
+    unsigned long code = 0;
+    int i;
+
+    for(i = 0; i < 4 && !status; i++) {
+        if(reader->offset >= reader->length || !isxdigit((unsigned char) reader->string[reader->offset])) {
+            status = I2D_FAIL;
+        } else {
+            symbol = (unsigned char) reader->string[reader->offset++];
+            code = code * 16 + (i2d_isdigit(symbol) ? symbol - '0' : (tolower(symbol) - 'a' + 10));
+        }
+    }
+
+    if(!status)
+        *result = code;
+
+    return status;
+}
+
+/*
+ * the number is not nul terminated because the
+ * next character is a delimiter of the document
+ */
+static int i2d_json_reader_number(i2d_json_reader * reader, size_t depth) {
+    int status = I2D_OK;
+    char * string;
+    size_t start;
+
+    start = reader->offset;
+    string = reader->string + start;
+
+    if(reader->offset < reader->length && '-' == reader->string[reader->offset])
+        reader->offset++;
+    while(reader->offset < reader->length && i2d_isdigit(reader->string[reader->offset]))
+        reader->offset++;
+    if(reader->offset < reader->length && '.' == reader->string[reader->offset]) {
+        reader->offset++;
+        while(reader->offset < reader->length && i2d_isdigit(reader->string[reader->offset]))
+            reader->offset++;
+    }
+    if(reader->offset < reader->length && ('e' == reader->string[reader->offset] || 'E' == reader->string[reader->offset])) {
+        reader->offset++;
+        if(reader->offset < reader->length && ('+' == reader->string[reader->offset] || '-' == reader->string[reader->offset]))
+            reader->offset++;
+        while(reader->offset < reader->length && i2d_isdigit(reader->string[reader->offset]))
+            reader->offset++;
+    }
+
+    if(reader->offset == start || !i2d_isdigit(reader->string[reader->offset - 1])) {
+        status = i2d_panic("invalid token (line %zu)", reader->line);
+    } else {
+        status = i2d_json_reader_emit(reader, i2d_json_number, depth, string, reader->offset - start);
+    }
+
+    return status;
+}
+
+static int i2d_json_reader_literal(i2d_json_reader * reader, size_t depth, const char * literal, enum i2d_json_type type) {
+    int status = I2D_OK;
+    size_t length;
+
+    length = strlen(literal);
+    if(reader->length - reader->offset < length || memcmp(reader->string + reader->offset, literal, length)) {
+        status = i2d_panic("invalid token (line %zu)", reader->line);
+    } else {
+        reader->offset += length;
+        status = i2d_json_reader_emit(reader, type, depth, reader->string + reader->offset - length, length);
+    }
+
+    return status;
+}
+
+/*
+ * parse the first value in the file and ignore any
+ * trailing data like JSON_DISABLE_EOF_CHECK does
+ */
+int i2d_json_stream(i2d_string * path, i2d_json_event_cb cb, void * data) {
+    int status = I2D_OK;
+    i2d_buffer buffer;
+    i2d_json_reader reader;
+
+    if(i2d_buffer_create(I2D_TAG_JSON, &buffer, BUFFER_SIZE_LARGE * 2)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        if(i2d_fd_read_file(path, &buffer)) {
+            status = i2d_panic("failed to read json file -- %s", path->string);
+        } else {
+            reader.string = buffer.buffer;
+            reader.length = buffer.offset;
+            reader.offset = 0;
+            reader.line = 1;
+            reader.cb = cb;
+            reader.data = data;
+
+            if(i2d_json_reader_value(&reader, 0))
+                status = i2d_panic("failed to stream json file -- %s", path->string);
+        }
+        i2d_buffer_destroy(&buffer);
+    }
+
+    return status;
+}
+
+/*
+ * murmur3's finalizer, which spreads the bits of
+ * a number key and of a key that is displaced by
+ * the seed of its bucket
+ */
+static uint64_t i2d_json_index_mix(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+static int i2d_json_index_search(const i2d_json_index * index, uint64_t hash, size_t * result) {
+    int status = I2D_OK;
+
+    if(!index->size) {
+        status = I2D_FAIL;
+    } else {
+        *result = index->slots[i2d_json_index_mix(hash ^ index->seeds[hash % index->buckets]) % index->size];
+    }
+
+    return status;
+}
+
+/* string keys are hashed without case like i2d_rbt_cmp_str */
+int i2d_json_index_string(const i2d_json_index * index, const char * key, size_t length, size_t * result) {
+    uint64_t hash = I2D_FNV_OFFSET;
+    size_t i;
+
+    for(i = 0; i < length; i++) {
+        hash ^= (unsigned char) tolower((unsigned char) key[i]);
+        hash *= I2D_FNV_PRIME;
+    }
+
+    return i2d_json_index_search(index, hash, result);
+}
+
+int i2d_json_index_number(const i2d_json_index * index, long long key, size_t * result) {
+    return i2d_json_index_search(index, i2d_json_index_mix((uint64_t) key), result);
+}
+
+/*
+ * a file without a table is not an error; the
+ * caller reads the file as json, which reports
+ * the errors of the file
+ */
+int i2d_json_table_get(i2d_string * path, const i2d_json_table ** result) {
+    int status = I2D_FAIL;
+#ifdef i2d_json_static
+    i2d_buffer buffer;
+    uint64_t hash = 0;
+    size_t i;
+
+    if(!i2d_buffer_create(I2D_TAG_JSON, &buffer, BUFFER_SIZE_LARGE * 2)) {
+        if(!i2d_fd_read_file(path, &buffer)) {
+            for(i = 0; i < i2d_json_table_size && status; i++) {
+                if(i2d_json_tables[i].length == buffer.offset) {
+                    if(!hash)
+                        hash = i2d_fnv1a(I2D_FNV_OFFSET, buffer.buffer, buffer.offset);
+
+                    if(i2d_json_tables[i].hash == hash) {
+                        *result = &i2d_json_tables[i];
+                        status = I2D_OK;
+                    }
+                }
+            }
+        }
+        i2d_buffer_destroy(&buffer);
+    }
+#endif
+
+    return status;
+}
+
+int i2d_json_table_get_section(const i2d_json_table * table, const char * key, const i2d_json_table_section ** result) {
+    int status = I2D_FAIL;
+    size_t i;
+
+    for(i = 0; i < table->section_size && status; i++) {
+        if(key ? table->sections[i].key && !strcmp(key, table->sections[i].key) : !table->sections[i].key) {
+            *result = &table->sections[i];
+            status = I2D_OK;
+        }
+    }
+
+    return status;
+}
+
+int i2d_event_get_string(i2d_json_event * event, i2d_string * result) {
+    int status = I2D_OK;
+
+    if(i2d_json_string != event->type) {
+        status = i2d_panic("invalid string object");
+    } else if(!event->length) {
+        status = i2d_panic("empty string object");
+    } else {
+        status = i2d_string_create(I2D_TAG_JSON, result, event->string, event->length);
+    }
+
+    return status;
+}
+
+int i2d_event_get_intern(i2d_json_event * event, i2d_string * result) {
+    int status = I2D_OK;
+
+    if(i2d_json_string != event->type) {
+        status = i2d_panic("invalid string object");
+    } else if(!event->length) {
+        status = i2d_panic("empty string object");
+    } else {
+        status = i2d_intern_get(event->string, event->length, result);
+    }
+
+    return status;
+}
+
+int i2d_event_get_number(i2d_json_event * event, long * result) {
+    int status = I2D_OK;
+
+    if(i2d_json_number != event->type) {
+        status = i2d_panic("invalid number object");
+    } else if(i2d_strtol(result, event->string, event->length, 10)) {
+        status = i2d_panic("integer underflow or overflow");
+    }
+
+    return status;
+}
+
+int i2d_event_get_boolean(i2d_json_event * event, int * result) {
+    int status = I2D_OK;
+
+    if(i2d_json_true == event->type) {
+        *result = 1;
+    } else if(i2d_json_false == event->type) {
+        *result = 0;
+    } else {
+        status = i2d_panic("invalid boolean object");
+    }
+
+    return status;
+}
+
 int i2d_config_init(i2d_config ** result, i2d_string * path) {
     int status = I2D_OK;
     i2d_config * object;
     json_t * config;
     json_t * item_id;
+    json_t * select;
     json_t * arguments_path;
     json_t * bonus_path;
     json_t * constants_path;
@@ -234,11 +786,23 @@ int i2d_config_init(i2d_config ** result, i2d_string * path) {
     json_t * mercenary_db_path;
     json_t * pet_db_path;
     json_t * item_combo_db_path;
+    json_t * index_path;
+    json_t * depend_path;
+    json_t * cache_path;
+    json_t * locale_path;
+    json_t * ir_path;
+    json_t * trace_path;
+    json_t * memory_path;
+    json_t * stream;
+    json_t * budget;
+    json_t * budget_time = NULL;
+    json_t * budget_range = NULL;
+    json_t * budget_logic = NULL;
 
     if(i2d_is_invalid(result) || !path) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_JSON, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -246,6 +810,7 @@ int i2d_config_init(i2d_config ** result, i2d_string * path) {
                 status = i2d_panic("failed to load -- %s", path->string);
             } else {
                 item_id = json_object_get(config, "item_id");
+                select = json_object_get(config, "select");
                 arguments_path = json_object_get(config, "arguments_path");
                 bonus_path = json_object_get(config, "bonus_path");
                 constants_path = json_object_get(config, "constants_path");
@@ -262,8 +827,24 @@ int i2d_config_init(i2d_config ** result, i2d_string * path) {
                 mercenary_db_path = json_object_get(config, "mercenary_db_path");
                 pet_db_path = json_object_get(config, "pet_db_path");
                 item_combo_db_path = json_object_get(config, "item_combo_db_path");
+                index_path = json_object_get(config, "index_path");
+                depend_path = json_object_get(config, "depend_path");
+                cache_path = json_object_get(config, "cache_path");
+                locale_path = json_object_get(config, "locale_path");
+                ir_path = json_object_get(config, "ir_path");
+                trace_path = json_object_get(config, "trace_path");
+                memory_path = json_object_get(config, "memory_path");
+                stream = json_object_get(config, "stream");
+                budget = json_object_get(config, "budget");
+                if(budget) {
+                    budget_time = json_object_get(budget, "time");
+                    budget_range = json_object_get(budget, "range");
+                    budget_logic = json_object_get(budget, "logic");
+                }
                 if(item_id && i2d_object_get_number(item_id, &object->item_id)) {
                     status = i2d_panic("failed to get item id");
+                } else if(select && i2d_select_init(&object->select, select)) {
+                    status = i2d_panic("failed to get select");
                 } else if(!arguments_path || i2d_object_get_string(arguments_path, &object->arguments_path)) {
                     status = i2d_panic("failed to get arguments path");
                 } else if(!bonus_path || i2d_object_get_string(bonus_path, &object->bonus_path)) {
@@ -296,6 +877,34 @@ int i2d_config_init(i2d_config ** result, i2d_string * path) {
                     status = i2d_panic("failed to get pet db path");
                 } else if(!item_combo_db_path || i2d_object_get_string(item_combo_db_path, &object->item_combo_db_path)) {
                     status = i2d_panic("failed to get item combo db path");
+                } else if(index_path && i2d_object_get_string(index_path, &object->index_path)) {
+                    status = i2d_panic("failed to get index path");
+                } else if(depend_path && i2d_object_get_string(depend_path, &object->depend_path)) {
+                    status = i2d_panic("failed to get depend path");
+                } else if(cache_path && i2d_object_get_string(cache_path, &object->cache_path)) {
+                    status = i2d_panic("failed to get cache path");
+                } else if(object->depend_path.string && (!object->index_path.string || !object->cache_path.string)) {
+                    status = i2d_panic("depend_path requires index_path and cache_path");
+                } else if(locale_path && i2d_object_get_string(locale_path, &object->locale_path)) {
+                    status = i2d_panic("failed to get locale path");
+                } else if(ir_path && i2d_object_get_string(ir_path, &object->ir_path)) {
+                    status = i2d_panic("failed to get ir path");
+                } else if(trace_path && i2d_object_get_string(trace_path, &object->trace_path)) {
+                    status = i2d_panic("failed to get trace path");
+                } else if(memory_path && i2d_object_get_string(memory_path, &object->memory_path)) {
+                    status = i2d_panic("failed to get memory path");
+                } else if(stream && i2d_object_get_boolean(stream, &object->stream)) {
+                    status = i2d_panic("failed to get stream");
+                } else if(object->stream && (object->item_id || object->select || object->depend_path.string)) {
+                    status = i2d_panic("stream is for a run of every item without item_id, select, or depend_path");
+                } else if(budget_time && i2d_object_get_number(budget_time, &object->budget.time)) {
+                    status = i2d_panic("failed to get budget time");
+                } else if(budget_range && i2d_object_get_number(budget_range, &object->budget.range)) {
+                    status = i2d_panic("failed to get budget range");
+                } else if(budget_logic && i2d_object_get_number(budget_logic, &object->budget.logic)) {
+                    status = i2d_panic("failed to get budget logic");
+                } else if(object->budget.time < 0 || object->budget.range < 0 || object->budget.logic < 0) {
+                    status = i2d_panic("budget time, range, and logic must not be negative");
                 }
                 i2d_json_destroy(config);
             }
@@ -314,6 +923,13 @@ void i2d_config_deit(i2d_config ** result) {
     i2d_config * object;
 
     object = *result;
+    i2d_string_destroy(&object->memory_path);
+    i2d_string_destroy(&object->trace_path);
+    i2d_string_destroy(&object->ir_path);
+    i2d_string_destroy(&object->locale_path);
+    i2d_string_destroy(&object->cache_path);
+    i2d_string_destroy(&object->depend_path);
+    i2d_string_destroy(&object->index_path);
     i2d_string_destroy(&object->item_combo_db_path);
     i2d_string_destroy(&object->pet_db_path);
     i2d_string_destroy(&object->mercenary_db_path);
@@ -330,66 +946,104 @@ void i2d_config_deit(i2d_config ** result) {
     i2d_string_destroy(&object->constants_path);
     i2d_string_destroy(&object->bonus_path);
     i2d_string_destroy(&object->arguments_path);
+    i2d_deit(object->select, i2d_select_deit);
     i2d_free(object);
     *result = NULL;
 }
 
+static void * i2d_json_malloc(size_t size) {
+    return i2d_malloc(I2D_TAG_JSON, size);
+}
+
+static void i2d_json_free(void * pointer) {
+    i2d_dealloc(pointer);
+}
+
+static int i2d_json_load_file(void * data) {
+    int status = I2D_OK;
+    i2d_json_file * file = data;
+
+    if(i2d_json_create(file->json, file->path))
+        status = i2d_panic("failed to load json file -- %s", file->path->string);
+
+    return status;
+}
+
+static int i2d_json_load(i2d_json * json) {
+    size_t i;
+    size_t size = 0;
+    i2d_json_file files[] = {
+        { &json->data_file, &json->config->data_path },
+        { &json->print_file, &json->config->print_path }
+    };
+    const i2d_json_table ** tables[] = {
+        &json->data_table,
+        &json->print_table
+    };
+    i2d_task tasks[i2d_size(files)];
+
+    /*
+     * the constants and data files are streamed
+     * by i2d_script_init; only the files that are
+     * read as documents after startup are loaded,
+     * unless the file has a table
+     */
+    for(i = 0; i < i2d_size(files); i++) {
+        if(i2d_json_table_get(files[i].path, tables[i])) {
+            tasks[size].cb = i2d_json_load_file;
+            tasks[size].data = &files[i];
+            tasks[size].status = I2D_OK;
+            size++;
+        }
+    }
+
+    return i2d_task_run(tasks, size);
+}
+
+static void i2d_json_section_init(i2d_json_section * result, json_t * json, const i2d_json_table * table, const char * key) {
+    result->json = json ? json_object_get(json, key) : NULL;
+    result->table = NULL;
+    if(table)
+        i2d_json_table_get_section(table, key, &result->table);
+}
+
 int i2d_json_init(i2d_json ** result, i2d_string * path) {
     int status = I2D_OK;
     i2d_json * object;
 
+    /* jansson allocates through the allocator */
+    json_set_alloc_funcs(i2d_json_malloc, i2d_json_free);
+
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_JSON, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
             if(i2d_config_init(&object->config, path)) {
                 status = i2d_panic("failed to create config object");
-            } else if(i2d_json_create(&object->statements, &object->config->statements_path)) {
-                status = i2d_panic("failed to load json file -- %s", &object->config->statements_path);
-            } else if(i2d_json_create(&object->functions, &object->config->functions_path)) {
-                status = i2d_panic("failed to load json file -- %s", &object->config->functions_path);
-            } else if(i2d_json_create(&object->constants, &object->config->constants_path)) {
-                status = i2d_panic("failed to load json file -- %s", &object->config->constants_path);
-            } else if(i2d_json_create(&object->arguments, &object->config->arguments_path)) {
-                status = i2d_panic("failed to load json file -- %s", &object->config->arguments_path);
-            } else if(i2d_json_create(&object->bonus_file, &object->config->bonus_path)) {
-                status = i2d_panic("failed to load json file -- %s", &object->config->bonus_path);
-            } else if(i2d_json_create(&object->sc_start_file, &object->config->sc_start_path)) {
-                status = i2d_panic("failed to load json file -- %s", &object->config->sc_start_path);
-            } else if(i2d_json_create(&object->data_file, &object->config->data_path)) {
-                status = i2d_panic("failed to load json file -- %s", &object->config->data_path);
-            } else if(i2d_json_create(&object->print_file, &object->config->print_path)) {
-                status = i2d_panic("failed to load json file -- %s", &object->config->print_path);
+            } else if(i2d_json_load(object)) {
+                status = i2d_panic("failed to load json files");
             } else {
-                object->bonus = json_object_get(object->bonus_file, "bonus");
-                object->bonus2 = json_object_get(object->bonus_file, "bonus2");
-                object->bonus3 = json_object_get(object->bonus_file, "bonus3");
-                object->bonus4 = json_object_get(object->bonus_file, "bonus4");
-                object->bonus5 = json_object_get(object->bonus_file, "bonus5");
-                object->ammo_type = json_object_get(object->data_file, "ammo_type");
-                object->bonus_script_flag = json_object_get(object->data_file, "bonus_script_flag");
-                object->getiteminfo_type = json_object_get(object->data_file, "getiteminfo_type");
-                object->searchstore_effect = json_object_get(object->data_file, "searchstore_effect");
-                object->skill_flag = json_object_get(object->data_file, "skill_flag");
-                object->strcharinfo_type = json_object_get(object->data_file, "strcharinfo_type");
-                object->weapon_type = json_object_get(object->data_file, "weapon_type");
-                object->item_type = json_object_get(object->data_file, "item_type");
-                object->item_location = json_object_get(object->data_file, "item_location");
-                object->job = json_object_get(object->data_file, "job");
-                object->job_group = json_object_get(object->data_file, "job_group");
-                object->class = json_object_get(object->data_file, "class");
-                object->class_group = json_object_get(object->data_file, "class_group");
-                object->gender = json_object_get(object->data_file, "gender");
-                object->refineable = json_object_get(object->data_file, "refineable");
-                object->basejob = json_object_get(object->data_file, "basejob");
-                object->sc_start = json_object_get(object->sc_start_file, "sc_start");
-                object->sc_start2 = json_object_get(object->sc_start_file, "sc_start2");
-                object->sc_start4 = json_object_get(object->sc_start_file, "sc_start4");
-                object->description_by_item_type = json_object_get(object->print_file, "description_by_item_type");
-                object->description_of_item_property = json_object_get(object->print_file, "description_of_item_property");
+                i2d_json_section_init(&object->ammo_type, object->data_file, object->data_table, "ammo_type");
+                i2d_json_section_init(&object->bonus_script_flag, object->data_file, object->data_table, "bonus_script_flag");
+                i2d_json_section_init(&object->getiteminfo_type, object->data_file, object->data_table, "getiteminfo_type");
+                i2d_json_section_init(&object->searchstore_effect, object->data_file, object->data_table, "searchstore_effect");
+                i2d_json_section_init(&object->skill_flag, object->data_file, object->data_table, "skill_flag");
+                i2d_json_section_init(&object->strcharinfo_type, object->data_file, object->data_table, "strcharinfo_type");
+                i2d_json_section_init(&object->weapon_type, object->data_file, object->data_table, "weapon_type");
+                i2d_json_section_init(&object->item_type, object->data_file, object->data_table, "item_type");
+                i2d_json_section_init(&object->item_location, object->data_file, object->data_table, "item_location");
+                i2d_json_section_init(&object->job, object->data_file, object->data_table, "job");
+                i2d_json_section_init(&object->job_group, object->data_file, object->data_table, "job_group");
+                i2d_json_section_init(&object->class, object->data_file, object->data_table, "class");
+                i2d_json_section_init(&object->class_group, object->data_file, object->data_table, "class_group");
+                i2d_json_section_init(&object->gender, object->data_file, object->data_table, "gender");
+                i2d_json_section_init(&object->refineable, object->data_file, object->data_table, "refineable");
+                i2d_json_section_init(&object->basejob, object->data_file, object->data_table, "basejob");
+                i2d_json_section_init(&object->description_by_item_type, object->print_file, object->print_table, "description_by_item_type");
+                i2d_json_section_init(&object->description_of_item_property, object->print_file, object->print_table, "description_of_item_property");
             }
 
             if(status)
@@ -408,12 +1062,6 @@ void i2d_json_deit(i2d_json ** result) {
     object = *result;
     i2d_json_destroy(object->print_file);
     i2d_json_destroy(object->data_file);
-    i2d_json_destroy(object->sc_start_file);
-    i2d_json_destroy(object->bonus_file);
-    i2d_json_destroy(object->arguments);
-    i2d_json_destroy(object->constants);
-    i2d_json_destroy(object->functions);
-    i2d_json_destroy(object->statements);
     i2d_deit(object->config, i2d_config_deit);
     i2d_free(object);
     *result = NULL;
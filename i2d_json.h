@@ -4,6 +4,8 @@
 #include "i2d_util.h"
 #include "i2d_range.h"
 #include "i2d_rbt.h"
+#include "i2d_intern.h"
+#include "i2d_select.h"
 #include "jansson.h"
 
 int i2d_json_create(json_t **, i2d_string *);
@@ -11,6 +13,7 @@ void i2d_json_destroy(json_t *);
 
 int i2d_object_get_string_stack(json_t *, i2d_string_stack *);
 int i2d_object_get_string(json_t *, i2d_string *);
+int i2d_object_get_intern(json_t *, i2d_string *);
 int i2d_object_get_number_array(json_t *, long **, size_t *);
 int i2d_object_get_number(json_t *, long *);
 int i2d_object_get_range_array(json_t *, i2d_range *);
@@ -18,8 +21,196 @@ int i2d_object_get_range(json_t *, json_t *, i2d_range *);
 int i2d_object_get_list(json_t *, size_t, void **, size_t *);
 int i2d_object_get_boolean(json_t *, int *);
 
+enum i2d_json_type {
+    i2d_json_object_start,
+    i2d_json_object_end,
+    i2d_json_array_start,
+    i2d_json_array_end,
+    i2d_json_key,
+    i2d_json_string,
+    i2d_json_number,
+    i2d_json_true,
+    i2d_json_false,
+    i2d_json_null
+};
+
+/*
+ * depth is the number of containers that enclose
+ * the event, i.e. the keys of the root object are
+ * at depth 1; string is nul terminated for a key
+ * or a string and points into the source buffer,
+ * which is only valid for the duration of stream
+ */
+struct i2d_json_event {
+    enum i2d_json_type type;
+    size_t depth;
+    char * string;
+    size_t length;
+};
+
+typedef struct i2d_json_event i2d_json_event;
+
+typedef int (* i2d_json_event_cb) (i2d_json_event *, void *);
+
+/*
+ * a perfect hash index that is generated at build
+ * time; a key hashes to a bucket, the seed of the
+ * bucket moves the key to a slot, and the slot has
+ * the position of the entry, which the caller must
+ * compare since a missing key also has a slot
+ */
+struct i2d_json_index {
+    const uint32_t * seeds;
+    size_t buckets;
+    const uint32_t * slots;
+    size_t size;
+};
+
+typedef struct i2d_json_index i2d_json_index;
+
+int i2d_json_index_string(const i2d_json_index *, const char *, size_t, size_t *);
+int i2d_json_index_number(const i2d_json_index *, long long, size_t *);
+
+/*
+ * the data files that are compiled by the generator
+ * data/json_table.py at build time (make TABLE=1);
+ * a table is used instead of a file that has the
+ * same length and hash as at build time, so that an
+ * edited file is still read as json
+ */
+struct i2d_json_table_string {
+    const char * string;
+    size_t length;
+};
+
+typedef struct i2d_json_table_string i2d_json_table_string;
+
+struct i2d_json_table_range {
+    long min;
+    long max;
+};
+
+typedef struct i2d_json_table_range i2d_json_table_range;
+
+struct i2d_json_table_constant {
+    i2d_json_table_string macro;
+    i2d_json_table_string name;
+    long value;
+    const i2d_json_table_range * range;
+    size_t range_size;
+};
+
+typedef struct i2d_json_table_constant i2d_json_table_constant;
+
+struct i2d_json_table_category {
+    const char * key;
+    i2d_json_index index;
+};
+
+typedef struct i2d_json_table_category i2d_json_table_category;
+
+struct i2d_json_table_constants {
+    const i2d_json_table_constant * list;
+    size_t size;
+    i2d_json_index macros;
+    const i2d_json_table_category * categories;
+    size_t category_size;
+};
+
+typedef struct i2d_json_table_constants i2d_json_table_constants;
+
+/* constant is the value of the macro of the name at build time */
+struct i2d_json_table_data {
+    i2d_json_table_string name;
+    long constant;
+    const i2d_json_table_range * range;
+    size_t range_size;
+    i2d_json_table_string description;
+    i2d_json_table_string handler;
+    const i2d_json_table_string * argument_type;
+    size_t argument_type_size;
+    const i2d_json_table_string * argument_default;
+    size_t argument_default_size;
+    const long * argument_order;
+    size_t argument_order_size;
+    long required;
+    long optional;
+    i2d_json_table_string positive;
+    i2d_json_table_string negative;
+    i2d_json_table_string zero;
+    int empty_description_on_zero;
+    int empty_description_on_empty_string;
+    int dump_stack_instead_of_description;
+    uint64_t hash;
+};
+
+typedef struct i2d_json_table_data i2d_json_table_data;
+
+struct i2d_json_table_value {
+    long long value;
+    i2d_json_table_string string;
+    const i2d_json_table_string * stack;
+    size_t stack_size;
+};
+
+typedef struct i2d_json_table_value i2d_json_table_value;
+
+/*
+ * a section is a data map or a value map; the key
+ * is null for a file that is a single data map
+ */
+struct i2d_json_table_section {
+    const char * key;
+    const i2d_json_table_data * data;
+    size_t data_size;
+    i2d_json_index names;
+    i2d_json_index constants;
+    const i2d_json_table_value * values;
+    size_t value_size;
+    i2d_json_index numbers;
+};
+
+typedef struct i2d_json_table_section i2d_json_table_section;
+
+struct i2d_json_table {
+    const char * name;
+    size_t length;
+    uint64_t hash;
+    const i2d_json_table_constants * constants;
+    const i2d_json_table_section * sections;
+    size_t section_size;
+};
+
+typedef struct i2d_json_table i2d_json_table;
+
+#ifdef i2d_json_static
+extern const i2d_json_table i2d_json_tables[];
+extern const size_t i2d_json_table_size;
+#endif
+
+int i2d_json_table_get(i2d_string *, const i2d_json_table **);
+int i2d_json_table_get_section(const i2d_json_table *, const char *, const i2d_json_table_section **);
+
+/*
+ * a section of the data or print file, which is
+ * either a json object or the section of a table
+ */
+struct i2d_json_section {
+    json_t * json;
+    const i2d_json_table_section * table;
+};
+
+typedef struct i2d_json_section i2d_json_section;
+
+int i2d_json_stream(i2d_string *, i2d_json_event_cb, void *);
+int i2d_event_get_string(i2d_json_event *, i2d_string *);
+int i2d_event_get_intern(i2d_json_event *, i2d_string *);
+int i2d_event_get_number(i2d_json_event *, long *);
+int i2d_event_get_boolean(i2d_json_event *, int *);
+
 struct i2d_config {
     long item_id;
+    i2d_select * select;
     i2d_string arguments_path;
     i2d_string bonus_path;
     i2d_string constants_path;
@@ -36,6 +227,19 @@ struct i2d_config {
     i2d_string mercenary_db_path;
     i2d_string pet_db_path;
     i2d_string item_combo_db_path;
+    i2d_string index_path;
+    i2d_string depend_path;
+    i2d_string cache_path;
+    i2d_string locale_path;
+    i2d_string ir_path;
+    i2d_string trace_path;
+    i2d_string memory_path;
+    int stream;
+    struct {
+        long time;
+        long range;
+        long logic;
+    } budget;
 };
 
 typedef struct i2d_config i2d_config;
@@ -45,40 +249,28 @@ void i2d_config_deit(i2d_config  **);
 
 struct i2d_json {
     i2d_config * config;
-    json_t * statements;
-    json_t * functions;
-    json_t * constants;
-    json_t * arguments;
-    json_t * bonus_file;
-    json_t * bonus;
-    json_t * bonus2;
-    json_t * bonus3;
-    json_t * bonus4;
-    json_t * bonus5;
-    json_t * sc_start_file;
-    json_t * sc_start;
-    json_t * sc_start2;
-    json_t * sc_start4;
     json_t * data_file;
-    json_t * ammo_type;
-    json_t * bonus_script_flag;
-    json_t * getiteminfo_type;
-    json_t * searchstore_effect;
-    json_t * skill_flag;
-    json_t * strcharinfo_type;
-    json_t * weapon_type;
-    json_t * item_type;
-    json_t * item_location;
-    json_t * job;
-    json_t * job_group;
-    json_t * class;
-    json_t * class_group;
-    json_t * gender;
-    json_t * refineable;
-    json_t * basejob;
+    const i2d_json_table * data_table;
+    i2d_json_section ammo_type;
+    i2d_json_section bonus_script_flag;
+    i2d_json_section getiteminfo_type;
+    i2d_json_section searchstore_effect;
+    i2d_json_section skill_flag;
+    i2d_json_section strcharinfo_type;
+    i2d_json_section weapon_type;
+    i2d_json_section item_type;
+    i2d_json_section item_location;
+    i2d_json_section job;
+    i2d_json_section job_group;
+    i2d_json_section class;
+    i2d_json_section class_group;
+    i2d_json_section gender;
+    i2d_json_section refineable;
+    i2d_json_section basejob;
     json_t * print_file;
-    json_t * description_by_item_type;
-    json_t * description_of_item_property;
+    const i2d_json_table * print_table;
+    i2d_json_section description_by_item_type;
+    i2d_json_section description_of_item_property;
 };
 
 typedef struct i2d_json i2d_json;
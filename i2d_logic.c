@@ -7,11 +7,11 @@ int i2d_logic_init(i2d_logic ** result, i2d_string * name, i2d_range * range) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_LOGIC, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_string_create(&object->name, name->string, name->length)) {
+            if(i2d_string_create(I2D_TAG_LOGIC, &object->name, name->string, name->length)) {
                 status = i2d_panic("failed to create string object");
             } else if(i2d_range_copy(&object->range, range)) {
                 status = i2d_panic("failed to create range list object");
@@ -66,7 +66,7 @@ int i2d_logic_link(i2d_logic ** result, i2d_logic * left, i2d_logic * right, int
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_LOGIC, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
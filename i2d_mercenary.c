@@ -11,7 +11,7 @@ int i2d_mercenary_init(i2d_mercenary ** result, char * string, size_t length) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -36,8 +36,6 @@ void i2d_mercenary_deit(i2d_mercenary ** result) {
     i2d_mercenary * object;
 
     object = *result;
-    i2d_string_destroy(&object->name);
-    i2d_string_destroy(&object->sprite_name);
     i2d_free(object);
     *result = NULL;
 }
@@ -45,71 +43,45 @@ void i2d_mercenary_deit(i2d_mercenary ** result) {
 static int i2d_mercenary_parse(i2d_mercenary * mercenary, char * string, size_t length) {
     int status = I2D_OK;
 
-    size_t i;
+    i2d_split split;
 
     char * anchor;
     size_t extent;
 
     int field = 0;
-    int last = 0;
-
-    anchor = string;
-    for(i = 0; i < length && !status && !last; i++) {
-        /*
-         * check for \t, \r, \n (exclude space)
-         */
-        if(i2d_isspace(string[i]) && ' ' != string[i])
-            last = 1;
-
-        /*
-         * check for line comments
-         */
-        if('/' == string[i] && i > 0 && '/' == string[i - 1]) {
-            i -= 1;
-            last = 1;
-        }
-
-        if(',' == string[i] || last) {
-            string[i] = 0;
-
-            if(string + i < anchor) {
-                status = i2d_panic("line overflow");
-            } else {
-                extent = (size_t) (string + i) - (size_t) anchor;
-                switch(field) {
-                    case 0: status = i2d_strtol(&mercenary->id, anchor, extent, 10); break;
-                    case 1: status = i2d_string_create(&mercenary->sprite_name, anchor, extent); break;
-                    case 2: status = i2d_string_create(&mercenary->name, anchor, extent); break;
-                    case 3: status = i2d_strtol(&mercenary->level, anchor, extent, 10); break;
-                    case 4: status = i2d_strtol(&mercenary->hp, anchor, extent, 10); break;
-                    case 5: status = i2d_strtol(&mercenary->sp, anchor, extent, 10); break;
-                    case 6: status = i2d_strtol(&mercenary->range1, anchor, extent, 10); break;
-                    case 7: status = i2d_strtol(&mercenary->atk1, anchor, extent, 10); break;
-                    case 8: status = i2d_strtol(&mercenary->atk2, anchor, extent, 10); break;
-                    case 9: status = i2d_strtol(&mercenary->def, anchor, extent, 10); break;
-                    case 10: status = i2d_strtol(&mercenary->mdef, anchor, extent, 10); break;
-                    case 11: status = i2d_strtol(&mercenary->str, anchor, extent, 10); break;
-                    case 12: status = i2d_strtol(&mercenary->agi, anchor, extent, 10); break;
-                    case 13: status = i2d_strtol(&mercenary->vit, anchor, extent, 10); break;
-                    case 14: status = i2d_strtol(&mercenary->ini, anchor, extent, 10); break;
-                    case 15: status = i2d_strtol(&mercenary->dex, anchor, extent, 10); break;
-                    case 16: status = i2d_strtol(&mercenary->luk, anchor, extent, 10); break;
-                    case 17: status = i2d_strtol(&mercenary->range2, anchor, extent, 10); break;
-                    case 18: status = i2d_strtol(&mercenary->range3, anchor, extent, 10); break;
-                    case 19: status = i2d_strtol(&mercenary->scale, anchor, extent, 10); break;
-                    case 20: status = i2d_strtol(&mercenary->race, anchor, extent, 10); break;
-                    case 21: status = i2d_strtol(&mercenary->element, anchor, extent, 10); break;
-                    case 22: status = i2d_strtol(&mercenary->speed, anchor, extent, 10); break;
-                    case 23: status = i2d_strtol(&mercenary->adelay, anchor, extent, 10); break;
-                    case 24: status = i2d_strtol(&mercenary->amotion, anchor, extent, 10); break;
-                    case 25: status = i2d_strtol(&mercenary->dmotion, anchor, extent, 10); break;
-                    default: status = i2d_panic("row has too many columns"); break;
-                }
-                field++;
-            }
 
-            anchor = (string + i + 1);
+    i2d_split_create(&split, string, length, 0);
+    while(!status && !i2d_split_next(&split, &anchor, &extent)) {
+        switch(field) {
+            case 0: status = i2d_strtol(&mercenary->id, anchor, extent, 10); break;
+            case 1: status = i2d_intern_get(anchor, extent, &mercenary->sprite_name); break;
+            case 2: status = i2d_intern_get(anchor, extent, &mercenary->name); break;
+            case 3: status = i2d_strtol(&mercenary->level, anchor, extent, 10); break;
+            case 4: status = i2d_strtol(&mercenary->hp, anchor, extent, 10); break;
+            case 5: status = i2d_strtol(&mercenary->sp, anchor, extent, 10); break;
+            case 6: status = i2d_strtol(&mercenary->range1, anchor, extent, 10); break;
+            case 7: status = i2d_strtol(&mercenary->atk1, anchor, extent, 10); break;
+            case 8: status = i2d_strtol(&mercenary->atk2, anchor, extent, 10); break;
+            case 9: status = i2d_strtol(&mercenary->def, anchor, extent, 10); break;
+            case 10: status = i2d_strtol(&mercenary->mdef, anchor, extent, 10); break;
+            case 11: status = i2d_strtol(&mercenary->str, anchor, extent, 10); break;
+            case 12: status = i2d_strtol(&mercenary->agi, anchor, extent, 10); break;
+            case 13: status = i2d_strtol(&mercenary->vit, anchor, extent, 10); break;
+            case 14: status = i2d_strtol(&mercenary->ini, anchor, extent, 10); break;
+            case 15: status = i2d_strtol(&mercenary->dex, anchor, extent, 10); break;
+            case 16: status = i2d_strtol(&mercenary->luk, anchor, extent, 10); break;
+            case 17: status = i2d_strtol(&mercenary->range2, anchor, extent, 10); break;
+            case 18: status = i2d_strtol(&mercenary->range3, anchor, extent, 10); break;
+            case 19: status = i2d_strtol(&mercenary->scale, anchor, extent, 10); break;
+            case 20: status = i2d_strtol(&mercenary->race, anchor, extent, 10); break;
+            case 21: status = i2d_strtol(&mercenary->element, anchor, extent, 10); break;
+            case 22: status = i2d_strtol(&mercenary->speed, anchor, extent, 10); break;
+            case 23: status = i2d_strtol(&mercenary->adelay, anchor, extent, 10); break;
+            case 24: status = i2d_strtol(&mercenary->amotion, anchor, extent, 10); break;
+            case 25: status = i2d_strtol(&mercenary->dmotion, anchor, extent, 10); break;
+            default: status = i2d_panic("row has too many columns"); break;
         }
+        field++;
     }
 
     if(!status && 26 != field)
@@ -139,7 +111,7 @@ int i2d_mercenary_db_init(i2d_mercenary_db ** result, i2d_string * path) {
     if(i2d_is_invalid(result) || !path) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -164,6 +136,7 @@ void i2d_mercenary_db_deit(i2d_mercenary_db ** result) {
     i2d_mercenary * mercenary;
 
     object = *result;
+    i2d_table_destroy(&object->table_by_id);
     i2d_deit(object->index_by_id, i2d_rbt_deit);
     if(object->list) {
         while(object->list != object->list->next) {
@@ -201,20 +174,26 @@ static int i2d_mercenary_db_index(i2d_mercenary_db * mercenary_db) {
     int status = I2D_OK;
     i2d_mercenary * mercenary = NULL;
 
-    if(i2d_rbt_init(&mercenary_db->index_by_id, i2d_rbt_cmp_long)) {
+    if(i2d_rbt_init_static(&mercenary_db->index_by_id, i2d_rbt_cmp_long)) {
         status = i2d_panic("failed to create red black tree object");
     } else {
         mercenary = mercenary_db->list;
         do {
-            if( i2d_rbt_insert(mercenary_db->index_by_id, &mercenary->id, mercenary))
+            if( i2d_rbt_insert(mercenary_db->index_by_id, &mercenary->id, mercenary) ||
+                (i2d_table_range(mercenary->id) && i2d_table_insert(&mercenary_db->table_by_id, mercenary->id, mercenary)) )
                 status = i2d_panic("failed to index mercenary by id -- %ld", mercenary->id);
             mercenary = mercenary->next;
         } while(mercenary != mercenary_db->list && !status);
+
+        if(!status && i2d_rbt_build(mercenary_db->index_by_id))
+            status = i2d_panic("failed to build red black tree object");
     }
 
     return status;
 }
 
 int i2d_mercenary_db_search_by_id(i2d_mercenary_db * mercenary_db, long id, i2d_mercenary ** mercenary) {
-    return i2d_rbt_search(mercenary_db->index_by_id, &id, (void **) mercenary);
+    return i2d_table_range(id) ?
+        i2d_table_search(&mercenary_db->table_by_id, id, (void **) mercenary) :
+        i2d_rbt_search(mercenary_db->index_by_id, &id, (void **) mercenary);
 }
@@ -3,6 +3,7 @@
 
 #include "i2d_util.h"
 #include "i2d_rbt.h"
+#include "i2d_intern.h"
 
 struct i2d_mercenary {
     long id;
@@ -46,6 +47,7 @@ struct i2d_mercenary_db {
     i2d_mercenary * list;
     size_t size;
     i2d_rbt * index_by_id;
+    i2d_table table_by_id;
 };
 
 typedef struct i2d_mercenary_db i2d_mercenary_db;
@@ -1,8 +1,57 @@
 #include "i2d_mob.h"
 
+struct i2d_mob_yml {
+    i2d_mob_db * mob_db;
+    i2d_rbt * index;
+    i2d_mob * mob;
+    int exist;
+    int fields;
+    long element;
+    long element_level;
+};
+
+typedef struct i2d_mob_yml i2d_mob_yml;
+
+static i2d_yaml_constant i2d_mob_size_list[] = {
+    { "Small", 0 },
+    { "Medium", 1 },
+    { "Large", 2 }
+};
+
+static i2d_yaml_constant i2d_mob_race_list[] = {
+    { "Formless", 0 },
+    { "Undead", 1 },
+    { "Brute", 2 },
+    { "Plant", 3 },
+    { "Insect", 4 },
+    { "Fish", 5 },
+    { "Demon", 6 },
+    { "Demihuman", 7 },
+    { "Angel", 8 },
+    { "Dragon", 9 }
+};
+
+static i2d_yaml_constant i2d_mob_element_list[] = {
+    { "Neutral", 0 },
+    { "Water", 1 },
+    { "Earth", 2 },
+    { "Fire", 3 },
+    { "Wind", 4 },
+    { "Poison", 5 },
+    { "Holy", 6 },
+    { "Dark", 7 },
+    { "Ghost", 8 },
+    { "Undead", 9 }
+};
+
 static int i2d_mob_parse(i2d_mob *, char *, size_t);
 static int i2d_mob_db_parse(char *, size_t, void *);
 static int i2d_mob_db_index(i2d_mob_db *);
+static int i2d_mob_yml_init(i2d_mob **);
+static int i2d_mob_parse_yml(i2d_mob_yml *, i2d_yaml_record *);
+static int i2d_mob_db_parse_yml_end(i2d_mob_yml *);
+static int i2d_mob_db_parse_yml(i2d_yaml_record *, void *);
+static int i2d_mob_db_load_yml(i2d_mob_db *, i2d_string *);
 static int i2d_mob_race_parse(i2d_mob_race *, char *, size_t);
 static int i2d_mob_race_db_parse(char *, size_t, void *);
 static int i2d_mob_race_db_index(i2d_mob_race_db *);
@@ -14,7 +63,7 @@ int i2d_mob_init(i2d_mob ** result, char * string, size_t length) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -39,9 +88,6 @@ void i2d_mob_deit(i2d_mob ** result) {
     i2d_mob * object;
 
     object = *result;
-    i2d_free(object->sprite.string);
-    i2d_free(object->kro.string);
-    i2d_free(object->iro.string);
     i2d_free(object);
     *result = NULL;
 }
@@ -49,102 +95,78 @@ void i2d_mob_deit(i2d_mob ** result) {
 static int i2d_mob_parse(i2d_mob * mob, char * string, size_t length) {
     int status = I2D_OK;
 
-    size_t i;
+    i2d_split split;
 
     char * anchor;
     size_t extent;
 
     int field = 0;
-    int last = 0;
-
-    anchor = string;
-    for(i = 0; i < length && !status && !last; i++) {
-        /*
-         * check for \t, \r, \n (exclude space)
-         */
-        if(i2d_isspace(string[i]) && ' ' != string[i])
-            last = 1;
 
-        /*
-         * check for line comments
-         */
-        if('/' == string[i] && i > 0 && '/' == string[i - 1]) {
-            i -= 1;
-            last = 1;
-        }
-
-        if(',' == string[i] || last) {
-            string[i] = 0;
-
-            if(string + i < anchor) {
-                status = i2d_panic("line overflow");
-            } else {
-                extent = (size_t) (string + i) - (size_t) anchor;
-                switch(field) {
-                    case 0: status = i2d_strtol(&mob->id, anchor, extent, 10); break;
-                    case 1: status = i2d_string_create(&mob->sprite, anchor, extent); break;
-                    case 2: status = i2d_string_create(&mob->kro, anchor, extent); break;
-                    case 3: status = i2d_string_create(&mob->iro, anchor, extent); break;
-                    case 4: status = i2d_strtol(&mob->level, anchor, extent, 10); break;
-                    case 5: status = i2d_strtol(&mob->hp, anchor, extent, 10); break;
-                    case 6: status = i2d_strtol(&mob->sp, anchor, extent, 10); break;
-                    case 7: status = i2d_strtol(&mob->exp, anchor, extent, 10); break;
-                    case 8: status = i2d_strtol(&mob->jexp, anchor, extent, 10); break;
-                    case 9: status = i2d_strtol(&mob->range1, anchor, extent, 10); break;
-                    case 10: status = i2d_strtol(&mob->atk1, anchor, extent, 10); break;
-                    case 11: status = i2d_strtol(&mob->atk2, anchor, extent, 10); break;
-                    case 12: status = i2d_strtol(&mob->def, anchor, extent, 10); break;
-                    case 13: status = i2d_strtol(&mob->mdef, anchor, extent, 10); break;
-                    case 14: status = i2d_strtol(&mob->str, anchor, extent, 10); break;
-                    case 15: status = i2d_strtol(&mob->agi, anchor, extent, 10); break;
-                    case 16: status = i2d_strtol(&mob->vit, anchor, extent, 10); break;
-                    case 17: status = i2d_strtol(&mob->inte, anchor, extent, 10); break;
-                    case 18: status = i2d_strtol(&mob->dex, anchor, extent, 10); break;
-                    case 19: status = i2d_strtol(&mob->luk, anchor, extent, 10); break;
-                    case 20: status = i2d_strtol(&mob->range2, anchor, extent, 10); break;
-                    case 21: status = i2d_strtol(&mob->range3, anchor, extent, 10); break;
-                    case 22: status = i2d_strtol(&mob->scale, anchor, extent, 10); break;
-                    case 23: status = i2d_strtol(&mob->race, anchor, extent, 10); break;
-                    case 24: status = i2d_strtol(&mob->element, anchor, extent, 10); break;
-                    case 25: status = i2d_strtol(&mob->mode, anchor, extent, 16); break;
-                    case 26: status = i2d_strtol(&mob->speed, anchor, extent, 10); break;
-                    case 27: status = i2d_strtol(&mob->adelay, anchor, extent, 10); break;
-                    case 28: status = i2d_strtol(&mob->amotion, anchor, extent, 10); break;
-                    case 29: status = i2d_strtol(&mob->dmotion, anchor, extent, 10); break;
-                    case 30: status = i2d_strtod(&mob->mexp, anchor, extent); break;
-                    case 31: status = i2d_strtol(&mob->mvp_drop_id[0], anchor, extent, 10); break;
-                    case 32: status = i2d_strtol(&mob->mvp_drop_pre[0], anchor, extent, 10); break;
-                    case 33: status = i2d_strtol(&mob->mvp_drop_id[1], anchor, extent, 10); break;
-                    case 34: status = i2d_strtol(&mob->mvp_drop_pre[1], anchor, extent, 10); break;
-                    case 35: status = i2d_strtol(&mob->mvp_drop_id[2], anchor, extent, 10); break;
-                    case 36: status = i2d_strtol(&mob->mvp_drop_pre[2], anchor, extent, 10); break;
-                    case 37: status = i2d_strtol(&mob->drop_id[0], anchor, extent, 10); break;
-                    case 38: status = i2d_strtol(&mob->drop_pre[0], anchor, extent, 10); break;
-                    case 39: status = i2d_strtol(&mob->drop_id[1], anchor, extent, 10); break;
-                    case 40: status = i2d_strtol(&mob->drop_pre[1], anchor, extent, 10); break;
-                    case 41: status = i2d_strtol(&mob->drop_id[2], anchor, extent, 10); break;
-                    case 42: status = i2d_strtol(&mob->drop_pre[2], anchor, extent, 10); break;
-                    case 43: status = i2d_strtol(&mob->drop_id[3], anchor, extent, 10); break;
-                    case 44: status = i2d_strtol(&mob->drop_pre[3], anchor, extent, 10); break;
-                    case 45: status = i2d_strtol(&mob->drop_id[4], anchor, extent, 10); break;
-                    case 46: status = i2d_strtol(&mob->drop_pre[4], anchor, extent, 10); break;
-                    case 47: status = i2d_strtol(&mob->drop_id[5], anchor, extent, 10); break;
-                    case 48: status = i2d_strtol(&mob->drop_pre[5], anchor, extent, 10); break;
-                    case 49: status = i2d_strtol(&mob->drop_id[6], anchor, extent, 10); break;
-                    case 50: status = i2d_strtol(&mob->drop_pre[6], anchor, extent, 10); break;
-                    case 51: status = i2d_strtol(&mob->drop_id[7], anchor, extent, 10); break;
-                    case 52: status = i2d_strtol(&mob->drop_pre[7], anchor, extent, 10); break;
-                    case 53: status = i2d_strtol(&mob->drop_id[8], anchor, extent, 10); break;
-                    case 54: status = i2d_strtol(&mob->drop_pre[8], anchor, extent, 10); break;
-                    case 55: status = i2d_strtol(&mob->drop_card_id, anchor, extent, 10); break;
-                    case 56: status = i2d_strtol(&mob->drop_card_per, anchor, extent, 10); break;
-                    default: status = i2d_panic("row has too many columns"); break;
-                }
-                field++;
-            }
-
-            anchor = (string + i + 1);
+    mob->hash = i2d_fnv1a(I2D_FNV_OFFSET, string, length);
+
+    i2d_split_create(&split, string, length, 0);
+    while(!status && !i2d_split_next(&split, &anchor, &extent)) {
+        switch(field) {
+            case 0: status = i2d_strtol(&mob->id, anchor, extent, 10); break;
+            case 1: status = i2d_intern_get(anchor, extent, &mob->sprite); break;
+            case 2: status = i2d_intern_get(anchor, extent, &mob->kro); break;
+            case 3: status = i2d_intern_get(anchor, extent, &mob->iro); break;
+            case 4: status = i2d_strtol(&mob->level, anchor, extent, 10); break;
+            case 5: status = i2d_strtol(&mob->hp, anchor, extent, 10); break;
+            case 6: status = i2d_strtol(&mob->sp, anchor, extent, 10); break;
+            case 7: status = i2d_strtol(&mob->exp, anchor, extent, 10); break;
+            case 8: status = i2d_strtol(&mob->jexp, anchor, extent, 10); break;
+            case 9: status = i2d_strtol(&mob->range1, anchor, extent, 10); break;
+            case 10: status = i2d_strtol(&mob->atk1, anchor, extent, 10); break;
+            case 11: status = i2d_strtol(&mob->atk2, anchor, extent, 10); break;
+            case 12: status = i2d_strtol(&mob->def, anchor, extent, 10); break;
+            case 13: status = i2d_strtol(&mob->mdef, anchor, extent, 10); break;
+            case 14: status = i2d_strtol(&mob->str, anchor, extent, 10); break;
+            case 15: status = i2d_strtol(&mob->agi, anchor, extent, 10); break;
+            case 16: status = i2d_strtol(&mob->vit, anchor, extent, 10); break;
+            case 17: status = i2d_strtol(&mob->inte, anchor, extent, 10); break;
+            case 18: status = i2d_strtol(&mob->dex, anchor, extent, 10); break;
+            case 19: status = i2d_strtol(&mob->luk, anchor, extent, 10); break;
+            case 20: status = i2d_strtol(&mob->range2, anchor, extent, 10); break;
+            case 21: status = i2d_strtol(&mob->range3, anchor, extent, 10); break;
+            case 22: status = i2d_strtol(&mob->scale, anchor, extent, 10); break;
+            case 23: status = i2d_strtol(&mob->race, anchor, extent, 10); break;
+            case 24: status = i2d_strtol(&mob->element, anchor, extent, 10); break;
+            case 25: status = i2d_strtol(&mob->mode, anchor, extent, 16); break;
+            case 26: status = i2d_strtol(&mob->speed, anchor, extent, 10); break;
+            case 27: status = i2d_strtol(&mob->adelay, anchor, extent, 10); break;
+            case 28: status = i2d_strtol(&mob->amotion, anchor, extent, 10); break;
+            case 29: status = i2d_strtol(&mob->dmotion, anchor, extent, 10); break;
+            case 30: status = i2d_strtod(&mob->mexp, anchor, extent); break;
+            case 31: status = i2d_strtol(&mob->mvp_drop_id[0], anchor, extent, 10); break;
+            case 32: status = i2d_strtol(&mob->mvp_drop_pre[0], anchor, extent, 10); break;
+            case 33: status = i2d_strtol(&mob->mvp_drop_id[1], anchor, extent, 10); break;
+            case 34: status = i2d_strtol(&mob->mvp_drop_pre[1], anchor, extent, 10); break;
+            case 35: status = i2d_strtol(&mob->mvp_drop_id[2], anchor, extent, 10); break;
+            case 36: status = i2d_strtol(&mob->mvp_drop_pre[2], anchor, extent, 10); break;
+            case 37: status = i2d_strtol(&mob->drop_id[0], anchor, extent, 10); break;
+            case 38: status = i2d_strtol(&mob->drop_pre[0], anchor, extent, 10); break;
+            case 39: status = i2d_strtol(&mob->drop_id[1], anchor, extent, 10); break;
+            case 40: status = i2d_strtol(&mob->drop_pre[1], anchor, extent, 10); break;
+            case 41: status = i2d_strtol(&mob->drop_id[2], anchor, extent, 10); break;
+            case 42: status = i2d_strtol(&mob->drop_pre[2], anchor, extent, 10); break;
+            case 43: status = i2d_strtol(&mob->drop_id[3], anchor, extent, 10); break;
+            case 44: status = i2d_strtol(&mob->drop_pre[3], anchor, extent, 10); break;
+            case 45: status = i2d_strtol(&mob->drop_id[4], anchor, extent, 10); break;
+            case 46: status = i2d_strtol(&mob->drop_pre[4], anchor, extent, 10); break;
+            case 47: status = i2d_strtol(&mob->drop_id[5], anchor, extent, 10); break;
+            case 48: status = i2d_strtol(&mob->drop_pre[5], anchor, extent, 10); break;
+            case 49: status = i2d_strtol(&mob->drop_id[6], anchor, extent, 10); break;
+            case 50: status = i2d_strtol(&mob->drop_pre[6], anchor, extent, 10); break;
+            case 51: status = i2d_strtol(&mob->drop_id[7], anchor, extent, 10); break;
+            case 52: status = i2d_strtol(&mob->drop_pre[7], anchor, extent, 10); break;
+            case 53: status = i2d_strtol(&mob->drop_id[8], anchor, extent, 10); break;
+            case 54: status = i2d_strtol(&mob->drop_pre[8], anchor, extent, 10); break;
+            case 55: status = i2d_strtol(&mob->drop_card_id, anchor, extent, 10); break;
+            case 56: status = i2d_strtol(&mob->drop_card_per, anchor, extent, 10); break;
+            default: status = i2d_panic("row has too many columns"); break;
         }
+        field++;
     }
 
     if(!status && 57 != field)
@@ -174,16 +196,20 @@ int i2d_mob_db_init(i2d_mob_db ** result, i2d_string * path) {
     if(i2d_is_invalid(result) || !path) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_fd_load(path, i2d_mob_db_parse, object)) {
+            if(i2d_string_suffix(path, ".yml")) {
+                if(i2d_mob_db_load_yml(object, path))
+                    status = i2d_panic("failed to load mob db -- %s", path->string);
+            } else if(i2d_fd_load(path, i2d_mob_db_parse, object)) {
                 status = i2d_panic("failed to load mob db");
-            } else if(i2d_mob_db_index(object)) {
-                status = i2d_panic("failed to index mob db");
             }
 
+            if(!status && i2d_mob_db_index(object))
+                status = i2d_panic("failed to index mob db");
+
             if(status)
                 i2d_mob_db_deit(&object);
             else
@@ -199,6 +225,7 @@ void i2d_mob_db_deit(i2d_mob_db ** result) {
     i2d_mob * mob;
 
     object = *result;
+    i2d_table_destroy(&object->table_by_id);
     i2d_deit(object->index_by_id, i2d_rbt_deit);
     if(object->list) {
         while(object->list != object->list->next) {
@@ -232,26 +259,240 @@ static int i2d_mob_db_parse(char * string, size_t length, void * data) {
     return status;
 }
 
+static int i2d_mob_yml_init(i2d_mob ** result) {
+    int status = I2D_OK;
+    i2d_mob * object;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            object->level = 1;
+            object->hp = 1;
+            object->speed = 150;
+            object->hash = I2D_FNV_OFFSET;
+            object->next = object;
+            object->prev = object;
+
+            if(status)
+                i2d_mob_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+static int i2d_mob_parse_yml(i2d_mob_yml * load, i2d_yaml_record * record) {
+    int status = I2D_OK;
+    i2d_mob * mob = load->mob;
+    i2d_mob * exist = NULL;
+    const char * key = record->key;
+
+    if(!strcmp(key, "Id")) {
+        /*
+         * an imported file can update a mob by
+         * id so the id must precede other fields
+         */
+        if(load->fields) {
+            status = i2d_panic("mob id must be the first field");
+        } else if(i2d_yaml_get_number(record, &mob->id)) {
+            status = i2d_panic("failed to get mob id");
+        } else if(!i2d_rbt_search(load->index, &mob->id, (void **) &exist)) {
+            i2d_mob_deit(&load->mob);
+            load->mob = exist;
+            load->exist = 1;
+            load->element = exist->element % 20;
+            load->element_level = exist->element / 20;
+        }
+    } else if(!load->fields) {
+        status = i2d_panic("mob is missing id");
+    } else if(!strcmp(key, "AegisName")) {
+        status = i2d_intern_get(record->value, record->length, &mob->sprite);
+    } else if(!strcmp(key, "Name")) {
+        status = i2d_intern_get(record->value, record->length, &mob->kro);
+    } else if(!strcmp(key, "JapaneseName")) {
+        status = i2d_intern_get(record->value, record->length, &mob->iro);
+    } else if(!strcmp(key, "Level")) {
+        status = i2d_yaml_get_number(record, &mob->level);
+    } else if(!strcmp(key, "Hp")) {
+        status = i2d_yaml_get_number(record, &mob->hp);
+    } else if(!strcmp(key, "Sp")) {
+        status = i2d_yaml_get_number(record, &mob->sp);
+    } else if(!strcmp(key, "BaseExp")) {
+        status = i2d_yaml_get_number(record, &mob->exp);
+    } else if(!strcmp(key, "JobExp")) {
+        status = i2d_yaml_get_number(record, &mob->jexp);
+    } else if(!strcmp(key, "MvpExp")) {
+        if(i2d_strtod(&mob->mexp, record->value, record->length))
+            status = i2d_panic("failed to get mvp exp");
+    } else if(!strcmp(key, "Attack")) {
+        status = i2d_yaml_get_number(record, &mob->atk1);
+    } else if(!strcmp(key, "Attack2")) {
+        status = i2d_yaml_get_number(record, &mob->atk2);
+    } else if(!strcmp(key, "Defense")) {
+        status = i2d_yaml_get_number(record, &mob->def);
+    } else if(!strcmp(key, "MagicDefense")) {
+        status = i2d_yaml_get_number(record, &mob->mdef);
+    } else if(!strcmp(key, "Str")) {
+        status = i2d_yaml_get_number(record, &mob->str);
+    } else if(!strcmp(key, "Agi")) {
+        status = i2d_yaml_get_number(record, &mob->agi);
+    } else if(!strcmp(key, "Vit")) {
+        status = i2d_yaml_get_number(record, &mob->vit);
+    } else if(!strcmp(key, "Int")) {
+        status = i2d_yaml_get_number(record, &mob->inte);
+    } else if(!strcmp(key, "Dex")) {
+        status = i2d_yaml_get_number(record, &mob->dex);
+    } else if(!strcmp(key, "Luk")) {
+        status = i2d_yaml_get_number(record, &mob->luk);
+    } else if(!strcmp(key, "AttackRange")) {
+        status = i2d_yaml_get_number(record, &mob->range1);
+    } else if(!strcmp(key, "SkillRange")) {
+        status = i2d_yaml_get_number(record, &mob->range2);
+    } else if(!strcmp(key, "ChaseRange")) {
+        status = i2d_yaml_get_number(record, &mob->range3);
+    } else if(!strcmp(key, "Size")) {
+        status = i2d_yaml_get_constant(i2d_mob_size_list, i2d_size(i2d_mob_size_list), record->value, &mob->scale);
+    } else if(!strcmp(key, "Race")) {
+        status = i2d_yaml_get_constant(i2d_mob_race_list, i2d_size(i2d_mob_race_list), record->value, &mob->race);
+    } else if(!strcmp(key, "Element")) {
+        status = i2d_yaml_get_constant(i2d_mob_element_list, i2d_size(i2d_mob_element_list), record->value, &load->element);
+    } else if(!strcmp(key, "ElementLevel")) {
+        status = i2d_yaml_get_number(record, &load->element_level);
+    } else if(!strcmp(key, "WalkSpeed")) {
+        status = i2d_yaml_get_number(record, &mob->speed);
+    } else if(!strcmp(key, "AttackDelay")) {
+        status = i2d_yaml_get_number(record, &mob->adelay);
+    } else if(!strcmp(key, "AttackMotion")) {
+        status = i2d_yaml_get_number(record, &mob->amotion);
+    } else if(!strcmp(key, "DamageMotion")) {
+        status = i2d_yaml_get_number(record, &mob->dmotion);
+    }
+
+    if(!status)
+        load->fields++;
+
+    return status;
+}
+
+static int i2d_mob_db_parse_yml_end(i2d_mob_yml * load) {
+    int status = I2D_OK;
+    i2d_mob_db * mob_db = load->mob_db;
+    i2d_mob * mob = load->mob;
+
+    if(!mob->sprite.string || !mob->kro.string) {
+        status = i2d_panic("mob is missing aegis name or name -- %ld", mob->id);
+    } else {
+        if(!mob->iro.string)
+            mob->iro = mob->kro;
+
+        /*
+         * the txt element is the element level
+         * times twenty plus the element
+         */
+        mob->element = load->element_level * 20 + load->element;
+
+        if(!load->exist) {
+            if(!mob_db->list) {
+                mob_db->list = mob;
+            } else {
+                i2d_mob_append(mob, mob_db->list);
+            }
+
+            mob_db->size++;
+
+            if(i2d_rbt_insert(load->index, &mob->id, mob))
+                status = i2d_panic("failed to index mob by id -- %ld", mob->id);
+        }
+
+        load->mob = NULL;
+    }
+
+    return status;
+}
+
+static int i2d_mob_db_parse_yml(i2d_yaml_record * record, void * data) {
+    int status = I2D_OK;
+    i2d_mob_yml * load = data;
+
+    switch(record->type) {
+        case i2d_yaml_record_start:
+            load->exist = 0;
+            load->fields = 0;
+            load->element = 0;
+            load->element_level = 1;
+
+            if(i2d_mob_yml_init(&load->mob))
+                status = i2d_panic("failed to create mob object");
+            break;
+        case i2d_yaml_record_field:
+            if(i2d_mob_parse_yml(load, record)) {
+                status = i2d_panic("failed to load mob -- %ld", load->mob->id);
+            } else {
+                load->mob->hash = i2d_yaml_hash(record, load->mob->hash);
+            }
+            break;
+        case i2d_yaml_record_end:
+            status = i2d_mob_db_parse_yml_end(load);
+            break;
+    }
+
+    return status;
+}
+
+static int i2d_mob_db_load_yml(i2d_mob_db * mob_db, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_mob_yml load;
+
+    i2d_zero(load);
+    load.mob_db = mob_db;
+
+    if(i2d_rbt_init(&load.index, i2d_rbt_cmp_long)) {
+        status = i2d_panic("failed to create red black tree object");
+    } else {
+        if(i2d_yaml_map(path, i2d_mob_db_parse_yml, &load))
+            status = i2d_panic("failed to map mob db -- %s", path->string);
+
+        if(load.mob && !load.exist)
+            i2d_mob_deit(&load.mob);
+
+        i2d_rbt_deit(&load.index);
+    }
+
+    return status;
+}
+
 static int i2d_mob_db_index(i2d_mob_db * mob_db) {
     int status = I2D_OK;
     i2d_mob * mob = NULL;
 
-    if(i2d_rbt_init(&mob_db->index_by_id, i2d_rbt_cmp_long)) {
+    if(i2d_rbt_init_static(&mob_db->index_by_id, i2d_rbt_cmp_long)) {
         status = i2d_panic("failed to create red black tree object");
     } else {
         mob = mob_db->list;
         do {
-            if(i2d_rbt_insert(mob_db->index_by_id, &mob->id, mob))
+            if( i2d_rbt_insert(mob_db->index_by_id, &mob->id, mob) ||
+                (i2d_table_range(mob->id) && i2d_table_insert(&mob_db->table_by_id, mob->id, mob)) )
                 status = i2d_panic("failed to index mob by id -- %ld", mob->id);
             mob = mob->next;
         } while(mob != mob_db->list && !status);
+
+        if(!status && i2d_rbt_build(mob_db->index_by_id))
+            status = i2d_panic("failed to build red black tree object");
     }
 
     return status;
 }
 
 int i2d_mob_db_search_by_id(i2d_mob_db * mob_db, long id, i2d_mob ** mob) {
-    return i2d_rbt_search(mob_db->index_by_id, &id, (void **) mob);
+    return i2d_table_range(id) ?
+        i2d_table_search(&mob_db->table_by_id, id, (void **) mob) :
+        i2d_rbt_search(mob_db->index_by_id, &id, (void **) mob);
 }
 
 int i2d_mob_race_init(i2d_mob_race ** result, char * string, size_t length) {
@@ -261,7 +502,7 @@ int i2d_mob_race_init(i2d_mob_race ** result, char * string, size_t length) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -311,7 +552,7 @@ static int i2d_mob_race_parse(i2d_mob_race * mob_race, char * string, size_t len
     if(!comma_count) {
         status = i2d_panic("empty list of mob id");
     } else {
-        mob_race->list = calloc(comma_count, sizeof(*mob_race->list));
+        mob_race->list = i2d_calloc(I2D_TAG_DB, comma_count, sizeof(*mob_race->list));
         if(!mob_race->list) {
             status = i2d_panic("out of memory");
         } else {
@@ -339,7 +580,7 @@ static int i2d_mob_race_parse(i2d_mob_race * mob_race, char * string, size_t len
                     } else {
                         extent = (size_t) (string + i) - (size_t) anchor;
                         switch(field) {
-                            case 0: status = i2d_string_create(&mob_race->macro, anchor, extent); break;
+                            case 0: status = i2d_string_create(I2D_TAG_DB, &mob_race->macro, anchor, extent); break;
                             default:
                                 if(mob_race->size >= comma_count) {
                                     status = i2d_panic("list overflow");
@@ -382,7 +623,7 @@ int i2d_mob_race_db_init(i2d_mob_race_db ** result, i2d_string * path) {
     if(i2d_is_invalid(result) || !path) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -444,7 +685,7 @@ static int i2d_mob_race_db_index(i2d_mob_race_db * mob_race_db) {
     int status = I2D_OK;
     i2d_mob_race * mob_race = NULL;
 
-    if(i2d_rbt_init(&mob_race_db->index_by_macro, i2d_rbt_cmp_str)) {
+    if(i2d_rbt_init_static(&mob_race_db->index_by_macro, i2d_rbt_cmp_str)) {
         status = i2d_panic("failed to create red black tree object");
     } else {
         mob_race = mob_race_db->list;
@@ -453,6 +694,9 @@ static int i2d_mob_race_db_index(i2d_mob_race_db * mob_race_db) {
                 status = i2d_panic("failed to index mob race by macro -- %s", mob_race->macro.string);
             mob_race = mob_race->next;
         } while(mob_race != mob_race_db->list && !status);
+
+        if(!status && i2d_rbt_build(mob_race_db->index_by_macro))
+            status = i2d_panic("failed to build red black tree object");
     }
 
     return status;
@@ -3,6 +3,8 @@
 
 #include "i2d_util.h"
 #include "i2d_rbt.h"
+#include "i2d_intern.h"
+#include "i2d_yaml.h"
 
 struct i2d_mob {
     long id;
@@ -42,6 +44,7 @@ struct i2d_mob {
     long drop_pre[9];
     long drop_card_id;
     long drop_card_per;
+    uint64_t hash;
     struct i2d_mob * next;
     struct i2d_mob * prev;
 };
@@ -57,6 +60,7 @@ struct i2d_mob_db {
     i2d_mob * list;
     size_t size;
     i2d_rbt * index_by_id;
+    i2d_table table_by_id;
 };
 
 typedef struct i2d_mob_db i2d_mob_db;
@@ -1,10 +1,20 @@
 #include "i2d_pet.h"
 
+struct i2d_pet_yml_load {
+    i2d_pet_db * pet_db;
+    i2d_pet_yml * pet;
+};
+
+typedef struct i2d_pet_yml_load i2d_pet_yml_load;
+
 static int i2d_pet_parse(i2d_pet *, char *, size_t);
 static int i2d_pet_db_parse_txt(char *, size_t, void *);
 
-static int i2d_pet_db_parse_yml(i2d_pet_db *, i2d_string *);
-static int i2d_pet_db_parse_yml_cb(yaml_event_t *, void *);
+static int i2d_pet_parse_yml(i2d_pet_yml *, i2d_yaml_record *);
+static int i2d_pet_db_parse_yml(i2d_yaml_record *, void *);
+static int i2d_pet_db_load_yml(i2d_pet_db *, i2d_string *);
+static int i2d_pet_db_resolve_item(i2d_rbt *, i2d_string *, long *);
+static int i2d_pet_db_resolve_pet(i2d_pet_db *, i2d_pet_yml *, i2d_rbt *, i2d_rbt *);
 
 int i2d_pet_init(i2d_pet ** result) {
     int status = I2D_OK;
@@ -13,7 +23,7 @@ int i2d_pet_init(i2d_pet ** result) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -34,10 +44,6 @@ void i2d_pet_deit(i2d_pet ** result) {
     i2d_pet * object;
 
     object = *result;
-    i2d_string_destroy(&object->loyal_script);
-    i2d_string_destroy(&object->pet_script);
-    i2d_string_destroy(&object->jname);
-    i2d_string_destroy(&object->name);
     i2d_free(object);
     *result = NULL;
 }
@@ -45,73 +51,41 @@ void i2d_pet_deit(i2d_pet ** result) {
 static int i2d_pet_parse(i2d_pet * pet, char * string, size_t length) {
     int status = I2D_OK;
 
-    size_t i;
-    int brace_depth = 0;
+    i2d_split split;
 
     char * anchor;
     size_t extent;
 
     int field = 0;
-    int last = 0;
-
-    anchor = string;
-    for(i = 0; i < length && !status && !last; i++) {
-        switch(string[i]) {
-            case '{': brace_depth++; break;
-            case '}': brace_depth--; break;
-            default:
-                /*
-                 * check for \t, \r, \n (exclude space)
-                 */
-                if(i2d_isspace(string[i]) && ' ' != string[i])
-                    last = 1;
-
-                /*
-                 * check for line comments
-                 */
-                if('/' == string[i] && i > 0 && '/' == string[i - 1]) {
-                    i -= 1;
-                    last = 1;
-                }
 
-                if((',' == string[i] || last) && !brace_depth) {
-                    string[i] = 0;
-
-                    if(string + i < anchor) {
-                        status = i2d_panic("line overflow");
-                    } else {
-                        extent = (size_t) (string + i) - (size_t) anchor;
-                        switch(field) {
-                            case 0: status = i2d_strtol(&pet->id, anchor, extent, 10); break;
-                            case 1: status = i2d_string_create(&pet->name, anchor, extent); break;
-                            case 2: status = i2d_string_create(&pet->jname, anchor, extent); break;
-                            case 3: status = i2d_strtol(&pet->lure_id, anchor, extent, 10); break;
-                            case 4: status = i2d_strtol(&pet->egg_id, anchor, extent, 10); break;
-                            case 5: status = i2d_strtol(&pet->equip_id, anchor, extent, 10); break;
-                            case 6: status = i2d_strtol(&pet->food_id, anchor, extent, 10); break;
-                            case 7: status = i2d_strtol(&pet->fullness, anchor, extent, 10); break;
-                            case 8: status = i2d_strtol(&pet->hungry_delay, anchor, extent, 10); break;
-                            case 9: status = i2d_strtol(&pet->r_hungry, anchor, extent, 10); break;
-                            case 10: status = i2d_strtol(&pet->r_full, anchor, extent, 10); break;
-                            case 11: status = i2d_strtol(&pet->intimate, anchor, extent, 10); break;
-                            case 12: status = i2d_strtol(&pet->die, anchor, extent, 10); break;
-                            case 13: status = i2d_strtol(&pet->capture, anchor, extent, 10); break;
-                            case 14: status = i2d_strtol(&pet->speed, anchor, extent, 10); break;
-                            case 15: status = i2d_strtol(&pet->s_performance, anchor, extent, 10); break;
-                            case 16: status = i2d_strtol(&pet->talk_convert_class, anchor, extent, 10); break;
-                            case 17: status = i2d_strtol(&pet->attack_rate, anchor, extent, 10); break;
-                            case 18: status = i2d_strtol(&pet->defence_attack_rate, anchor, extent, 10); break;
-                            case 19: status = i2d_strtol(&pet->change_target_rate, anchor, extent, 10); break;
-                            case 20: status = i2d_string_create(&pet->pet_script, anchor, extent); break;
-                            case 21: status = i2d_string_create(&pet->loyal_script, anchor, extent); break;
-                            default: status = i2d_panic("row has too many columns"); break;
-                        }
-                        field++;
-                    }
-
-                    anchor = (string + i + 1);
-                }
+    i2d_split_create(&split, string, length, I2D_SPLIT_BRACE);
+    while(!status && !i2d_split_next(&split, &anchor, &extent)) {
+        switch(field) {
+            case 0: status = i2d_strtol(&pet->id, anchor, extent, 10); break;
+            case 1: status = i2d_intern_get(anchor, extent, &pet->name); break;
+            case 2: status = i2d_intern_get(anchor, extent, &pet->jname); break;
+            case 3: status = i2d_strtol(&pet->lure_id, anchor, extent, 10); break;
+            case 4: status = i2d_strtol(&pet->egg_id, anchor, extent, 10); break;
+            case 5: status = i2d_strtol(&pet->equip_id, anchor, extent, 10); break;
+            case 6: status = i2d_strtol(&pet->food_id, anchor, extent, 10); break;
+            case 7: status = i2d_strtol(&pet->fullness, anchor, extent, 10); break;
+            case 8: status = i2d_strtol(&pet->hungry_delay, anchor, extent, 10); break;
+            case 9: status = i2d_strtol(&pet->r_hungry, anchor, extent, 10); break;
+            case 10: status = i2d_strtol(&pet->r_full, anchor, extent, 10); break;
+            case 11: status = i2d_strtol(&pet->intimate, anchor, extent, 10); break;
+            case 12: status = i2d_strtol(&pet->die, anchor, extent, 10); break;
+            case 13: status = i2d_strtol(&pet->capture, anchor, extent, 10); break;
+            case 14: status = i2d_strtol(&pet->speed, anchor, extent, 10); break;
+            case 15: status = i2d_strtol(&pet->s_performance, anchor, extent, 10); break;
+            case 16: status = i2d_strtol(&pet->talk_convert_class, anchor, extent, 10); break;
+            case 17: status = i2d_strtol(&pet->attack_rate, anchor, extent, 10); break;
+            case 18: status = i2d_strtol(&pet->defence_attack_rate, anchor, extent, 10); break;
+            case 19: status = i2d_strtol(&pet->change_target_rate, anchor, extent, 10); break;
+            case 20: status = i2d_intern_get(anchor, extent, &pet->pet_script); break;
+            case 21: status = i2d_intern_get(anchor, extent, &pet->loyal_script); break;
+            default: status = i2d_panic("row has too many columns"); break;
         }
+        field++;
     }
 
     if(!status && 22 != field)
@@ -141,7 +115,7 @@ int i2d_pet_item_init(i2d_pet_item ** result) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -189,7 +163,7 @@ int i2d_pet_evolution_init(i2d_pet_evolution ** result) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -246,7 +220,7 @@ int i2d_pet_yml_init(i2d_pet_yml ** result) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -326,7 +300,8 @@ static int i2d_pet_db_parse_txt(char * string, size_t length, void * data) {
         } else {
             i2d_pet_append(pet, pet_db->list);
 
-            if(i2d_rbt_insert(pet_db->index, &pet->id, pet))
+            if( i2d_rbt_insert(pet_db->index, &pet->id, pet) ||
+                (i2d_table_range(pet->id) && i2d_table_insert(&pet_db->table_by_id, pet->id, pet)) )
                 status = i2d_panic("failed to index pet by id -- %ld", pet->id);
         }
     }
@@ -334,37 +309,277 @@ static int i2d_pet_db_parse_txt(char * string, size_t length, void * data) {
     return status;
 }
 
-static int i2d_pet_db_parse_yml(i2d_pet_db * pet_db, i2d_string * path) {
+static int i2d_pet_parse_yml(i2d_pet_yml * pet, i2d_yaml_record * record) {
     int status = I2D_OK;
-
-    if(i2d_yaml_parse(path, i2d_pet_db_parse_yml_cb, NULL))
-        status = i2d_panic("failed to parse yml file -- %s", path->string);
+    const char * key = record->key;
+    i2d_pet_evolution * evolution = NULL;
+    i2d_pet_item * item = NULL;
+    int boolean;
+
+    if(!strcmp(key, "Mob")) {
+        status = i2d_yaml_get_string(record, &pet->mob);
+    } else if(!strcmp(key, "TameItem")) {
+        status = i2d_yaml_get_string(record, &pet->tame_item);
+    } else if(!strcmp(key, "EggItem")) {
+        status = i2d_yaml_get_string(record, &pet->egg_item);
+    } else if(!strcmp(key, "EquipItem")) {
+        status = i2d_yaml_get_string(record, &pet->equip_item);
+    } else if(!strcmp(key, "FoodItem")) {
+        status = i2d_yaml_get_string(record, &pet->food_item);
+    } else if(!strcmp(key, "Fullness")) {
+        status = i2d_yaml_get_number(record, &pet->fullness);
+    } else if(!strcmp(key, "HungryDelay")) {
+        status = i2d_yaml_get_number(record, &pet->hungry_delay);
+    } else if(!strcmp(key, "HungerIncrease")) {
+        status = i2d_yaml_get_number(record, &pet->hungry_increase);
+    } else if(!strcmp(key, "IntimacyStart")) {
+        status = i2d_yaml_get_number(record, &pet->intimacy_start);
+    } else if(!strcmp(key, "IntimacyFed")) {
+        status = i2d_yaml_get_number(record, &pet->intimacy_fed);
+    } else if(!strcmp(key, "IntimacyOverfed")) {
+        status = i2d_yaml_get_number(record, &pet->intimacy_overfed);
+    } else if(!strcmp(key, "IntimacyHungry")) {
+        status = i2d_yaml_get_number(record, &pet->intimacy_hungry);
+    } else if(!strcmp(key, "IntimacyOwnerDie")) {
+        status = i2d_yaml_get_number(record, &pet->intimacy_owner_die);
+    } else if(!strcmp(key, "CaptureRate")) {
+        status = i2d_yaml_get_number(record, &pet->capture_rate);
+    } else if(!strcmp(key, "SpecialPerformance")) {
+        if(i2d_yaml_get_boolean(record, &boolean)) {
+            status = i2d_panic("failed to get boolean");
+        } else {
+            pet->special_performance = boolean;
+        }
+    } else if(!strcmp(key, "AttackRate")) {
+        status = i2d_yaml_get_number(record, &pet->attack_rate);
+    } else if(!strcmp(key, "RetaliateRate")) {
+        status = i2d_yaml_get_number(record, &pet->retaliate_rate);
+    } else if(!strcmp(key, "ChangeTargetRate")) {
+        status = i2d_yaml_get_number(record, &pet->change_target_rate);
+    } else if(!strcmp(key, "AllowAutoFeed")) {
+        if(i2d_yaml_get_boolean(record, &boolean)) {
+            status = i2d_panic("failed to get boolean");
+        } else {
+            pet->allow_auto_feed = boolean;
+        }
+    } else if(!strcmp(key, "Script")) {
+        status = i2d_yaml_get_script(record, &pet->script);
+    } else if(!strcmp(key, "SupportScript")) {
+        status = i2d_yaml_get_script(record, &pet->support_script);
+    } else if(!strcmp(key, "Evolution.Target")) {
+        if(!pet->evolution_list && i2d_pet_evolution_init(&pet->evolution_list)) {
+            status = i2d_panic("failed to create pet evolution object");
+        } else if(i2d_pet_evolution_init(&evolution)) {
+            status = i2d_panic("failed to create pet evolution object");
+        } else {
+            i2d_pet_evolution_append(evolution, pet->evolution_list);
+            status = i2d_yaml_get_string(record, &evolution->target);
+        }
+    } else if(!strcmp(key, "Evolution.ItemRequirements.Item")) {
+        evolution = pet->evolution_list ? pet->evolution_list->prev : NULL;
+        if(!evolution || evolution == pet->evolution_list) {
+            status = i2d_panic("pet evolution is missing target");
+        } else if(!evolution->item_list && i2d_pet_item_init(&evolution->item_list)) {
+            status = i2d_panic("failed to create pet item object");
+        } else if(i2d_pet_item_init(&item)) {
+            status = i2d_panic("failed to create pet item object");
+        } else {
+            i2d_pet_item_append(item, evolution->item_list);
+            status = i2d_yaml_get_string(record, &item->item);
+        }
+    } else if(!strcmp(key, "Evolution.ItemRequirements.Amount")) {
+        evolution = pet->evolution_list ? pet->evolution_list->prev : NULL;
+        item = evolution && evolution->item_list ? evolution->item_list->prev : NULL;
+        if(!item || item == evolution->item_list) {
+            status = i2d_panic("pet evolution is missing item");
+        } else {
+            status = i2d_yaml_get_number(record, &item->amount);
+        }
+    }
 
     return status;
 }
 
-static int i2d_pet_db_parse_yml_cb(yaml_event_t * event, void * context) {
+static int i2d_pet_db_parse_yml(i2d_yaml_record * record, void * data) {
     int status = I2D_OK;
+    i2d_pet_yml_load * load = data;
 
-    switch(event->type) {
-        case YAML_STREAM_START_EVENT:
-        case YAML_DOCUMENT_START_EVENT:
-        case YAML_STREAM_END_EVENT:
-        case YAML_DOCUMENT_END_EVENT:
-        case YAML_ALIAS_EVENT:
-        case YAML_SCALAR_EVENT:
-        case YAML_SEQUENCE_START_EVENT:
-        case YAML_SEQUENCE_END_EVENT:
-        case YAML_MAPPING_START_EVENT:
-        case YAML_MAPPING_END_EVENT:
-        default:
-            status = i2d_panic("unsupport event type -- %d", event->type);
+    switch(record->type) {
+        case i2d_yaml_record_start:
+            if(i2d_pet_yml_init(&load->pet))
+                status = i2d_panic("failed to create pet object");
+            break;
+        case i2d_yaml_record_field:
+            if(i2d_pet_parse_yml(load->pet, record))
+                status = i2d_panic("failed to load pet -- %s", load->pet->mob.string ? load->pet->mob.string : "");
+            break;
+        case i2d_yaml_record_end:
+            if(!load->pet->mob.string) {
+                status = i2d_panic("pet is missing mob");
+            } else if( (!load->pet->script.string && i2d_string_create(I2D_TAG_DB, &load->pet->script, "{}", 2)) ||
+                       (!load->pet->support_script.string && i2d_string_create(I2D_TAG_DB, &load->pet->support_script, "{}", 2)) ) {
+                status = i2d_panic("failed to create string object");
+            } else {
+                i2d_pet_yml_append(load->pet, load->pet_db->yml_list);
+                load->pet = NULL;
+            }
             break;
     }
 
     return status;
 }
 
+static int i2d_pet_db_load_yml(i2d_pet_db * pet_db, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_pet_yml_load load;
+
+    i2d_zero(load);
+    load.pet_db = pet_db;
+
+    if(i2d_pet_yml_init(&pet_db->yml_list)) {
+        status = i2d_panic("failed to create pet object");
+    } else {
+        if(i2d_yaml_map(path, i2d_pet_db_parse_yml, &load))
+            status = i2d_panic("failed to map pet db -- %s", path->string);
+
+        if(load.pet)
+            i2d_pet_yml_deit(&load.pet);
+    }
+
+    return status;
+}
+
+static int i2d_pet_db_resolve_item(i2d_rbt * index, i2d_string * name, long * result) {
+    int status = I2D_OK;
+    i2d_item_entry * item;
+
+    if(!name->string) {
+        *result = 0;
+    } else if(i2d_rbt_search(index, name->string, (void **) &item)) {
+        status = i2d_panic("failed to get item by aegis name -- %s", name->string);
+    } else {
+        *result = item->id;
+    }
+
+    return status;
+}
+
+static int i2d_pet_db_resolve_pet(i2d_pet_db * pet_db, i2d_pet_yml * pet_yml, i2d_rbt * mob_index, i2d_rbt * item_index) {
+    int status = I2D_OK;
+    i2d_pet * pet = NULL;
+    i2d_pet * exist = NULL;
+    i2d_mob * mob;
+
+    if(i2d_rbt_search(mob_index, pet_yml->mob.string, (void **) &mob)) {
+        status = i2d_panic("failed to get mob by aegis name -- %s", pet_yml->mob.string);
+    } else if(i2d_pet_init(&pet)) {
+        status = i2d_panic("failed to create pet object");
+    } else {
+        /*
+         * the hunger and intimacy changes are
+         * positive amounts in the txt database
+         */
+        pet->id = mob->id;
+        pet->fullness = pet_yml->fullness;
+        pet->hungry_delay = pet_yml->hungry_delay;
+        pet->r_hungry = pet_yml->intimacy_fed;
+        pet->r_full = -pet_yml->intimacy_overfed;
+        pet->intimate = pet_yml->intimacy_start;
+        pet->die = -pet_yml->intimacy_owner_die;
+        pet->capture = pet_yml->capture_rate;
+        pet->s_performance = pet_yml->special_performance;
+        pet->attack_rate = pet_yml->attack_rate;
+        pet->defence_attack_rate = pet_yml->retaliate_rate;
+        pet->change_target_rate = pet_yml->change_target_rate;
+
+        if( i2d_intern_get(mob->sprite.string, mob->sprite.length, &pet->name) ||
+            i2d_intern_get(mob->kro.string, mob->kro.length, &pet->jname) ) {
+            status = i2d_panic("failed to create string object");
+        } else if( i2d_intern_get(pet_yml->support_script.string, pet_yml->support_script.length, &pet->pet_script) ||
+                   i2d_intern_get(pet_yml->script.string, pet_yml->script.length, &pet->loyal_script) ) {
+            status = i2d_panic("failed to create string object");
+        } else if( i2d_pet_db_resolve_item(item_index, &pet_yml->tame_item, &pet->lure_id) ||
+                   i2d_pet_db_resolve_item(item_index, &pet_yml->egg_item, &pet->egg_id) ||
+                   i2d_pet_db_resolve_item(item_index, &pet_yml->equip_item, &pet->equip_id) ||
+                   i2d_pet_db_resolve_item(item_index, &pet_yml->food_item, &pet->food_id) ) {
+            status = i2d_panic("failed to resolve pet items -- %s", pet_yml->mob.string);
+        }
+
+        if(status) {
+            i2d_pet_deit(&pet);
+        } else {
+            /*
+             * a later record of the same mob replaces
+             * the earlier record like an import does
+             */
+            if(!i2d_rbt_search(pet_db->index, &pet->id, (void **) &exist)) {
+                if(i2d_rbt_delete(pet_db->index, &pet->id)) {
+                    status = i2d_panic("failed to delete pet by id -- %ld", exist->id);
+                } else {
+                    i2d_pet_remove(exist);
+                    i2d_pet_deit(&exist);
+                }
+            }
+
+            i2d_pet_append(pet, pet_db->list);
+
+            /* the table slot of a replaced pet is overwritten */
+            if(!status && i2d_rbt_insert(pet_db->index, &pet->id, pet))
+                status = i2d_panic("failed to index pet by id -- %ld", pet->id);
+            else if(!status && i2d_table_range(pet->id) && i2d_table_insert(&pet_db->table_by_id, pet->id, pet))
+                status = i2d_panic("failed to index pet by id -- %ld", pet->id);
+        }
+    }
+
+    return status;
+}
+
+/*
+ * pets in the yml database refer to mobs and
+ * items by aegis name, which can be resolved
+ * after the mob and item databases are loaded
+ */
+int i2d_pet_db_resolve(i2d_pet_db * pet_db, i2d_mob_db * mob_db, i2d_item_db * item_db) {
+    int status = I2D_OK;
+    i2d_rbt * mob_index = NULL;
+    i2d_rbt * item_index = NULL;
+    i2d_mob * mob;
+    i2d_item_entry * item;
+    i2d_pet_yml * pet_yml;
+    size_t i;
+
+    if(pet_db->yml_list) {
+        if( i2d_rbt_init(&mob_index, i2d_rbt_cmp_str) ||
+            i2d_rbt_init(&item_index, i2d_rbt_cmp_str) ) {
+            status = i2d_panic("failed to create red black tree object");
+        } else {
+            mob = mob_db->list;
+            do {
+                if(i2d_rbt_insert(mob_index, mob->sprite.string, mob))
+                    status = i2d_panic("failed to index mob by aegis name -- %s", mob->sprite.string);
+                mob = mob->next;
+            } while(mob != mob_db->list && !status);
+
+            for(i = 0; i < item_db->size && !status; i++) {
+                item = &item_db->entries[i];
+                if(i2d_rbt_insert(item_index, item->aegis_name.string, item))
+                    status = i2d_panic("failed to index item by aegis name -- %s", item->aegis_name.string);
+            }
+
+            pet_yml = pet_db->yml_list->next;
+            while(pet_yml != pet_db->yml_list && !status) {
+                if(i2d_pet_db_resolve_pet(pet_db, pet_yml, mob_index, item_index))
+                    status = i2d_panic("failed to resolve pet -- %s", pet_yml->mob.string);
+                pet_yml = pet_yml->next;
+            }
+        }
+        i2d_deit(item_index, i2d_rbt_deit);
+        i2d_deit(mob_index, i2d_rbt_deit);
+    }
+
+    return status;
+}
+
 int i2d_pet_db_init(i2d_pet_db ** result, i2d_string * path) {
     int status = I2D_OK;
     i2d_pet_db * object;
@@ -372,7 +587,7 @@ int i2d_pet_db_init(i2d_pet_db ** result, i2d_string * path) {
     if(i2d_is_invalid(result) || !path) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -381,11 +596,11 @@ int i2d_pet_db_init(i2d_pet_db ** result, i2d_string * path) {
             } else if(i2d_rbt_init(&object->index, i2d_rbt_cmp_long)) {
                 status = i2d_panic("failed to create red black tree object");
             } else {
-                if(strstr(path->string, ".txt")) {
+                if(i2d_string_suffix(path, ".txt")) {
                     if(i2d_fd_load(path, i2d_pet_db_parse_txt, object))
                         status = i2d_panic("failed to load pet db -- %s", path->string);
-                } else if(strstr(path->string, ".yml")) {
-                    if(i2d_pet_db_parse_yml(object, path))
+                } else if(i2d_string_suffix(path, ".yml")) {
+                    if(i2d_pet_db_load_yml(object, path))
                         status = i2d_panic("failed to load pet db -- %s", path->string);
                 } else {
                     status = i2d_panic("unsupport file format -- %s", path->string);
@@ -405,8 +620,18 @@ int i2d_pet_db_init(i2d_pet_db ** result, i2d_string * path) {
 void i2d_pet_db_deit(i2d_pet_db ** result) {
     i2d_pet_db * object;
     i2d_pet * pet;
+    i2d_pet_yml * pet_yml;
 
     object = *result;
+    if(object->yml_list) {
+        while(object->yml_list != object->yml_list->next) {
+            pet_yml = object->yml_list->next;
+            i2d_pet_yml_remove(pet_yml);
+            i2d_pet_yml_deit(&pet_yml);
+        }
+        i2d_pet_yml_deit(&object->yml_list);
+    }
+    i2d_table_destroy(&object->table_by_id);
     i2d_deit(object->index, i2d_rbt_deit);
     if(object->list) {
         while(object->list != object->list->next) {
@@ -421,5 +646,7 @@ void i2d_pet_db_deit(i2d_pet_db ** result) {
 }
 
 int i2d_pet_db_search_by_id(i2d_pet_db * pet_db, long id, i2d_pet ** pet) {
-    return i2d_rbt_search(pet_db->index, &id, (void **) pet);
+    return i2d_table_range(id) ?
+        i2d_table_search(&pet_db->table_by_id, id, (void **) pet) :
+        i2d_rbt_search(pet_db->index, &id, (void **) pet);
 }
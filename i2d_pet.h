@@ -4,6 +4,8 @@
 #include "i2d_util.h"
 #include "i2d_rbt.h"
 #include "i2d_yaml.h"
+#include "i2d_item.h"
+#include "i2d_mob.h"
 
 struct i2d_pet {
     long id;
@@ -104,11 +106,14 @@ void i2d_pet_yml_remove(i2d_pet_yml *);
 struct i2d_pet_db {
     i2d_pet * list;
     i2d_rbt * index;
+    i2d_table table_by_id;
+    i2d_pet_yml * yml_list;
 };
 
 typedef struct i2d_pet_db i2d_pet_db;
 
 int i2d_pet_db_init(i2d_pet_db **, i2d_string *);
 void i2d_pet_db_deit(i2d_pet_db **);
+int i2d_pet_db_resolve(i2d_pet_db *, i2d_mob_db *, i2d_item_db *);
 int i2d_pet_db_search_by_id(i2d_pet_db *, long, i2d_pet **);
 #endif
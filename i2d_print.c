@@ -65,8 +65,10 @@ i2d_item_property item_properties[] = {
 
 static int i2d_print_get_property_integer(i2d_print *, const char *, i2d_item *, long *);
 static int i2d_print_get_property_string(i2d_print *, const char *, i2d_item *, i2d_string *);
+static int i2d_print_cache_add(i2d_print *, long, size_t, size_t);
+static int i2d_print_cache_cmp(const void *, const void *);
 
-typedef int (* i2d_handler_print_cb)(i2d_print *, i2d_data *, i2d_item *, i2d_string_stack *);
+typedef int (* i2d_handler_print_cb)(i2d_print *, i2d_data *, i2d_item *, i2d_rope *);
 
 struct i2d_handler {
     char * name;
@@ -75,18 +77,18 @@ struct i2d_handler {
 
 typedef struct i2d_handler i2d_handler;
 
-static int i2d_handler_general(i2d_print *, i2d_data *, i2d_string *, i2d_string_stack *);
-static int i2d_handler_integer(i2d_print *, i2d_data *, i2d_item *, i2d_string_stack *);
-static int i2d_handler_string(i2d_print *, i2d_data *, i2d_item *, i2d_string_stack *);
-static int i2d_handler_type(i2d_print *, i2d_data *, i2d_item *, i2d_string_stack *);
-static int i2d_handler_job_loop(uint64_t, void *);
-static int i2d_handler_job(i2d_print *, i2d_data *, i2d_item *, i2d_string_stack *);
-static int i2d_handler_class_loop(uint64_t, void *);
-static int i2d_handler_class(i2d_print *, i2d_data *, i2d_item *, i2d_string_stack *);
-static int i2d_handler_gender(i2d_print *, i2d_data *, i2d_item *, i2d_string_stack *);
-static int i2d_handler_location(i2d_print *, i2d_data *, i2d_item *, i2d_string_stack *);
-static int i2d_handler_refine(i2d_print *, i2d_data *, i2d_item *, i2d_string_stack *);
-static int i2d_handler_view(i2d_print *, i2d_data *, i2d_item *, i2d_string_stack *);
+static int i2d_handler_general(i2d_print *, i2d_data *, i2d_string *, i2d_rope *);
+static int i2d_handler_integer(i2d_print *, i2d_data *, i2d_item *, i2d_rope *);
+static int i2d_handler_string(i2d_print *, i2d_data *, i2d_item *, i2d_rope *);
+static int i2d_handler_type(i2d_print *, i2d_data *, i2d_item *, i2d_rope *);
+static int i2d_handler_mask_loop(uint64_t, void *);
+static int i2d_handler_mask(i2d_print *, i2d_rbt *, i2d_value_map *, i2d_value_map *, long, i2d_string *);
+static int i2d_handler_job(i2d_print *, i2d_data *, i2d_item *, i2d_rope *);
+static int i2d_handler_class(i2d_print *, i2d_data *, i2d_item *, i2d_rope *);
+static int i2d_handler_gender(i2d_print *, i2d_data *, i2d_item *, i2d_rope *);
+static int i2d_handler_location(i2d_print *, i2d_data *, i2d_item *, i2d_rope *);
+static int i2d_handler_refine(i2d_print *, i2d_data *, i2d_item *, i2d_rope *);
+static int i2d_handler_view(i2d_print *, i2d_data *, i2d_item *, i2d_rope *);
 
 i2d_handler print_handlers[] = {
     { "integer", i2d_handler_integer },
@@ -104,48 +106,56 @@ int i2d_print_init(i2d_print ** result, i2d_json * json) {
     int status = I2D_OK;
     i2d_print * object;
 
+    i2d_trace_begin("i2d_print_init", 0);
+
     size_t i;
     size_t size;
 
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_PRINT, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_value_map_init(&object->description_by_item_type, json->description_by_item_type, i2d_value_string_stack)) {
+            if(i2d_value_map_init(&object->description_by_item_type, &json->description_by_item_type, i2d_value_string_stack)) {
                 status = i2d_panic("failed to load description_by_item_type ");
-            } else if(i2d_data_map_init(&object->description_of_item_property, data_map_by_name, json->description_of_item_property, NULL)) {
+            } else if(i2d_data_map_init(&object->description_of_item_property, data_map_by_name, &json->description_of_item_property, NULL)) {
                 status = i2d_panic("failed to load description_of_item_property");
             } else if(i2d_rbt_init(&object->print_handlers, i2d_rbt_cmp_str)) {
                 status = i2d_panic("failed to create read black tree object");
             } else if(i2d_rbt_init(&object->item_properties, i2d_rbt_cmp_str)) {
                 status = i2d_panic("failed to create read black tree object");
-            } else if(i2d_buffer_cache_init(&object->buffer_cache)) {
+            } else if(i2d_buffer_cache_init(I2D_TAG_PRINT, &object->buffer_cache)) {
                 status = i2d_panic("failed to create buffer cache object");
-            } else if(i2d_string_stack_cache_init(&object->stack_cache)) {
+            } else if(i2d_string_stack_cache_init(I2D_TAG_PRINT, &object->stack_cache)) {
                 status = i2d_panic("failed to create string stack cache object");
-            } else if(i2d_value_map_init(&object->item_type, json->item_type, i2d_value_string)) {
+            } else if(i2d_rope_create(&object->rope)) {
+                status = i2d_panic("failed to create rope object");
+            } else if(i2d_value_map_init(&object->item_type, &json->item_type, i2d_value_string)) {
                 status = i2d_panic("failed to load item_type");
-            } else if(i2d_value_map_init(&object->item_location, json->item_location, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->item_location, &json->item_location, i2d_value_string)) {
                 status = i2d_panic("failed to load item_location");
-            } else if(i2d_value_map_init(&object->ammo_type, json->ammo_type, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->ammo_type, &json->ammo_type, i2d_value_string)) {
                 status = i2d_panic("failed to load ammo_type");
-            } else if(i2d_value_map_init(&object->weapon_type, json->weapon_type, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->weapon_type, &json->weapon_type, i2d_value_string)) {
                 status = i2d_panic("failed to load weapon_type");
-            } else if(i2d_value_map_init(&object->gender, json->gender, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->gender, &json->gender, i2d_value_string)) {
                 status = i2d_panic("failed to load gender");
-            } else if(i2d_value_map_init(&object->refineable, json->refineable, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->refineable, &json->refineable, i2d_value_string)) {
                 status = i2d_panic("failed to load refineable");
-            } else if(i2d_value_map_init(&object->job, json->job, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->job, &json->job, i2d_value_string)) {
                 status = i2d_panic("failed to load job");
-            } else if(i2d_value_map_init(&object->job_group, json->job_group, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->job_group, &json->job_group, i2d_value_string)) {
                 status = i2d_panic("failed to load job_group");
-            } else if(i2d_value_map_init(&object->class, json->class, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->class, &json->class, i2d_value_string)) {
                 status = i2d_panic("failed to load class");
-            } else if(i2d_value_map_init(&object->class_group, json->class_group, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->class_group, &json->class_group, i2d_value_string)) {
                 status = i2d_panic("failed to load class_group");
+            } else if(i2d_rbt_init(&object->job_masks, i2d_rbt_cmp_long)) {
+                status = i2d_panic("failed to create read black tree object");
+            } else if(i2d_rbt_init(&object->class_masks, i2d_rbt_cmp_long)) {
+                status = i2d_panic("failed to create read black tree object");
             } else {
                 size = i2d_size(print_handlers);
                 for(i = 0; i < size && !status; i++)
@@ -166,13 +176,25 @@ int i2d_print_init(i2d_print ** result, i2d_json * json) {
         }
     }
 
+    i2d_trace_end("i2d_print_init");
+
     return status;
 }
 
 void i2d_print_deit(i2d_print ** result) {
     i2d_print * object;
+    size_t i;
 
     object = *result;
+    i2d_deit(object->cache, i2d_buffer_deit);
+    i2d_free(object->items);
+    for(i = 0; i < object->mask_size; i++) {
+        i2d_string_destroy(&object->masks[i]->string);
+        i2d_free(object->masks[i]);
+    }
+    i2d_free(object->masks);
+    i2d_deit(object->class_masks, i2d_rbt_deit);
+    i2d_deit(object->job_masks, i2d_rbt_deit);
     i2d_deit(object->class_group, i2d_value_map_deit);
     i2d_deit(object->class, i2d_value_map_deit);
     i2d_deit(object->job_group, i2d_value_map_deit);
@@ -183,6 +205,7 @@ void i2d_print_deit(i2d_print ** result) {
     i2d_deit(object->ammo_type, i2d_value_map_deit);
     i2d_deit(object->item_location, i2d_value_map_deit);
     i2d_deit(object->item_type, i2d_value_map_deit);
+    i2d_rope_destroy(&object->rope);
     i2d_deit(object->stack_cache, i2d_string_stack_cache_deit);
     i2d_deit(object->buffer_cache, i2d_buffer_cache_deit);
     i2d_deit(object->item_properties, i2d_rbt_deit);
@@ -195,56 +218,257 @@ void i2d_print_deit(i2d_print ** result) {
 
 int i2d_print_format(i2d_print * print, i2d_item * item) {
     int status = I2D_OK;
-    i2d_buffer * buffer = NULL;
-    i2d_string_stack * stack = NULL;
     i2d_string_stack properties;
     i2d_string * list;
     size_t size;
     size_t i;
     i2d_data * data;
     i2d_handler * handler;
-    i2d_string description;
+    i2d_item ** items;
+    size_t capacity;
+    size_t start;
+    size_t length;
+
+    i2d_trace_begin("i2d_print_format", item->id);
+
+    print->properties = 0;
+    start = print->rope.size;
+    length = print->rope.length;
+
+    if(print->item_size == print->item_capacity) {
+        capacity = print->item_capacity ? print->item_capacity * 2 : BUFFER_SIZE_LARGE;
+        items = i2d_realloc(I2D_TAG_PRINT, print->items, capacity * sizeof(*items));
+        if(!items) {
+            status = i2d_panic("out of memory");
+        } else {
+            print->items = items;
+            print->item_capacity = capacity;
+        }
+    }
+
+    if(status) {
+        /* item is not formatted */
+    } else if(i2d_value_map_get_string_stack(print->description_by_item_type, item->type, &properties)) {
+        status = i2d_panic("failed to get item properties by item type -- %ld", item->type);
+    } else if(i2d_string_stack_get(&properties, &list, &size)) {
+        status = i2d_panic("failed to get item properties from stack");
+    } else {
+        for(i = 0; i < size && !status; i++) {
+            if(i2d_data_map_get(print->description_of_item_property, list[i].string, &data)) {
+                status = i2d_panic("failed to get item property by name -- %s", list[i].string);
+            } else if(i2d_rbt_search(print->print_handlers, data->handler.string, (void **) &handler)) {
+                status = i2d_panic("failed to get handler by name -- %s", data->handler.string);
+            } else if(handler->handler(print, data, item, &print->rope)) {
+                status = I2D_FAIL;
+            }
+        }
+
+        print->items[print->item_size++] = item;
+
+        if(i2d_rope_add(&print->rope, "\n", 1)) {
+            status = i2d_panic("failed to add rope segment");
+        } else if(print->cache && i2d_print_cache_add(print, item->id, start, print->rope.length - length)) {
+            status = i2d_panic("failed to cache item -- %ld", item->id);
+        } else if(print->rope.size >= I2D_ROPE_IOV && i2d_print_flush(print)) {
+            status = i2d_panic("failed to write item -- %ld", item->id);
+        }
+    }
+
+    i2d_trace_end("i2d_print_format");
+
+    return status;
+}
 
-    if(i2d_buffer_cache_get(print->buffer_cache, &buffer)) {
+/*
+ * the rope refers to the descriptions of the
+ * items, which are freed once they are written,
+ * so only the descriptions of the items since
+ * the last flush are in memory at any time
+ */
+int i2d_print_flush(i2d_print * print) {
+    int status = I2D_OK;
+    size_t i;
+
+    if(i2d_rope_write(&print->rope, stdout)) {
+        status = i2d_panic("failed to write rope");
+    } else {
+        for(i = 0; i < print->item_size; i++)
+            i2d_item_reset_description(print->items[i]);
+        print->item_size = 0;
+    }
+
+    return status;
+}
+
+/* keep the output of each item for the cache file */
+int i2d_print_record(i2d_print * print) {
+    int status = I2D_OK;
+
+    if(print->cache) {
+        status = i2d_panic("print is already recorded");
+    } else if(i2d_buffer_init(I2D_TAG_PRINT, &print->cache, BUFFER_SIZE_LARGE)) {
         status = i2d_panic("failed to create buffer object");
+    }
+
+    return status;
+}
+
+/*
+ * write the output of an item of the last run; the
+ * string must outlive the next flush
+ */
+int i2d_print_replay(i2d_print * print, long id, i2d_string * string) {
+    int status = I2D_OK;
+    size_t start;
+
+    start = print->rope.size;
+
+    if(i2d_rope_add(&print->rope, string->string, string->length)) {
+        status = i2d_panic("failed to add rope segment");
+    } else if(print->cache && i2d_print_cache_add(print, id, start, string->length)) {
+        status = i2d_panic("failed to cache item -- %ld", id);
+    } else if(print->rope.size >= I2D_ROPE_IOV && i2d_print_flush(print)) {
+        status = i2d_panic("failed to write item -- %ld", id);
+    }
+
+    return status;
+}
+
+/* the segments of the item are from start to the end of the rope */
+static int i2d_print_cache_add(i2d_print * print, long id, size_t start, size_t length) {
+    int status = I2D_OK;
+    size_t i;
+
+    if(i2d_buffer_printf(print->cache, "%ld\t%zu\n", id, length)) {
+        status = i2d_panic("failed to write buffer object");
+    } else {
+        for(i = start; i < print->rope.size && !status; i++)
+            if(i2d_buffer_memcpy(print->cache, print->rope.list[i].string, print->rope.list[i].length))
+                status = i2d_panic("failed to write buffer object");
+    }
+
+    return status;
+}
+
+int i2d_print_write_cache(i2d_print * print, i2d_string * path) {
+    int status = I2D_OK;
+    FILE * file;
+
+    if(!print->cache) {
+        status = i2d_panic("print is not recorded");
+    } else {
+        file = fopen(path->string, "wb");
+        if(!file) {
+            status = i2d_panic("failed to open file -- %s", path->string);
+        } else {
+            if(print->cache->offset != fwrite(print->cache->buffer, 1, print->cache->offset, file))
+                status = i2d_panic("failed to write file -- %s", path->string);
+            if(fclose(file))
+                status = i2d_panic("failed to close file -- %s", path->string);
+        }
+    }
+
+    return status;
+}
+
+static int i2d_print_cache_cmp(const void * left, const void * right) {
+    const i2d_print_cache_entry * x = left;
+    const i2d_print_cache_entry * y = right;
+
+    return x->id < y->id ? -1 : x->id > y->id ? 1 : 0;
+}
+
+int i2d_print_cache_init(i2d_print_cache ** result, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_print_cache * object;
+    i2d_print_cache_entry * list;
+    size_t capacity;
+    unsigned long length;
+    char * anchor;
+    char * delimit;
+    char * end;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
     } else {
-        if(i2d_string_stack_cache_get(print->stack_cache, &stack)) {
-            status = i2d_panic("failed to create string stack object");
+        object = i2d_calloc(I2D_TAG_PRINT, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
         } else {
-            if(i2d_value_map_get_string_stack(print->description_by_item_type, item->type, &properties)) {
-                status = i2d_panic("failed to get item properties by item type -- %ld", item->type);
-            } else if(i2d_string_stack_get(&properties, &list, &size)) {
-                status = i2d_panic("failed to get item properties from stack");
+            if(i2d_buffer_create(I2D_TAG_PRINT, &object->buffer, BUFFER_SIZE_LARGE)) {
+                status = i2d_panic("failed to create buffer object");
+            } else if(i2d_fd_read_file(path, &object->buffer)) {
+                status = i2d_panic("failed to read file -- %s", path->string);
             } else {
-                for(i = 0; i < size && !status; i++) {
-                    if(i2d_data_map_get(print->description_of_item_property, list[i].string, &data)) {
-                        status = i2d_panic("failed to get item property by name -- %s", list[i].string);
-                    } else if(i2d_rbt_search(print->print_handlers, data->handler.string, (void **) &handler)) {
-                        status = i2d_panic("failed to get handler by name -- %s", data->handler.string);
-                    } else if(handler->handler(print, data, item, stack)) {
-                        status = I2D_FAIL;
+                anchor = object->buffer.buffer;
+                end = anchor + object->buffer.offset;
+                while(anchor < end && !status) {
+                    if(object->size == object->capacity) {
+                        capacity = object->capacity ? object->capacity * 2 : BUFFER_SIZE_LARGE;
+                        list = i2d_realloc(I2D_TAG_PRINT, object->list, capacity * sizeof(*list));
+                        if(!list) {
+                            status = i2d_panic("out of memory");
+                        } else {
+                            object->list = list;
+                            object->capacity = capacity;
+                        }
+                    }
+
+                    delimit = memchr(anchor, '\t', (size_t) (end - anchor));
+                    if(status) {
+                        /* failed to grow the list */
+                    } else if(!delimit || i2d_strtol(&object->list[object->size].id, anchor, (size_t) (delimit - anchor), 10)) {
+                        status = i2d_panic("invalid cache id -- %s", path->string);
+                    } else {
+                        anchor = delimit + 1;
+                        delimit = memchr(anchor, '\n', (size_t) (end - anchor));
+                        if(!delimit || i2d_strtoul(&length, anchor, (size_t) (delimit - anchor), 10) || length > (size_t) (end - delimit - 1)) {
+                            status = i2d_panic("invalid cache length -- %s", path->string);
+                        } else {
+                            object->list[object->size].string.string = delimit + 1;
+                            object->list[object->size].string.length = length;
+                            object->size++;
+                            anchor = delimit + 1 + length;
+                        }
                     }
                 }
-                if(i2d_string_stack_dump_buffer(stack, buffer, "\n")) {
-                    status = i2d_panic("failed to dump string stack to buffer");
-                } else {
-                    i2d_buffer_get(buffer, &description.string, &description.length);
-                    if(i2d_print_format_lua(print, item, &description))
-                        status = i2d_panic("failed to write item in lua format -- %ld", item->id);
-                }
+
+                if(!status && object->size)
+                    qsort(object->list, object->size, sizeof(*object->list), i2d_print_cache_cmp);
             }
-            i2d_string_stack_cache_put(print->stack_cache, &stack);
+
+            if(status)
+                i2d_print_cache_deit(&object);
+            else
+                *result = object;
         }
-        i2d_buffer_cache_put(print->buffer_cache, &buffer);
     }
 
     return status;
 }
 
-int i2d_print_format_lua(i2d_print * print, i2d_item * item, i2d_string * description) {
+void i2d_print_cache_deit(i2d_print_cache ** result) {
+    i2d_print_cache * object;
+
+    object = *result;
+    i2d_free(object->list);
+    i2d_buffer_destroy(&object->buffer);
+    i2d_free(object);
+    *result = NULL;
+}
+
+int i2d_print_cache_search(i2d_print_cache * cache, long id, i2d_string * result) {
     int status = I2D_OK;
+    i2d_print_cache_entry key;
+    i2d_print_cache_entry * entry;
 
-    fprintf(stdout, "%s\n", description->string);
+    key.id = id;
+    entry = cache->size ? bsearch(&key, cache->list, cache->size, sizeof(*cache->list), i2d_print_cache_cmp) : NULL;
+    if(!entry) {
+        status = I2D_FAIL;
+    } else {
+        *result = entry->string;
+    }
 
     return status;
 }
@@ -306,35 +530,23 @@ static int i2d_print_get_property_string(i2d_print * print, const char * propert
     return status;
 }
 
-static int i2d_handler_general(i2d_print * print, i2d_data * data, i2d_string * string, i2d_string_stack * stack) {
+static int i2d_handler_general(i2d_print * print, i2d_data * data, i2d_string * string, i2d_rope * rope) {
     int status = I2D_OK;
-    i2d_string_stack * format = NULL;
-    i2d_buffer * description = NULL;
 
     if(string->length > 0) {
-        if(i2d_string_stack_cache_get(print->stack_cache, &format)) {
-            status = i2d_panic("failed to create string stack object");
+        if(print->properties && i2d_rope_add(rope, "\n", 1)) {
+            status = i2d_panic("failed to add rope segment");
+        } else if(i2d_rope_format(rope, &data->description, string, 1)) {
+            status = i2d_panic("failed to format rope");
         } else {
-            if(i2d_string_stack_push(format, string->string, string->length)) {
-                status = i2d_panic("failed to push buffer on stack");
-            } else if(i2d_buffer_cache_get(print->buffer_cache, &description)) {
-                status = i2d_panic("failed to create buffer object");
-            } else {
-                if(i2d_string_stack_format(format, &data->description, description)) {
-                    status = i2d_panic("failed to format string stack");
-                } else if(i2d_string_stack_push_buffer(stack, description)) {
-                    status = i2d_panic("failed to push buffer on stack");
-                }
-                i2d_buffer_cache_put(print->buffer_cache, &description);
-            }
-            i2d_string_stack_cache_put(print->stack_cache, &format);
+            print->properties++;
         }
     }
 
     return status;
 }
 
-static int i2d_handler_integer(i2d_print * print, i2d_data * data, i2d_item * item, i2d_string_stack * stack) {
+static int i2d_handler_integer(i2d_print * print, i2d_data * data, i2d_item * item, i2d_rope * rope) {
     int status = I2D_OK;
     long integer;
     i2d_buffer * buffer = NULL;
@@ -349,11 +561,12 @@ static int i2d_handler_integer(i2d_print * print, i2d_data * data, i2d_item * it
         if(i2d_buffer_cache_get(print->buffer_cache, &buffer)) {
             status = i2d_panic("failed to create buffer object");
         } else {
-            if(i2d_buffer_printf(buffer, "%ld", integer)) {
+            if(i2d_buffer_putl(buffer, integer, 0)) {
                 status = i2d_panic("failed to write buffer object");
+            } else if(i2d_rope_store(rope, buffer->buffer, buffer->offset, &string)) {
+                status = i2d_panic("failed to store rope string");
             } else {
-                i2d_buffer_get(buffer, &string.string, &string.length);
-                status = i2d_handler_general(print, data, &string, stack);
+                status = i2d_handler_general(print, data, &string, rope);
             }
             i2d_buffer_cache_put(print->buffer_cache, &buffer);
         }
@@ -362,7 +575,7 @@ static int i2d_handler_integer(i2d_print * print, i2d_data * data, i2d_item * it
     return status;
 }
 
-static int i2d_handler_string(i2d_print * print, i2d_data * data, i2d_item * item, i2d_string_stack * stack) {
+static int i2d_handler_string(i2d_print * print, i2d_data * data, i2d_item * item, i2d_rope * rope) {
     int status = I2D_OK;
     i2d_string string;
     i2d_zero(string);
@@ -370,13 +583,13 @@ static int i2d_handler_string(i2d_print * print, i2d_data * data, i2d_item * ite
     if(i2d_print_get_property_string(print, data->name.string, item, &string)) {
         status = i2d_panic("failed to get string by name -- %s", data->name.string);
     } else {
-        status = i2d_handler_general(print, data, &string, stack);
+        status = i2d_handler_general(print, data, &string, rope);
     }
 
     return status;
 }
 
-static int i2d_handler_type(i2d_print * print, i2d_data * data, i2d_item * item, i2d_string_stack * stack) {
+static int i2d_handler_type(i2d_print * print, i2d_data * data, i2d_item * item, i2d_rope * rope) {
     int status = I2D_OK;
     long integer;
     i2d_string string;
@@ -387,27 +600,27 @@ static int i2d_handler_type(i2d_print * print, i2d_data * data, i2d_item * item,
     } else if(i2d_value_map_get_string(print->item_type, integer, &string)) {
         status = i2d_panic("failed to get item type by integer -- %ld", integer);
     } else {
-        status = i2d_handler_general(print, data, &string, stack);
+        status = i2d_handler_general(print, data, &string, rope);
     }
 
     return status;
 }
 
 struct i2d_loop_context {
-    i2d_print * print;
+    i2d_value_map * map;
     i2d_string_stack * stack;
 };
 
 typedef struct i2d_loop_context i2d_loop_context;
 
-static int i2d_handler_job_loop(uint64_t flag, void * data) {
+static int i2d_handler_mask_loop(uint64_t flag, void * data) {
     int status = I2D_OK;
     i2d_loop_context * context = data;
     i2d_string string;
     i2d_zero(string);
 
-    if(i2d_value_map_get_string(context->print->job, (long) flag, &string)) {
-        status = i2d_panic("failed to get job by flag -- %ld", flag);
+    if(i2d_value_map_get_string(context->map, (long) flag, &string)) {
+        status = i2d_panic("failed to get string by flag -- %ld", flag);
     } else if(string.length > 0 && i2d_string_stack_push(context->stack, string.string, string.length)) {
         status = i2d_panic("failed to push string on stack");
     }
@@ -415,92 +628,122 @@ static int i2d_handler_job_loop(uint64_t flag, void * data) {
     return status;
 }
 
-static int i2d_handler_job(i2d_print * print, i2d_data * data, i2d_item * item, i2d_string_stack * stack) {
+/*
+ * the group of the mask (i.e. every job) or the
+ * list of the bits of the mask, which is rendered
+ * once for each mask
+ */
+static int i2d_handler_mask(i2d_print * print, i2d_rbt * masks, i2d_value_map * group, i2d_value_map * map, long integer, i2d_string * result) {
     int status = I2D_OK;
-    long integer;
+    i2d_print_mask * mask = NULL;
+    i2d_print_mask ** list;
+    size_t capacity;
     i2d_buffer * buffer = NULL;
     i2d_string string;
-    i2d_loop_context context = { print, NULL };
+    i2d_loop_context context = { map, NULL };
     i2d_zero(string);
 
-    if(i2d_print_get_property_integer(print, data->name.string, item, &integer)) {
-        status = i2d_panic("failed to get integer by name -- %s", data->name.string);
-    } else if(!i2d_value_map_get_string(print->job_group, integer, &string) && string.length > 0) {
-        status = i2d_handler_general(print, data, &string, stack);
-    } else if(i2d_string_stack_cache_get(print->stack_cache, &context.stack)) {
-        status = i2d_panic("failed to create string stack object");
+    if(!i2d_rbt_search(masks, &integer, (void **) &mask)) {
+        *result = mask->string;
     } else {
-        if(i2d_by_bit64(integer, i2d_handler_job_loop, &context)) {
-            status = i2d_panic("failed to get job by flag -- %ld", integer);
-        } else if(i2d_buffer_cache_get(print->buffer_cache, &buffer)) {
-            status = i2d_panic("failed to create buffer object");
-        } else {
-            if(i2d_string_stack_dump_buffer(context.stack, buffer, ", ")) {
-                status = i2d_panic("failed to get job list from stack");
+        if(print->mask_size == print->mask_capacity) {
+            capacity = print->mask_capacity ? print->mask_capacity * 2 : 64;
+            list = i2d_realloc(I2D_TAG_PRINT, print->masks, capacity * sizeof(*list));
+            if(!list) {
+                status = i2d_panic("out of memory");
             } else {
-                i2d_buffer_get(buffer, &string.string, &string.length);
-                status = i2d_handler_general(print, data, &string, stack);
+                print->masks = list;
+                print->mask_capacity = capacity;
             }
-            i2d_buffer_cache_put(print->buffer_cache, &buffer);
         }
 
-        i2d_string_stack_cache_put(print->stack_cache, &context.stack);
+        if(status) {
+            /* mask is not rendered */
+        } else {
+            mask = i2d_calloc(I2D_TAG_PRINT, 1, sizeof(*mask));
+            if(!mask) {
+                status = i2d_panic("out of memory");
+            } else {
+                mask->mask = integer;
+
+                if(!i2d_value_map_get_string(group, integer, &string) && string.length > 0) {
+                    if(i2d_string_create(I2D_TAG_PRINT, &mask->string, string.string, string.length))
+                        status = i2d_panic("failed to create string object");
+                } else if(i2d_string_stack_cache_get(print->stack_cache, &context.stack)) {
+                    status = i2d_panic("failed to create string stack object");
+                } else {
+                    if(i2d_by_bit64((uint64_t) integer, i2d_handler_mask_loop, &context)) {
+                        status = i2d_panic("failed to get string by mask -- %ld", integer);
+                    } else if(i2d_buffer_cache_get(print->buffer_cache, &buffer)) {
+                        status = i2d_panic("failed to create buffer object");
+                    } else {
+                        if(i2d_string_stack_dump_buffer(context.stack, buffer, ", ")) {
+                            status = i2d_panic("failed to get string list from stack");
+                        } else if(i2d_string_create(I2D_TAG_PRINT, &mask->string, buffer->buffer, buffer->offset)) {
+                            status = i2d_panic("failed to create string object");
+                        }
+                        i2d_buffer_cache_put(print->buffer_cache, &buffer);
+                    }
+
+                    i2d_string_stack_cache_put(print->stack_cache, &context.stack);
+                }
+
+                if(status) {
+                    /* mask is not mapped */
+                } else if(i2d_rbt_insert(masks, &mask->mask, mask)) {
+                    status = i2d_panic("failed to map mask object");
+                } else {
+                    print->masks[print->mask_size++] = mask;
+                    *result = mask->string;
+                    mask = NULL;
+                }
+
+                if(mask) {
+                    i2d_free(mask->string.string);
+                    i2d_free(mask);
+                }
+            }
+        }
     }
 
     return status;
 }
 
-static int i2d_handler_class_loop(uint64_t flag, void * data) {
+static int i2d_handler_job(i2d_print * print, i2d_data * data, i2d_item * item, i2d_rope * rope) {
     int status = I2D_OK;
-    i2d_loop_context * context = data;
+    long integer;
     i2d_string string;
     i2d_zero(string);
 
-    if(i2d_value_map_get_string(context->print->class, (long) flag, &string)) {
-        status = i2d_panic("failed to get class by flag -- %ld", flag);
-    } else if(string.length > 0 && i2d_string_stack_push(context->stack, string.string, string.length)) {
-        status = i2d_panic("failed to push string on stack");
+    if(i2d_print_get_property_integer(print, data->name.string, item, &integer)) {
+        status = i2d_panic("failed to get integer by name -- %s", data->name.string);
+    } else if(i2d_handler_mask(print, print->job_masks, print->job_group, print->job, integer, &string)) {
+        status = i2d_panic("failed to get job by flag -- %ld", integer);
+    } else {
+        status = i2d_handler_general(print, data, &string, rope);
     }
 
     return status;
 }
 
-static int i2d_handler_class(i2d_print * print, i2d_data * data, i2d_item * item, i2d_string_stack * stack) {
+static int i2d_handler_class(i2d_print * print, i2d_data * data, i2d_item * item, i2d_rope * rope) {
     int status = I2D_OK;
     long integer;
-    i2d_buffer * buffer = NULL;
     i2d_string string;
-    i2d_loop_context context = { print, NULL };
     i2d_zero(string);
 
     if(i2d_print_get_property_integer(print, data->name.string, item, &integer)) {
         status = i2d_panic("failed to get integer by name -- %s", data->name.string);
-    } else if(!i2d_value_map_get_string(print->class_group, integer, &string) && string.length > 0) {
-        status = i2d_handler_general(print, data, &string, stack);
-    } else if(i2d_string_stack_cache_get(print->stack_cache, &context.stack)) {
-        status = i2d_panic("failed to create string stack object");
+    } else if(i2d_handler_mask(print, print->class_masks, print->class_group, print->class, integer, &string)) {
+        status = i2d_panic("failed to get class by flag -- %ld", integer);
     } else {
-        if(i2d_by_bit64(integer, i2d_handler_class_loop, &context)) {
-            status = i2d_panic("failed to get class by flag -- %ld", integer);
-        } else if(i2d_buffer_cache_get(print->buffer_cache, &buffer)) {
-            status = i2d_panic("failed to create buffer object");
-        } else {
-            if(i2d_string_stack_dump_buffer(context.stack, buffer, ", ")) {
-                status = i2d_panic("failed to get class list from stack");
-            } else {
-                i2d_buffer_get(buffer, &string.string, &string.length);
-                status = i2d_handler_general(print, data, &string, stack);
-            }
-            i2d_buffer_cache_put(print->buffer_cache, &buffer);
-        }
-
-        i2d_string_stack_cache_put(print->stack_cache, &context.stack);
+        status = i2d_handler_general(print, data, &string, rope);
     }
 
     return status;
 }
 
-static int i2d_handler_gender(i2d_print * print, i2d_data * data, i2d_item * item, i2d_string_stack * stack) {
+static int i2d_handler_gender(i2d_print * print, i2d_data * data, i2d_item * item, i2d_rope * rope) {
     int status = I2D_OK;
     long integer;
     i2d_string string;
@@ -511,13 +754,13 @@ static int i2d_handler_gender(i2d_print * print, i2d_data * data, i2d_item * ite
     } else if(i2d_value_map_get_string(print->gender, integer, &string)) {
         status = i2d_panic("failed to get gender by integer -- %ld", integer);
     } else {
-        status = i2d_handler_general(print, data, &string, stack);
+        status = i2d_handler_general(print, data, &string, rope);
     }
 
     return status;
 }
 
-static int i2d_handler_location(i2d_print * print, i2d_data * data, i2d_item * item, i2d_string_stack * stack) {
+static int i2d_handler_location(i2d_print * print, i2d_data * data, i2d_item * item, i2d_rope * rope) {
     int status = I2D_OK;
     long integer;
     i2d_string string;
@@ -528,13 +771,13 @@ static int i2d_handler_location(i2d_print * print, i2d_data * data, i2d_item * i
     } else if(i2d_value_map_get_string(print->item_location, integer, &string)) {
         status = i2d_panic("failed to get item location by integer -- %ld", integer);
     } else {
-        status = i2d_handler_general(print, data, &string, stack);
+        status = i2d_handler_general(print, data, &string, rope);
     }
 
     return status;
 }
 
-static int i2d_handler_refine(i2d_print * print, i2d_data * data, i2d_item * item, i2d_string_stack * stack) {
+static int i2d_handler_refine(i2d_print * print, i2d_data * data, i2d_item * item, i2d_rope * rope) {
     int status = I2D_OK;
     long integer;
     i2d_string string;
@@ -545,13 +788,13 @@ static int i2d_handler_refine(i2d_print * print, i2d_data * data, i2d_item * ite
     } else if(i2d_value_map_get_string(print->refineable, integer, &string)) {
         status = i2d_panic("failed to get refineable by integer -- %ld", integer);
     } else {
-        status = i2d_handler_general(print, data, &string, stack);
+        status = i2d_handler_general(print, data, &string, rope);
     }
 
     return status;
 }
 
-static int i2d_handler_view(i2d_print * print, i2d_data * data, i2d_item * item, i2d_string_stack * stack) {
+static int i2d_handler_view(i2d_print * print, i2d_data * data, i2d_item * item, i2d_rope * rope) {
     int status = I2D_OK;
     long integer;
     i2d_string string;
@@ -565,14 +808,14 @@ static int i2d_handler_view(i2d_print * print, i2d_data * data, i2d_item * item,
                 if(i2d_value_map_get_string(print->weapon_type, integer, &string)) {
                     status = i2d_panic("failed to get weapon type by integer -- %ld", integer);
                 } else {
-                    status = i2d_handler_general(print, data, &string, stack);
+                    status = i2d_handler_general(print, data, &string, rope);
                 }
                 break;
             case 10: /* ammo */
                 if(i2d_value_map_get_string(print->ammo_type, integer, &string)) {
                     status = i2d_panic("failed to get ammo type by integer -- %ld", integer);
                 } else {
-                    status = i2d_handler_general(print, data, &string, stack);
+                    status = i2d_handler_general(print, data, &string, rope);
                 }
                 break;
         }
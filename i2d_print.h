@@ -4,6 +4,50 @@
 #include "i2d_data.h"
 #include "i2d_json.h"
 #include "i2d_item.h"
+#include "i2d_trace.h"
+
+/*
+ * the rendered job or class list of a mask, since
+ * an item db has a few hundred distinct masks at
+ * most; the rope refers to the string
+ */
+struct i2d_print_mask {
+    long mask;
+    i2d_string string;
+};
+
+typedef struct i2d_print_mask i2d_print_mask;
+
+/*
+ * the output of each item of a run in the order
+ * of the item db, i.e.
+ *
+ *  501<tab>123
+ *  <123 bytes of output>
+ *
+ * so an incremental run writes the items that are
+ * not compiled again from the cache of the last
+ * run; the strings of the list refer to buffer
+ */
+struct i2d_print_cache_entry {
+    long id;
+    i2d_string string;
+};
+
+typedef struct i2d_print_cache_entry i2d_print_cache_entry;
+
+struct i2d_print_cache {
+    i2d_buffer buffer;
+    i2d_print_cache_entry * list;
+    size_t size;
+    size_t capacity;
+};
+
+typedef struct i2d_print_cache i2d_print_cache;
+
+int i2d_print_cache_init(i2d_print_cache **, i2d_string *);
+void i2d_print_cache_deit(i2d_print_cache **);
+int i2d_print_cache_search(i2d_print_cache *, long, i2d_string *);
 
 struct i2d_print {
     i2d_value_map * description_by_item_type;
@@ -12,6 +56,8 @@ struct i2d_print {
     i2d_rbt * item_properties;
     i2d_buffer_cache * buffer_cache;
     i2d_string_stack_cache * stack_cache;
+    i2d_rope rope;
+    size_t properties;
     i2d_value_map * item_type;
     i2d_value_map * item_location;
     i2d_value_map * ammo_type;
@@ -22,6 +68,15 @@ struct i2d_print {
     i2d_value_map * job_group;
     i2d_value_map * class;
     i2d_value_map * class_group;
+    i2d_rbt * job_masks;
+    i2d_rbt * class_masks;
+    i2d_print_mask ** masks;
+    size_t mask_size;
+    size_t mask_capacity;
+    i2d_item ** items;
+    size_t item_size;
+    size_t item_capacity;
+    i2d_buffer * cache;
 };
 
 typedef struct i2d_print i2d_print;
@@ -29,5 +84,8 @@ typedef struct i2d_print i2d_print;
 int i2d_print_init(i2d_print **, i2d_json *);
 void i2d_print_deit(i2d_print **);
 int i2d_print_format(i2d_print *, i2d_item *);
-int i2d_print_format_lua(i2d_print *, i2d_item *, i2d_string *);
+int i2d_print_flush(i2d_print *);
+int i2d_print_record(i2d_print *);
+int i2d_print_replay(i2d_print *, long, i2d_string *);
+int i2d_print_write_cache(i2d_print *, i2d_string *);
 #endif
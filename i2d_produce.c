@@ -5,6 +5,7 @@ static int i2d_produce_parse(i2d_produce *, char *, size_t);
 static int i2d_produce_db_parse(char *, size_t, void *);
 static int i2d_produce_db_index(i2d_produce_db *);
 static int i2d_produce_db_create_produce_list(i2d_produce_db *, long, i2d_produce_list **);
+static int i2d_produce_list_resolve(i2d_produce_list *, i2d_item_db *, i2d_skill_db *, i2d_buffer *);
 
 int i2d_produce_init(i2d_produce ** result, char * string, size_t length) {
     int status = I2D_OK;
@@ -13,7 +14,7 @@ int i2d_produce_init(i2d_produce ** result, char * string, size_t length) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -60,7 +61,7 @@ static int i2d_produce_create(i2d_produce * produce, char * string, size_t lengt
         if((produce->material_count % 2) != 0) {
             status = i2d_panic("mismatch in material item id and amount");
         } else {
-            produce->materials = calloc(produce->material_count, sizeof(*produce->materials));
+            produce->materials = i2d_calloc(I2D_TAG_DB, produce->material_count, sizeof(*produce->materials));
             if(!produce->materials)
                 status = i2d_panic("out of memory");
         }
@@ -72,59 +73,33 @@ static int i2d_produce_create(i2d_produce * produce, char * string, size_t lengt
 static int i2d_produce_parse(i2d_produce * produce, char * string, size_t length) {
     int status = I2D_OK;
 
-    size_t i;
+    i2d_split split;
 
     char * anchor;
     size_t extent;
 
     int field = 0;
-    int last = 0;
 
     size_t material_index = 0;
 
-    anchor = string;
-    for(i = 0; i < length && !status && !last; i++) {
-        /*
-         * check for \t, \r, \n (include space)
-         */
-        if(i2d_isspace(string[i]))
-            last = 1;
-
-        /*
-         * check for line comments
-         */
-        if('/' == string[i] && i > 0 && '/' == string[i - 1]) {
-            i -= 1;
-            last = 1;
-        }
-
-        if(',' == string[i] || last) {
-            string[i] = 0;
-
-            if(string + i < anchor) {
-                status = i2d_panic("line overflow");
-            } else {
-                extent = (size_t) (string + i) - (size_t) anchor;
-                switch(field) {
-                    case 0: status = i2d_strtol(&produce->id, anchor, extent, 10); break;
-                    case 1: status = i2d_strtol(&produce->item_id, anchor, extent, 10); break;
-                    case 2: status = i2d_strtol(&produce->item_level, anchor, extent, 10); break;
-                    case 3: status = i2d_strtol(&produce->skill_id, anchor, extent, 10); break;
-                    case 4: status = i2d_strtol(&produce->skill_level, anchor, extent, 10); break;
-                    default:
-                        if(material_index >= produce->material_count) {
-                            status = i2d_panic("material overflow");
-                        } else {
-                            status = i2d_strtol(&produce->materials[material_index], anchor, extent, 10);
-                            material_index++;
-                        }
-                        break;
+    i2d_split_create(&split, string, length, I2D_SPLIT_SPACE);
+    while(!status && !i2d_split_next(&split, &anchor, &extent)) {
+        switch(field) {
+            case 0: status = i2d_strtol(&produce->id, anchor, extent, 10); break;
+            case 1: status = i2d_strtol(&produce->item_id, anchor, extent, 10); break;
+            case 2: status = i2d_strtol(&produce->item_level, anchor, extent, 10); break;
+            case 3: status = i2d_strtol(&produce->skill_id, anchor, extent, 10); break;
+            case 4: status = i2d_strtol(&produce->skill_level, anchor, extent, 10); break;
+            default:
+                if(material_index >= produce->material_count) {
+                    status = i2d_panic("material overflow");
+                } else {
+                    status = i2d_strtol(&produce->materials[material_index], anchor, extent, 10);
+                    material_index++;
                 }
-                field++;
-            }
-
-            anchor = (string + i + 1);
+                break;
         }
+        field++;
     }
 
     if(!status && 5 > field) {
@@ -157,7 +132,7 @@ int i2d_produce_list_init(i2d_produce_list ** result, long item_level) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -179,6 +154,7 @@ void i2d_produce_list_deit(i2d_produce_list ** result) {
     i2d_produce_list * object;
 
     object = *result;
+    i2d_string_destroy(&object->description);
     i2d_free(object->list);
     i2d_free(object);
     *result = NULL;
@@ -190,7 +166,7 @@ int i2d_produce_list_add(i2d_produce_list * produce_list, i2d_produce * produce)
     size_t size;
 
     size = produce_list->size + 1;
-    list = realloc(produce_list->list, size * sizeof(*produce_list->list));
+    list = i2d_realloc(I2D_TAG_DB, produce_list->list, size * sizeof(*produce_list->list));
     if(!list) {
         status = i2d_panic("out of memory");
     } else {
@@ -202,6 +178,49 @@ int i2d_produce_list_add(i2d_produce_list * produce_list, i2d_produce * produce)
     return status;
 }
 
+static int i2d_produce_list_resolve(i2d_produce_list * produce_list, i2d_item_db * item_db, i2d_skill_db * skill_db, i2d_buffer * buffer) {
+    int status = I2D_OK;
+    i2d_produce * produce;
+    i2d_item_entry * item;
+    i2d_skill * skill;
+    i2d_item_entry * material;
+    int is_missing = 0;
+    size_t i;
+    size_t j;
+
+    for(i = 0; i < produce_list->size && !status && !is_missing; i++) {
+        item = NULL;
+        skill = NULL;
+        produce = produce_list->list[i];
+        /* leave the description null; the produce handler reports it
+         * only if an item script actually refers to this item level */
+        if(i2d_item_db_search_entry_by_id(item_db, produce->item_id, &item)) {
+            is_missing = 1;
+        } else if(produce->skill_id && i2d_skill_db_search_by_id(skill_db, produce->skill_id, &skill)) {
+            is_missing = 1;
+        } else {
+            if( skill ?
+                i2d_buffer_printf(buffer, "[%s - Level %ld %s]\n", item->name.string, produce->skill_level, skill->name.string) :
+                i2d_buffer_printf(buffer, "[%s]\n", item->name.string) ) {
+                status = i2d_panic("failed to write buffer object");
+            } else {
+                for(j = 0; j < produce->material_count && !status && !is_missing; j += 2) {
+                    if(i2d_item_db_search_entry_by_id(item_db, produce->materials[j], &material)) {
+                        is_missing = 1;
+                    } else if(i2d_buffer_printf(buffer, "x%ld %s\n", produce->materials[j + 1], material->name.string)) {
+                        status = i2d_panic("failed to write buffer object");
+                    }
+                }
+            }
+        }
+    }
+
+    if(!status && !is_missing && i2d_string_create(I2D_TAG_DB, &produce_list->description, buffer->buffer, buffer->offset))
+        status = i2d_panic("failed to create string object");
+
+    return status;
+}
+
 void i2d_produce_list_append(i2d_produce_list * x, i2d_produce_list * y) {
     x->next->prev = y->prev;
     y->prev->next = x->next;
@@ -223,7 +242,7 @@ int i2d_produce_db_init(i2d_produce_db ** result, i2d_string * path) {
     if(i2d_is_invalid(result) || !path) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -296,7 +315,7 @@ static int i2d_produce_db_index(i2d_produce_db * produce_db) {
     i2d_produce * produce = NULL;
     i2d_produce_list * produce_list;
 
-    if(i2d_rbt_init(&produce_db->index_by_id, i2d_rbt_cmp_long)) {
+    if(i2d_rbt_init_static(&produce_db->index_by_id, i2d_rbt_cmp_long)) {
         status = i2d_panic("failed to create red black tree object");
     } else if(i2d_rbt_init(&produce_db->index_by_item_level, i2d_rbt_cmp_long)) {
         status = i2d_panic("failed to create red black tree object");
@@ -320,6 +339,9 @@ static int i2d_produce_db_index(i2d_produce_db * produce_db) {
             }
             produce = produce->next;
         } while(produce != produce_db->list && !status);
+
+        if(!status && i2d_rbt_build(produce_db->index_by_id))
+            status = i2d_panic("failed to build red black tree object");
     }
 
     return status;
@@ -344,6 +366,38 @@ static int i2d_produce_db_create_produce_list(i2d_produce_db * produce_db, long
     return status;
 }
 
+/*
+ * the description of each item level is the
+ * same for every item that produces it, so it
+ * is rendered once instead of on every item;
+ * an item level with an item or skill that is
+ * not in the databases is logged and has no
+ * description, which only fails the items that
+ * refer to it
+ */
+int i2d_produce_db_resolve(i2d_produce_db * produce_db, i2d_item_db * item_db, i2d_skill_db * skill_db) {
+    int status = I2D_OK;
+    i2d_produce_list * produce_list;
+    i2d_buffer buffer;
+
+    if(produce_db->produce_list) {
+        if(i2d_buffer_create(I2D_TAG_DB, &buffer, BUFFER_SIZE_LARGE)) {
+            status = i2d_panic("failed to create buffer object");
+        } else {
+            produce_list = produce_db->produce_list;
+            do {
+                i2d_buffer_clear(&buffer);
+                if(i2d_produce_list_resolve(produce_list, item_db, skill_db, &buffer))
+                    status = i2d_panic("failed to resolve produce list -- %ld", produce_list->item_level);
+                produce_list = produce_list->next;
+            } while(produce_list != produce_db->produce_list && !status);
+            i2d_buffer_destroy(&buffer);
+        }
+    }
+
+    return status;
+}
+
 int i2d_produce_db_search_by_id(i2d_produce_db * produce_db, long id, i2d_produce ** produce) {
     return i2d_rbt_search(produce_db->index_by_id, &id, (void **) produce);
 }
@@ -3,6 +3,8 @@
 
 #include "i2d_util.h"
 #include "i2d_rbt.h"
+#include "i2d_item.h"
+#include "i2d_skill.h"
 
 struct i2d_produce {
     long id;
@@ -23,10 +25,16 @@ void i2d_produce_deit(i2d_produce **);
 void i2d_produce_append(i2d_produce *, i2d_produce *);
 void i2d_produce_remove(i2d_produce *);
 
+/*
+ * description is the recipes of the item level
+ * and is rendered once the item and skill
+ * databases are loaded
+ */
 struct i2d_produce_list {
     long item_level;
     i2d_produce ** list;
     size_t size;
+    i2d_string description;
     struct i2d_produce_list * next;
     struct i2d_produce_list * prev;
 };
@@ -52,6 +60,7 @@ typedef struct i2d_produce_db i2d_produce_db;
 
 int i2d_produce_db_init(i2d_produce_db **, i2d_string *);
 void i2d_produce_db_deit(i2d_produce_db **);
+int i2d_produce_db_resolve(i2d_produce_db *, i2d_item_db *, i2d_skill_db *);
 int i2d_produce_db_search_by_id(i2d_produce_db *, long, i2d_produce **);
 int i2d_produce_db_search_by_item_level(i2d_produce_db *, long, i2d_produce_list **);
 #endif
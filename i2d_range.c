@@ -9,7 +9,7 @@ int i2d_range_node_init(i2d_range_node ** result, long min, long max) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_RANGE, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
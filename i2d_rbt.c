@@ -13,9 +13,36 @@ struct i2d_rbt_node {
 
 typedef struct i2d_rbt_node i2d_rbt_node;
 
+struct i2d_rbt_pair {
+    void * key;
+    void * val;
+};
+
+typedef struct i2d_rbt_pair i2d_rbt_pair;
+
+/*
+ * a static tree is for the indexes that are built
+ * once and only searched afterwards; insert appends
+ * to list and build sorts list once and lays it out
+ * in eytzinger order (the children of k are 2k and
+ * 2k + 1), so the top of the tree shares the first
+ * few cache lines and search has no pointers to
+ * chase; a static tree cannot delete or replace and
+ * must be built again after an insert
+ *
+ * keys is a copy of the keys in the same layout if
+ * the keys are long, so that search compares the
+ * keys inline instead of calling compare
+ */
 struct i2d_rbt {
     i2d_rbt_node * root;
     i2d_rbt_cmp compare;
+    int is_static;
+    int is_built;
+    i2d_rbt_pair * list;
+    long * keys;
+    size_t size;
+    size_t capacity;
 };
 
 enum { black, red };
@@ -26,6 +53,12 @@ enum { black, red };
 #define is_black(x)         ((x) == NULL || (x)->c == black)
 #define is_red(x)           ((x) != NULL && (x)->c == red)
 
+#ifdef __GNUC__
+#define i2d_prefetch(x)     __builtin_prefetch(x)
+#else
+#define i2d_prefetch(x)
+#endif
+
 static void right_rotate(i2d_rbt *, i2d_rbt_node *);
 static void left_rotate(i2d_rbt *, i2d_rbt_node *);
 static void change_parent(i2d_rbt *, i2d_rbt_node *, i2d_rbt_node *);
@@ -36,6 +69,11 @@ static void i2d_rbt_node_remove(i2d_rbt_node *);
 static int i2d_rbt_node_insert(i2d_rbt *, i2d_rbt_node *);
 static int i2d_rbt_node_delete(i2d_rbt *, i2d_rbt_node *);
 static int i2d_rbt_node_search(i2d_rbt *, i2d_rbt_node **, const void *);
+static size_t i2d_rbt_static_first(size_t);
+static size_t i2d_rbt_static_next(size_t, size_t);
+static void i2d_rbt_static_sort(i2d_rbt *, i2d_rbt_pair *, i2d_rbt_pair *, size_t);
+static int i2d_rbt_static_search(i2d_rbt *, const void *, i2d_rbt_pair **);
+static size_t i2d_rbt_static_search_long(i2d_rbt *, long);
 
 /* right rotation on x shifts the tree's height
  * from the left sub tree to the right sub tree
@@ -156,7 +194,7 @@ int i2d_rbt_init(i2d_rbt ** result, i2d_rbt_cmp compare) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_RBT, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -173,11 +211,75 @@ int i2d_rbt_init(i2d_rbt ** result, i2d_rbt_cmp compare) {
     return status;
 }
 
+int i2d_rbt_init_static(i2d_rbt ** result, i2d_rbt_cmp compare) {
+    int status = I2D_OK;
+
+    if(i2d_rbt_init(result, compare)) {
+        status = i2d_panic("failed to create red black tree object");
+    } else {
+        (*result)->is_static = 1;
+        (*result)->is_built = 1;
+    }
+
+    return status;
+}
+
+/*
+ * list[0] is unused so that the root is at 1; the
+ * pairs are sorted into a second array and then
+ * copied back in order of an in order walk of the
+ * eytzinger layout
+ */
+int i2d_rbt_build(i2d_rbt * tree) {
+    int status = I2D_OK;
+    i2d_rbt_pair * sort;
+    i2d_rbt_pair * temp;
+    long * keys;
+    size_t i;
+    size_t k;
+
+    if(!tree->is_static) {
+        status = i2d_panic("red black tree is not static");
+    } else if(!tree->is_built) {
+        sort = i2d_malloc(I2D_TAG_RBT, tree->size * 2 * sizeof(*sort));
+        if(!sort) {
+            status = i2d_panic("out of memory");
+        } else {
+            temp = sort + tree->size;
+            memcpy(sort, tree->list + 1, tree->size * sizeof(*sort));
+            i2d_rbt_static_sort(tree, sort, temp, tree->size);
+
+            i = 0;
+            for(k = i2d_rbt_static_first(tree->size); k; k = i2d_rbt_static_next(k, tree->size))
+                tree->list[k] = sort[i++];
+
+            if(i2d_rbt_cmp_long == tree->compare) {
+                keys = i2d_realloc(I2D_TAG_RBT, tree->keys, (tree->size + 1) * sizeof(*keys));
+                if(!keys) {
+                    status = i2d_panic("out of memory");
+                } else {
+                    tree->keys = keys;
+                    for(k = 1; k <= tree->size; k++)
+                        tree->keys[k] = *((long *) tree->list[k].key);
+                }
+            }
+
+            if(!status)
+                tree->is_built = 1;
+            i2d_free(sort);
+        }
+    }
+
+    return status;
+}
+
 void i2d_rbt_deit(i2d_rbt ** result) {
     i2d_rbt * object;
     i2d_rbt_node * node;
 
     object = *result;
+    i2d_free(object->keys);
+    i2d_free(object->list);
     if(object->root) {
         while(object->root != object->root->next) {
             node = object->root->next;
@@ -194,11 +296,19 @@ int i2d_rbt_copy(i2d_rbt ** result, i2d_rbt * tree) {
     int status = I2D_OK;
     i2d_rbt * object = NULL;
     i2d_rbt_node * node;
+    size_t i;
 
-    if(i2d_rbt_init(&object, tree->compare)) {
+    if(tree->is_static ? i2d_rbt_init_static(&object, tree->compare) : i2d_rbt_init(&object, tree->compare)) {
         status = i2d_panic("failed ot create red black tree object");
     } else {
-        if(tree->root) {
+        if(tree->is_static) {
+            for(i = 1; i <= tree->size && !status; i++)
+                if(i2d_rbt_insert(object, tree->list[i].key, tree->list[i].val))
+                    status = i2d_panic("failed to insert node object");
+
+            if(!status && tree->is_built && i2d_rbt_build(object))
+                status = i2d_panic("failed to build red black tree object");
+        } else if(tree->root) {
             node = tree->root;
             do {
                 if(i2d_rbt_insert(object, node->key, node->val))
@@ -219,8 +329,28 @@ int i2d_rbt_copy(i2d_rbt ** result, i2d_rbt * tree) {
 int i2d_rbt_insert(i2d_rbt * tree, void * key, void * value) {
     int status = I2D_OK;
     i2d_rbt_node * node = NULL;
+    i2d_rbt_pair * list;
+    size_t capacity;
+
+    if(tree->is_static) {
+        if(tree->size + 1 >= tree->capacity) {
+            capacity = tree->capacity ? tree->capacity * 2 : 64;
+            list = i2d_realloc(I2D_TAG_RBT, tree->list, capacity * sizeof(*list));
+            if(!list) {
+                status = i2d_panic("out of memory");
+            } else {
+                tree->list = list;
+                tree->capacity = capacity;
+            }
+        }
 
-    if(i2d_rbt_node_init(&node, key, value)) {
+        if(!status) {
+            tree->size++;
+            tree->list[tree->size].key = key;
+            tree->list[tree->size].val = value;
+            tree->is_built = 0;
+        }
+    } else if(i2d_rbt_node_init(&node, key, value)) {
         status = i2d_panic("failed to create node object");
     } else {
         if(i2d_rbt_node_insert(tree, node))
@@ -236,7 +366,9 @@ int i2d_rbt_delete(i2d_rbt * tree, void * key) {
     int status = I2D_OK;
     i2d_rbt_node * node = NULL;
 
-    if(i2d_rbt_node_search(tree, &node, key)) {
+    if(tree->is_static) {
+        status = i2d_panic("red black tree is static");
+    } else if(i2d_rbt_node_search(tree, &node, key)) {
         status = i2d_panic("failed to search for node object");
     } else if(i2d_rbt_node_delete(tree, node)) {
         status = i2d_panic("failed to delete node object");
@@ -250,8 +382,15 @@ int i2d_rbt_delete(i2d_rbt * tree, void * key) {
 int i2d_rbt_search(i2d_rbt * tree, const void * key, void ** value) {
     int status = I2D_OK;
     i2d_rbt_node * node = NULL;
+    i2d_rbt_pair * pair;
 
-    if(i2d_rbt_node_search(tree, &node, key)) {
+    if(tree->is_static) {
+        if(i2d_rbt_static_search(tree, key, &pair)) {
+            status = I2D_FAIL;
+        } else {
+            *value = pair->val;
+        }
+    } else if(i2d_rbt_node_search(tree, &node, key)) {
         status = I2D_FAIL;
     } else {
         *value = node->val;
@@ -264,7 +403,9 @@ int i2d_rbt_replace(i2d_rbt * tree, void * key, void * value) {
     int status = I2D_OK;
     void * exist;
 
-    if(!i2d_rbt_search(tree, key, &exist) &&
+    if(tree->is_static) {
+        status = i2d_panic("red black tree is static");
+    } else if(!i2d_rbt_search(tree, key, &exist) &&
         i2d_rbt_delete(tree, exist) ) {
         status = i2d_panic("failed to delete node");
     } else if(i2d_rbt_insert(tree, key, value)) {
@@ -276,17 +417,28 @@ int i2d_rbt_replace(i2d_rbt * tree, void * key, void * value) {
 
 int i2d_rbt_exist(i2d_rbt * tree, const void * key) {
     i2d_rbt_node * node = NULL;
-    return i2d_rbt_node_search(tree, &node, key);
+    i2d_rbt_pair * pair;
+    return tree->is_static ?
+        i2d_rbt_static_search(tree, key, &pair) :
+        i2d_rbt_node_search(tree, &node, key);
 }
 
 int i2d_rbt_iterate(i2d_rbt * tree, i2d_rbt_iterate_cb cb, void * data) {
     int status = I2D_OK;
     i2d_rbt_node * node;
+    size_t k;
 
-    if(tree->root) {
+    if(tree->is_static) {
+        if(!tree->is_built) {
+            status = i2d_panic("red black tree is not built");
+        } else {
+            for(k = i2d_rbt_static_first(tree->size); k && !status; k = i2d_rbt_static_next(k, tree->size))
+                status = cb(tree->list[k].val, data);
+        }
+    } else if(tree->root) {
         node = tree->root;
         do {
-            status = cb(node, data);
+            status = cb(node->val, data);
             node = node->next;
         } while(node != tree->root && !status);
     }
@@ -301,7 +453,7 @@ static int i2d_rbt_node_init(i2d_rbt_node ** result, void * key, void * val) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_RBT, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -562,3 +714,120 @@ static int i2d_rbt_node_search(i2d_rbt * tree, i2d_rbt_node ** x, const void * k
 
     return I2D_FAIL;
 }
+
+static size_t i2d_rbt_static_first(size_t size) {
+    size_t k = 0;
+
+    if(size) {
+        k = 1;
+        while(k * 2 <= size)
+            k *= 2;
+    }
+
+    return k;
+}
+
+/*
+ * the successor of k is the left most node of the
+ * right sub tree of k or else the parent of the
+ * last left child on the path to k; 0 is the end
+ */
+static size_t i2d_rbt_static_next(size_t k, size_t size) {
+    if(k * 2 + 1 <= size) {
+        k = k * 2 + 1;
+        while(k * 2 <= size)
+            k *= 2;
+    } else {
+        while(k & 1)
+            k >>= 1;
+        k >>= 1;
+    }
+
+    return k;
+}
+
+/*
+ * merge sort is stable, so the first of the pairs
+ * with the same key is the first that is inserted
+ */
+static void i2d_rbt_static_sort(i2d_rbt * tree, i2d_rbt_pair * list, i2d_rbt_pair * temp, size_t size) {
+    size_t i;
+    size_t j;
+    size_t k;
+    size_t half;
+
+    if(size > 1) {
+        half = size / 2;
+        i2d_rbt_static_sort(tree, list, temp, half);
+        i2d_rbt_static_sort(tree, list + half, temp, size - half);
+
+        if(0 < tree->compare(list[half - 1].key, list[half].key)) {
+            memcpy(temp, list, size * sizeof(*temp));
+            i = 0;
+            j = half;
+            k = 0;
+            while(i < half && j < size)
+                list[k++] = (0 < tree->compare(temp[i].key, temp[j].key)) ? temp[j++] : temp[i++];
+            while(i < half)
+                list[k++] = temp[i++];
+            while(j < size)
+                list[k++] = temp[j++];
+        }
+    }
+}
+
+/*
+ * descend without testing for equality and find
+ * the lower bound, which is the node at which the
+ * walk last went left; the walk went left at k if
+ * k is followed by a 0 and then only 1s
+ */
+static int i2d_rbt_static_search(i2d_rbt * tree, const void * key, i2d_rbt_pair ** pair) {
+    int status = I2D_OK;
+    size_t k = 1;
+
+    if(!tree->is_built) {
+        status = i2d_panic("red black tree is not built");
+    } else {
+        if(tree->keys) {
+            k = i2d_rbt_static_search_long(tree, *((const long *) key));
+        } else {
+            while(k <= tree->size)
+                k = k * 2 + (0 > tree->compare(tree->list[k].key, key));
+
+            while(k & 1)
+                k >>= 1;
+            k >>= 1;
+        }
+
+        if(!k || tree->compare(tree->list[k].key, key)) {
+            status = I2D_FAIL;
+        } else {
+            *pair = &tree->list[k];
+        }
+    }
+
+    return status;
+}
+
+/*
+ * the descent has no branch on the compare and
+ * fetches the keys four levels ahead, which are
+ * the sixteen descendants of k at 16k
+ */
+static size_t i2d_rbt_static_search_long(i2d_rbt * tree, long key) {
+    const long * keys = tree->keys;
+    size_t size = tree->size;
+    size_t k = 1;
+
+    while(k <= size) {
+        i2d_prefetch(keys + k * 16);
+        k = k * 2 + (keys[k] < key);
+    }
+
+    while(k & 1)
+        k >>= 1;
+    k >>= 1;
+
+    return k;
+}
@@ -11,6 +11,8 @@ int i2d_rbt_cmp_long(const void *, const void *);
 int i2d_rbt_cmp_str(const void *, const void *);
 
 int i2d_rbt_init(i2d_rbt **, i2d_rbt_cmp);
+int i2d_rbt_init_static(i2d_rbt **, i2d_rbt_cmp);
+int i2d_rbt_build(i2d_rbt *);
 void i2d_rbt_deit(i2d_rbt **);
 int i2d_rbt_copy(i2d_rbt **, i2d_rbt *);
 int i2d_rbt_insert(i2d_rbt *, void *, void *);
@@ -16,11 +16,13 @@ typedef int (* i2d_handler_multiple_node_cb) (i2d_script *, i2d_rbt *, i2d_node
 typedef int (* i2d_handler_single_node_data_cb) (i2d_data *, i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
 typedef int (* i2d_handler_block_statement_cb) (i2d_script *, i2d_block *, i2d_rbt *, i2d_data *);
 typedef int (* i2d_handler_logic_generate_cb) (i2d_script *, i2d_logic *, i2d_buffer *);
+typedef i2d_ir_format_cb i2d_handler_range_value_cb;
 
 enum i2d_handler_type {
     single_node,
     multiple_node,
     single_node_data,
+    range_value,
     block_statement,
     logic_generate
 };
@@ -33,6 +35,7 @@ struct i2d_handler {
         i2d_handler_single_node_cb single_node;
         i2d_handler_multiple_node_cb multiple_node;
         i2d_handler_single_node_data_cb single_node_data;
+        i2d_handler_range_value_cb range_value;
         i2d_handler_block_statement_cb block_statement;
         i2d_handler_logic_generate_cb logic_generate;
     };
@@ -106,27 +109,29 @@ i2d_handler function_handlers[] = {
 typedef int (*i2d_handler_range_cb)(i2d_script *, i2d_string_stack *, long);
 static int i2d_handler_range(i2d_script *, i2d_node *, i2d_local *, i2d_handler_range_cb);
 static int i2d_handler_expression(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_milliseconds(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_milliseconds_absolute(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_seconds(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
+static int i2d_handler_range_value(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *, i2d_handler_range_value_cb, i2d_ir_range *);
+static void i2d_handler_absolute(long *, long *);
+static int i2d_handler_milliseconds(long, long, i2d_buffer *);
+static int i2d_handler_milliseconds_absolute(long, long, i2d_buffer *);
+static int i2d_handler_seconds(long, long, i2d_buffer *);
 static int i2d_handler_regen(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_splash(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
+static int i2d_handler_splash(long, long, i2d_buffer *);
 static int i2d_handler_elements_cb(i2d_script *, i2d_string_stack *, long);
 static int i2d_handler_elements(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
 static int i2d_handler_races_cb(i2d_script *, i2d_string_stack *, long);
 static int i2d_handler_races(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
 static int i2d_handler_classes_cb(i2d_script *, i2d_string_stack *, long);
 static int i2d_handler_classes(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_integer(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_integer_sign(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_integer_absolute(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_percent(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_percent_sign(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_percent_sign_inverse(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_percent_absolute(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_percent10(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_percent100(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_percent100_absolute(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
+static int i2d_handler_integer(long, long, i2d_buffer *);
+static int i2d_handler_integer_sign(long, long, i2d_buffer *);
+static int i2d_handler_integer_absolute(long, long, i2d_buffer *);
+static int i2d_handler_percent(long, long, i2d_buffer *);
+static int i2d_handler_percent_sign(long, long, i2d_buffer *);
+static int i2d_handler_percent_sign_inverse(long, long, i2d_buffer *);
+static int i2d_handler_percent_absolute(long, long, i2d_buffer *);
+static int i2d_handler_percent10(long, long, i2d_buffer *);
+static int i2d_handler_percent100(long, long, i2d_buffer *);
+static int i2d_handler_percent100_absolute(long, long, i2d_buffer *);
 static int i2d_handler_ignore(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
 static int i2d_handler_sizes_cb(i2d_script *, i2d_string_stack *, long);
 static int i2d_handler_sizes(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
@@ -140,7 +145,7 @@ static int i2d_handler_mob_races_cb(i2d_script *, i2d_string_stack *, long);
 static int i2d_handler_mob_races(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
 static int i2d_handler_weapons_cb(i2d_script *, i2d_string_stack *, long);
 static int i2d_handler_weapons(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
-static int i2d_handler_zeny(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
+static int i2d_handler_zeny(long, long, i2d_buffer *);
 static int i2d_handler_item_cb(i2d_script *, i2d_string_stack *, long);
 static int i2d_handler_item(i2d_script *, i2d_rbt *, i2d_node *, i2d_local *);
 static int i2d_handler_itemgroups_cb(i2d_script *, i2d_string_stack *, long);
@@ -177,24 +182,24 @@ static int i2d_handler_sc_start2(i2d_script *, i2d_rbt *, i2d_node **, i2d_local
 static int i2d_handler_sc_start4(i2d_script *, i2d_rbt *, i2d_node **, i2d_local *);
 
 i2d_handler argument_handlers[] = {
-    { "milliseconds", single_node, {i2d_handler_milliseconds} },
-    { "milliseconds_absolute", single_node, {i2d_handler_milliseconds_absolute} },
-    { "seconds", single_node, {i2d_handler_seconds} },
+    { "milliseconds", range_value, {i2d_handler_milliseconds} },
+    { "milliseconds_absolute", range_value, {i2d_handler_milliseconds_absolute} },
+    { "seconds", range_value, {i2d_handler_seconds} },
     { "regen", single_node, {i2d_handler_regen} },
-    { "splash", single_node, {i2d_handler_splash} },
+    { "splash", range_value, {i2d_handler_splash} },
     { "elements", single_node, {i2d_handler_elements} },
     { "races", single_node, {i2d_handler_races} },
     { "classes", single_node, {i2d_handler_classes} },
-    { "integer", single_node, {i2d_handler_integer} },
-    { "integer_sign", single_node, {i2d_handler_integer_sign} },
-    { "integer_absolute", single_node, {i2d_handler_integer_absolute} },
-    { "percent", single_node, {i2d_handler_percent} },
-    { "percent_sign", single_node, {i2d_handler_percent_sign} },
-    { "percent_sign_inverse", single_node, {i2d_handler_percent_sign_inverse} },
-    { "percent_absolute", single_node, {i2d_handler_percent_absolute} },
-    { "percent10", single_node, {i2d_handler_percent10} },
-    { "percent100", single_node, {i2d_handler_percent100} },
-    { "percent100_absolute", single_node, {i2d_handler_percent100_absolute} },
+    { "integer", range_value, {i2d_handler_integer} },
+    { "integer_sign", range_value, {i2d_handler_integer_sign} },
+    { "integer_absolute", range_value, {i2d_handler_integer_absolute} },
+    { "percent", range_value, {i2d_handler_percent} },
+    { "percent_sign", range_value, {i2d_handler_percent_sign} },
+    { "percent_sign_inverse", range_value, {i2d_handler_percent_sign_inverse} },
+    { "percent_absolute", range_value, {i2d_handler_percent_absolute} },
+    { "percent10", range_value, {i2d_handler_percent10} },
+    { "percent100", range_value, {i2d_handler_percent100} },
+    { "percent100_absolute", range_value, {i2d_handler_percent100_absolute} },
     { "ignore", single_node, {i2d_handler_ignore} },
     { "sizes", single_node, {i2d_handler_sizes} },
     { "skill", single_node, {i2d_handler_skill} },
@@ -202,7 +207,7 @@ i2d_handler argument_handlers[] = {
     { "effects", single_node, {i2d_handler_effects} },
     { "mob_races", single_node, {i2d_handler_mob_races} },
     { "weapons", single_node, {i2d_handler_weapons} },
-    { "zeny", single_node, {i2d_handler_zeny} },
+    { "zeny", range_value, {i2d_handler_zeny} },
     { "item", single_node, {i2d_handler_item} },
     { "itemgroups", single_node, {i2d_handler_itemgroups} },
     { "bf_type", single_node, {i2d_handler_bf_type} },
@@ -255,6 +260,43 @@ i2d_handler statement_handlers[] = {
     { "generic", block_statement, {i2d_script_statement_generic} }
 };
 
+struct i2d_script_load {
+    i2d_script * script;
+    i2d_json * json;
+};
+
+typedef struct i2d_script_load i2d_script_load;
+
+static int i2d_script_load_db(void *);
+static int i2d_script_load_constant_db(void *);
+static int i2d_script_load_bonus(void *);
+static int i2d_script_load_sc_start(void *);
+static int i2d_script_load_statements(void *);
+static int i2d_script_load_functions(void *);
+static int i2d_script_load_arguments(void *);
+static int i2d_script_index_data_maps(i2d_script *);
+static int i2d_script_map_arguments(i2d_script *);
+static int i2d_script_unmap_arguments(i2d_script *);
+static int i2d_script_compile_defaults(i2d_script *);
+static void i2d_script_reset_defaults(i2d_script *);
+static int i2d_script_compile_output(i2d_script *, i2d_string *, i2d_string *, i2d_rbt *, json_t *, const char *);
+static int i2d_script_cache_cmp(const void *, const void *);
+static int i2d_script_cache_entry_init(i2d_script_cache_entry **, i2d_buffer *);
+static void i2d_script_cache_entry_deit(i2d_script_cache_entry **);
+static int i2d_script_cache_find(const char *, const char *);
+static int i2d_script_cache_range(i2d_buffer *, i2d_range *);
+static int i2d_script_cache_logic(i2d_buffer *, i2d_logic *);
+static int i2d_script_cache_node(i2d_buffer *, i2d_node *);
+static int i2d_script_cache_variable(void *, void *);
+static int i2d_script_compile_cache(i2d_script *, i2d_string *, i2d_string *, i2d_rbt *);
+static long i2d_script_budget_range(i2d_range *, int);
+static long i2d_script_budget_logic(i2d_logic *);
+static int i2d_script_budget_charge(i2d_script *, long, long);
+static int i2d_script_budget_node(i2d_script *, i2d_node *);
+static int i2d_script_budget_fallback(i2d_item *);
+static i2d_ir_range * i2d_script_ir_range(i2d_script *, i2d_local *, i2d_ir_range *);
+static int i2d_script_statement_rope(i2d_data *, i2d_string *, i2d_string *, size_t, i2d_rope *);
+
 const char * i2d_token_string[] = {
     "token",
     "{",
@@ -451,11 +493,11 @@ int i2d_token_init(i2d_token ** result, enum i2d_token_type type) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_LEXER, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_buffer_create(&object->buffer, 256)) {
+            if(i2d_buffer_create(I2D_TAG_LEXER, &object->buffer, 256)) {
                 status = i2d_panic("failed to create buffer object");
             } else {
                 object->type = type;
@@ -552,7 +594,7 @@ int i2d_token_set_string(i2d_token * token, i2d_string * string) {
     int status = I2D_OK;
 
     i2d_buffer_clear(&token->buffer);
-    if(i2d_buffer_printf(&token->buffer, "%s", string->string))
+    if(i2d_buffer_memcpy(&token->buffer, string->string, string->length))
         status = i2d_panic("failed to copy string");
 
     return status;
@@ -587,7 +629,7 @@ int i2d_lexer_init(i2d_lexer ** result) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_LEXER, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -988,7 +1030,7 @@ int i2d_node_init(i2d_node ** result, enum i2d_node_type type, i2d_token * token
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_PARSER, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -1271,11 +1313,11 @@ int i2d_block_init(i2d_block ** result, enum i2d_block_type type, i2d_token * to
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_PARSER, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_buffer_create(&object->buffer, BUFFER_SIZE_LARGE)) {
+            if(i2d_buffer_create(I2D_TAG_PARSER, &object->buffer, BUFFER_SIZE_LARGE)) {
                 status = i2d_panic("failed to create buffer object");
             } else {
                 object->type = type;
@@ -1375,7 +1417,7 @@ int i2d_parser_init(i2d_parser ** result) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_PARSER, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -2027,7 +2069,7 @@ int i2d_parser_expression_recursive(i2d_parser * parser, i2d_lexer * lexer, i2d_
             } else if(i2d_lexer_token_init(lexer, &token, I2D_TOKEN)) {
                 status = i2d_panic("failed to create token object");
             } else {
-                if(i2d_node_init(&node, I2D_NODE, token)) {
+                if(i2d_parser_node_init(parser, &node, I2D_NODE, token)) {
                     status = i2d_panic("failed to create node object");
                 } else {
                     node->left = root;
@@ -2049,72 +2091,183 @@ int i2d_parser_expression_recursive(i2d_parser * parser, i2d_lexer * lexer, i2d_
     return status;
 }
 
+static int i2d_script_load_db(void * data) {
+    int status = I2D_OK;
+    i2d_script_load * load = data;
+
+    if(i2d_db_init(&load->script->db, load->json->config))
+        status = i2d_panic("failed to create database object");
+
+    return status;
+}
+
+static int i2d_script_load_constant_db(void * data) {
+    int status = I2D_OK;
+    i2d_script_load * load = data;
+
+    i2d_trace_begin("i2d_constant_db_init", 0);
+
+    if(i2d_constant_db_init(&load->script->constant_db, &load->json->config->constants_path))
+        status = i2d_panic("failed to create constant db object");
+
+    i2d_trace_end("i2d_constant_db_init");
+
+    return status;
+}
+
+static int i2d_script_load_bonus(void * data) {
+    i2d_script_load * load = data;
+    i2d_data_section sections[] = {
+        { "bonus", &load->script->bonus },
+        { "bonus2", &load->script->bonus2 },
+        { "bonus3", &load->script->bonus3 },
+        { "bonus4", &load->script->bonus4 },
+        { "bonus5", &load->script->bonus5 }
+    };
+
+    return i2d_data_map_load(&load->json->config->bonus_path, sections, i2d_size(sections));
+}
+
+static int i2d_script_load_sc_start(void * data) {
+    i2d_script_load * load = data;
+    i2d_data_section sections[] = {
+        { "sc_start", &load->script->sc_start },
+        { "sc_start2", &load->script->sc_start2 },
+        { "sc_start4", &load->script->sc_start4 }
+    };
+
+    return i2d_data_map_load(&load->json->config->sc_start_path, sections, i2d_size(sections));
+}
+
+static int i2d_script_load_statements(void * data) {
+    i2d_script_load * load = data;
+    i2d_data_section sections[] = {
+        { NULL, &load->script->statements }
+    };
+
+    return i2d_data_map_load(&load->json->config->statements_path, sections, i2d_size(sections));
+}
+
+static int i2d_script_load_functions(void * data) {
+    i2d_script_load * load = data;
+    i2d_data_section sections[] = {
+        { NULL, &load->script->functions }
+    };
+
+    return i2d_data_map_load(&load->json->config->functions_path, sections, i2d_size(sections));
+}
+
+static int i2d_script_load_arguments(void * data) {
+    i2d_script_load * load = data;
+    i2d_data_section sections[] = {
+        { NULL, &load->script->arguments }
+    };
+
+    return i2d_data_map_load(&load->json->config->arguments_path, sections, i2d_size(sections));
+}
+
+static int i2d_script_index_data_maps(i2d_script * script) {
+    int status = I2D_OK;
+
+    if(i2d_data_map_index(script->bonus, data_map_by_constant, script->constant_db)) {
+        status = i2d_panic("failed to index bonus");
+    } else if(i2d_data_map_index(script->bonus2, data_map_by_constant, script->constant_db)) {
+        status = i2d_panic("failed to index bonus2");
+    } else if(i2d_data_map_index(script->bonus3, data_map_by_constant, script->constant_db)) {
+        status = i2d_panic("failed to index bonus3");
+    } else if(i2d_data_map_index(script->bonus4, data_map_by_constant, script->constant_db)) {
+        status = i2d_panic("failed to index bonus4");
+    } else if(i2d_data_map_index(script->bonus5, data_map_by_constant, script->constant_db)) {
+        status = i2d_panic("failed to index bonus5");
+    } else if(i2d_data_map_index(script->sc_start, data_map_by_constant, script->constant_db)) {
+        status = i2d_panic("failed to index sc_start");
+    } else if(i2d_data_map_index(script->sc_start2, data_map_by_constant, script->constant_db)) {
+        status = i2d_panic("failed to index sc_start2");
+    } else if(i2d_data_map_index(script->sc_start4, data_map_by_constant, script->constant_db)) {
+        status = i2d_panic("failed to index sc_start4");
+    } else if(i2d_data_map_index(script->functions, data_map_by_name, script->constant_db)) {
+        status = i2d_panic("failed to index functions");
+    } else if(i2d_data_map_index(script->arguments, data_map_by_name, script->constant_db)) {
+        status = i2d_panic("failed to index arguments");
+    } else if(i2d_data_map_index(script->statements, data_map_by_name, script->constant_db)) {
+        status = i2d_panic("failed to index statements");
+    }
+
+    return status;
+}
+
 int i2d_script_init(i2d_script ** result, i2d_json * json) {
     int status = I2D_OK;
     i2d_script * object;
     size_t i;
     size_t size;
-    i2d_handler * handler;
+    i2d_script_load load;
+    i2d_task tasks[] = {
+        { i2d_script_load_db, &load, I2D_OK },
+        { i2d_script_load_constant_db, &load, I2D_OK },
+        { i2d_script_load_bonus, &load, I2D_OK },
+        { i2d_script_load_sc_start, &load, I2D_OK },
+        { i2d_script_load_statements, &load, I2D_OK },
+        { i2d_script_load_functions, &load, I2D_OK },
+        { i2d_script_load_arguments, &load, I2D_OK }
+    };
+
+    i2d_trace_begin("i2d_script_init", 0);
 
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_SCRIPT, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_db_init(&object->db, json->config)) {
-                status = i2d_panic("failed to create database object");
+            load.script = object;
+            load.json = json;
+
+            object->budget.time = json->config->budget.time;
+            object->budget.range = json->config->budget.range;
+            object->budget.logic = json->config->budget.logic;
+
+            if(i2d_task_run(tasks, i2d_size(tasks))) {
+                status = i2d_panic("failed to load database, constant, and data files");
             } else if(i2d_lexer_init(&object->lexer)) {
                 status = i2d_panic("failed to create lexer object");
             } else if(i2d_parser_init(&object->parser)) {
                 status = i2d_panic("failed to create parser object");
-            } else if(i2d_constant_db_init(&object->constant_db, json->constants)) {
-                status = i2d_panic("failed to create constant db object");
             } else if(i2d_constant_index_mob_races(object->constant_db, object->db->mob_race2_db)) {
                 status = i2d_panic("failed to index mob race db");
-            } else if(i2d_value_map_init(&object->getiteminfo, json->getiteminfo_type, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->getiteminfo, &json->getiteminfo_type, i2d_value_string)) {
                 status = i2d_panic("failed to load getiteminfo");
-            } else if(i2d_value_map_init(&object->strcharinfo, json->strcharinfo_type, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->strcharinfo, &json->strcharinfo_type, i2d_value_string)) {
                 status = i2d_panic("failed to load strcharinfo");
-            } else if(i2d_value_map_init(&object->weapons, json->weapon_type, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->weapons, &json->weapon_type, i2d_value_string)) {
                 status = i2d_panic("failed to load weapons");
-            } else if(i2d_value_map_init(&object->ammos, json->ammo_type, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->ammos, &json->ammo_type, i2d_value_string)) {
                 status = i2d_panic("failed to load ammos");
-            } else if(i2d_value_map_init(&object->skill_flags, json->skill_flag, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->skill_flags, &json->skill_flag, i2d_value_string)) {
                 status = i2d_panic("failed to load skill_flags");
-            } else if(i2d_value_map_init(&object->searchstore_effect, json->searchstore_effect, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->searchstore_effect, &json->searchstore_effect, i2d_value_string)) {
                 status = i2d_panic("failed to load searchstore_effect");
-            } else if(i2d_value_map_init(&object->bonus_script_flag, json->bonus_script_flag, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->bonus_script_flag, &json->bonus_script_flag, i2d_value_string)) {
                 status = i2d_panic("failed to load bonus_script_flag");
-            } else if(i2d_value_map_init(&object->basejob, json->basejob, i2d_value_string)) {
+            } else if(i2d_value_map_init(&object->basejob, &json->basejob, i2d_value_string)) {
                 status = i2d_panic("failed to load basejob");
-            } else if(i2d_data_map_init(&object->bonus, data_map_by_constant, json->bonus, object->constant_db)) {
-                status = i2d_panic("failed to load bonus");
-            } else if(i2d_data_map_init(&object->bonus2, data_map_by_constant, json->bonus2, object->constant_db)) {
-                status = i2d_panic("failed to load bonus2");
-            } else if(i2d_data_map_init(&object->bonus3, data_map_by_constant, json->bonus3, object->constant_db)) {
-                status = i2d_panic("failed to load bonus3");
-            } else if(i2d_data_map_init(&object->bonus4, data_map_by_constant, json->bonus4, object->constant_db)) {
-                status = i2d_panic("failed to load bonus4");
-            } else if(i2d_data_map_init(&object->bonus5, data_map_by_constant, json->bonus5, object->constant_db)) {
-                status = i2d_panic("failed to load bonus5");
-            } else if(i2d_data_map_init(&object->sc_start, data_map_by_constant, json->sc_start, object->constant_db)) {
-                status = i2d_panic("failed to load sc_start");
-            } else if(i2d_data_map_init(&object->sc_start2, data_map_by_constant, json->sc_start2, object->constant_db)) {
-                status = i2d_panic("failed to load sc_start2");
-            } else if(i2d_data_map_init(&object->sc_start4, data_map_by_constant, json->sc_start4, object->constant_db)) {
-                status = i2d_panic("failed to load sc_start4");
-            } else if(i2d_data_map_init(&object->functions, data_map_by_name, json->functions, object->constant_db)) {
-                status = i2d_panic("failed to load functions");
-            } else if(i2d_data_map_init(&object->arguments, data_map_by_name, json->arguments, object->constant_db)) {
-                status = i2d_panic("failed to load arguments");
-            } else if(i2d_data_map_init(&object->statements, data_map_by_name, json->statements, object->constant_db)) {
-                status = i2d_panic("failed to load statements");
-            } else if(i2d_buffer_cache_init(&object->buffer_cache)) {
+            } else if(i2d_script_index_data_maps(object)) {
+                status = i2d_panic("failed to index data maps");
+            } else if(i2d_buffer_cache_init(I2D_TAG_SCRIPT, &object->buffer_cache)) {
                 status = i2d_panic("failed to create buffer cache object");
-            } else if(i2d_string_stack_cache_init(&object->stack_cache)) {
+            } else if(i2d_string_stack_cache_init(I2D_TAG_SCRIPT, &object->stack_cache)) {
                 status = i2d_panic("failed to create string stack cache object");
+            } else if(i2d_script_cache_init(&object->script_cache)) {
+                status = i2d_panic("failed to create script cache object");
+            } else if(i2d_index_init(&object->index)) {
+                status = i2d_panic("failed to create index object");
+            } else if(i2d_rope_create(&object->rope)) {
+                status = i2d_panic("failed to create rope object");
+            } else if(json->config->locale_path.string && i2d_locale_init(&object->locale, &json->config->locale_path)) {
+                status = i2d_panic("failed to load locale -- %s", json->config->locale_path.string);
+            } else if(json->config->ir_path.string && !(object->ir_output = json_array())) {
+                status = i2d_panic("failed to create json array");
             } else if(i2d_rbt_init(&object->function_handlers, i2d_rbt_cmp_str)) {
                 status = i2d_panic("failed to create read black tree object");
             } else if(i2d_rbt_init(&object->argument_handlers, i2d_rbt_cmp_str)) {
@@ -2124,6 +2277,9 @@ int i2d_script_init(i2d_script ** result, i2d_json * json) {
             } else if(i2d_rbt_init(&object->statement_handlers, i2d_rbt_cmp_str)) {
                 status = i2d_panic("failed to create read black tree object");
             } else {
+                /* a streamed run keeps the index only to write it */
+                object->is_index = !json->config->stream || json->config->index_path.string;
+
                 size = i2d_size(function_handlers);
                 for(i = 0; i < size && !status; i++)
                     if(i2d_rbt_insert(object->function_handlers, function_handlers[i].name, &function_handlers[i]))
@@ -2144,21 +2300,10 @@ int i2d_script_init(i2d_script ** result, i2d_json * json) {
                     if(i2d_rbt_insert(object->statement_handlers, statement_handlers[i].name, &statement_handlers[i]))
                         status = i2d_panic("failed to map handler object");
 
-                for(i = 0; i < object->arguments->size && !status; i++) {
-                    if(i2d_rbt_search(object->argument_handlers, object->arguments->list[i].handler.string, (void **) &handler)) {
-                        status = i2d_panic("failed to find handler -- %s", object->arguments->list[i].name.string);
-                    } else if(i2d_handler_list_append((i2d_handler **) &object->handlers, handler->type, &object->arguments->list[i], handler->ptr)) {
-                        status = i2d_panic("failed to append handler object");
-                    }
-                }
-
-                if(object->handlers) {
-                    handler = object->handlers;
-                    do {
-                        if(i2d_rbt_insert(object->argument_handlers, handler->name, handler))
-                            status = i2d_panic("failed to map handler object");
-                        handler = handler->next;
-                    } while(!status && handler != object->handlers);
+                if(!status && i2d_script_map_arguments(object)) {
+                    status = i2d_panic("failed to map arguments");
+                } else if(!status && i2d_script_compile_defaults(object)) {
+                    status = i2d_panic("failed to compile argument defaults");
                 }
             }
 
@@ -2169,6 +2314,193 @@ int i2d_script_init(i2d_script ** result, i2d_json * json) {
         }
     }
 
+    i2d_trace_end("i2d_script_init");
+
+    return status;
+}
+
+static int i2d_script_map_arguments(i2d_script * script) {
+    int status = I2D_OK;
+    i2d_handler * handler;
+    size_t i;
+
+    for(i = 0; i < script->arguments->size && !status; i++) {
+        if(i2d_rbt_search(script->argument_handlers, script->arguments->list[i].handler.string, (void **) &handler)) {
+            status = i2d_panic("failed to find handler -- %s", script->arguments->list[i].name.string);
+        } else if(i2d_handler_list_append((i2d_handler **) &script->handlers, handler->type, &script->arguments->list[i], handler->ptr)) {
+            status = i2d_panic("failed to append handler object");
+        }
+    }
+
+    if(!status && script->handlers) {
+        handler = script->handlers;
+        do {
+            if(i2d_rbt_insert(script->argument_handlers, handler->name, handler))
+                status = i2d_panic("failed to map handler object");
+            handler = handler->next;
+        } while(!status && handler != script->handlers);
+    }
+
+    return status;
+}
+
+static int i2d_script_unmap_arguments(i2d_script * script) {
+    int status = I2D_OK;
+    i2d_handler * handler;
+
+    if(script->handlers) {
+        handler = script->handlers;
+        do {
+            if(i2d_rbt_delete(script->argument_handlers, handler->name))
+                status = i2d_panic("failed to unmap handler object -- %s", handler->name);
+            handler = handler->next;
+        } while(!status && handler != script->handlers);
+
+        handler = script->handlers;
+        i2d_handler_list_deit(&handler);
+        script->handlers = NULL;
+    }
+
+    return status;
+}
+
+/*
+ * compile the argument_default of statements once
+ * instead of on each statement that omits them;
+ * the defaults are constants, so the nodes can be
+ * shared by every statement without a copy
+ */
+static int i2d_script_compile_defaults(i2d_script * script) {
+    int status = I2D_OK;
+    i2d_data * statement;
+    i2d_string * list;
+    size_t size;
+    size_t i;
+    size_t j;
+
+    for(i = 0; i < script->statements->size && !status; i++) {
+        statement = &script->statements->list[i];
+        i2d_string_stack_get(&statement->argument_default, &list, &size);
+        if(size) {
+            statement->argument_nodes = i2d_calloc(I2D_TAG_SCRIPT, size, sizeof(*statement->argument_nodes));
+            if(!statement->argument_nodes) {
+                status = i2d_panic("out of memory");
+            } else {
+                for(j = 0; j < size && !status; j++)
+                    if(i2d_script_compile_node(script, list[j].string, &statement->argument_nodes[j], NULL))
+                        status = i2d_panic("failed to compile argument default -- %s", statement->name.string);
+            }
+        }
+    }
+
+    return status;
+}
+
+static void i2d_script_reset_defaults(i2d_script * script) {
+    i2d_data * statement;
+    size_t i;
+    size_t j;
+
+    for(i = 0; i < script->statements->size; i++) {
+        statement = &script->statements->list[i];
+        if(statement->argument_nodes) {
+            for(j = 0; j < statement->argument_default.top; j++)
+                if(statement->argument_nodes[j])
+                    i2d_parser_node_reset(script->parser, script->lexer, &statement->argument_nodes[j]);
+            i2d_free(statement->argument_nodes);
+        }
+    }
+}
+
+/*
+ * reload the data file of kind (i.e. bonus) in
+ * place, where kind is the prefix of the index
+ * key; the script must be deit on failure
+ */
+int i2d_script_reload(i2d_script * script, i2d_json * json, const char * kind) {
+    int status = I2D_OK;
+    i2d_script_load load;
+
+    load.script = script;
+    load.json = json;
+
+    /* the descriptions of the nested scripts are stale */
+    i2d_deit(script->script_cache, i2d_script_cache_deit);
+
+    if(i2d_script_cache_init(&script->script_cache)) {
+        status = i2d_panic("failed to create script cache object");
+    } else if(!strcmp(kind, "bonus")) {
+        i2d_deit(script->bonus5, i2d_data_map_deit);
+        i2d_deit(script->bonus4, i2d_data_map_deit);
+        i2d_deit(script->bonus3, i2d_data_map_deit);
+        i2d_deit(script->bonus2, i2d_data_map_deit);
+        i2d_deit(script->bonus, i2d_data_map_deit);
+
+        if(i2d_script_load_bonus(&load)) {
+            status = i2d_panic("failed to load bonus");
+        } else if(i2d_data_map_index(script->bonus, data_map_by_constant, script->constant_db)) {
+            status = i2d_panic("failed to index bonus");
+        } else if(i2d_data_map_index(script->bonus2, data_map_by_constant, script->constant_db)) {
+            status = i2d_panic("failed to index bonus2");
+        } else if(i2d_data_map_index(script->bonus3, data_map_by_constant, script->constant_db)) {
+            status = i2d_panic("failed to index bonus3");
+        } else if(i2d_data_map_index(script->bonus4, data_map_by_constant, script->constant_db)) {
+            status = i2d_panic("failed to index bonus4");
+        } else if(i2d_data_map_index(script->bonus5, data_map_by_constant, script->constant_db)) {
+            status = i2d_panic("failed to index bonus5");
+        }
+    } else if(!strcmp(kind, "sc_start")) {
+        i2d_deit(script->sc_start4, i2d_data_map_deit);
+        i2d_deit(script->sc_start2, i2d_data_map_deit);
+        i2d_deit(script->sc_start, i2d_data_map_deit);
+
+        if(i2d_script_load_sc_start(&load)) {
+            status = i2d_panic("failed to load sc_start");
+        } else if(i2d_data_map_index(script->sc_start, data_map_by_constant, script->constant_db)) {
+            status = i2d_panic("failed to index sc_start");
+        } else if(i2d_data_map_index(script->sc_start2, data_map_by_constant, script->constant_db)) {
+            status = i2d_panic("failed to index sc_start2");
+        } else if(i2d_data_map_index(script->sc_start4, data_map_by_constant, script->constant_db)) {
+            status = i2d_panic("failed to index sc_start4");
+        }
+    } else if(!strcmp(kind, "statement")) {
+        i2d_script_reset_defaults(script);
+        i2d_deit(script->statements, i2d_data_map_deit);
+
+        if(i2d_script_load_statements(&load)) {
+            status = i2d_panic("failed to load statements");
+        } else if(i2d_data_map_index(script->statements, data_map_by_name, script->constant_db)) {
+            status = i2d_panic("failed to index statements");
+        } else if(i2d_script_compile_defaults(script)) {
+            status = i2d_panic("failed to compile argument defaults");
+        }
+    } else if(!strcmp(kind, "function")) {
+        i2d_deit(script->functions, i2d_data_map_deit);
+
+        if(i2d_script_load_functions(&load)) {
+            status = i2d_panic("failed to load functions");
+        } else if(i2d_data_map_index(script->functions, data_map_by_name, script->constant_db)) {
+            status = i2d_panic("failed to index functions");
+        }
+    } else if(!strcmp(kind, "argument")) {
+        /* the handlers of arguments refer to the data */
+        if(i2d_script_unmap_arguments(script)) {
+            status = i2d_panic("failed to unmap arguments");
+        } else {
+            i2d_deit(script->arguments, i2d_data_map_deit);
+
+            if(i2d_script_load_arguments(&load)) {
+                status = i2d_panic("failed to load arguments");
+            } else if(i2d_data_map_index(script->arguments, data_map_by_name, script->constant_db)) {
+                status = i2d_panic("failed to index arguments");
+            } else if(i2d_script_map_arguments(script)) {
+                status = i2d_panic("failed to map arguments");
+            }
+        }
+    } else {
+        status = i2d_panic("invalid data kind -- %s", kind);
+    }
+
     return status;
 }
 
@@ -2183,8 +2515,16 @@ void i2d_script_deit(i2d_script ** result) {
     i2d_deit(object->generate_handlers, i2d_rbt_deit);
     i2d_deit(object->argument_handlers, i2d_rbt_deit);
     i2d_deit(object->function_handlers, i2d_rbt_deit);
+    if(object->ir_output)
+        json_decref(object->ir_output);
+    i2d_deit(object->locale, i2d_locale_deit);
+    i2d_rope_destroy(&object->rope);
+    i2d_deit(object->index, i2d_index_deit);
+    i2d_deit(object->script_cache, i2d_script_cache_deit);
     i2d_deit(object->stack_cache, i2d_string_stack_cache_deit);
     i2d_deit(object->buffer_cache, i2d_buffer_cache_deit);
+    if(object->statements && object->parser && object->lexer)
+        i2d_script_reset_defaults(object);
     i2d_deit(object->statements, i2d_data_map_deit);
     i2d_deit(object->arguments, i2d_data_map_deit);
     i2d_deit(object->functions, i2d_data_map_deit);
@@ -2212,19 +2552,418 @@ void i2d_script_deit(i2d_script ** result) {
     *result = NULL;
 }
 
-int i2d_script_compile(i2d_script * script, i2d_string * source, i2d_string * target, i2d_rbt * inherit_variables) {
+int i2d_script_compile(i2d_script * script, i2d_string * source, i2d_string * target, i2d_rbt * inherit_variables) {
+    return i2d_script_compile_output(script, source, target, inherit_variables, NULL, NULL);
+}
+
+static int i2d_script_cache_cmp(const void * left, const void * right) {
+    return strcmp(left, right);
+}
+
+static int i2d_script_cache_entry_init(i2d_script_cache_entry ** result, i2d_buffer * key) {
+    int status = I2D_OK;
+    i2d_script_cache_entry * object;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_SCRIPT, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            if(i2d_string_create(I2D_TAG_SCRIPT, &object->key, key->buffer, key->offset)) {
+                status = i2d_panic("failed to create string object");
+            } else if(i2d_buffer_create(I2D_TAG_SCRIPT, &object->trace, BUFFER_SIZE_SMALL)) {
+                status = i2d_panic("failed to create buffer object");
+            }
+
+            if(status)
+                i2d_script_cache_entry_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+static void i2d_script_cache_entry_deit(i2d_script_cache_entry ** result) {
+    i2d_script_cache_entry * object;
+
+    object = *result;
+    i2d_buffer_destroy(&object->trace);
+    i2d_free(object->description.string);
+    i2d_free(object->key.string);
+    i2d_free(object);
+    *result = NULL;
+}
+
+int i2d_script_cache_init(i2d_script_cache ** result) {
+    int status = I2D_OK;
+    i2d_script_cache * object;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_SCRIPT, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            if(i2d_rbt_init(&object->map, i2d_script_cache_cmp)) {
+                status = i2d_panic("failed to create red black tree object");
+            } else if(i2d_buffer_create(I2D_TAG_SCRIPT, &object->key, BUFFER_SIZE_LARGE)) {
+                status = i2d_panic("failed to create buffer object");
+            }
+
+            if(status)
+                i2d_script_cache_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+void i2d_script_cache_deit(i2d_script_cache ** result) {
+    i2d_script_cache * object;
+    size_t i;
+
+    object = *result;
+    i2d_buffer_destroy(&object->key);
+    for(i = 0; i < object->size; i++)
+        i2d_script_cache_entry_deit(&object->list[i]);
+    i2d_free(object->list);
+    i2d_deit(object->map, i2d_rbt_deit);
+    i2d_free(object);
+    *result = NULL;
+}
+
+/*
+ * whether name is in string, i.e. whether the
+ * script can read the variable; variable names
+ * are not case sensitive
+ */
+static int i2d_script_cache_find(const char * string, const char * name) {
+    int status = I2D_FAIL;
+    size_t length;
+
+    length = strlen(name);
+    if(length) {
+        for(; *string && status; string++)
+#ifndef _WIN32
+            if(!strncasecmp(string, name, length))
+#else
+            if(!_strnicmp(string, name, length))
+#endif
+                status = I2D_OK;
+    }
+
+    return status;
+}
+
+static int i2d_script_cache_range(i2d_buffer * buffer, i2d_range * range) {
+    int status = I2D_OK;
+    i2d_range_node * walk;
+
+    if(range->list) {
+        walk = range->list;
+        do {
+            if(i2d_buffer_printf(buffer, "[%ld,%ld]", walk->min, walk->max))
+                status = i2d_panic("failed to write buffer object");
+            walk = walk->next;
+        } while(walk != range->list && !status);
+    }
+
+    return status;
+}
+
+static int i2d_script_cache_logic(i2d_buffer * buffer, i2d_logic * logic) {
+    int status = I2D_OK;
+
+    if(i2d_buffer_printf(buffer, "(%d,%lu:%s", logic->type, (unsigned long) logic->name.length, logic->name.string ? logic->name.string : "")) {
+        status = i2d_panic("failed to write buffer object");
+    } else if(i2d_script_cache_range(buffer, &logic->range)) {
+        status = i2d_panic("failed to write range object");
+    } else if(logic->left && (i2d_buffer_putc(buffer, 'l') || i2d_script_cache_logic(buffer, logic->left))) {
+        status = i2d_panic("failed to write logic object");
+    } else if(logic->right && (i2d_buffer_putc(buffer, 'r') || i2d_script_cache_logic(buffer, logic->right))) {
+        status = i2d_panic("failed to write logic object");
+    } else if(i2d_buffer_putc(buffer, ')')) {
+        status = i2d_panic("failed to write buffer object");
+    }
+
+    return status;
+}
+
+/*
+ * write every field that is copied when the node
+ * is read as a variable (i2d_parser_node_copy)
+ */
+static int i2d_script_cache_node(i2d_buffer * buffer, i2d_node * node) {
+    int status = I2D_OK;
+    i2d_string string;
+
+    i2d_zero(string);
+
+    /* only literal tokens have a string */
+    if(node->tokens)
+        i2d_node_get_string(node, &string);
+
+    if(i2d_buffer_printf(buffer, "(%d,%p,%d,%lu:%s", node->type, (void *) node->constant, node->tokens ? (int) node->tokens->type : -1, (unsigned long) string.length, string.string ? string.string : "")) {
+        status = i2d_panic("failed to write buffer object");
+    } else if(i2d_script_cache_range(buffer, &node->range)) {
+        status = i2d_panic("failed to write range object");
+    } else if(node->logic && (i2d_buffer_putc(buffer, 'g') || i2d_script_cache_logic(buffer, node->logic))) {
+        status = i2d_panic("failed to write logic object");
+    } else if(node->index && (i2d_buffer_putc(buffer, 'i') || i2d_script_cache_node(buffer, node->index))) {
+        status = i2d_panic("failed to write node object");
+    } else if(node->left && (i2d_buffer_putc(buffer, 'l') || i2d_script_cache_node(buffer, node->left))) {
+        status = i2d_panic("failed to write node object");
+    } else if(node->right && (i2d_buffer_putc(buffer, 'r') || i2d_script_cache_node(buffer, node->right))) {
+        status = i2d_panic("failed to write node object");
+    } else if(i2d_buffer_putc(buffer, ')')) {
+        status = i2d_panic("failed to write buffer object");
+    }
+
+    return status;
+}
+
+static int i2d_script_cache_variable(void * value, void * data) {
+    int status = I2D_OK;
+    i2d_node * variable = value;
+    i2d_script_cache * cache = data;
+    i2d_string name;
+
+    if(i2d_node_get_string(variable, &name)) {
+        status = i2d_panic("failed to get variable string");
+    } else if(i2d_script_cache_find(cache->source.string, name.string)) {
+        /* not read by the script */
+    } else if(i2d_buffer_putc(&cache->key, 'v') || i2d_script_cache_node(&cache->key, variable)) {
+        status = i2d_panic("failed to write variable -- %s", name.string);
+    }
+
+    return status;
+}
+
+/*
+ * compile a nested script once for each value of
+ * the variables that it can read; a hit copies the
+ * description and adds the index keys of the first
+ * compile for the current item
+ */
+static int i2d_script_compile_cache(i2d_script * script, i2d_string * source, i2d_string * target, i2d_rbt * variables) {
+    int status = I2D_OK;
+    i2d_script_cache * cache = script->script_cache;
+    i2d_script_cache_entry * entry = NULL;
+    i2d_script_cache_entry ** list;
+    size_t capacity;
+    i2d_buffer * trace;
+    char * key;
+    char * end;
+
+    i2d_buffer_clear(&cache->key);
+    cache->source = *source;
+
+    if(i2d_buffer_printf(&cache->key, "%lu:%s", (unsigned long) source->length, source->string)) {
+        status = i2d_panic("failed to write buffer object");
+    } else if(variables && i2d_rbt_iterate(variables, i2d_script_cache_variable, cache)) {
+        status = i2d_panic("failed to write variables");
+    } else if(!i2d_rbt_search(cache->map, cache->key.buffer, (void **) &entry)) {
+        key = entry->trace.buffer;
+        end = entry->trace.buffer + entry->trace.offset;
+        while(key < end && !status) {
+            if(i2d_index_add(script->index, "%s", key)) {
+                status = i2d_panic("failed to add index entry -- %s", key);
+            } else {
+                key += strlen(key) + 1;
+            }
+        }
+
+        if(!status && i2d_string_create(I2D_TAG_SCRIPT, target, entry->description.string, entry->description.length))
+            status = i2d_panic("failed to create string object");
+    } else if(i2d_script_cache_entry_init(&entry, &cache->key)) {
+        status = i2d_panic("failed to create script cache entry object");
+    } else {
+        /* the key buffer is reused by nested scripts */
+        trace = script->index->trace;
+        script->index->trace = &entry->trace;
+        if(i2d_script_compile(script, source, target, variables))
+            status = i2d_panic("failed to compile script -- %s", source->string);
+        script->index->trace = trace;
+
+        if(!status) {
+            if(trace && i2d_buffer_memcpy(trace, entry->trace.buffer, entry->trace.offset)) {
+                status = i2d_panic("failed to write buffer object");
+            } else if(i2d_string_create(I2D_TAG_SCRIPT, &entry->description, target->string, target->length)) {
+                status = i2d_panic("failed to create string object");
+            } else {
+                if(cache->size == cache->capacity) {
+                    capacity = cache->capacity ? cache->capacity * 2 : 64;
+                    list = i2d_realloc(I2D_TAG_SCRIPT, cache->list, capacity * sizeof(*cache->list));
+                    if(!list) {
+                        status = i2d_panic("out of memory");
+                    } else {
+                        cache->list = list;
+                        cache->capacity = capacity;
+                    }
+                }
+
+                if(status) {
+                    /* list is full */
+                } else if(i2d_rbt_insert(cache->map, entry->key.string, entry)) {
+                    status = i2d_panic("failed to map script cache entry object");
+                } else {
+                    cache->list[cache->size++] = entry;
+                    entry = NULL;
+                }
+            }
+
+            if(status)
+                i2d_string_destroy(target);
+        }
+
+        if(entry)
+            i2d_script_cache_entry_deit(&entry);
+    }
+
+    return status;
+}
+
+/*
+ * the number of intervals of a range, or else the
+ * number of values, which saturates at LONG_MAX
+ */
+static long i2d_script_budget_range(i2d_range * range, int is_value) {
+    long size = 0;
+    unsigned long span;
+    i2d_range_node * walk;
+
+    if(range->list) {
+        walk = range->list;
+        do {
+            span = is_value ? (unsigned long) walk->max - (unsigned long) walk->min + 1 : 1;
+            size = (!span || span > (unsigned long) (LONG_MAX - size)) ? LONG_MAX : size + (long) span;
+            walk = walk->next;
+        } while(walk != range->list && size < LONG_MAX);
+    }
+
+    return size;
+}
+
+static long i2d_script_budget_logic(i2d_logic * logic) {
+    return logic ? 1 + i2d_script_budget_logic(logic->left) + i2d_script_budget_logic(logic->right) : 0;
+}
+
+/*
+ * the budget stays exceeded for the rest of the
+ * item so that each level of the compile fails
+ */
+static int i2d_script_budget_charge(i2d_script * script, long ranges, long logics) {
+    int status = I2D_OK;
+    i2d_script_budget * budget = &script->budget;
+
+    budget->ranges = (ranges > LONG_MAX - budget->ranges) ? LONG_MAX : budget->ranges + ranges;
+    budget->logics = (logics > LONG_MAX - budget->logics) ? LONG_MAX : budget->logics + logics;
+
+    if(budget->is_exceeded) {
+        status = I2D_FAIL;
+    } else if(budget->range && budget->ranges > budget->range) {
+        status = i2d_panic("range budget of %ld exceeded", budget->range);
+    } else if(budget->logic && budget->logics > budget->logic) {
+        status = i2d_panic("logic budget of %ld exceeded", budget->logic);
+    } else if(budget->time && i2d_time() - budget->start > (uint64_t) budget->time) {
+        status = i2d_panic("time budget of %ld ms exceeded", budget->time);
+    }
+
+    if(status)
+        budget->is_exceeded = 1;
+
+    return status;
+}
+
+static int i2d_script_budget_node(i2d_script * script, i2d_node * node) {
+    int status = I2D_OK;
+
+    if(script->budget.is_active)
+        status = i2d_script_budget_charge(script, i2d_script_budget_range(&node->range, 0), i2d_script_budget_logic(node->logic));
+
+    return status;
+}
+
+static int i2d_script_budget_fallback(i2d_item * item) {
+    int status = I2D_OK;
+
+    i2d_item_reset_description(item);
+
+    if(i2d_string_create(I2D_TAG_SCRIPT, &item->script_description, I2D_SCRIPT_BUDGET_DESCRIPTION, strlen(I2D_SCRIPT_BUDGET_DESCRIPTION))) {
+        status = i2d_panic("failed to create string object");
+    } else if(i2d_string_create(I2D_TAG_SCRIPT, &item->onequip_script_description, "", 0)) {
+        status = i2d_panic("failed to create string object");
+    } else if(i2d_string_create(I2D_TAG_SCRIPT, &item->onunequip_script_description, "", 0)) {
+        status = i2d_panic("failed to create string object");
+    } else if(i2d_string_create(I2D_TAG_SCRIPT, &item->combo_description, "", 0)) {
+        status = i2d_panic("failed to create string object");
+    }
+
+    return status;
+}
+
+/*
+ * compile once and render the ir to the target
+ * string and to the key of the object if there
+ * is an object
+ */
+static int i2d_script_compile_output(i2d_script * script, i2d_string * source, i2d_string * target, i2d_rbt * inherit_variables, json_t * object, const char * key) {
+    int status = I2D_OK;
+    i2d_ir ir;
+    i2d_string description;
+    json_t * json = NULL;
+
+    i2d_trace_begin("i2d_script_compile", 0);
+
+    if(i2d_ir_create(&ir)) {
+        status = i2d_panic("failed to create ir object");
+    } else {
+        if(i2d_script_compile_ir(script, source, &ir, inherit_variables)) {
+            status = i2d_panic("failed to compile ir -- %s", source->string);
+        } else {
+            /* nested scripts are rendered while the ir is compiled */
+            i2d_rope_clear(&script->rope);
+            if( i2d_script_ir_text(script, &ir, &script->rope) ||
+                i2d_rope_join(&script->rope, 0, &description) ) {
+                status = i2d_panic("failed to render ir -- %s", source->string);
+            } else {
+                /* remove the last newline */
+                while(description.length > 0 && description.string[description.length - 1] == '\n')
+                    description.length--;
+                if(i2d_string_create(I2D_TAG_SCRIPT, target, description.string, description.length)) {
+                    status = i2d_panic("failed to create string object");
+                } else if(object) {
+                    if(i2d_script_ir_json(script, &ir, &json)) {
+                        status = i2d_panic("failed to render ir -- %s", source->string);
+                    } else if(json_object_set_new(object, key, json)) {
+                        status = i2d_panic("failed to set json object -- %s", key);
+                    }
+                }
+            }
+        }
+        i2d_ir_destroy(&ir);
+    }
+
+    i2d_trace_end("i2d_script_compile");
+
+    return status;
+}
+
+int i2d_script_compile_ir(i2d_script * script, i2d_string * source, i2d_ir * ir, i2d_rbt * inherit_variables) {
     int status = I2D_OK;
     i2d_token * tokens = NULL;
     i2d_block * blocks = NULL;
     i2d_rbt * variables = NULL;
-    i2d_string description;
-
-    i2d_zero(description);
+    i2d_ir * parent;
 
-    if(!strcmp("{}", source->string)) {
-        if(i2d_string_create(target, "", 0))
-            status = i2d_panic("failed to create string object");
-    } else {
+    if(strcmp("{}", source->string)) {
         if( inherit_variables ?
                 i2d_rbt_copy(&variables, inherit_variables) :
                 i2d_rbt_init(&variables, i2d_rbt_cmp_node) ) {
@@ -2236,18 +2975,16 @@ int i2d_script_compile(i2d_script * script, i2d_string * source, i2d_string * ta
                 if(i2d_parser_analysis(script->parser, script->lexer, script->statements, tokens, &blocks)) {
                     status = i2d_panic("failed to parse -- %s", source->string);
                 } else {
-                    if(i2d_script_translate(script, blocks, variables, NULL)) {
+                    /*
+                     * scripts that are compiled for the
+                     * arguments of a statement have an
+                     * ir of their own
+                     */
+                    parent = script->ir;
+                    script->ir = ir;
+                    if(i2d_script_translate(script, blocks, variables, NULL))
                         status = i2d_panic("failed to translate -- %s", source->string);
-                    } else if(i2d_script_generate(script, blocks, &blocks->buffer)) {
-                        status = i2d_panic("failed to generate -- %s", source->string);
-                    } else {
-                        i2d_buffer_get(&blocks->buffer, &description.string, &description.length);
-                        /* remove the last newline */
-                        while(description.length > 0 && description.string[description.length - 1] == '\n')
-                            description.string[--description.length] = 0;
-                        if(i2d_string_create(target, description.string, description.length))
-                            status = i2d_panic("failed to create string object");
-                    }
+                    script->ir = parent;
                     i2d_parser_reset(script->parser, script->lexer, &blocks);
                 }
                 i2d_lexer_reset(script->lexer, &tokens);
@@ -2261,17 +2998,50 @@ int i2d_script_compile(i2d_script * script, i2d_string * source, i2d_string * ta
 
 int i2d_script_compile_item(i2d_script * script, i2d_item * item) {
     int status = I2D_OK;
+    json_t * object = NULL;
+    i2d_script_budget * budget = &script->budget;
 
-    if(i2d_script_compile(script, &item->script, &item->script_description, NULL)) {
+    i2d_trace_begin("i2d_script_compile_item", item->id);
+
+    /* the item may be compiled again (i.e. in watch mode) */
+    i2d_item_reset_description(item);
+
+    if(script->is_index)
+        i2d_index_set_item(script->index, item->id);
+
+    budget->ranges = 0;
+    budget->logics = 0;
+    budget->is_exceeded = 0;
+    budget->is_active = budget->time || budget->range || budget->logic;
+    if(budget->time)
+        budget->start = i2d_time();
+
+    if(script->ir_output && !(object = json_pack("{s:I}", "id", (json_int_t) item->id))) {
+        status = i2d_panic("failed to create json object");
+    } else if(i2d_script_compile_output(script, &item->script, &item->script_description, NULL, object, "script")) {
         status = i2d_panic("failed to compile script -- %ld", item->id);
-    } else if(i2d_script_compile(script, &item->onequip_script, &item->onequip_script_description, NULL)) {
+    } else if(i2d_script_compile_output(script, &item->onequip_script, &item->onequip_script_description, NULL, object, "onequip_script")) {
         status = i2d_panic("failed to compile onequip script -- %ld", item->id);
-    } else if(i2d_script_compile(script, &item->onunequip_script, &item->onunequip_script_description, NULL)) {
+    } else if(i2d_script_compile_output(script, &item->onunequip_script, &item->onunequip_script_description, NULL, object, "onunequip_script")) {
         status = i2d_panic("failed to compile onunequip script -- %ld", item->id);
     } else if(i2d_script_compile_item_combo(script, item, &item->combo_description)) {
         status = i2d_panic("failed to compile item combo script -- %ld", item->id);
+    } else if(object && json_array_append(script->ir_output, object)) {
+        status = i2d_panic("failed to append json object");
     }
 
+    /* the panics of the charge and the compile are the log */
+    if(status && budget->is_exceeded)
+        status = i2d_script_budget_fallback(item);
+
+    if(object)
+        json_decref(object);
+
+    budget->is_active = 0;
+    i2d_index_set_item(script->index, 0);
+
+    i2d_trace_end("i2d_script_compile_item");
+
     return status;
 }
 
@@ -2289,7 +3059,7 @@ int i2d_script_compile_node(i2d_script * script, const char * string, i2d_node *
             i2d_rbt_init(&variables, i2d_rbt_cmp_node) ) {
         status = i2d_panic("failed to create red black tree object");
     } else {
-        if(i2d_string_create(&source, string, strlen(string))) {
+        if(i2d_string_create(I2D_TAG_SCRIPT, &source, string, strlen(string))) {
             status = i2d_panic("failed to create string object");
         } else {
             if(i2d_lexer_tokenize(script->lexer, &source, &tokens)) {
@@ -2328,10 +3098,10 @@ int i2d_script_compile_item_combo(i2d_script * script, i2d_item * item, i2d_stri
     i2d_string output;
 
     if(i2d_item_combo_db_search_by_id(script->db->item_combo_db, item->id, &item_combo_list)) {
-        if(i2d_string_create(result, "", 0))
+        if(i2d_string_create(I2D_TAG_SCRIPT, result, "", 0))
             status = i2d_panic("failed to create string object");
     } else {
-        if(i2d_buffer_create(&buffer, BUFFER_SIZE_LARGE)) {
+        if(i2d_buffer_create(I2D_TAG_SCRIPT, &buffer, BUFFER_SIZE_LARGE)) {
             status = i2d_panic("failed to create buffer object");
         } else {
             for(i = 0; i < item_combo_list->size && !status; i++) {
@@ -2352,7 +3122,7 @@ int i2d_script_compile_item_combo(i2d_script * script, i2d_item * item, i2d_stri
 
             if(!status) {
                 i2d_buffer_get(&buffer, &output.string, &output.length);
-                if(i2d_string_create(result, output.string, output.length))
+                if(i2d_string_create(I2D_TAG_SCRIPT, result, output.string, output.length))
                     status = i2d_panic("failed to create string object");
             }
 
@@ -2387,19 +3157,32 @@ int i2d_script_translate(i2d_script * script, i2d_block * blocks, i2d_rbt * vari
                         status = i2d_panic("failed to evaluate expression");
                     } else if(block->nodes->logic && i2d_logic_copy(&block->logics, block->nodes->logic)) {
                         status = i2d_panic("failed to copy logic object");
+                    } else if(block->logics && i2d_ir_condition(script->ir, block->logics)) {
+                        status = i2d_panic("failed to add condition to ir");
                     } else {
-                        if(block->logics && logics && i2d_logic_or(&merge, block->logics, logics))
+                        if(block->logics && logics && i2d_logic_or(&merge, block->logics, logics)) {
                             status = i2d_panic("failed to or logic object");
+                        } else if(merge && script->budget.is_active && i2d_script_budget_charge(script, 0, i2d_script_budget_logic(merge))) {
+                            status = i2d_panic("failed to or logic object within budget");
+                        }
                         if(!status)
                             status = i2d_script_translate(script, block->child, variables, merge ? merge : logics);
                         i2d_deit(merge, i2d_logic_deit);
+                        if(!status && block->logics && i2d_ir_end(script->ir))
+                            status = i2d_panic("failed to add end to ir");
                     }
                     break;
                 case I2D_ELSE:
                     if(logics && i2d_logic_not(&block->logics, logics)) {
                         status = i2d_panic("failed to not logic object");
+                    } else if(block->logics && script->budget.is_active && i2d_script_budget_charge(script, 0, i2d_script_budget_logic(block->logics))) {
+                        status = i2d_panic("failed to not logic object within budget");
+                    } else if(block->logics && i2d_ir_condition(script->ir, block->logics)) {
+                        status = i2d_panic("failed to add condition to ir");
                     } else {
                         status = i2d_script_translate(script, block->child, variables, block->logics);
+                        if(!status && block->logics && i2d_ir_end(script->ir))
+                            status = i2d_panic("failed to add end to ir");
                     }
                     break;
                 case I2D_FOR:
@@ -2416,44 +3199,251 @@ int i2d_script_translate(i2d_script * script, i2d_block * blocks, i2d_rbt * vari
     return status;
 }
 
-int i2d_script_generate(i2d_script * script, i2d_block * blocks, i2d_buffer * buffer) {
+int i2d_script_ir_text(i2d_script * script, i2d_ir * ir, i2d_rope * rope) {
     int status = I2D_OK;
+    i2d_buffer * buffer = NULL;
+    i2d_string condition;
+    size_t length;
+    size_t i;
 
-    i2d_block * block;
-    i2d_string string;
-
-    if(blocks) {
-        block = blocks;
-        do {
-            switch(block->type) {
-                case I2D_BLOCK:
-                    status = i2d_script_generate(script, block->child, buffer);
+    if(i2d_buffer_cache_get(script->buffer_cache, &buffer)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        for(i = 0; i < ir->size && !status; i++) {
+            switch(ir->list[i].type) {
+                case ir_statement:
+                    if(ir->list[i].parent < 0) {
+                        length = rope->length;
+                        if(i2d_script_ir_text_statement(script, ir, i, rope)) {
+                            status = i2d_panic("failed to render statement");
+                        } else if(rope->length > length && i2d_rope_add(rope, "\n", 1)) {
+                            status = i2d_panic("failed to add rope segment");
+                        }
+                    }
                     break;
-                case I2D_STATEMENT:
-                    i2d_buffer_get(&block->buffer, &string.string, &string.length);
-                    if(string.length && i2d_buffer_printf(buffer, "%s\n", string.string))
-                        status = i2d_panic("failed to write buffer object");
+                case ir_condition:
+                    i2d_buffer_clear(buffer);
+                    if(i2d_script_generate_or(script, ir->list[i].logic, buffer)) {
+                        status = i2d_panic("failed to generate condition");
+                    } else if( i2d_rope_store(rope, buffer->buffer, buffer->offset, &condition) ||
+                               i2d_rope_add(rope, "[", 1) ||
+                               i2d_rope_add(rope, condition.string, condition.length) ||
+                               i2d_rope_add(rope, "]\n", 2) ) {
+                        status = i2d_panic("failed to add rope segment");
+                    }
                     break;
-                case I2D_IF:
-                case I2D_ELSE:
-                    if(block->logics) {
-                        status = i2d_buffer_printf(buffer, "[") ||
-                                 i2d_script_generate_or(script, block->logics, buffer) ||
-                                 i2d_buffer_printf(buffer, "]\n") ||
-                                 i2d_script_generate(script, block->child, buffer);
+                case ir_end:
+                    break;
+                default:
+                    status = i2d_panic("invalid ir type -- %d", ir->list[i].type);
+                    break;
+            }
+        }
+        i2d_buffer_cache_put(script->buffer_cache, &buffer);
+    }
+
+    return status;
+}
+
+/*
+ * statements that are the arguments of another
+ * statement are only rendered again if there is
+ * a locale, otherwise the argument is the same;
+ * the description and the arguments are added as
+ * segments that refer to the data and the ir, and
+ * only a formatted range is copied to the rope
+ */
+int i2d_script_ir_text_statement(i2d_script * script, i2d_ir * ir, size_t index, i2d_rope * rope) {
+    int status = I2D_OK;
+    i2d_ir_entry * entry;
+    i2d_ir_entry * child;
+    i2d_ir_argument * argument;
+    i2d_string * description = NULL;
+    i2d_string list[MAX_ARGUMENT];
+    i2d_buffer * buffer = NULL;
+    size_t start;
+    size_t i;
+
+    entry = &ir->list[index];
+
+    if(entry->size > i2d_size(list)) {
+        status = i2d_panic("too many arguments -- %s", entry->data->name.string);
+    } else if(i2d_buffer_cache_get(script->buffer_cache, &buffer)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        for(i = 0; i < entry->size && !status; i++) {
+            if(script->locale && !i2d_ir_get_child(ir, index, i, &child)) {
+                start = rope->size;
+                if( i2d_script_ir_text_statement(script, ir, (size_t) (child - ir->list), rope) ||
+                    i2d_rope_join(rope, start, &list[i]) )
+                    status = i2d_panic("failed to render statement");
+            } else if(i2d_ir_get_value(ir, entry, i, &argument)) {
+                status = i2d_panic("failed to get argument");
+            } else if(!argument->format) {
+                list[i].string = ir->buffer.buffer + argument->offset;
+                list[i].length = argument->length;
+            } else {
+                i2d_buffer_clear(buffer);
+                if( i2d_ir_get_argument(ir, entry, i, buffer) ||
+                    i2d_rope_store(rope, buffer->buffer, buffer->offset, &list[i]) )
+                    status = i2d_panic("failed to format argument");
+            }
+        }
+
+        if(!status) {
+            if(!script->locale || i2d_locale_get(script->locale, entry->data, &description))
+                description = &entry->data->description;
+
+            if(i2d_script_statement_rope(entry->data, description, list, entry->size, rope))
+                status = i2d_panic("failed to format statement -- %s", entry->data->name.string);
+        }
+        i2d_buffer_cache_put(script->buffer_cache, &buffer);
+    }
+
+    return status;
+}
+
+/*
+ * statements are { name, arguments, description }
+ * where an argument is a string, a statement, or
+ * a range { text, min, max } and conditions are
+ * { condition, statements }
+ */
+int i2d_script_ir_json(i2d_script * script, i2d_ir * ir, json_t ** result) {
+    int status = I2D_OK;
+    json_t * stack[MAX_STACK];
+    size_t top = 0;
+    json_t * object = NULL;
+    i2d_buffer * buffer = NULL;
+    size_t i;
+
+    stack[top] = json_array();
+    if(!stack[top]) {
+        status = i2d_panic("failed to create json array");
+    } else if(i2d_buffer_cache_get(script->buffer_cache, &buffer)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        for(i = 0; i < ir->size && !status; i++) {
+            switch(ir->list[i].type) {
+                case ir_statement:
+                    if(ir->list[i].parent < 0) {
+                        if(i2d_script_ir_json_statement(script, ir, i, NULL, &object)) {
+                            status = i2d_panic("failed to render statement");
+                        } else if(json_array_append_new(stack[top], object)) {
+                            status = i2d_panic("failed to append json object");
+                        }
+                    }
+                    break;
+                case ir_condition:
+                    i2d_buffer_clear(buffer);
+                    if(top + 1 >= i2d_size(stack)) {
+                        status = i2d_panic("condition stack overflow");
+                    } else if(i2d_script_generate_or(script, ir->list[i].logic, buffer)) {
+                        status = i2d_panic("failed to generate condition");
+                    } else if(!(object = json_pack("{s:s%,s:[]}", "condition", buffer->buffer, buffer->offset, "statements"))) {
+                        status = i2d_panic("failed to create json object");
+                    } else if(json_array_append_new(stack[top], object)) {
+                        status = i2d_panic("failed to append json object");
                     } else {
-                        status = i2d_script_generate(script, block->child, buffer);
+                        top++;
+                        stack[top] = json_object_get(object, "statements");
                     }
                     break;
-                case I2D_FOR:
-                    /* for is unsupported */
+                case ir_end:
+                    if(!top) {
+                        status = i2d_panic("condition stack underflow");
+                    } else {
+                        top--;
+                    }
                     break;
                 default:
-                    status = i2d_panic("invalid block type -- %d", block->type);
+                    status = i2d_panic("invalid ir type -- %d", ir->list[i].type);
                     break;
             }
-            block = block->next;
-        } while(block != blocks && !status);
+        }
+        i2d_buffer_cache_put(script->buffer_cache, &buffer);
+    }
+
+    if(status) {
+        if(stack[0])
+            json_decref(stack[0]);
+    } else {
+        *result = stack[0];
+    }
+
+    return status;
+}
+
+/*
+ * the description of a statement is rendered by
+ * the text back-end unless it is given, i.e. the
+ * argument of the parent statement has the same
+ * text if there is no locale
+ */
+int i2d_script_ir_json_statement(i2d_script * script, i2d_ir * ir, size_t index, i2d_string * description, json_t ** result) {
+    int status = I2D_OK;
+    i2d_ir_entry * entry;
+    i2d_ir_entry * child;
+    i2d_ir_argument * range;
+    i2d_string argument;
+    i2d_string text;
+    size_t start;
+    i2d_buffer * buffer = NULL;
+    json_t * object = NULL;
+    json_t * arguments;
+    json_t * value;
+    size_t i;
+
+    entry = &ir->list[index];
+
+    if(i2d_buffer_cache_get(script->buffer_cache, &buffer)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        if(description) {
+            text = *description;
+        } else {
+            start = script->rope.size;
+            if( i2d_script_ir_text_statement(script, ir, index, &script->rope) ||
+                i2d_rope_join(&script->rope, start, &text) )
+                status = i2d_panic("failed to render statement");
+        }
+
+        if(status) {
+            /* failed to render statement */
+        } else if(!(object = json_pack("{s:s,s:[],s:s%}", "name", entry->data->name.string, "arguments", "description", text.string, text.length))) {
+            status = i2d_panic("failed to create json object");
+        } else {
+            arguments = json_object_get(object, "arguments");
+            for(i = 0; i < entry->size && !status; i++) {
+                i2d_buffer_clear(buffer);
+                if( i2d_ir_get_value(ir, entry, i, &range) ||
+                    i2d_ir_get_argument(ir, entry, i, buffer) ) {
+                    status = i2d_panic("failed to get argument");
+                } else {
+                    i2d_buffer_get(buffer, &argument.string, &argument.length);
+                    if(!i2d_ir_get_child(ir, index, i, &child)) {
+                        if(i2d_script_ir_json_statement(script, ir, (size_t) (child - ir->list), script->locale ? NULL : &argument, &value))
+                            status = i2d_panic("failed to render statement");
+                    } else if(range->format) {
+                        if(!(value = json_pack("{s:s%,s:I,s:I}", "text", argument.string, argument.length, "min", (json_int_t) range->min, "max", (json_int_t) range->max)))
+                            status = i2d_panic("failed to create json object");
+                    } else if(!(value = json_stringn(argument.string, argument.length))) {
+                        status = i2d_panic("failed to create json string");
+                    }
+                }
+
+                if(!status && json_array_append_new(arguments, value))
+                    status = i2d_panic("failed to append json object");
+            }
+        }
+        i2d_buffer_cache_put(script->buffer_cache, &buffer);
+    }
+
+    if(status) {
+        if(object)
+            json_decref(object);
+    } else {
+        *result = object;
     }
 
     return status;
@@ -2465,7 +3455,7 @@ int i2d_script_generate_or(i2d_script * script, i2d_logic * logic, i2d_buffer *
     switch(logic->type) {
         case or:
             status = i2d_script_generate_or(script, logic->left, buffer) ||
-                     i2d_buffer_printf(buffer, " or ") ||
+                     i2d_buffer_memcpy(buffer, " or ", 4) ||
                      i2d_script_generate_or(script, logic->right, buffer);
             break;
         case and:
@@ -2488,7 +3478,7 @@ int i2d_script_generate_and(i2d_script * script, i2d_logic * logic, i2d_buffer *
     switch(logic->type) {
         case and:
             status = i2d_script_generate_and(script, logic->left, buffer) ||
-                     i2d_buffer_printf(buffer, " and ") ||
+                     i2d_buffer_memcpy(buffer, " and ", 5) ||
                      i2d_script_generate_and(script, logic->right, buffer);
             break;
         case var:
@@ -2514,13 +3504,15 @@ int i2d_script_generate_var(i2d_script * script, i2d_logic * logic, i2d_buffer *
             walk = logic->range.list;
             do {
                 if(walk != logic->range.list)
-                    if(i2d_buffer_printf(buffer, ", "))
+                    if(i2d_buffer_memcpy(buffer, ", ", 2))
                         status = i2d_panic("failed to write buffer object");
                 if(walk->min == walk->max) {
-                    if(i2d_buffer_printf(buffer, "%ld", walk->min))
+                    if(i2d_buffer_putl(buffer, walk->min, 0))
                         status = i2d_panic("failed to write buffer object");
                 } else {
-                    if(i2d_buffer_printf(buffer, "%ld - %ld", walk->min, walk->max))
+                    if( i2d_buffer_putl(buffer, walk->min, 0) ||
+                        i2d_buffer_memcpy(buffer, " - ", 3) ||
+                        i2d_buffer_putl(buffer, walk->max, 0) )
                         status = i2d_panic("failed to write buffer object");
                 }
                 walk = walk->next;
@@ -2594,7 +3586,9 @@ static int i2d_script_logic_generate_basejob(i2d_script * script, i2d_logic * lo
         if(i2d_script_logic_generate_inverse(script, "BaseJob", &logic->range, &inverse, &is_inverse)) {
             status = i2d_panic("failed to generate inverse range object");
         } else {
-            if(i2d_range_iterate_by_number(is_inverse ? &inverse : &logic->range, i2d_script_logic_generate_basejob_cb, &context)) {
+            if(script->budget.is_active && i2d_script_budget_charge(script, i2d_script_budget_range(is_inverse ? &inverse : &logic->range, 1), 0)) {
+                status = i2d_panic("failed to iterate range object within budget");
+            } else if(i2d_range_iterate_by_number(is_inverse ? &inverse : &logic->range, i2d_script_logic_generate_basejob_cb, &context)) {
                 status = i2d_panic("failed to iterate range object");
             } else if(i2d_string_stack_dump_buffer(context.stack, context.buffer, ", ")) {
                 status = i2d_panic("failed to get job list from stack");
@@ -2633,7 +3627,9 @@ static int i2d_script_logic_generate_view(i2d_script * script, i2d_logic * logic
     if(i2d_local_create(&context, script)) {
         status = i2d_panic("failed to create local object");
     } else {
-        if(i2d_range_iterate_by_number(&logic->range, i2d_script_logic_generate_view_cb, &context)) {
+        if(script->budget.is_active && i2d_script_budget_charge(script, i2d_script_budget_range(&logic->range, 1), 0)) {
+            status = i2d_panic("failed to iterate range object within budget");
+        } else if(i2d_range_iterate_by_number(&logic->range, i2d_script_logic_generate_view_cb, &context)) {
             status = i2d_panic("failed to iterate range object");
         } else if(i2d_string_stack_dump_buffer(context.stack, context.buffer, ", ")) {
             status = i2d_panic("failed to get view list from stack");
@@ -2651,9 +3647,9 @@ static int i2d_script_logic_generate_view(i2d_script * script, i2d_logic * logic
 static int i2d_script_logic_generate_equipon_cb(long value, void * data) {
     int status = I2D_OK;
     i2d_local * context = data;
-    i2d_item * item;
+    i2d_item_entry * item;
 
-    if(i2d_item_db_search_by_id(context->script->db->item_db, value, &item)) {
+    if(i2d_item_db_search_entry_by_id(context->script->db->item_db, value, &item)) {
         status = i2d_panic("failed to get item by id -- %ld", value);
     } else if(i2d_string_stack_push(context->stack, item->name.string, item->name.length)) {
         status = i2d_panic("failed to push item name");
@@ -2670,7 +3666,9 @@ static int i2d_script_logic_generate_equipon(i2d_script * script, i2d_logic * lo
     if(i2d_local_create(&context, script)) {
         status = i2d_panic("failed to create local object");
     } else {
-        if(i2d_range_iterate_by_number(&logic->range, i2d_script_logic_generate_equipon_cb, &context)) {
+        if(script->budget.is_active && i2d_script_budget_charge(script, i2d_script_budget_range(&logic->range, 1), 0)) {
+            status = i2d_panic("failed to iterate range object within budget");
+        } else if(i2d_range_iterate_by_number(&logic->range, i2d_script_logic_generate_equipon_cb, &context)) {
             status = i2d_panic("failed to iterate range object");
         } else if(i2d_string_stack_dump_buffer(context.stack, context.buffer, ", ")) {
             status = i2d_panic("failed to get item list from stack");
@@ -2693,6 +3691,8 @@ int i2d_script_statement(i2d_script * script, i2d_block * block, i2d_rbt * varia
         status = i2d_panic("invalid handler string");
     } else if(i2d_rbt_search(script->statement_handlers, block->statement->handler.string, (void **) &handler)) {
         status = i2d_panic("failed to find handler -- %s", block->statement->handler.string);
+    } else if(i2d_index_add(script->index, "statement:%s", block->statement->name.string)) {
+        status = i2d_panic("failed to index statement -- %s", block->statement->name.string);
     } else {
         switch(handler->type) {
             case block_statement:
@@ -2728,40 +3728,32 @@ int i2d_script_statement_generic(i2d_script * script, i2d_block * block, i2d_rbt
     i2d_node * arguments[MAX_ARGUMENT];
 
     size_t i;
-    i2d_string * list;
-    size_t size;
-    i2d_node * defaults[MAX_ARGUMENT];
 
     i2d_zero(arguments);
-    i2d_zero(defaults);
 
     if(MAX_ARGUMENT <= statement->required + statement->optional) {
         status = i2d_panic("MAX_ARGUMENT overflow");
     } else if(i2d_node_get_arguments(block->nodes->tokens->type == I2D_TOKEN ? block->nodes->left : block->nodes, arguments, statement->required, statement->optional)) {
         status = i2d_panic("failed to get arguments");
     } else {
-        i2d_string_stack_get(&statement->argument_default, &list, &size);
-        for(i = 0; i < (size_t) statement->optional && i < size; i++) {
-            if(!arguments[i + statement->required]) {
-                if(i2d_script_compile_node(script, list[i].string, &defaults[i], variables)) {
-                    status = i2d_panic("failed to create default node object");
-                } else {
-                    arguments[i + statement->required] = defaults[i];
-                }
-            }
-        }
+        /* bind the compiled argument_default */
+        for(i = 0; i < (size_t) statement->optional && i < statement->argument_default.top; i++)
+            if(!arguments[i + statement->required])
+                arguments[i + statement->required] = statement->argument_nodes[i];
 
-        if(i2d_script_statement_evaluate(script, variables, arguments, statement, &block->buffer))
+        /* the ir back-ends render the description */
+        if(i2d_script_statement_evaluate(script, variables, arguments, statement, NULL))
             status = i2d_panic("failed to handle statement arguments");
-
-        for(i = 0; i < (size_t) statement->optional && i < size; i++)
-            if(defaults[i])
-                i2d_parser_node_reset(script->parser, script->lexer, &defaults[i]);
     }
 
     return status;
 }
 
+/*
+ * the description is only formatted to the buffer
+ * if there is one (i.e. the statement is the
+ * argument of another statement)
+ */
 int i2d_script_statement_evaluate(i2d_script * script, i2d_rbt * variables, i2d_node ** arguments, i2d_data * statement, i2d_buffer * buffer) {
     int status = I2D_OK;
     i2d_local local;
@@ -2770,9 +3762,14 @@ int i2d_script_statement_evaluate(i2d_script * script, i2d_rbt * variables, i2d_
     size_t size;
     i2d_string * list;
     i2d_handler * handler;
-    int is_empty;
+    size_t mark;
+    i2d_ir_range ranges[MAX_ARGUMENT];
 
     i2d_zero(local);
+    if(script->ir)
+        i2d_zero(ranges);
+
+    mark = i2d_ir_mark(script->ir);
 
     if(i2d_local_create(&local, script)) {
         status = i2d_panic("failed to create local object");
@@ -2794,6 +3791,8 @@ int i2d_script_statement_evaluate(i2d_script * script, i2d_rbt * variables, i2d_
                             status = i2d_panic("failed to find handler -- %s", list[i].string);
                         } else if(!arguments[statement->argument_order.list[i]]) {
                             break;
+                        } else if(i2d_index_add(script->index, "argument:%s", list[i].string)) {
+                            status = i2d_panic("failed to add index entry");
                         } else {
                             switch(handler->type) {
                                 case single_node:
@@ -2805,6 +3804,9 @@ int i2d_script_statement_evaluate(i2d_script * script, i2d_rbt * variables, i2d_
                                 case single_node_data:
                                     status = handler->single_node_data(handler->data, script, variables, arguments[statement->argument_order.list[i]], &local);
                                     break;
+                                case range_value:
+                                    status = i2d_handler_range_value(script, variables, arguments[statement->argument_order.list[i]], &local, handler->range_value, i2d_script_ir_range(script, &local, ranges));
+                                    break;
                                 default:
                                     status = i2d_panic("invalid handler type -- %d", handler->type);
                             }
@@ -2820,6 +3822,8 @@ int i2d_script_statement_evaluate(i2d_script * script, i2d_rbt * variables, i2d_
 
                     if(i2d_rbt_search(script->argument_handlers, list[i].string, (void **) &handler)) {
                         status = i2d_panic("failed to find handler -- %s", list[i].string);
+                    } else if(i2d_index_add(script->index, "argument:%s", list[i].string)) {
+                        status = i2d_panic("failed to add index entry");
                     } else {
                         switch(handler->type) {
                             case single_node:
@@ -2831,6 +3835,9 @@ int i2d_script_statement_evaluate(i2d_script * script, i2d_rbt * variables, i2d_
                             case single_node_data:
                                 status = handler->single_node_data(handler->data, script, variables, arguments[i], &local);
                                 break;
+                            case range_value:
+                                status = i2d_handler_range_value(script, variables, arguments[i], &local, handler->range_value, i2d_script_ir_range(script, &local, ranges));
+                                break;
                             default:
                                 status = i2d_panic("invalid handler type -- %d", handler->type);
                         }
@@ -2839,23 +3846,14 @@ int i2d_script_statement_evaluate(i2d_script * script, i2d_rbt * variables, i2d_
             }
         }
 
-        if(statement->dump_stack_instead_of_description) {
-            if(i2d_string_stack_dump_buffer(local.stack, buffer, "\n"))
-                status = i2d_panic("failed to dump string stack to buffer");
-        } else if(statement->empty_description_on_empty_string) {
-            if(i2d_string_stack_get(local.stack, &list, &size)) {
-                status = i2d_panic("failed to get argument stack array");
-            } else {
-                is_empty = I2D_OK;
-                for(i = 0; i < size && !status && !is_empty; i++)
-                    if(!list[i].length)
-                        is_empty = I2D_FAIL;
-
-                if(!is_empty && i2d_string_stack_format(local.stack, &statement->description, buffer))
-                    status = i2d_panic("failed to write statment description");
-            }
-        } else if(!status && i2d_string_stack_format(local.stack, &statement->description, buffer)) {
-            status = i2d_panic("failed to write statment description");
+        if(status) {
+            /* failed to evaluate arguments */
+        } else if(i2d_string_stack_get(local.stack, &list, &size)) {
+            status = i2d_panic("failed to get argument stack array");
+        } else if(i2d_ir_statement(script->ir, mark, statement, list, size > MAX_ARGUMENT ? NULL : ranges, size)) {
+            status = i2d_panic("failed to add statement to ir");
+        } else if(buffer && i2d_script_statement_format(statement, &statement->description, local.stack, buffer)) {
+            status = i2d_panic("failed to format statement");
         }
 
         if(i2d_local_destroy(&local))
@@ -2865,6 +3863,70 @@ int i2d_script_statement_evaluate(i2d_script * script, i2d_rbt * variables, i2d_
     return status;
 }
 
+/*
+ * the range of the argument that is pushed next
+ * on the stack if the ir is recorded
+ */
+static i2d_ir_range * i2d_script_ir_range(i2d_script * script, i2d_local * local, i2d_ir_range * ranges) {
+    return (script->ir && local->stack->top < MAX_ARGUMENT) ? &ranges[local->stack->top] : NULL;
+}
+
+int i2d_script_statement_format(i2d_data * statement, i2d_string * description, i2d_string_stack * stack, i2d_buffer * buffer) {
+    int status = I2D_OK;
+    size_t i;
+    size_t size;
+    i2d_string * list;
+    int is_empty;
+
+    if(statement->dump_stack_instead_of_description) {
+        if(i2d_string_stack_dump_buffer(stack, buffer, "\n"))
+            status = i2d_panic("failed to dump string stack to buffer");
+    } else if(statement->empty_description_on_empty_string) {
+        if(i2d_string_stack_get(stack, &list, &size)) {
+            status = i2d_panic("failed to get argument stack array");
+        } else {
+            is_empty = I2D_OK;
+            for(i = 0; i < size && !status && !is_empty; i++)
+                if(!list[i].length)
+                    is_empty = I2D_FAIL;
+
+            if(!is_empty && i2d_string_stack_format(stack, description, buffer))
+                status = i2d_panic("failed to write statment description");
+        }
+    } else if(i2d_string_stack_format(stack, description, buffer)) {
+        status = i2d_panic("failed to write statment description");
+    }
+
+    return status;
+}
+
+/*
+ * same as i2d_script_statement_format except that
+ * the description is split into rope segments
+ */
+static int i2d_script_statement_rope(i2d_data * statement, i2d_string * description, i2d_string * list, size_t size, i2d_rope * rope) {
+    int status = I2D_OK;
+    size_t i;
+    int is_empty;
+
+    if(statement->dump_stack_instead_of_description) {
+        if(i2d_rope_dump(rope, list, size, "\n"))
+            status = i2d_panic("failed to dump argument list to rope");
+    } else if(statement->empty_description_on_empty_string) {
+        is_empty = I2D_OK;
+        for(i = 0; i < size && !is_empty; i++)
+            if(!list[i].length)
+                is_empty = I2D_FAIL;
+
+        if(!is_empty && i2d_rope_format(rope, description, list, size))
+            status = i2d_panic("failed to write statment description");
+    } else if(i2d_rope_format(rope, description, list, size)) {
+        status = i2d_panic("failed to write statment description");
+    }
+
+    return status;
+}
+
 int i2d_script_expression(i2d_script * script, i2d_node * node, int flag, i2d_rbt * variables, i2d_logic * logics) {
     int status = I2D_OK;
     i2d_logic * conditional = NULL;
@@ -2903,6 +3965,9 @@ int i2d_script_expression(i2d_script * script, i2d_node * node, int flag, i2d_rb
         }
     }
 
+    if(!status && i2d_script_budget_node(script, node))
+        status = i2d_panic("failed to evaluate expression within budget");
+
     i2d_deit(conditional, i2d_logic_deit);
     return status;
 }
@@ -3004,6 +4069,8 @@ int i2d_script_expression_function(i2d_script * script, i2d_node * node, i2d_rbt
             status = i2d_panic("failed to get function string");
         } else if(i2d_rbt_search(script->function_handlers, name.string, (void **) &handler)) {
             status = i2d_panic("failed to get function handler -- %s", name.string);
+        } else if(i2d_index_add(script->index, "function:%s", name.string)) {
+            status = i2d_panic("failed to index function -- %s", name.string);
         } else {
             status = handler->single_node(script, variables, node, &local);
             if(!status && i2d_script_expression_variable_logic(script, node))
@@ -3368,11 +4435,11 @@ static int i2d_handler_init(i2d_handler ** result, enum i2d_handler_type type, i
     if(i2d_is_invalid(result) || !data) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_SCRIPT, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_string_copy(&object->name, data->name.string, data->name.length)) {
+            if(i2d_string_copy(I2D_TAG_SCRIPT, &object->name, data->name.string, data->name.length)) {
                 status = i2d_panic("failed to copy string object");
             } else {
                 object->type = type;
@@ -3531,7 +4598,9 @@ static int i2d_handler_getskilllv(i2d_script * script, i2d_rbt * variables, i2d_
     }
 
     if(!status) {
-        if(i2d_node_set_string(node, &skill->name)) {
+        if(i2d_index_add(script->index, "skill:%ld", skill->id)) {
+            status = i2d_panic("failed to index skill -- %ld", skill->id);
+        } else if(i2d_node_set_string(node, &skill->name)) {
             status = i2d_panic("failed to write skill string");
         } else if(i2d_range_create_add(&node->range, 0, skill->maxlv)) {
             status = i2d_panic("failed to create skill range");
@@ -3547,7 +4616,7 @@ static int i2d_handler_isequipped(i2d_script * script, i2d_rbt * variables, i2d_
     size_t i;
     size_t size;
     long id;
-    i2d_item * item;
+    i2d_item_entry * item;
 
     i2d_zero(arguments);
     size = i2d_size(arguments);
@@ -3558,12 +4627,13 @@ static int i2d_handler_isequipped(i2d_script * script, i2d_rbt * variables, i2d_
         for(i = 0; i < size && arguments[i] && !status; i++) {
             if(i2d_node_get_constant(arguments[i], &id)) {
                 status = i2d_panic("failed to get item id");
-            } else if(i2d_item_db_search_by_id(script->db->item_db, id, &item)) {
+            } else if(i2d_item_db_search_entry_by_id(script->db->item_db, id, &item)) {
                 status = i2d_panic("failed to get item by id -- %ld", id);
+            } else if(i2d_index_add(script->index, "item:%ld", item->id)) {
+                status = i2d_panic("failed to index item -- %ld", item->id);
             } else {
-                if( i ?
-                    i2d_buffer_printf(local->buffer, ", %s", item->name.string) :
-                    i2d_buffer_printf(local->buffer, "%s", item->name.string) )
+                if( (i && i2d_buffer_memcpy(local->buffer, ", ", 2)) ||
+                    i2d_buffer_memcpy(local->buffer, item->name.string, item->name.length) )
                     status = i2d_panic("failed to write expression buffer");
             }
         }
@@ -3585,22 +4655,24 @@ static int i2d_handler_countitem(i2d_script * script, i2d_rbt * variables, i2d_n
     i2d_node * arguments;
     long id;
     i2d_string name;
-    i2d_item * item = NULL;
+    i2d_item_entry * item = NULL;
 
     if(i2d_node_get_arguments(node->left, &arguments, 1, 0)) {
         status = i2d_panic("failed to get countitem arguments");
     } else if(i2d_node_get_constant(arguments, &id)) {
         status = i2d_panic("failed to get item id");
-    } else if(i2d_item_db_search_by_id(script->db->item_db, id, &item)) {
+    } else if(i2d_item_db_search_entry_by_id(script->db->item_db, id, &item)) {
         if(i2d_node_get_string(arguments, &name)) {
             status = i2d_panic("failed to get item string");
-        } else if(i2d_item_db_search_by_name(script->db->item_db, name.string, &item)) {
+        } else if(i2d_item_db_search_entry_by_name(script->db->item_db, name.string, &item)) {
             status = i2d_panic("failed to get item by id and string -- %ld %s", id, name.string);
         }
     }
 
     if(!status) {
-        if(i2d_string_stack_push(local->stack, item->name.string, item->name.length)) {
+        if(i2d_index_add(script->index, "item:%ld", item->id)) {
+            status = i2d_panic("failed to index item -- %ld", item->id);
+        } else if(i2d_string_stack_push(local->stack, item->name.string, item->name.length)) {
             status = i2d_panic("failed to push item name");
         } else {
             status = i2d_handler_general(script, variables, node, local);
@@ -3684,7 +4756,7 @@ static int i2d_handler_getiteminfo(i2d_script * script, i2d_rbt * variables, i2d
     i2d_node * arguments[2];
     long value;
     i2d_string string;
-    i2d_item * item;
+    i2d_item_entry * item;
 
     if(i2d_node_get_arguments(node->left, arguments, i2d_size(arguments), 0)) {
         status = i2d_panic("failed to get getiteminfo arguments");
@@ -3698,8 +4770,10 @@ static int i2d_handler_getiteminfo(i2d_script * script, i2d_rbt * variables, i2d
         } else {
             if(i2d_node_get_constant(arguments[0], &value)) {
                 status = i2d_panic("failed to get item id");
-            } else if(i2d_item_db_search_by_id(script->db->item_db, value, &item)) {
+            } else if(i2d_item_db_search_entry_by_id(script->db->item_db, value, &item)) {
                 status = i2d_panic("failed to get item by id -- %ld", value);
+            } else if(i2d_index_add(script->index, "item:%ld", item->id)) {
+                status = i2d_panic("failed to index item -- %ld", item->id);
             } else if(i2d_string_stack_push(local->stack, item->name.string, item->name.length)) {
                 status = i2d_panic("failed to push function string");
             }
@@ -4003,9 +5077,7 @@ static int i2d_handler_getexp2(i2d_script * script, i2d_rbt * variables, i2d_nod
         status = i2d_panic("failed to get getexp2 arguments");
     } else {
         i2d_range_get_range(&arguments[0]->range, &min, &max);
-        if( min == max ?
-            i2d_buffer_printf(local->buffer, "%ld", min) :
-            i2d_buffer_printf(local->buffer, "%ld ~ %ld", min, max) ) {
+        if(i2d_buffer_putr(local->buffer, min, max, 0)) {
             status = i2d_panic("failed to write integer range");
         } else if(i2d_string_stack_push_buffer(local->stack, local->buffer)) {
             status = i2d_panic("failed to push buffer on stack");
@@ -4013,9 +5085,7 @@ static int i2d_handler_getexp2(i2d_script * script, i2d_rbt * variables, i2d_nod
             i2d_buffer_clear(local->buffer);
 
             i2d_range_get_range(&arguments[1]->range, &min, &max);
-            if( min == max ?
-                i2d_buffer_printf(local->buffer, "%ld", min) :
-                i2d_buffer_printf(local->buffer, "%ld ~ %ld", min, max) ) {
+            if(i2d_buffer_putr(local->buffer, min, max, 0)) {
                 status = i2d_panic("failed to write integer range");
             } else if(i2d_string_stack_push_buffer(local->stack, local->buffer)) {
                 status = i2d_panic("failed to push buffer on stack");
@@ -4115,16 +5185,54 @@ static int i2d_handler_expression(i2d_script * script, i2d_rbt * variables, i2d_
     return status;
 }
 
-static int i2d_handler_milliseconds(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+/*
+ * the range of the node is written by format and
+ * the expression follows it; the ir keeps the
+ * range so that the back-ends can format it again
+ */
+static int i2d_handler_range_value(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local, i2d_handler_range_value_cb format, i2d_ir_range * range) {
     int status = I2D_OK;
     long min;
     long max;
 
+    i2d_range_get_range(&node->range, &min, &max);
+
+    if(format(min, max, local->buffer)) {
+        status = i2d_panic("failed to write range");
+    } else {
+        if(range) {
+            range->format = format;
+            range->min = min;
+            range->max = max;
+            range->length = local->buffer->offset;
+        }
+
+        if(i2d_handler_expression(script, variables, node, local))
+            status = i2d_panic("failed to write expression");
+    }
+
+    return status;
+}
+
+static void i2d_handler_absolute(long * result_min, long * result_max) {
+    long min = *result_min;
+    long max = *result_max;
+
+    if(min < 0)
+        min *= -1;
+    if(max < 0)
+        max *= -1;
+
+    *result_min = min(min, max);
+    *result_max = max(min, max);
+}
+
+static int i2d_handler_milliseconds(long min, long max, i2d_buffer * buffer) {
+    int status = I2D_OK;
+
     char * suffix = NULL;
     long unit = 0;
 
-    i2d_range_get_range(&node->range, &min, &max);
-
     if (min / 86400000 > 0) {
         suffix = "day";
         unit = 86400000;
@@ -4146,25 +5254,21 @@ static int i2d_handler_milliseconds(i2d_script * script, i2d_rbt * variables, i2
     max /= unit;
 
     if( min == max ?
-        i2d_buffer_printf(local->buffer, "%ld %s%s", min, suffix, min > 1 ? "s" : "") :
-        i2d_buffer_printf(local->buffer, "%ld ~ %ld %s%s", min, max, suffix, max > 1 ? "s" : "") ) {
+        i2d_buffer_printf(buffer, "%ld %s%s", min, suffix, min > 1 ? "s" : "") :
+        i2d_buffer_printf(buffer, "%ld ~ %ld %s%s", min, max, suffix, max > 1 ? "s" : "") ) {
         status = i2d_panic("failed to write time range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
     }
 
     return status;
 }
 
-static int i2d_handler_milliseconds_absolute(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_milliseconds_absolute(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
 
     char * suffix = NULL;
     long unit = 0;
 
-    i2d_range_get_range_absolute(&node->range, &min, &max);
+    i2d_handler_absolute(&min, &max);
 
     if (min / 86400000 > 0) {
         suffix = "day";
@@ -4187,26 +5291,20 @@ static int i2d_handler_milliseconds_absolute(i2d_script * script, i2d_rbt * vari
     max /= unit;
 
     if( min == max ?
-        i2d_buffer_printf(local->buffer, "%ld %s%s", min, suffix, min > 1 ? "s" : "") :
-        i2d_buffer_printf(local->buffer, "%ld ~ %ld %s%s", min, max, suffix, max > 1 ? "s" : "") ) {
+        i2d_buffer_printf(buffer, "%ld %s%s", min, suffix, min > 1 ? "s" : "") :
+        i2d_buffer_printf(buffer, "%ld ~ %ld %s%s", min, max, suffix, max > 1 ? "s" : "") ) {
         status = i2d_panic("failed to write time range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
     }
 
     return status;
 }
 
-static int i2d_handler_seconds(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_seconds(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
 
     char * suffix = NULL;
     long unit = 0;
 
-    i2d_range_get_range(&node->range, &min, &max);
-
     if (min / 86400 > 0) {
         suffix = "day";
         unit = 86400;
@@ -4225,11 +5323,9 @@ static int i2d_handler_seconds(i2d_script * script, i2d_rbt * variables, i2d_nod
     max /= unit;
 
     if( min == max ?
-        i2d_buffer_printf(local->buffer, "%ld %s%s", min, suffix, min > 1 ? "s" : "") :
-        i2d_buffer_printf(local->buffer, "%ld ~ %ld %s%s", min, max, suffix, max > 1 ? "s" : "") ) {
+        i2d_buffer_printf(buffer, "%ld %s%s", min, suffix, min > 1 ? "s" : "") :
+        i2d_buffer_printf(buffer, "%ld ~ %ld %s%s", min, max, suffix, max > 1 ? "s" : "") ) {
         status = i2d_panic("failed to write time range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
     }
 
     return status;
@@ -4243,8 +5339,8 @@ static int i2d_handler_regen(i2d_script * script, i2d_rbt * variables, i2d_node
         status = i2d_panic("failed to get constant");
     } else {
         switch(constant) {
-            case 1: status = i2d_buffer_printf(local->buffer, "HP"); break;
-            case 2: status = i2d_buffer_printf(local->buffer, "SP"); break;
+            case 1: status = i2d_buffer_memcpy(local->buffer, "HP", 2); break;
+            case 2: status = i2d_buffer_memcpy(local->buffer, "SP", 2); break;
             default: status = i2d_panic("unsupported regen value -- %ld", constant); break;
         }
         if(status) {
@@ -4257,21 +5353,16 @@ static int i2d_handler_regen(i2d_script * script, i2d_rbt * variables, i2d_node
     return status;
 }
 
-static int i2d_handler_splash(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_splash(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
 
-    i2d_range_get_range(&node->range, &min, &max);
     min = min * 2 + 1;
     max = max * 2 + 1;
 
     if( min == max ?
-        i2d_buffer_printf(local->buffer, "%ld x %ld", min, min) :
-        i2d_buffer_printf(local->buffer, "%ld x %ld ~ %ld x %ld", min, min, max, max) ) {
+        i2d_buffer_printf(buffer, "%ld x %ld", min, min) :
+        i2d_buffer_printf(buffer, "%ld x %ld ~ %ld x %ld", min, min, max, max) ) {
         status = i2d_panic("failed to write splash range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
     }
 
     return status;
@@ -4331,188 +5422,108 @@ static int i2d_handler_classes(i2d_script * script, i2d_rbt * variables, i2d_nod
             i2d_handler_expression(script, variables, node, local);
 }
 
-static int i2d_handler_integer(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_integer(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
 
-    i2d_range_get_range(&node->range, &min, &max);
-    if( min == max ?
-        i2d_buffer_printf(local->buffer, "%ld", min) :
-        i2d_buffer_printf(local->buffer, "%ld ~ %ld", min, max) ) {
+    if(i2d_buffer_putr(buffer, min, max, 0))
         status = i2d_panic("failed to write integer range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
-    }
 
     return status;
 }
 
-static int i2d_handler_integer_sign(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_integer_sign(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
 
-    i2d_range_get_range(&node->range, &min, &max);
-    if( min == max ?
-        i2d_buffer_printf(local->buffer, "%+ld", min) :
-        i2d_buffer_printf(local->buffer, "%+ld ~ %+ld", min, max) ) {
+    if(i2d_buffer_putr(buffer, min, max, I2D_BUFFER_SIGN))
         status = i2d_panic("failed to write integer range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
-    }
 
     return status;
 }
 
-static int i2d_handler_integer_absolute(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_integer_absolute(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
 
-    i2d_range_get_range_absolute(&node->range, &min, &max);
-    if( min == max ?
-        i2d_buffer_printf(local->buffer, "%ld", min) :
-        i2d_buffer_printf(local->buffer, "%ld ~ %ld", min, max) ) {
+    i2d_handler_absolute(&min, &max);
+    if(i2d_buffer_putr(buffer, min, max, 0))
         status = i2d_panic("failed to write integer range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
-    }
 
     return status;
 }
 
-static int i2d_handler_percent(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_percent(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
 
-    i2d_range_get_range(&node->range, &min, &max);
-    if( min == max ?
-        i2d_buffer_printf(local->buffer, "%ld%%", min) :
-        i2d_buffer_printf(local->buffer, "%ld%% ~ %ld%%", min, max) ) {
+    if(i2d_buffer_putr(buffer, min, max, I2D_BUFFER_PERCENT))
         status = i2d_panic("failed to write percent range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
-    }
 
     return status;
 }
 
-static int i2d_handler_percent_sign(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_percent_sign(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
 
-    i2d_range_get_range(&node->range, &min, &max);
-    if( min == max ?
-        i2d_buffer_printf(local->buffer, "%+ld%%", min) :
-        i2d_buffer_printf(local->buffer, "%+ld%% ~ %+ld%%", min, max) ) {
+    if(i2d_buffer_putr(buffer, min, max, I2D_BUFFER_SIGN | I2D_BUFFER_PERCENT))
         status = i2d_panic("failed to write percent range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
-    }
 
     return status;
 }
 
-static int i2d_handler_percent_sign_inverse(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_percent_sign_inverse(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
-
-    i2d_range_get_range(&node->range, &min, &max);
 
     min *= -1;
     max *= -1;
 
-    if( min == max ?
-        i2d_buffer_printf(local->buffer, "%+ld%%", min) :
-        i2d_buffer_printf(local->buffer, "%+ld%% ~ %+ld%%", min, max) ) {
+    if(i2d_buffer_putr(buffer, min, max, I2D_BUFFER_SIGN | I2D_BUFFER_PERCENT))
         status = i2d_panic("failed to write percent range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
-    }
 
     return status;
 }
 
-static int i2d_handler_percent_absolute(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_percent_absolute(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
 
-    i2d_range_get_range_absolute(&node->range, &min, &max);
-    if( min == max ?
-        i2d_buffer_printf(local->buffer, "%ld%%", min) :
-        i2d_buffer_printf(local->buffer, "%ld%% ~ %ld%%", min, max) ) {
+    i2d_handler_absolute(&min, &max);
+    if(i2d_buffer_putr(buffer, min, max, I2D_BUFFER_PERCENT))
         status = i2d_panic("failed to write percent range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
-    }
 
     return status;
 }
 
-static int i2d_handler_percent10(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_percent10(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
-
-    i2d_range_get_range(&node->range, &min, &max);
 
     min /= 10;
     max /= 10;
 
-    if( min == max ?
-        i2d_buffer_printf(local->buffer, "%ld%%", min) :
-        i2d_buffer_printf(local->buffer, "%ld%% ~ %ld%%", min, max) ) {
+    if(i2d_buffer_putr(buffer, min, max, I2D_BUFFER_PERCENT))
         status = i2d_panic("failed to write percent range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
-    }
 
     return status;
 }
 
-static int i2d_handler_percent100(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_percent100(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
-
-    i2d_range_get_range(&node->range, &min, &max);
 
     min /= 100;
     max /= 100;
 
-    if( min == max ?
-        i2d_buffer_printf(local->buffer, "%ld%%", min) :
-        i2d_buffer_printf(local->buffer, "%ld%% ~ %ld%%", min, max) ) {
+    if(i2d_buffer_putr(buffer, min, max, I2D_BUFFER_PERCENT))
         status = i2d_panic("failed to write percent range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
-    }
 
     return status;
 }
 
-static int i2d_handler_percent100_absolute(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_percent100_absolute(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
-    long min;
-    long max;
 
-    i2d_range_get_range_absolute(&node->range, &min, &max);
+    i2d_handler_absolute(&min, &max);
 
     min /= 100;
     max /= 100;
 
-    if( min == max ?
-        i2d_buffer_printf(local->buffer, "%ld%%", min) :
-        i2d_buffer_printf(local->buffer, "%ld%% ~ %ld%%", min, max) ) {
+    if(i2d_buffer_putr(buffer, min, max, I2D_BUFFER_PERCENT))
         status = i2d_panic("failed to write percent range");
-    } else if(i2d_handler_expression(script, variables, node, local)) {
-        status = i2d_panic("failed to write expression");
-    }
 
     return status;
 }
@@ -4550,6 +5561,8 @@ static int i2d_handler_skill_cb(i2d_script * script, i2d_string_stack * stack, l
 
     if(i2d_skill_db_search_by_id(script->db->skill_db, id, &skill)) {
         status = i2d_panic("failed to get skill by id -- %ld", id);
+    } else if(i2d_index_add(script->index, "skill:%ld", skill->id)) {
+        status = i2d_panic("failed to index skill -- %ld", skill->id);
     } else if(i2d_string_stack_push(stack, skill->name.string, skill->name.length)) {
         status = i2d_panic("failed to push string on stack");
     }
@@ -4567,6 +5580,8 @@ static int i2d_handler_skill(i2d_script * script, i2d_rbt * variables, i2d_node
     } else if(i2d_skill_db_search_by_macro(script->db->skill_db, name.string, &skill)) {
         status =    i2d_handler_range(script, node, local, i2d_handler_skill_cb) ||
                     i2d_handler_expression(script, variables, node, local);
+    } else if(i2d_index_add(script->index, "skill:%ld", skill->id)) {
+        status = i2d_panic("failed to index skill -- %ld", skill->id);
     } else if(i2d_string_stack_push(local->stack, skill->name.string, skill->name.length)) {
         status = i2d_panic("failed to push string on stack");
     }
@@ -4580,7 +5595,9 @@ static int i2d_handler_mob_cb(i2d_script * script, i2d_string_stack * stack, lon
     i2d_constant * constant;
 
     if(!i2d_mob_db_search_by_id(script->db->mob_db, id, &mob)) {
-        if(i2d_string_stack_push(stack, mob->kro.string, mob->kro.length))
+        if(i2d_index_add(script->index, "mob:%ld", mob->id))
+            status = i2d_panic("failed to index mob -- %ld", mob->id);
+        else if(i2d_string_stack_push(stack, mob->kro.string, mob->kro.length))
             status = i2d_panic("failed to push string on stack");
     } else if(!i2d_constant_get_by_job(script->constant_db, id, &constant)) {
         if(i2d_string_stack_push(stack, constant->name.string, constant->name.length))
@@ -4651,14 +5668,9 @@ static int i2d_handler_weapons(i2d_script * script, i2d_rbt * variables, i2d_nod
             i2d_handler_expression(script, variables, node, local);
 }
 
-static int i2d_handler_zeny(i2d_script * script, i2d_rbt * variables, i2d_node * node, i2d_local * local) {
+static int i2d_handler_zeny(long min, long max, i2d_buffer * buffer) {
     int status = I2D_OK;
 
-    long min;
-    long max;
-
-    i2d_range_get_range(&node->range, &min, &max);
-
     if(is_negative(min)) {
         if(is_positive(max)) {
             status = i2d_panic("zeny range cannot be both negative and positive");
@@ -4666,21 +5678,13 @@ static int i2d_handler_zeny(i2d_script * script, i2d_rbt * variables, i2d_node *
             min *= -1;
             max *= -1;
             if( min == max ?
-                i2d_buffer_printf(local->buffer, "%ld * Monster Level", min) :
-                i2d_buffer_printf(local->buffer, "(%ld ~ %ld) * Monster Level", min, max) ) {
+                i2d_buffer_printf(buffer, "%ld * Monster Level", min) :
+                i2d_buffer_printf(buffer, "(%ld ~ %ld) * Monster Level", min, max) ) {
                 status = i2d_panic("failed to write zeny formula");
-            } else if(i2d_handler_expression(script, variables, node, local)) {
-                status = i2d_panic("failed to write expression");
             }
         }
-    } else {
-        if( min == max ?
-            i2d_buffer_printf(local->buffer, "%ld", min) :
-            i2d_buffer_printf(local->buffer, "%ld ~ %ld", min, max) ) {
-            status = i2d_panic("failed to write zeny range");
-        } else if(i2d_handler_expression(script, variables, node, local)) {
-            status = i2d_panic("failed to write expression");
-        }
+    } else if(i2d_buffer_putr(buffer, min, max, 0)) {
+        status = i2d_panic("failed to write zeny range");
     }
 
     return status;
@@ -4688,10 +5692,12 @@ static int i2d_handler_zeny(i2d_script * script, i2d_rbt * variables, i2d_node *
 
 static int i2d_handler_item_cb(i2d_script * script, i2d_string_stack * stack, long id) {
     int status = I2D_OK;
-    i2d_item * item;
+    i2d_item_entry * item;
 
-    if(i2d_item_db_search_by_id(script->db->item_db, id, &item)) {
+    if(i2d_item_db_search_entry_by_id(script->db->item_db, id, &item)) {
         status = i2d_panic("failed to get item by id -- %ld", id);
+    } else if(i2d_index_add(script->index, "item:%ld", item->id)) {
+        status = i2d_panic("failed to index item -- %ld", item->id);
     } else if(i2d_string_stack_push(stack, item->name.string, item->name.length)) {
         status = i2d_panic("failed to push string on stack");
     }
@@ -4776,9 +5782,9 @@ static int i2d_handler_bf_type(i2d_script * script, i2d_rbt * variables, i2d_nod
             if((BF_NORMAL->value | BF_SKILL->value) == (mask & (BF_NORMAL->value | BF_SKILL->value))) {
                 status = i2d_buffer_printf(local->buffer, "%s / %s", BF_NORMAL->name.string, BF_SKILL->name.string);
             } else if(mask & BF_NORMAL->value) {
-                status = i2d_buffer_printf(local->buffer, "%s", BF_NORMAL->name.string);
+                status = i2d_buffer_memcpy(local->buffer, BF_NORMAL->name.string, BF_NORMAL->name.length);
             } else if(mask & BF_SKILL->value) {
-                status = i2d_buffer_printf(local->buffer, "%s", BF_SKILL->name.string);
+                status = i2d_buffer_memcpy(local->buffer, BF_SKILL->name.string, BF_SKILL->name.length);
             }
 
             if(status) {
@@ -4814,7 +5820,7 @@ static int i2d_handler_bf_damage(i2d_script * script, i2d_rbt * variables, i2d_n
             mask |= BF_WEAPON->value;
 
         if(mask & BF_WEAPON->value)
-            status = i2d_buffer_printf(local->buffer, "%s", BF_WEAPON->name.string);
+            status = i2d_buffer_memcpy(local->buffer, BF_WEAPON->name.string, BF_WEAPON->name.length);
         if(!status && mask & BF_MAGIC->value)
             status = i2d_buffer_printf(local->buffer, "%s%s", local->buffer->offset ? ", " : "", BF_MAGIC->name.string);
         if(!status && mask & BF_MISC->value)
@@ -4903,7 +5909,7 @@ static int i2d_handler_atf_type(i2d_script * script, i2d_rbt * variables, i2d_no
             status = i2d_panic("failed to write buffer");
         } else {
             if(mask & ATF_WEAPON->value)
-                status = i2d_buffer_printf(local->buffer, "%s", ATF_WEAPON->name.string);
+                status = i2d_buffer_memcpy(local->buffer, ATF_WEAPON->name.string, ATF_WEAPON->name.length);
             if(!status && mask & ATF_MAGIC->value)
                 status = i2d_buffer_printf(local->buffer, "%s%s", local->buffer->offset ? ", " : "", ATF_MAGIC->name.string);
             if(!status && mask & ATF_MISC->value)
@@ -4930,11 +5936,11 @@ static int i2d_handler_script(i2d_script * script, i2d_rbt * variables, i2d_node
     } else {
         if( string.string[0] != '{' ?
             i2d_buffer_printf(local->buffer, "{%s}", string.string) :
-            i2d_buffer_printf(local->buffer, "%s", string.string) ) {
+            i2d_buffer_memcpy(local->buffer, string.string, string.length) ) {
             status = i2d_panic("failed to write buffer object");
         } else {
             i2d_buffer_get(local->buffer, &string.string, &string.length);
-            if(i2d_script_compile(script, &string, &description, variables)) {
+            if(i2d_script_compile_cache(script, &string, &description, variables)) {
                 status = i2d_panic("failed to compile script -- %s", string.string);
             } else {
                 if(i2d_string_stack_push(local->stack, description.string, description.length))
@@ -5098,7 +6104,7 @@ static int i2d_handler_pet_script(i2d_script * script, i2d_rbt * variables, i2d_
         status = i2d_panic("failed to get pet id");
     } else if(i2d_pet_db_search_by_id(script->db->pet_db, id, &pet)) {
         status = i2d_panic("failed to get pet by id -- %ld", id);
-    } else if(i2d_script_compile(script, &pet->pet_script, &pet_script, variables)) {
+    } else if(i2d_script_compile_cache(script, &pet->pet_script, &pet_script, variables)) {
         status = i2d_panic("failed to compile script -- %s", pet->pet_script.string);
     } else {
         if(i2d_string_stack_push(local->stack, pet_script.string, pet_script.length))
@@ -5121,7 +6127,7 @@ static int i2d_handler_pet_loyal_script(i2d_script * script, i2d_rbt * variables
         status = i2d_panic("failed to get pet id");
     } else if(i2d_pet_db_search_by_id(script->db->pet_db, id, &pet)) {
         status = i2d_panic("failed to get pet by id -- %ld", id);
-    } else if(i2d_script_compile(script, &pet->loyal_script, &loyal_script, variables)) {
+    } else if(i2d_script_compile_cache(script, &pet->loyal_script, &loyal_script, variables)) {
         status = i2d_panic("failed to compile script -- %s", pet->loyal_script.string);
     } else {
         if(i2d_string_stack_push(local->stack, loyal_script.string, loyal_script.length))
@@ -5136,48 +6142,17 @@ static int i2d_handler_produce(i2d_script * script, i2d_rbt * variables, i2d_nod
     int status = I2D_OK;
     long item_level;
     i2d_produce_list * produce_list;
-    i2d_produce * produce;
-    size_t i;
-    i2d_item * item;
-    i2d_skill * skill;
-    size_t j;
-    long item_id;
-    long item_amount;
-    i2d_item * material;
 
     if(i2d_node_get_constant(node, &item_level)) {
         status = i2d_panic("failed to get item level");
     } else if(i2d_produce_db_search_by_item_level(script->db->produce_db, item_level, &produce_list)) {
         status = i2d_panic("failed to get produce list by item level -- %ld", item_level);
-    } else {
-        for(i = 0; i < produce_list->size && !status; i++) {
-            item = NULL;
-            skill = NULL;
-            produce = produce_list->list[i];
-            if(i2d_item_db_search_by_id(script->db->item_db, produce->item_id, &item)) {
-                status = i2d_panic("failed to get item by id -- %ld", produce->item_id);
-            } else if(produce->skill_id && i2d_skill_db_search_by_id(script->db->skill_db, produce->skill_id, &skill)) {
-                status = i2d_panic("failed to get skill by id -- %ld", produce->skill_id);
-            } else {
-                if( skill ?
-                    i2d_buffer_printf(local->buffer, "[%s - Level %ld %s]\n", item->name.string, produce->skill_level, skill->name.string) :
-                    i2d_buffer_printf(local->buffer, "[%s]\n", item->name.string) ) {
-                    status = i2d_panic("failed to write buffer object");
-                } else {
-                    for(j = 0; j < produce->material_count && !status; j += 2) {
-                        item_id = produce->materials[j];
-                        item_amount = produce->materials[j + 1];
-                        if(i2d_item_db_search_by_id(script->db->item_db, item_id, &material)) {
-                            status = i2d_panic("failed to get item by id -- %ld", item_id);
-                        } else if(i2d_buffer_printf(local->buffer, "x%ld %s\n", item_amount, material->name.string)) {
-                            status = i2d_panic("failed to write buffer object");
-                        }
-                    }
-                }
-            }
-        }
-        if(!status && i2d_string_stack_push_buffer(local->stack, local->buffer))
-            status = i2d_panic("failed to push string on stack");
+    } else if(!produce_list->description.string) {
+        status = i2d_panic("failed to resolve produce list by item level -- %ld", item_level);
+    } else if(i2d_index_add(script->index, "produce:%ld", item_level)) {
+        status = i2d_panic("failed to index produce -- %ld", item_level);
+    } else if(i2d_string_stack_push(local->stack, produce_list->description.string, produce_list->description.length)) {
+        status = i2d_panic("failed to push string on stack");
     }
 
     return status;
@@ -5257,10 +6232,14 @@ static int i2d_handler_bonus_generic(i2d_script * script, i2d_rbt * variables, i
         } else {
             status = i2d_panic("failed to get bonus by type -- %ld (%s)", bonus_type, bonus_name.string);
         }
+    } else if(i2d_index_add(script->index, "bonus:%s", data->name.string)) {
+        status = i2d_panic("failed to index bonus -- %s", data->name.string);
     } else if(i2d_script_statement_evaluate(script, variables, &nodes[1], data, local->buffer)) {
         status = i2d_panic("failed to handle bonus arguments");
     } else if(i2d_string_stack_push_buffer(local->stack, local->buffer)) {
         status = i2d_panic("failed to push string on stack");
+    } else if(i2d_ir_bind(script->ir, local->stack->top - 1)) {
+        status = i2d_panic("failed to bind statement to argument");
     }
 
     return status;
@@ -5299,10 +6278,14 @@ static int i2d_handler_sc_start_generic(i2d_script * script, i2d_rbt * variables
         } else {
             status = i2d_panic("failed to get effect by type -- %ld (%s)", effect_type, nodes[0]->constant->macro.string);
         }
+    } else if(i2d_index_add(script->index, "sc_start:%s", data->name.string)) {
+        status = i2d_panic("failed to index effect -- %s", data->name.string);
     } else if(i2d_script_statement_evaluate(script, variables, &nodes[0], data, local->buffer)) {
         status = i2d_panic("failed to handle bonus arguments");
     } else if(i2d_string_stack_push_buffer(local->stack, local->buffer)) {
         status = i2d_panic("failed to push string on stack");
+    } else if(i2d_ir_bind(script->ir, local->stack->top - 1)) {
+        status = i2d_panic("failed to bind statement to argument");
     }
 
     return status;
@@ -8,6 +8,8 @@
 #include "i2d_db.h"
 #include "i2d_json.h"
 #include "i2d_data.h"
+#include "i2d_index.h"
+#include "i2d_ir.h"
 
 enum i2d_token_type {
     I2D_TOKEN,
@@ -200,6 +202,58 @@ int i2d_parser_analysis(i2d_parser *, i2d_lexer *, i2d_data_map *, i2d_token *,
 int i2d_parser_analysis_recursive(i2d_parser *, i2d_lexer *, i2d_data_map *, i2d_block *, i2d_block **, i2d_token *);
 int i2d_parser_expression_recursive(i2d_parser *, i2d_lexer *, i2d_token *, i2d_node **);
 
+/*
+ * the description of a nested script (i.e. pet
+ * script or autobonus) depends on the text and
+ * the inherited variables that the text can read,
+ * so key is both and trace is the index keys of
+ * the compile that are added again on a hit
+ */
+struct i2d_script_cache_entry {
+    i2d_string key;
+    i2d_string description;
+    i2d_buffer trace;
+};
+
+typedef struct i2d_script_cache_entry i2d_script_cache_entry;
+
+struct i2d_script_cache {
+    i2d_rbt * map;
+    i2d_script_cache_entry ** list;
+    size_t size;
+    size_t capacity;
+    i2d_buffer key;
+    i2d_string source;
+};
+
+typedef struct i2d_script_cache i2d_script_cache;
+
+int i2d_script_cache_init(i2d_script_cache **);
+void i2d_script_cache_deit(i2d_script_cache **);
+
+/*
+ * the limits of the work to compile an item from
+ * budget in config.json; time is in milliseconds,
+ * range is the number of range intervals computed
+ * or values enumerated, logic is the number of
+ * logic nodes created, and 0 is no limit; an item
+ * over budget gets I2D_SCRIPT_BUDGET_DESCRIPTION
+ */
+#define I2D_SCRIPT_BUDGET_DESCRIPTION "[Description unavailable: compile budget exceeded]"
+
+struct i2d_script_budget {
+    long time;
+    long range;
+    long logic;
+    uint64_t start;
+    long ranges;
+    long logics;
+    int is_active;
+    int is_exceeded;
+};
+
+typedef struct i2d_script_budget i2d_script_budget;
+
 enum {
     I2D_FLAG_NONE = 0x0,
     I2D_FLAG_CONDITIONAL = 0x1
@@ -231,6 +285,14 @@ struct i2d_script {
     i2d_data_map * statements;
     i2d_buffer_cache * buffer_cache;
     i2d_string_stack_cache * stack_cache;
+    i2d_script_cache * script_cache;
+    i2d_script_budget budget;
+    i2d_index * index;
+    int is_index;
+    i2d_ir * ir;
+    i2d_rope rope;
+    i2d_locale * locale;
+    json_t * ir_output;
     i2d_rbt * function_handlers;
     i2d_rbt * argument_handlers;
     i2d_rbt * generate_handlers;
@@ -242,12 +304,17 @@ typedef struct i2d_script i2d_script;
 
 int i2d_script_init(i2d_script **, i2d_json *);
 void i2d_script_deit(i2d_script **);
+int i2d_script_reload(i2d_script *, i2d_json *, const char *);
 int i2d_script_compile(i2d_script *, i2d_string *, i2d_string *, i2d_rbt *);
+int i2d_script_compile_ir(i2d_script *, i2d_string *, i2d_ir *, i2d_rbt *);
 int i2d_script_compile_item(i2d_script *, i2d_item *);
 int i2d_script_compile_node(i2d_script *, const char *, i2d_node **, i2d_rbt *);
 int i2d_script_compile_item_combo(i2d_script *, i2d_item *, i2d_string *);
 int i2d_script_translate(i2d_script *, i2d_block *, i2d_rbt *, i2d_logic *);
-int i2d_script_generate(i2d_script *, i2d_block *, i2d_buffer *);
+int i2d_script_ir_text(i2d_script *, i2d_ir *, i2d_rope *);
+int i2d_script_ir_text_statement(i2d_script *, i2d_ir *, size_t, i2d_rope *);
+int i2d_script_ir_json(i2d_script *, i2d_ir *, json_t **);
+int i2d_script_ir_json_statement(i2d_script *, i2d_ir *, size_t, i2d_string *, json_t **);
 int i2d_script_generate_or(i2d_script *, i2d_logic *, i2d_buffer *);
 int i2d_script_generate_and(i2d_script *, i2d_logic *, i2d_buffer *);
 int i2d_script_generate_var(i2d_script *, i2d_logic *, i2d_buffer *);
@@ -256,6 +323,7 @@ int i2d_script_statement_ignore(i2d_script *, i2d_block *, i2d_rbt *, i2d_data *
 int i2d_script_statement_set(i2d_script *, i2d_block *, i2d_rbt *, i2d_data *);
 int i2d_script_statement_generic(i2d_script *, i2d_block *, i2d_rbt *, i2d_data *);
 int i2d_script_statement_evaluate(i2d_script *, i2d_rbt *, i2d_node **, i2d_data *, i2d_buffer *);
+int i2d_script_statement_format(i2d_data *, i2d_string *, i2d_string_stack *, i2d_buffer *);
 int i2d_script_expression(i2d_script *, i2d_node *, int, i2d_rbt *, i2d_logic *);
 int i2d_script_expression_logic(i2d_script *, i2d_node *, i2d_logic *);
 int i2d_script_expression_conditional(i2d_script *, i2d_node *, i2d_logic *, i2d_logic **);
@@ -0,0 +1,430 @@
+#include "i2d_select.h"
+#include "i2d_json.h"
+
+struct i2d_select_field {
+    char * name;
+    enum i2d_item_field field;
+};
+
+typedef struct i2d_select_field i2d_select_field;
+
+static i2d_select_field select_fields[] = {
+    { "id", I2D_ITEM_FIELD_ID },
+    { "type", I2D_ITEM_FIELD_TYPE },
+    { "buy", I2D_ITEM_FIELD_BUY },
+    { "sell", I2D_ITEM_FIELD_SELL },
+    { "weight", I2D_ITEM_FIELD_WEIGHT },
+    { "atk", I2D_ITEM_FIELD_ATK },
+    { "matk", I2D_ITEM_FIELD_MATK },
+    { "def", I2D_ITEM_FIELD_DEF },
+    { "range", I2D_ITEM_FIELD_RANGE },
+    { "slots", I2D_ITEM_FIELD_SLOTS },
+    { "job", I2D_ITEM_FIELD_JOB },
+    { "upper", I2D_ITEM_FIELD_UPPER },
+    { "gender", I2D_ITEM_FIELD_GENDER },
+    { "location", I2D_ITEM_FIELD_LOCATION },
+    { "weapon_level", I2D_ITEM_FIELD_WEAPON_LEVEL },
+    { "base_level", I2D_ITEM_FIELD_BASE_LEVEL },
+    { "max_level", I2D_ITEM_FIELD_MAX_LEVEL },
+    { "refineable", I2D_ITEM_FIELD_REFINEABLE },
+    { "view", I2D_ITEM_FIELD_VIEW }
+};
+
+struct i2d_select_op {
+    char * name;
+    enum i2d_item_op op;
+};
+
+typedef struct i2d_select_op i2d_select_op;
+
+static i2d_select_op select_ops[] = {
+    { "==", I2D_ITEM_OP_EQ },
+    { "!=", I2D_ITEM_OP_NE },
+    { "<", I2D_ITEM_OP_LT },
+    { "<=", I2D_ITEM_OP_LE },
+    { ">", I2D_ITEM_OP_GT },
+    { ">=", I2D_ITEM_OP_GE },
+    { "&", I2D_ITEM_OP_AND }
+};
+
+static int i2d_select_get_ranges(i2d_select *, json_t *);
+static int i2d_select_get_names(i2d_select *, json_t *);
+static int i2d_select_get_predicates(i2d_select *, json_t *);
+static int i2d_select_get_predicate(json_t *, i2d_item_predicate *);
+static int i2d_select_glob(const char *, const char *);
+static int i2d_select_add(i2d_select *, i2d_item *);
+static int i2d_select_add_cb(i2d_item *, void *);
+static int i2d_select_add_range(i2d_select *, i2d_item_db *, long, long);
+static int i2d_select_add_combo(i2d_select *, i2d_item_db *, i2d_item_combo_db *, i2d_item *);
+static int i2d_select_cmp(const void *, const void *);
+
+int i2d_select_init(i2d_select ** result, json_t * json) {
+    int status = I2D_OK;
+    i2d_select * object;
+    json_t * ids;
+    json_t * ranges;
+    json_t * names;
+    json_t * predicates;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_JSON, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else if(!json) {
+            /* empty selection */
+            *result = object;
+        } else {
+            ids = json_object_get(json, "id");
+            ranges = json_object_get(json, "range");
+            names = json_object_get(json, "name");
+            predicates = json_object_get(json, "where");
+            if(ids && i2d_object_get_number_array(ids, &object->ids, &object->id_size)) {
+                status = i2d_panic("failed to get id list");
+            } else if(ranges && i2d_select_get_ranges(object, ranges)) {
+                status = i2d_panic("failed to get range list");
+            } else if(names && i2d_select_get_names(object, names)) {
+                status = i2d_panic("failed to get name list");
+            } else if(predicates && i2d_select_get_predicates(object, predicates)) {
+                status = i2d_panic("failed to get predicate list");
+            } else {
+                object->id_capacity = object->id_size;
+            }
+
+            if(status)
+                i2d_select_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+void i2d_select_deit(i2d_select ** result) {
+    i2d_select * object;
+    size_t i;
+
+    object = *result;
+    i2d_free(object->list);
+    i2d_free(object->predicates);
+    if(object->names) {
+        for(i = 0; i < object->name_size; i++)
+            i2d_string_destroy(&object->names[i]);
+        i2d_free(object->names);
+    }
+    i2d_free(object->ranges);
+    i2d_free(object->ids);
+    i2d_free(object);
+    *result = NULL;
+}
+
+int i2d_select_add_id(i2d_select * select, long id) {
+    int status = I2D_OK;
+    long * ids;
+    size_t capacity;
+
+    if(select->id_size == select->id_capacity) {
+        capacity = select->id_capacity ? select->id_capacity * 2 : 64;
+        ids = i2d_realloc(I2D_TAG_JSON, select->ids, capacity * sizeof(*select->ids));
+        if(!ids) {
+            status = i2d_panic("out of memory");
+        } else {
+            select->ids = ids;
+            select->id_capacity = capacity;
+        }
+    }
+
+    if(!status)
+        select->ids[select->id_size++] = id;
+
+    return status;
+}
+
+static int i2d_select_get_ranges(i2d_select * select, json_t * json) {
+    int status = I2D_OK;
+    size_t index;
+    json_t * value;
+    long * range;
+
+    select->ranges = i2d_calloc(I2D_TAG_JSON, json_array_size(json) * 2, sizeof(*select->ranges));
+    if(!select->ranges) {
+        status = i2d_panic("out of memory");
+    } else {
+        json_array_foreach(json, index, value) {
+            range = &select->ranges[index * 2];
+            if(i2d_object_get_number(json_object_get(value, "min"), &range[0])) {
+                status = i2d_panic("failed to get number object");
+            } else if(i2d_object_get_number(json_object_get(value, "max"), &range[1])) {
+                status = i2d_panic("failed to get number object");
+            } else if(range[0] > range[1]) {
+                status = i2d_panic("invalid range -- %ld to %ld", range[0], range[1]);
+            } else {
+                select->range_size++;
+            }
+
+            if(status)
+                break;
+        }
+    }
+
+    return status;
+}
+
+static int i2d_select_get_names(i2d_select * select, json_t * json) {
+    int status = I2D_OK;
+    size_t index;
+    json_t * value;
+
+    select->names = i2d_calloc(I2D_TAG_JSON, json_array_size(json), sizeof(*select->names));
+    if(!select->names) {
+        status = i2d_panic("out of memory");
+    } else {
+        json_array_foreach(json, index, value) {
+            if(i2d_object_get_string(value, &select->names[index])) {
+                status = i2d_panic("failed to get string object");
+            } else {
+                select->name_size++;
+            }
+
+            if(status)
+                break;
+        }
+    }
+
+    return status;
+}
+
+static int i2d_select_get_predicates(i2d_select * select, json_t * json) {
+    int status = I2D_OK;
+    size_t index;
+    json_t * value;
+
+    select->predicates = i2d_calloc(I2D_TAG_JSON, json_array_size(json), sizeof(*select->predicates));
+    if(!select->predicates) {
+        status = i2d_panic("out of memory");
+    } else {
+        json_array_foreach(json, index, value) {
+            if(i2d_select_get_predicate(value, &select->predicates[index])) {
+                status = i2d_panic("failed to get predicate object");
+            } else {
+                select->predicate_size++;
+            }
+
+            if(status)
+                break;
+        }
+    }
+
+    return status;
+}
+
+static int i2d_select_get_predicate(json_t * json, i2d_item_predicate * result) {
+    int status = I2D_OK;
+    const char * field;
+    const char * op;
+    size_t i;
+
+    field = json_string_value(json_object_get(json, "field"));
+    op = json_string_value(json_object_get(json, "op"));
+    if(!field || !op) {
+        status = i2d_panic("invalid predicate object");
+    } else if(i2d_object_get_number(json_object_get(json, "value"), &result->value)) {
+        status = i2d_panic("failed to get number object");
+    } else {
+        for(i = 0; i < i2d_size(select_fields) && strcmp(select_fields[i].name, field); i++);
+        if(i == i2d_size(select_fields)) {
+            status = i2d_panic("invalid item field -- %s", field);
+        } else {
+            result->field = select_fields[i].field;
+
+            for(i = 0; i < i2d_size(select_ops) && strcmp(select_ops[i].name, op); i++);
+            if(i == i2d_size(select_ops)) {
+                status = i2d_panic("invalid item operator -- %s", op);
+            } else {
+                result->op = select_ops[i].op;
+            }
+        }
+    }
+
+    return status;
+}
+
+/*
+ * * matches any run of characters and ? matches
+ * one character; a failed match after a * only
+ * has to retry from the character after the
+ * last * that was matched
+ */
+static int i2d_select_glob(const char * pattern, const char * string) {
+    int match = 1;
+    const char * star = NULL;
+    const char * retry = NULL;
+
+    while(*string && match) {
+        if(*pattern == '*') {
+            star = ++pattern;
+            retry = string;
+        } else if(*pattern == '?' || tolower((unsigned char) *pattern) == tolower((unsigned char) *string)) {
+            pattern++;
+            string++;
+        } else if(star) {
+            pattern = star;
+            string = ++retry;
+        } else {
+            match = 0;
+        }
+    }
+
+    if(match) {
+        while(*pattern == '*')
+            pattern++;
+        match = !*pattern;
+    }
+
+    return match;
+}
+
+static int i2d_select_add(i2d_select * select, i2d_item * item) {
+    int status = I2D_OK;
+    i2d_item ** list;
+    size_t capacity;
+
+    if(select->size == select->capacity) {
+        capacity = select->capacity ? select->capacity * 2 : 64;
+        list = i2d_realloc(I2D_TAG_JSON, select->list, capacity * sizeof(*select->list));
+        if(!list) {
+            status = i2d_panic("out of memory");
+        } else {
+            select->list = list;
+            select->capacity = capacity;
+        }
+    }
+
+    if(!status)
+        select->list[select->size++] = item;
+
+    return status;
+}
+
+static int i2d_select_add_cb(i2d_item * item, void * data) {
+    return i2d_select_add(data, item);
+}
+
+/*
+ * a range that is narrower than the item db is
+ * looked up id by id, otherwise the id column
+ * is scanned
+ */
+static int i2d_select_add_range(i2d_select * select, i2d_item_db * item_db, long min, long max) {
+    int status = I2D_OK;
+    unsigned long width;
+    unsigned long i;
+    i2d_item * item;
+    i2d_item_predicate predicates[] = {
+        { I2D_ITEM_FIELD_ID, I2D_ITEM_OP_GE, min },
+        { I2D_ITEM_FIELD_ID, I2D_ITEM_OP_LE, max }
+    };
+
+    width = (unsigned long) max - (unsigned long) min;
+    if(width < item_db->store.size) {
+        for(i = 0; i <= width && !status; i++)
+            if(!i2d_item_db_search_by_id(item_db, (long) (min + i), &item) && i2d_select_add(select, item))
+                status = i2d_panic("failed to add item -- %ld", item->id);
+    } else if(i2d_item_db_scan(item_db, predicates, i2d_size(predicates), i2d_select_add_cb, select)) {
+        status = i2d_panic("failed to scan item db");
+    }
+
+    return status;
+}
+
+static int i2d_select_add_combo(i2d_select * select, i2d_item_db * item_db, i2d_item_combo_db * item_combo_db, i2d_item * item) {
+    int status = I2D_OK;
+    i2d_item_combo_list * item_combo_list;
+    i2d_item_combo * item_combo;
+    i2d_item * partner;
+    size_t i;
+    size_t j;
+
+    if(!i2d_item_combo_db_search_by_id(item_combo_db, item->id, &item_combo_list)) {
+        for(i = 0; i < item_combo_list->size && !status; i++) {
+            item_combo = item_combo_list->list[i];
+            for(j = 0; j < item_combo->size && !status; j++)
+                if(!i2d_item_db_search_by_id(item_db, item_combo->list[j], &partner) && i2d_select_add(select, partner))
+                    status = i2d_panic("failed to add item -- %ld", partner->id);
+        }
+    }
+
+    return status;
+}
+
+static int i2d_select_cmp(const void * left, const void * right) {
+    const i2d_item * const * x = left;
+    const i2d_item * const * y = right;
+
+    return (*x)->id < (*y)->id ? -1 : (*x)->id > (*y)->id ? 1 : 0;
+}
+
+/*
+ * list is the selected items in order of id
+ * without duplicates
+ */
+int i2d_select_resolve(i2d_select * select, i2d_item_db * item_db, i2d_item_combo_db * item_combo_db) {
+    int status = I2D_OK;
+    i2d_item * item;
+    size_t size;
+    size_t i;
+    size_t j;
+
+    select->size = 0;
+
+    for(i = 0; i < select->id_size && !status; i++) {
+        if(i2d_item_db_search_by_id(item_db, select->ids[i], &item)) {
+            status = i2d_panic("failed to get item by id -- %ld", select->ids[i]);
+        } else if(i2d_select_add(select, item)) {
+            status = i2d_panic("failed to add item -- %ld", item->id);
+        }
+    }
+
+    for(i = 0; i < select->range_size && !status; i++)
+        if(i2d_select_add_range(select, item_db, select->ranges[i * 2], select->ranges[i * 2 + 1]))
+            status = i2d_panic("failed to add range -- %ld to %ld", select->ranges[i * 2], select->ranges[i * 2 + 1]);
+
+    if(select->name_size) {
+        for(i = 0; i < item_db->store.size && !status; i++) {
+            item = item_db->store.items[i];
+            for(j = 0; j < select->name_size && !i2d_select_glob(select->names[j].string, item->aegis_name.string); j++);
+            if(j < select->name_size && i2d_select_add(select, item))
+                status = i2d_panic("failed to add item -- %ld", item->id);
+        }
+    }
+
+    if(!status && select->predicate_size && i2d_item_db_scan(item_db, select->predicates, select->predicate_size, i2d_select_add_cb, select))
+        status = i2d_panic("failed to scan item db");
+
+    size = select->size;
+    for(i = 0; i < size && !status; i++)
+        if(i2d_select_add_combo(select, item_db, item_combo_db, select->list[i]))
+            status = i2d_panic("failed to add combo items -- %ld", select->list[i]->id);
+
+    if(!status && select->size) {
+        qsort(select->list, select->size, sizeof(*select->list), i2d_select_cmp);
+        for(i = 1, j = 1; i < select->size; i++)
+            if(select->list[i] != select->list[j - 1])
+                select->list[j++] = select->list[i];
+        select->size = j;
+    }
+
+    return status;
+}
+
+/* the list must be resolved */
+int i2d_select_search(i2d_select * select, i2d_item * item) {
+    int status = I2D_OK;
+
+    if(!select->size || !bsearch(&item, select->list, select->size, sizeof(*select->list), i2d_select_cmp))
+        status = I2D_FAIL;
+
+    return status;
+}
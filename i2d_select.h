@@ -0,0 +1,49 @@
+#ifndef i2d_select_h
+#define i2d_select_h
+
+#include "i2d_util.h"
+#include "i2d_item.h"
+#include "jansson.h"
+
+/*
+ * items to compile instead of the whole item db,
+ * i.e. for a patch that only touches a few items
+ *
+ *  "select": {
+ *      "id": [ 501, 502 ],
+ *      "range": [ { "min": 1201, "max": 1299 } ],
+ *      "name": [ "*_Card" ],
+ *      "where": [ { "field": "type", "op": "==", "value": 4 } ]
+ *  }
+ *
+ * an item is selected if it matches an id, a
+ * range, or an aegis name glob (* and ?), or if
+ * it matches every predicate of where; the combo
+ * partners of a selected item are also selected
+ * since their combo description names the item;
+ * the ids of an empty selection (json is NULL)
+ * are added with i2d_select_add_id
+ */
+struct i2d_select {
+    long * ids;
+    size_t id_size;
+    size_t id_capacity;
+    long * ranges;
+    size_t range_size;
+    i2d_string * names;
+    size_t name_size;
+    i2d_item_predicate * predicates;
+    size_t predicate_size;
+    i2d_item ** list;
+    size_t size;
+    size_t capacity;
+};
+
+typedef struct i2d_select i2d_select;
+
+int i2d_select_init(i2d_select **, json_t *);
+void i2d_select_deit(i2d_select **);
+int i2d_select_add_id(i2d_select *, long);
+int i2d_select_resolve(i2d_select *, i2d_item_db *, i2d_item_combo_db *);
+int i2d_select_search(i2d_select *, i2d_item *);
+#endif
@@ -1,9 +1,59 @@
 #include "i2d_skill.h"
 
+struct i2d_skill_yml {
+    i2d_skill_db * skill_db;
+    i2d_buffer buffer;
+    i2d_rbt * index;
+    i2d_skill * skill;
+    int exist;
+    int fields;
+    long level;
+};
+
+typedef struct i2d_skill_yml i2d_skill_yml;
+
+static i2d_yaml_constant i2d_skill_target_list[] = {
+    { "Passive", 0 },
+    { "Attack", 1 },
+    { "Ground", 2 },
+    { "Self", 4 },
+    { "Support", 16 },
+    { "Trap", 32 }
+};
+
+static i2d_yaml_constant i2d_skill_hit_list[] = {
+    { "Normal", 0 },
+    { "Single", 6 },
+    { "Multi_Hit", 8 }
+};
+
+static i2d_yaml_constant i2d_skill_element_list[] = {
+    { "Neutral", 0 },
+    { "Water", 1 },
+    { "Earth", 2 },
+    { "Fire", 3 },
+    { "Wind", 4 },
+    { "Poison", 5 },
+    { "Holy", 6 },
+    { "Dark", 7 },
+    { "Ghost", 8 },
+    { "Undead", 9 },
+    { "Weapon", -1 },
+    { "Endowed", -2 },
+    { "Random", -3 }
+};
+
 static int i2d_skill_parse_list(long **, size_t *, char *, size_t);
 static int i2d_skill_parse(i2d_skill *, char *, size_t);
 static int i2d_skill_db_parse(char *, size_t, void *);
 static int i2d_skill_db_index(i2d_skill_db *);
+static int i2d_skill_yml_init(i2d_skill **);
+static int i2d_skill_parse_yml_list(long **, size_t *, long, long);
+static int i2d_skill_parse_yml_level(i2d_skill_yml *, i2d_yaml_record *, i2d_yaml_constant *, size_t, long **, size_t *);
+static int i2d_skill_parse_yml(i2d_skill_yml *, i2d_yaml_record *);
+static int i2d_skill_db_parse_yml_end(i2d_skill_yml *);
+static int i2d_skill_db_parse_yml(i2d_yaml_record *, void *);
+static int i2d_skill_db_load_yml(i2d_skill_db *, i2d_string *);
 
 int i2d_skill_init(i2d_skill ** result, char * string, size_t length) {
     int status = I2D_OK;
@@ -12,7 +62,7 @@ int i2d_skill_init(i2d_skill ** result, char * string, size_t length) {
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
@@ -37,12 +87,8 @@ void i2d_skill_deit(i2d_skill ** result) {
     i2d_skill * object;
 
     object = *result;
-    i2d_free(object->name.string);
-    i2d_free(object->macro.string);
     i2d_free(object->blow_count);
-    i2d_free(object->type.string);
     i2d_free(object->max_count);
-    i2d_free(object->cast_cancel.string);
     i2d_free(object->hit_amount);
     i2d_free(object->splash);
     i2d_free(object->element);
@@ -65,7 +111,7 @@ static int i2d_skill_parse_list(long ** result_list, size_t * result_size, char
         if(':' == string[i])
             size++;
 
-    list = calloc(size, sizeof(*list));
+    list = i2d_calloc(I2D_TAG_DB, size, sizeof(*list));
     if(!list) {
         status = i2d_panic("out of memory");
     } else {
@@ -102,7 +148,7 @@ static int i2d_skill_parse_list(long ** result_list, size_t * result_size, char
         }
 
         if(status) {
-            free(list);
+            i2d_free(list);
         } else {
             *result_size = size;
             *result_list = list;
@@ -116,72 +162,39 @@ static int i2d_skill_parse_list(long ** result_list, size_t * result_size, char
 static int i2d_skill_parse(i2d_skill * skill, char * string, size_t length) {
     int status = I2D_OK;
 
-    size_t i;
+    i2d_split split;
 
     char * anchor;
     size_t extent;
 
     int field = 0;
-    int last = 0;
-
-    anchor = string;
-    for(i = 0; i < length && !status && !last; i++) {
-        /*
-         * check for \t, \r, \n (exclude space and tab)
-         */
-        if(i2d_isspace(string[i]) && '\t' != string[i] && ' ' != string[i])
-            last = 1;
-
-        /*
-         * check for line comments
-         */
-        if('/' == string[i] && i > 0 && '/' == string[i - 1]) {
-            i -= 1;
-            last = 1;
-        }
-
-        if(',' == string[i] || last) {
-            string[i] = 0;
-
-            if(string + i < anchor) {
-                status = i2d_panic("line overflow");
-            } else {
-                extent = (size_t) (string + i) - (size_t) anchor;
-
-                /*
-                 * remove initial space and tab character
-                 */
-                while(extent && ('\t' == *anchor || ' ' == *anchor)) {
-                    anchor++;
-                    extent--;
-                }
 
-                switch(field) {
-                    case 0: status = i2d_strtol(&skill->id, anchor, extent, 10); break;
-                    case 1: status = i2d_skill_parse_list(&skill->range, &skill->range_size, anchor, extent); break;
-                    case 2: status = i2d_strtol(&skill->hit, anchor, extent, 10); break;
-                    case 3: status = i2d_strtol(&skill->inf, anchor, extent, 10); break;
-                    case 4: status = i2d_skill_parse_list(&skill->element, &skill->element_size, anchor, extent); break;
-                    case 5: status = i2d_strtol(&skill->nk, anchor, extent, 16); break;
-                    case 6: status = i2d_skill_parse_list(&skill->splash, &skill->splash_size, anchor, extent); break;
-                    case 7: status = i2d_strtol(&skill->maxlv, anchor, extent, 10); break;
-                    case 8: status = i2d_skill_parse_list(&skill->hit_amount, &skill->hit_amount_size, anchor, extent); break;
-                    case 9: status = i2d_string_create(&skill->cast_cancel, anchor, extent); break;
-                    case 10: status = i2d_strtol(&skill->cast_def_reduce_rate, anchor, extent, 10); break;
-                    case 11: status = i2d_strtol(&skill->inf2, anchor, extent, 16); break;
-                    case 12: status = i2d_skill_parse_list(&skill->max_count, &skill->max_count_size, anchor, extent); break;
-                    case 13: status = i2d_string_create(&skill->type, anchor, extent); break;
-                    case 14: status = i2d_skill_parse_list(&skill->blow_count, &skill->blow_count_size, anchor, extent); break;
-                    case 15: status = i2d_strtol(&skill->inf3, anchor, extent, 16); break;
-                    case 16: status = i2d_string_create(&skill->macro, anchor, extent); break;
-                    case 17: status = i2d_string_create(&skill->name, anchor, extent); break;
-                    default: status = i2d_panic("row has too many columns"); break;
-                }
-                field++;
-            }
-
-            anchor = (string + i + 1);
+    skill->hash = i2d_fnv1a(I2D_FNV_OFFSET, string, length);
+
+    i2d_split_create(&split, string, length, I2D_SPLIT_TAB);
+    while(!status && !i2d_split_next(&split, &anchor, &extent)) {
+        switch(field) {
+            case 0: status = i2d_strtol(&skill->id, anchor, extent, 10); break;
+            case 1: status = i2d_skill_parse_list(&skill->range, &skill->range_size, anchor, extent); break;
+            case 2: status = i2d_strtol(&skill->hit, anchor, extent, 10); break;
+            case 3: status = i2d_strtol(&skill->inf, anchor, extent, 10); break;
+            case 4: status = i2d_skill_parse_list(&skill->element, &skill->element_size, anchor, extent); break;
+            case 5: status = i2d_strtol(&skill->nk, anchor, extent, 16); break;
+            case 6: status = i2d_skill_parse_list(&skill->splash, &skill->splash_size, anchor, extent); break;
+            case 7: status = i2d_strtol(&skill->maxlv, anchor, extent, 10); break;
+            case 8: status = i2d_skill_parse_list(&skill->hit_amount, &skill->hit_amount_size, anchor, extent); break;
+            case 9: status = i2d_intern_get(anchor, extent, &skill->cast_cancel); break;
+            case 10: status = i2d_strtol(&skill->cast_def_reduce_rate, anchor, extent, 10); break;
+            case 11: status = i2d_strtol(&skill->inf2, anchor, extent, 16); break;
+            case 12: status = i2d_skill_parse_list(&skill->max_count, &skill->max_count_size, anchor, extent); break;
+            case 13: status = i2d_intern_get(anchor, extent, &skill->type); break;
+            case 14: status = i2d_skill_parse_list(&skill->blow_count, &skill->blow_count_size, anchor, extent); break;
+            case 15: status = i2d_strtol(&skill->inf3, anchor, extent, 16); break;
+            case 16: status = i2d_intern_get(anchor, extent, &skill->macro); break;
+            case 17: status = i2d_intern_get(anchor, extent, &skill->name); break;
+            default: status = i2d_panic("row has too many columns"); break;
         }
+        field++;
     }
 
     if(!status && 18 != field)
@@ -211,16 +224,20 @@ int i2d_skill_db_init(i2d_skill_db ** result, i2d_string * path) {
     if(i2d_is_invalid(result) || !path) {
         status = i2d_panic("invalid parameter");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_fd_load(path, i2d_skill_db_parse, object)) {
+            if(i2d_string_suffix(path, ".yml")) {
+                if(i2d_skill_db_load_yml(object, path))
+                    status = i2d_panic("failed to load skill db -- %s", path->string);
+            } else if(i2d_fd_load(path, i2d_skill_db_parse, object)) {
                 status = i2d_panic("failed to load skill db");
-            } else if(i2d_skill_db_index(object)) {
-                status = i2d_panic("failed to index skill db");
             }
 
+            if(!status && i2d_skill_db_index(object))
+                status = i2d_panic("failed to index skill db");
+
             if(status)
                 i2d_skill_db_deit(&object);
             else
@@ -237,6 +254,7 @@ void i2d_skill_db_deit(i2d_skill_db ** result) {
 
     object = *result;
     i2d_deit(object->index_by_macro, i2d_rbt_deit);
+    i2d_table_destroy(&object->table_by_id);
     i2d_deit(object->index_by_id, i2d_rbt_deit);
     if(object->list) {
         while(object->list != object->list->next) {
@@ -270,28 +288,279 @@ static int i2d_skill_db_parse(char * string, size_t length, void * data) {
     return status;
 }
 
+static int i2d_skill_yml_init(i2d_skill ** result) {
+    int status = I2D_OK;
+    i2d_skill * object;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_DB, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            object->hash = I2D_FNV_OFFSET;
+            object->next = object;
+            object->prev = object;
+
+            if(status)
+                i2d_skill_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+/*
+ * a level of zero replaces the list with the
+ * value for all levels, i.e. Range: 9, and a
+ * level of one or more sets the value of that
+ * level, i.e. Range: [ { Level: 1, Size: 9 } ]
+ */
+static int i2d_skill_parse_yml_list(long ** result_list, size_t * result_size, long level, long value) {
+    int status = I2D_OK;
+    long * list;
+
+    if(0 > level) {
+        status = i2d_panic("invalid skill level -- %ld", level);
+    } else if(!level) {
+        list = i2d_calloc(I2D_TAG_DB, 1, sizeof(*list));
+        if(!list) {
+            status = i2d_panic("out of memory");
+        } else {
+            list[0] = value;
+            i2d_free(*result_list);
+            *result_list = list;
+            *result_size = 1;
+        }
+    } else {
+        if((size_t) level > *result_size) {
+            list = i2d_realloc(I2D_TAG_DB, *result_list, level * sizeof(*list));
+            if(!list) {
+                status = i2d_panic("out of memory");
+            } else {
+                memset(&list[*result_size], 0, (level - *result_size) * sizeof(*list));
+                *result_list = list;
+                *result_size = level;
+            }
+        }
+
+        if(!status)
+            (*result_list)[level - 1] = value;
+    }
+
+    return status;
+}
+
+static int i2d_skill_parse_yml_level(i2d_skill_yml * load, i2d_yaml_record * record, i2d_yaml_constant * constant, size_t size, long ** list, size_t * list_size) {
+    int status = I2D_OK;
+    long number;
+
+    if(constant ? i2d_yaml_get_constant(constant, size, record->value, &number) : i2d_yaml_get_number(record, &number)) {
+        status = i2d_panic("failed to get value -- %s", record->key);
+    } else {
+        status = i2d_skill_parse_yml_list(list, list_size, strchr(record->key, '.') ? load->level : 0, number);
+    }
+
+    return status;
+}
+
+static int i2d_skill_parse_yml(i2d_skill_yml * load, i2d_yaml_record * record) {
+    int status = I2D_OK;
+    i2d_skill * skill = load->skill;
+    i2d_skill * exist = NULL;
+    const char * key = record->key;
+    const char * field;
+    int boolean;
+    size_t i;
+
+    field = strchr(key, '.');
+    field = field ? field + 1 : key;
+
+    if(!strcmp(key, "Id")) {
+        /*
+         * an imported file can update a skill by
+         * id so the id must precede other fields
+         */
+        if(load->fields) {
+            status = i2d_panic("skill id must be the first field");
+        } else if(i2d_yaml_get_number(record, &skill->id)) {
+            status = i2d_panic("failed to get skill id");
+        } else if(!i2d_rbt_search(load->index, &skill->id, (void **) &exist)) {
+            i2d_skill_deit(&load->skill);
+            load->skill = exist;
+            load->exist = 1;
+        }
+    } else if(!load->fields) {
+        status = i2d_panic("skill is missing id");
+    } else if(!strcmp(key, "Name")) {
+        status = i2d_intern_get(record->value, record->length, &skill->macro);
+    } else if(!strcmp(key, "Description")) {
+        status = i2d_intern_get(record->value, record->length, &skill->name);
+    } else if(!strcmp(key, "MaxLevel")) {
+        status = i2d_yaml_get_number(record, &skill->maxlv);
+    } else if(!strcmp(key, "Type")) {
+        i2d_buffer_clear(&load->buffer);
+
+        for(i = 0; i < record->length && !status; i++)
+            if(i2d_buffer_putc(&load->buffer, tolower((unsigned char) record->value[i])))
+                status = i2d_panic("failed to write buffer object");
+
+        if(!status && i2d_intern_get(load->buffer.buffer, load->buffer.offset, &skill->type))
+            status = i2d_panic("failed to get skill type");
+    } else if(!strcmp(key, "TargetType")) {
+        status = i2d_yaml_get_constant(i2d_skill_target_list, i2d_size(i2d_skill_target_list), record->value, &skill->inf);
+    } else if(!strcmp(key, "Hit")) {
+        status = i2d_yaml_get_constant(i2d_skill_hit_list, i2d_size(i2d_skill_hit_list), record->value, &skill->hit);
+    } else if(!strcmp(key, "CastCancel")) {
+        if(i2d_yaml_get_boolean(record, &boolean)) {
+            status = i2d_panic("failed to get boolean");
+        } else {
+            status = boolean ?
+                i2d_intern_get("yes", 3, &skill->cast_cancel) :
+                i2d_intern_get("no", 2, &skill->cast_cancel);
+        }
+    } else if(!strcmp(key, "CastDefenseReduction")) {
+        status = i2d_yaml_get_number(record, &skill->cast_def_reduce_rate);
+    } else if(field != key && !strcmp(field, "Level")) {
+        status = i2d_yaml_get_number(record, &load->level);
+    } else if(!strcmp(key, "Element") || !strcmp(key, "Element.Element")) {
+        status = i2d_skill_parse_yml_level(load, record, i2d_skill_element_list, i2d_size(i2d_skill_element_list), &skill->element, &skill->element_size);
+    } else if(!strcmp(key, "Range") || !strcmp(key, "Range.Size")) {
+        status = i2d_skill_parse_yml_level(load, record, NULL, 0, &skill->range, &skill->range_size);
+    } else if(!strcmp(key, "HitCount") || !strcmp(key, "HitCount.Count")) {
+        status = i2d_skill_parse_yml_level(load, record, NULL, 0, &skill->hit_amount, &skill->hit_amount_size);
+    } else if(!strcmp(key, "SplashArea") || !strcmp(key, "SplashArea.Area")) {
+        status = i2d_skill_parse_yml_level(load, record, NULL, 0, &skill->splash, &skill->splash_size);
+    } else if(!strcmp(key, "ActiveInstance") || !strcmp(key, "ActiveInstance.Max")) {
+        status = i2d_skill_parse_yml_level(load, record, NULL, 0, &skill->max_count, &skill->max_count_size);
+    } else if(!strcmp(key, "Knockback") || !strcmp(key, "Knockback.Amount")) {
+        status = i2d_skill_parse_yml_level(load, record, NULL, 0, &skill->blow_count, &skill->blow_count_size);
+    }
+
+    if(!status)
+        load->fields++;
+
+    return status;
+}
+static int i2d_skill_db_parse_yml_end(i2d_skill_yml * load) {
+    int status = I2D_OK;
+    i2d_skill_db * skill_db = load->skill_db;
+    i2d_skill * skill = load->skill;
+
+    if(!skill->macro.string || !skill->name.string) {
+        status = i2d_panic("skill is missing name or description -- %ld", skill->id);
+    } else if( (!skill->type.string && i2d_intern_get("none", 4, &skill->type)) ||
+               (!skill->cast_cancel.string && i2d_intern_get("no", 2, &skill->cast_cancel)) ) {
+        status = i2d_panic("failed to create string object");
+    } else {
+        if(!load->exist) {
+            if(!skill_db->list) {
+                skill_db->list = skill;
+            } else {
+                i2d_skill_append(skill, skill_db->list);
+            }
+
+            skill_db->size++;
+
+            if(i2d_rbt_insert(load->index, &skill->id, skill))
+                status = i2d_panic("failed to index skill by id -- %ld", skill->id);
+        }
+
+        load->skill = NULL;
+    }
+
+    return status;
+}
+
+static int i2d_skill_db_parse_yml(i2d_yaml_record * record, void * data) {
+    int status = I2D_OK;
+    i2d_skill_yml * load = data;
+
+    switch(record->type) {
+        case i2d_yaml_record_start:
+            load->exist = 0;
+            load->fields = 0;
+            load->level = 0;
+
+            if(i2d_skill_yml_init(&load->skill))
+                status = i2d_panic("failed to create skill object");
+            break;
+        case i2d_yaml_record_field:
+            if(i2d_skill_parse_yml(load, record)) {
+                status = i2d_panic("failed to load skill -- %ld", load->skill->id);
+            } else {
+                load->skill->hash = i2d_yaml_hash(record, load->skill->hash);
+            }
+            break;
+        case i2d_yaml_record_end:
+            status = i2d_skill_db_parse_yml_end(load);
+            break;
+    }
+
+    return status;
+}
+
+static int i2d_skill_db_load_yml(i2d_skill_db * skill_db, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_skill_yml load;
+
+    i2d_zero(load);
+    load.skill_db = skill_db;
+
+    if(i2d_buffer_create(I2D_TAG_DB, &load.buffer, BUFFER_SIZE_SMALL)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        if(i2d_rbt_init(&load.index, i2d_rbt_cmp_long)) {
+            status = i2d_panic("failed to create red black tree object");
+        } else {
+            if(i2d_yaml_map(path, i2d_skill_db_parse_yml, &load))
+                status = i2d_panic("failed to map skill db -- %s", path->string);
+
+            if(load.skill && !load.exist)
+                i2d_skill_deit(&load.skill);
+
+            i2d_rbt_deit(&load.index);
+        }
+        i2d_buffer_destroy(&load.buffer);
+    }
+
+    return status;
+}
+
 static int i2d_skill_db_index(i2d_skill_db * skill_db) {
     int status = I2D_OK;
     i2d_skill * skill = NULL;
 
-    if( i2d_rbt_init(&skill_db->index_by_id, i2d_rbt_cmp_long) ||
-        i2d_rbt_init(&skill_db->index_by_macro, i2d_rbt_cmp_str) ) {
+    if( i2d_rbt_init_static(&skill_db->index_by_id, i2d_rbt_cmp_long) ||
+        i2d_rbt_init_static(&skill_db->index_by_macro, i2d_rbt_cmp_str) ) {
         status = i2d_panic("failed to create red black tree objects");
     } else {
         skill = skill_db->list;
         do {
             if( i2d_rbt_insert(skill_db->index_by_id, &skill->id, skill) ||
-                i2d_rbt_insert(skill_db->index_by_macro, skill->macro.string, skill) )
+                i2d_rbt_insert(skill_db->index_by_macro, skill->macro.string, skill) ||
+                (i2d_table_range(skill->id) && i2d_table_insert(&skill_db->table_by_id, skill->id, skill)) )
                 status = i2d_panic("failed to index skill by id -- %ld", skill->id);
             skill = skill->next;
         } while(skill != skill_db->list && !status);
+
+        if(status) {
+            /* skip build */
+        } else if(i2d_rbt_build(skill_db->index_by_id) || i2d_rbt_build(skill_db->index_by_macro)) {
+            status = i2d_panic("failed to build red black tree object");
+        }
     }
 
     return status;
 }
 
 int i2d_skill_db_search_by_id(i2d_skill_db * skill_db, long skill_id, i2d_skill ** skill) {
-    return i2d_rbt_search(skill_db->index_by_id, &skill_id, (void **) skill);
+    return i2d_table_range(skill_id) ?
+        i2d_table_search(&skill_db->table_by_id, skill_id, (void **) skill) :
+        i2d_rbt_search(skill_db->index_by_id, &skill_id, (void **) skill);
 }
 
 int i2d_skill_db_search_by_macro(i2d_skill_db * skill_db, const char * macro, i2d_skill ** skill) {
@@ -3,6 +3,8 @@
 
 #include "i2d_util.h"
 #include "i2d_rbt.h"
+#include "i2d_intern.h"
+#include "i2d_yaml.h"
 
 struct i2d_skill {
     long id;
@@ -29,6 +31,7 @@ struct i2d_skill {
     long inf3;
     i2d_string macro;
     i2d_string name;
+    uint64_t hash;
     struct i2d_skill * next;
     struct i2d_skill * prev;
 };
@@ -44,6 +47,7 @@ struct i2d_skill_db {
     i2d_skill * list;
     size_t size;
     i2d_rbt * index_by_id;
+    i2d_table table_by_id;
     i2d_rbt * index_by_macro;
 };
 
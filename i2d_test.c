@@ -7,7 +7,12 @@
 #include "i2d_constant.h"
 #include "i2d_db.h"
 #include "i2d_script.h"
+#include "i2d_json.h"
+#include "i2d_select.h"
+#include "i2d_intern.h"
+#include "i2d_index.h"
 
+static void i2d_test_file(const char *, const char *);
 static void i2d_format_test(void);
 static void i2d_lexer_test(void);
 static void i2d_range_not_test(void);
@@ -15,27 +20,67 @@ static void i2d_logic_test(void);
 static void i2d_logic_or_test(i2d_logic *, i2d_logic *, i2d_logic *);
 static void i2d_logic_and_test(i2d_logic *, i2d_logic *, i2d_logic *);
 static void i2d_logic_not_test(i2d_logic *, i2d_logic *, i2d_logic *);
+static void i2d_rbt_static_test(void);
+static void i2d_json_stream_test(void);
+static int i2d_json_stream_test_file(const char *, i2d_buffer *);
+static int i2d_json_stream_test_cb(i2d_json_event *, void *);
+static void i2d_split_test(void);
+static void i2d_split_test_line(const char *, int, const char *);
+static void i2d_strtol_test(void);
+static void i2d_select_test(void);
+static void i2d_select_test_name(i2d_item_db *, i2d_item_combo_db *, const char *, const char *);
+static void i2d_rope_test(void);
+static void i2d_rope_test_write(i2d_rope *, i2d_buffer *);
+static void i2d_intern_test(void);
+static void i2d_index_remove_test(void);
+static void i2d_duplicate_id_test(void);
+static void i2d_json_table_test(void);
+static void i2d_json_table_test_copy(const char *, i2d_string *);
+static int i2d_rbt_static_test_cb(void *, void *);
 
 int main(int argc, char * argv[]) {
     i2d_format_test();
     i2d_range_not_test();
     i2d_lexer_test();
     i2d_logic_test();
+    i2d_rbt_static_test();
+    i2d_json_stream_test();
+    i2d_split_test();
+    i2d_strtol_test();
+    i2d_select_test();
+    i2d_rope_test();
+    i2d_intern_test();
+    i2d_index_remove_test();
+    i2d_duplicate_id_test();
+    i2d_json_table_test();
     return 0;
 }
 
+static void i2d_test_file(const char * path, const char * string) {
+    FILE * file;
+
+    file = fopen(path, "wb");
+    assert(file);
+    assert(strlen(string) == fwrite(string, 1, strlen(string), file));
+    assert(!fclose(file));
+}
+
 static void i2d_format_test(void) {
     i2d_buffer buffer;
     i2d_string_stack stack;
-    i2d_format format;
+    i2d_string format;
+    char * string;
+    size_t length;
 
-    assert(!i2d_buffer_create(&buffer, BUFFER_SIZE_SMALL));
-    assert(!i2d_string_stack_create(&stack, 16));
+    assert(!i2d_buffer_create(I2D_TAG_UTIL, &buffer, BUFFER_SIZE_SMALL));
+    assert(!i2d_string_stack_create(I2D_TAG_UTIL, &stack, 16));
     assert(!i2d_string_stack_push(&stack, "Hello", 5));
     assert(!i2d_string_stack_push(&stack, "World", 5));
-    assert(!i2d_format_create(&format, "{0} {1}!", 8));
-    assert(!i2d_format_write(&format, &stack, &buffer));
-    i2d_format_destroy(&format);
+    assert(!i2d_string_create(I2D_TAG_UTIL, &format, "{0} {1}!", 8));
+    assert(!i2d_string_stack_format(&stack, &format, &buffer));
+    i2d_buffer_get(&buffer, &string, &length);
+    assert(12 == length && !memcmp(string, "Hello World!", 12));
+    i2d_string_destroy(&format);
     i2d_string_stack_destroy(&stack);
     i2d_buffer_destroy(&buffer);
 }
@@ -51,7 +96,7 @@ static void i2d_lexer_test(void) {
     enum i2d_token_type sequence[] = { I2D_LITERAL, I2D_CURLY_OPEN, I2D_CURLY_CLOSE, I2D_PARENTHESIS_OPEN, I2D_PARENTHESIS_CLOSE, I2D_COMMA, I2D_SEMICOLON, I2D_LITERAL, I2D_LITERAL, I2D_LITERAL, I2D_LITERAL, I2D_TEMPORARY_CHARACTER, I2D_PERMANENT_GLOBAL, I2D_TEMPORARY_GLOBAL, I2D_TEMPORARY_NPC, I2D_TEMPORARY_SCOPE, I2D_TEMPORARY_INSTANCE, I2D_PERMANENT_ACCOUNT_LOCAL, I2D_PERMANENT_ACCOUNT_GLOBAL, I2D_ADD, I2D_SUBTRACT, I2D_MULTIPLY, I2D_DIVIDE, I2D_MODULUS, I2D_ADD_ASSIGN, I2D_SUBTRACT_ASSIGN, I2D_MULTIPLY_ASSIGN, I2D_DIVIDE_ASSIGN, I2D_MODULUS_ASSIGN, I2D_GREATER, I2D_LESS, I2D_NOT, I2D_EQUAL, I2D_GREATER_EQUAL, I2D_LESS_EQUAL, I2D_NOT_EQUAL, I2D_RIGHT_SHIFT, I2D_LEFT_SHIFT, I2D_BIT_AND, I2D_BIT_OR, I2D_BIT_XOR, I2D_BIT_NOT, I2D_RIGHT_SHIFT_ASSIGN, I2D_LEFT_SHIFT_ASSIGN, I2D_BIT_AND_ASSIGN, I2D_BIT_OR_ASSIGN, I2D_BIT_XOR_ASSIGN, I2D_AND, I2D_OR, I2D_CONDITIONAL, I2D_COLON, I2D_UNIQUE_NAME, I2D_ASSIGN };
 
     assert(!i2d_lexer_init(&lexer));
-    assert(!i2d_string_create(&script, "//\n\"QUOTE\"/*123*/{}(),; _var1 var2 1234 0x11 @ $ $@ . .@ ' # ## + - * / % += -= *= /= %= > < ! == >= <= != >> <<  & | ^ ~ >>= <<= &= |= ^= && || ? : :: =", 147));
+    assert(!i2d_string_create(I2D_TAG_UTIL, &script, "//\n\"QUOTE\"/*123*/{}(),; _var1 var2 1234 0x11 @ $ $@ . .@ ' # ## + - * / % += -= *= /= %= > < ! == >= <= != >> <<  & | ^ ~ >>= <<= &= |= ^= && || ? : :: =", 147));
     for(j = 0; j < 2; j++) {
         assert(!i2d_lexer_tokenize(lexer, &script, &tokens));
         i = 0;
@@ -66,7 +111,7 @@ static void i2d_lexer_test(void) {
     i2d_lexer_deit(&lexer);
 
     assert(!i2d_lexer_init(&lexer));
-    assert(!i2d_string_create(&script, "@var $var $@var .var .@var 'var #var ##var @var$ $var$ $@var$ .var$ .@var$ 'var$ #var$ ##var$", 93));
+    assert(!i2d_string_create(I2D_TAG_UTIL, &script, "@var $var $@var .var .@var 'var #var ##var @var$ $var$ $@var$ .var$ .@var$ 'var$ #var$ ##var$", 93));
     assert(!i2d_lexer_tokenize(lexer, &script, &tokens));
     token = tokens->next;
     while(token != tokens) {
@@ -125,8 +170,8 @@ static void i2d_logic_test(void) {
     i2d_logic * and_logic = NULL;
     i2d_logic * or_logic = NULL;
 
-    i2d_string_create(&getrefine, "getrefine", 9);
-    i2d_string_create(&readparam, "readparam", 9);
+    i2d_string_create(I2D_TAG_UTIL, &getrefine, "getrefine", 9);
+    i2d_string_create(I2D_TAG_UTIL, &readparam, "readparam", 9);
     i2d_range_create(&getrefine_range);
     i2d_range_create(&readparam_range);
     i2d_range_add(&getrefine_range, 0, 15);
@@ -243,3 +288,648 @@ static void i2d_logic_not_test(i2d_logic * var_logic, i2d_logic * and_logic, i2d
     i2d_logic_deit(&not_and);
     i2d_logic_deit(&not_var);
 }
+
+/*
+ * every size up to a few levels is tested so that
+ * the last level of the eytzinger layout is empty,
+ * partial, and full; the long keys are compared
+ * inline and the string keys through compare
+ */
+static void i2d_rbt_static_test(void) {
+    i2d_rbt * tree = NULL;
+    i2d_rbt * strings = NULL;
+    long keys[130];
+    long last;
+    char names[130][8];
+    char name[8];
+    long key;
+    long * value;
+    size_t size;
+    size_t i;
+
+    for(size = 0; size < i2d_size(keys); size++) {
+        assert(!i2d_rbt_init_static(&tree, i2d_rbt_cmp_long));
+        assert(!i2d_rbt_init_static(&strings, i2d_rbt_cmp_str));
+
+        /* even keys from both ends inward */
+        for(i = 0; i < size; i++) {
+            keys[i] = (long) (i & 1 ? size - 1 - i / 2 : i / 2) * 2;
+            snprintf(names[i], sizeof(names[i]), "%04ld", keys[i]);
+            assert(!i2d_rbt_insert(tree, &keys[i], &keys[i]));
+            assert(!i2d_rbt_insert(strings, names[i], &keys[i]));
+        }
+        assert(!i2d_rbt_build(tree));
+        assert(!i2d_rbt_build(strings));
+
+        last = -1;
+        assert(!i2d_rbt_iterate(tree, i2d_rbt_static_test_cb, &last));
+        assert(last == (long) size * 2 - 2 || (!size && -1 == last));
+        last = -1;
+        assert(!i2d_rbt_iterate(strings, i2d_rbt_static_test_cb, &last));
+        assert(last == (long) size * 2 - 2 || (!size && -1 == last));
+
+        for(key = -1; key <= (long) size * 2; key++) {
+            snprintf(name, sizeof(name), "%04ld", key);
+            if(0 <= key && key < (long) size * 2 && !(key & 1)) {
+                assert(!i2d_rbt_search(tree, &key, (void **) &value) && *value == key);
+                assert(!i2d_rbt_search(strings, name, (void **) &value) && *value == key);
+            } else {
+                assert(i2d_rbt_search(tree, &key, (void **) &value));
+                assert(i2d_rbt_search(strings, name, (void **) &value));
+            }
+        }
+
+        i2d_rbt_deit(&strings);
+        i2d_rbt_deit(&tree);
+    }
+
+    /* the first of the duplicates is found after a second build */
+    keys[0] = 5;
+    keys[1] = 5;
+    keys[2] = 3;
+    assert(!i2d_rbt_init_static(&tree, i2d_rbt_cmp_long));
+    assert(!i2d_rbt_insert(tree, &keys[0], &keys[0]));
+    assert(!i2d_rbt_build(tree));
+    assert(!i2d_rbt_insert(tree, &keys[1], &keys[1]));
+    assert(!i2d_rbt_insert(tree, &keys[2], &keys[2]));
+    assert(!i2d_rbt_build(tree));
+    assert(!i2d_rbt_search(tree, &keys[1], (void **) &value) && value == &keys[0]);
+    assert(!i2d_rbt_search(tree, &keys[2], (void **) &value) && value == &keys[2]);
+    i2d_rbt_deit(&tree);
+}
+
+/* the values are visited in order of the keys */
+static int i2d_rbt_static_test_cb(void * value, void * data) {
+    long * last = data;
+
+    assert(*last < *((long *) value));
+    *last = *((long *) value);
+
+    return I2D_OK;
+}
+
+/*
+ * each event is written as type, depth, and the
+ * string of the event on a line; the utf-8 of the
+ * surrogate pair is the same as jansson's
+ */
+static void i2d_json_stream_test(void) {
+    i2d_buffer buffer;
+    char * string;
+    size_t length;
+    const char * json = "{ \"a\": [ \"x\\\"\\\\\\/\\b\\f\\n\\r\\t\", \"\\u00e9\\u20AC\\ud83d\\ude00\", -1.5e3, true, false, null ], \"b\": {} }";
+    const char events[] =
+        "0 0 \n"
+        "4 1 a\n"
+        "2 1 \n"
+        "5 2 x\"\\/\b\f\n\r\t\n"
+        "5 2 \xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\n"
+        "6 2 -1.5e3\n"
+        "7 2 \n"
+        "8 2 \n"
+        "9 2 \n"
+        "3 1 \n"
+        "4 1 b\n"
+        "0 1 \n"
+        "1 1 \n"
+        "1 0 \n";
+
+    assert(!i2d_buffer_create(I2D_TAG_UTIL, &buffer, BUFFER_SIZE_SMALL));
+    assert(!i2d_json_stream_test_file(json, &buffer));
+    i2d_buffer_get(&buffer, &string, &length);
+    assert(sizeof(events) - 1 == length && !memcmp(string, events, length));
+
+    /* a lone or reversed surrogate, a bad escape, and a bad document */
+    assert(i2d_json_stream_test_file("[ \"\\udc00\" ]", &buffer));
+    assert(i2d_json_stream_test_file("[ \"\\ud83d\" ]", &buffer));
+    assert(i2d_json_stream_test_file("[ \"\\ud83d\\u0041\" ]", &buffer));
+    assert(i2d_json_stream_test_file("[ \"\\u12g4\" ]", &buffer));
+    assert(i2d_json_stream_test_file("[ \"\\q\" ]", &buffer));
+    assert(i2d_json_stream_test_file("{ \"a\" 1 }", &buffer));
+    assert(i2d_json_stream_test_file("[ 1, ", &buffer));
+    i2d_buffer_destroy(&buffer);
+}
+
+static int i2d_json_stream_test_file(const char * json, i2d_buffer * buffer) {
+    int status = I2D_OK;
+    i2d_string path;
+
+    assert(!i2d_string_create(I2D_TAG_UTIL, &path, "i2d_test.json", 13));
+    i2d_test_file(path.string, json);
+
+    i2d_buffer_clear(buffer);
+    status = i2d_json_stream(&path, i2d_json_stream_test_cb, buffer);
+
+    remove(path.string);
+    i2d_string_destroy(&path);
+
+    return status;
+}
+
+static int i2d_json_stream_test_cb(i2d_json_event * event, void * data) {
+    i2d_buffer * buffer = data;
+
+    assert(!i2d_buffer_printf(buffer, "%d %zu ", (int) event->type, event->depth));
+    if(i2d_json_key == event->type || i2d_json_string == event->type || i2d_json_number == event->type)
+        assert(!i2d_buffer_memcpy(buffer, event->string, event->length));
+    assert(!i2d_buffer_putc(buffer, '\n'));
+
+    return I2D_OK;
+}
+
+static void i2d_split_test(void) {
+    i2d_split_test_line("501,{ a, b },\"x,y\"\n", 0, "501|{ a| b }|\"x|y\"|");
+    i2d_split_test_line("501,Red_Potion,Red Potion,{ a, b },\"x,y\",last // note\n", I2D_SPLIT_QUOTE | I2D_SPLIT_BRACE, "501|Red_Potion|Red Potion|{ a, b }|\"x,y\"|last |");
+    i2d_split_test_line("a,{ b, c } ,\"d\n", I2D_SPLIT_BRACE, "a|{ b, c } |\"d|");
+    i2d_split_test_line("a,{ b, c\n", I2D_SPLIT_BRACE, "a|");
+    i2d_split_test_line("a,\"b, c\n", I2D_SPLIT_QUOTE, "a|");
+    i2d_split_test_line("a,b c,d\n", I2D_SPLIT_SPACE, "a|b|");
+    i2d_split_test_line("a,b\tc,d\n", 0, "a|b|");
+    i2d_split_test_line("a,b\tc,d\n", I2D_SPLIT_TAB, "a|b\tc|d|");
+    i2d_split_test_line("a,b/c,d\r\n", 0, "a|b/c|d|");
+    i2d_split_test_line("a,b,c", 0, "a|b|");
+    i2d_split_test_line(",,\n", 0, "|||");
+    i2d_split_test_line("// a,b\n", 0, "|");
+}
+
+/*
+ * expect is the fields of the line each followed
+ * by a bar
+ */
+static void i2d_split_test_line(const char * line, int flags, const char * expect) {
+    i2d_split split;
+    char string[128];
+    char result[128];
+    char * field;
+    size_t length;
+    size_t offset = 0;
+
+    length = strlen(line);
+    assert(length < sizeof(string));
+    memcpy(string, line, length + 1);
+
+    i2d_split_create(&split, string, length, flags);
+    while(!i2d_split_next(&split, &field, &length)) {
+        assert(strlen(field) == length);
+        assert(offset + length + 1 < sizeof(result));
+        memcpy(result + offset, field, length);
+        offset += length;
+        result[offset++] = '|';
+    }
+    result[offset] = 0;
+    assert(!strcmp(result, expect));
+}
+
+/*
+ * the numbers that fit in the digits of the fast
+ * path and the numbers that are passed to libc
+ */
+static void i2d_strtol_test(void) {
+    long number;
+    long long big;
+    unsigned long bits;
+
+    assert(!i2d_strtol(&number, "", 0, 10) && 0 == number);
+    assert(!i2d_strtol(&number, "0", 1, 10) && 0 == number);
+    assert(!i2d_strtol(&number, "501", 3, 10) && 501 == number);
+    assert(!i2d_strtol(&number, "-45", 3, 10) && -45 == number);
+    assert(!i2d_strtol(&number, "+7", 2, 10) && 7 == number);
+    assert(!i2d_strtol(&number, "999999999", 9, 10) && 999999999L == number);
+    assert(!i2d_strtol(&number, "2147483647", 10, 10) && 2147483647L == number);
+    assert(!i2d_strtol(&number, "-2147483648", 11, 10) && -2147483647L - 1 == number);
+    assert(!i2d_strtol(&number, "ff", 2, 16) && 255 == number);
+    assert(!i2d_strtol(&number, "FFFFFFF", 7, 16) && 0xFFFFFFFL == number);
+    assert(!i2d_strtol(&number, "0x1f", 4, 16) && 31 == number);
+    assert(!i2d_strtol(&number, "0755", 4, 8) && 493 == number);
+    assert(!i2d_strtol(&number, "015", 3, 10) && 15 == number);
+    assert(!i2d_strtol(&number, "12", 1, 10) && 1 == number);
+    assert(i2d_strtol(&number, "12a", 3, 10));
+    assert(i2d_strtol(&number, "1g", 2, 16));
+    assert(i2d_strtol(&number, "-", 1, 10));
+    assert(i2d_strtol(&number, "1.5", 3, 10));
+
+    assert(!i2d_strtoll(&big, "123456789012345678", 18, 10) && 123456789012345678LL == big);
+    assert(!i2d_strtoll(&big, "-9223372036854775807", 20, 10) && -9223372036854775807LL == big);
+    assert(!i2d_strtoll(&big, "7FFFFFFFFFFFFFFF", 16, 16) && 0x7FFFFFFFFFFFFFFFLL == big);
+    assert(i2d_strtoll(&big, "12 ", 3, 10));
+
+    assert(!i2d_strtoul(&bits, "FFFFFFFF", 8, 16) && 0xFFFFFFFFUL == bits);
+    assert(!i2d_strtoul(&bits, "4294967295", 10, 10) && 4294967295UL == bits);
+    assert(i2d_strtoul(&bits, "-", 1, 10));
+}
+
+/* the combo partner of a selected item is also selected */
+static void i2d_select_test(void) {
+    i2d_string item_path;
+    i2d_string combo_path;
+    i2d_item_db * item_db = NULL;
+    i2d_item_combo_db * item_combo_db = NULL;
+
+    assert(!i2d_string_create(I2D_TAG_UTIL, &item_path, "i2d_test_item_db.txt", 20));
+    assert(!i2d_string_create(I2D_TAG_UTIL, &combo_path, "i2d_test_item_combo_db.txt", 26));
+    i2d_test_file(item_path.string,
+        "501,Red_Potion,Red Potion,0,10,5,70,,,,,FFFFFFFF,63,2,,,,,,{},{},{}\n"
+        "502,Orange_Potion,Orange Potion,0,50,25,100,,,,,FFFFFFFF,63,2,,,,,,{},{},{}\n"
+        "1201,Knife,Knife,5,50,25,400,17,,1,3,FFFFFFFF,63,2,2,1,1,1,1,{},{},{}\n"
+        "4001,Poring_Card,Poring Card,6,20,10,10,,,,,,,,2,,,,,{},{},{}\n"
+        "4002,Fabre_Card,Fabre Card,6,20,10,10,,,,,,,,2,,,,,{},{},{}\n");
+    i2d_test_file(combo_path.string, "501:502,{ bonus bStr,1; }\n");
+    assert(!i2d_item_db_init(&item_db, &item_path, 0));
+    assert(!i2d_item_combo_db_init(&item_combo_db, &combo_path));
+
+    i2d_select_test_name(item_db, item_combo_db, "*_Card", "4001 4002 ");
+    i2d_select_test_name(item_db, item_combo_db, "?ed_*", "501 502 ");
+    i2d_select_test_name(item_db, item_combo_db, "*potion", "501 502 ");
+    i2d_select_test_name(item_db, item_combo_db, "K*e", "1201 ");
+    i2d_select_test_name(item_db, item_combo_db, "*a*a*", "4002 ");
+    i2d_select_test_name(item_db, item_combo_db, "**_?a*d", "4001 4002 ");
+    i2d_select_test_name(item_db, item_combo_db, "F*?_c*", "4002 ");
+    i2d_select_test_name(item_db, item_combo_db, "Knife?", "");
+    i2d_select_test_name(item_db, item_combo_db, "Knif", "");
+    i2d_select_test_name(item_db, item_combo_db, "*", "501 502 1201 4001 4002 ");
+
+    i2d_item_combo_db_deit(&item_combo_db);
+    i2d_item_db_deit(&item_db);
+    remove(combo_path.string);
+    remove(item_path.string);
+    i2d_string_destroy(&combo_path);
+    i2d_string_destroy(&item_path);
+}
+
+/*
+ * expect is the ids of the selected items each
+ * followed by a space
+ */
+static void i2d_select_test_name(i2d_item_db * item_db, i2d_item_combo_db * item_combo_db, const char * name, const char * expect) {
+    json_t * json;
+    i2d_select * select = NULL;
+    char result[64];
+    size_t offset = 0;
+    size_t i;
+
+    json = json_pack("{s:[s]}", "name", name);
+    assert(json);
+    assert(!i2d_select_init(&select, json));
+    assert(!i2d_select_resolve(select, item_db, item_combo_db));
+    for(i = 0; i < select->size; i++)
+        offset += (size_t) snprintf(result + offset, sizeof(result) - offset, "%ld ", select->list[i]->id);
+    result[offset] = 0;
+    assert(!strcmp(result, expect));
+    i2d_select_deit(&select);
+    json_decref(json);
+}
+
+/*
+ * the rope is compared with a buffer that has
+ * the same text; the segments are more than one
+ * writev and a stored string is larger than a
+ * block
+ */
+static void i2d_rope_test(void) {
+    i2d_rope rope;
+    i2d_buffer buffer;
+    i2d_string format;
+    i2d_string list[2];
+    i2d_string string;
+    char source[BUFFER_SIZE_LARGE * 2];
+    size_t i;
+
+    assert(!i2d_rope_create(&rope));
+    assert(!i2d_buffer_create(I2D_TAG_UTIL, &buffer, BUFFER_SIZE_SMALL));
+
+    assert(!i2d_rope_add(&rope, "ID: ", 4));
+    assert(!i2d_rope_add(&rope, "", 0));
+    assert(!i2d_buffer_puts(&buffer, "ID: "));
+
+    /* a stored string is a copy of the source */
+    memcpy(source, "501\n", 4);
+    assert(!i2d_rope_store(&rope, source, 4, &string));
+    assert(!i2d_rope_add(&rope, string.string, string.length));
+    memcpy(source, "XXX\n", 4);
+    assert(!i2d_buffer_puts(&buffer, "501\n"));
+
+    assert(!i2d_string_create(I2D_TAG_UTIL, &format, "{1} and {0}!", 12));
+    list[0].string = "Hello";
+    list[0].length = 5;
+    list[1].string = "World";
+    list[1].length = 5;
+    assert(!i2d_rope_format(&rope, &format, list, 2));
+    assert(!i2d_buffer_puts(&buffer, "World and Hello!"));
+
+    memset(source, 'x', sizeof(source));
+    assert(!i2d_rope_store(&rope, source, sizeof(source), &string));
+    assert(!i2d_rope_add(&rope, string.string, string.length));
+    assert(!i2d_buffer_memcpy(&buffer, source, sizeof(source)));
+
+    for(i = 0; i < I2D_ROPE_IOV + 8; i++) {
+        assert(!i2d_rope_add(&rope, (i & 1) ? "ab" : "c", (i & 1) ? 2 : 1));
+        assert(!i2d_buffer_puts(&buffer, (i & 1) ? "ab" : "c"));
+    }
+
+    assert(rope.length == buffer.offset);
+    i2d_rope_test_write(&rope, &buffer);
+
+    /* the blocks are reused after a clear */
+    i2d_rope_clear(&rope);
+    i2d_buffer_clear(&buffer);
+    assert(!rope.size && !rope.length);
+    assert(!i2d_rope_store(&rope, "Weight: 70\n", 11, &string));
+    assert(!i2d_rope_add(&rope, string.string, string.length));
+    assert(!i2d_buffer_puts(&buffer, "Weight: 70\n"));
+    i2d_rope_test_write(&rope, &buffer);
+
+    assert(i2d_rope_format(&rope, &format, list, 1));
+
+    /* the segments after the start are joined into one */
+    i2d_buffer_clear(&buffer);
+    assert(!i2d_rope_add(&rope, "[", 1));
+    assert(!i2d_rope_format(&rope, &format, list, 2));
+    assert(!i2d_rope_join(&rope, 1, &string));
+    assert(1 == rope.size && 1 == rope.length);
+    assert(16 == string.length && !memcmp(string.string, "World and Hello!", 16));
+    assert(!i2d_rope_add(&rope, string.string, string.length));
+    assert(!i2d_buffer_puts(&buffer, "[World and Hello!"));
+    i2d_rope_test_write(&rope, &buffer);
+
+    /* the empty strings of a dump have no delimiter */
+    i2d_buffer_clear(&buffer);
+    list[0].length = 0;
+    assert(!i2d_rope_dump(&rope, list, 2, "\n"));
+    list[0].length = 5;
+    assert(!i2d_rope_dump(&rope, list, 2, "\n"));
+    assert(!i2d_buffer_puts(&buffer, "WorldHello\nWorld"));
+    i2d_rope_test_write(&rope, &buffer);
+
+    i2d_string_destroy(&format);
+    i2d_buffer_destroy(&buffer);
+    i2d_rope_destroy(&rope);
+}
+
+static void i2d_rope_test_write(i2d_rope * rope, i2d_buffer * buffer) {
+    FILE * file;
+    char * string;
+    size_t length;
+
+    file = tmpfile();
+    assert(file);
+    assert(!i2d_rope_write(rope, file));
+    assert(!fflush(file));
+    assert((long) buffer->offset == ftell(file));
+
+    string = i2d_malloc(I2D_TAG_UTIL, buffer->offset);
+    assert(string);
+    rewind(file);
+    length = fread(string, 1, buffer->offset, file);
+    assert(length == buffer->offset && !memcmp(string, buffer->buffer, length));
+    i2d_free(string);
+    assert(!fclose(file));
+}
+
+/*
+ * the index grows several times and a string is
+ * larger than a block, but an interned string is
+ * never moved, so the first copy is found again
+ */
+static void i2d_intern_test(void) {
+    i2d_string first;
+    i2d_string second;
+    i2d_string * list;
+    char name[16];
+    char * large;
+    size_t size = I2D_INTERN_SLOTS * 8;
+    size_t i;
+
+    assert(!i2d_intern_get("Red_Potion", 10, &first));
+    assert(!i2d_intern_get("Red_Potion", 10, &second));
+    assert(first.string == second.string && 10 == first.length && !strcmp(first.string, "Red_Potion"));
+    assert(!i2d_intern_get("Red_Potion", 3, &second));
+    assert(first.string != second.string && 3 == second.length && !strcmp(second.string, "Red"));
+    assert(!i2d_intern_get("", 0, &second));
+    assert(0 == second.length && !*second.string);
+
+    list = i2d_malloc(I2D_TAG_UTIL, size * sizeof(*list));
+    assert(list);
+    for(i = 0; i < size; i++) {
+        snprintf(name, sizeof(name), "s%zu", i);
+        assert(!i2d_intern_get(name, strlen(name), &list[i]));
+    }
+
+    large = i2d_malloc(I2D_TAG_UTIL, I2D_INTERN_BLOCK + 16);
+    assert(large);
+    memset(large, 'x', I2D_INTERN_BLOCK + 16);
+    assert(!i2d_intern_get(large, I2D_INTERN_BLOCK + 16, &second));
+    assert(I2D_INTERN_BLOCK + 16 == second.length && !memcmp(second.string, large, second.length) && !second.string[second.length]);
+    assert(!i2d_intern_get(large, I2D_INTERN_BLOCK + 16, &first));
+    assert(first.string == second.string);
+    i2d_free(large);
+
+    for(i = 0; i < size; i++) {
+        snprintf(name, sizeof(name), "s%zu", i);
+        assert(!i2d_intern_get(name, strlen(name), &second));
+        assert(list[i].string == second.string && !strcmp(second.string, name));
+    }
+    assert(!i2d_intern_get("Red_Potion", 10, &second));
+    assert(!strcmp(second.string, "Red_Potion"));
+    i2d_free(list);
+
+    /* the arena is empty again after deit */
+    i2d_intern_deit();
+    assert(!i2d_intern_get("Red_Potion", 10, &first));
+    assert(!strcmp(first.string, "Red_Potion"));
+    i2d_intern_deit();
+}
+
+/*
+ * an incremental run in which no item changed
+ * removes nothing with an empty selection
+ */
+static void i2d_index_remove_test(void) {
+    i2d_index * index = NULL;
+    i2d_index_entry * entry;
+    i2d_item item;
+    i2d_item * list[1];
+
+    assert(!i2d_index_init(&index));
+    i2d_index_set_item(index, 501);
+    assert(!i2d_index_add(index, "bonus:%s", "bStr"));
+    i2d_index_set_item(index, 502);
+    assert(!i2d_index_add(index, "bonus:%s", "bStr"));
+
+    i2d_index_remove(index, NULL, 0);
+    assert(!i2d_index_search(index, "bonus:bStr", &entry));
+    assert(2 == entry->size && 501 == entry->list[0] && 502 == entry->list[1]);
+
+    i2d_zero(item);
+    item.id = 501;
+    list[0] = &item;
+    i2d_index_remove(index, list, 1);
+    assert(!i2d_index_search(index, "bonus:bStr", &entry));
+    assert(1 == entry->size && 502 == entry->list[0]);
+
+    i2d_index_deit(&index);
+}
+
+/*
+ * the first of the entries with the same id wins
+ * in the table and in the static red black tree
+ */
+static void i2d_duplicate_id_test(void) {
+    i2d_table table;
+    long values[2];
+    long * value;
+    i2d_string item_path;
+    i2d_item_db * item_db = NULL;
+    i2d_item * item;
+
+    memset(&table, 0, sizeof(table));
+    assert(!i2d_table_insert(&table, 5, &values[0]));
+    assert(!i2d_table_insert(&table, 5, &values[1]));
+    assert(!i2d_table_search(&table, 5, (void **) &value) && value == &values[0]);
+    assert(i2d_table_search(&table, 6, (void **) &value));
+    i2d_table_destroy(&table);
+
+    assert(!i2d_string_create(I2D_TAG_UTIL, &item_path, "i2d_test_item_db.txt", 20));
+    i2d_test_file(item_path.string,
+        "501,Red_Potion,Red Potion,0,10,5,70,,,,,FFFFFFFF,63,2,,,,,,{},{},{}\n"
+        "501,Orange_Potion,Orange Potion,0,50,25,100,,,,,FFFFFFFF,63,2,,,,,,{},{},{}\n"
+        "20000000,Knife,Knife,5,50,25,400,17,,1,3,FFFFFFFF,63,2,2,1,1,1,1,{},{},{}\n"
+        "20000000,Cutter,Cutter,5,1250,625,550,30,,1,3,FFFFFFFF,63,2,2,1,1,1,1,{},{},{}\n");
+    assert(!i2d_item_db_init(&item_db, &item_path, 0));
+    assert(!i2d_item_db_search_by_id(item_db, 501, &item) && !strcmp(item->name.string, "Red Potion"));
+    assert(!i2d_item_db_search_by_id(item_db, 20000000, &item) && !strcmp(item->name.string, "Knife"));
+    i2d_item_db_deit(&item_db);
+    remove(item_path.string);
+    i2d_string_destroy(&item_path);
+}
+
+/*
+ * the data files are loaded as they are, which is
+ * from the tables of a build with TABLE=1, and from
+ * a copy with a trailing newline, which is always
+ * read as json, and the lookups must be the same
+ */
+static void i2d_json_table_test(void) {
+    i2d_string constants_path;
+    i2d_string constants_copy;
+    i2d_string bonus_path;
+    i2d_string bonus_copy;
+    i2d_string data_path;
+    i2d_string data_copy;
+    i2d_constant_db * table_db = NULL;
+    i2d_constant_db * json_db = NULL;
+    i2d_constant * table_constant;
+    i2d_constant * json_constant;
+    i2d_data_map * table_bonus = NULL;
+    i2d_data_map * json_bonus = NULL;
+    i2d_data_section table_sections[] = { { "bonus", &table_bonus } };
+    i2d_data_section json_sections[] = { { "bonus", &json_bonus } };
+    i2d_data * table_data;
+    i2d_data * json_data;
+    const i2d_json_table * table;
+    json_t * table_json = NULL;
+    json_t * json;
+    i2d_json_section table_section;
+    i2d_json_section json_section;
+    i2d_value_map * table_weapons = NULL;
+    i2d_value_map * json_weapons = NULL;
+    i2d_string table_string;
+    i2d_string json_string;
+    size_t i;
+    long key;
+
+    assert(!i2d_string_create(I2D_TAG_UTIL, &constants_path, "data/constants.json", 19));
+    assert(!i2d_string_create(I2D_TAG_UTIL, &bonus_path, "data/bonus.json", 15));
+    assert(!i2d_string_create(I2D_TAG_UTIL, &data_path, "data/data.json", 14));
+    i2d_json_table_test_copy(constants_path.string, &constants_copy);
+    i2d_json_table_test_copy(bonus_path.string, &bonus_copy);
+    i2d_json_table_test_copy(data_path.string, &data_copy);
+    assert(i2d_json_table_get(&constants_copy, &table));
+
+    assert(!i2d_constant_db_init(&table_db, &constants_path));
+    assert(!i2d_constant_db_init(&json_db, &constants_copy));
+    assert(table_db->size == json_db->size);
+    for(i = 0; i < json_db->size; i++) {
+        assert(!i2d_constant_get_by_macro(table_db, json_db->constants[i].macro.string, &table_constant));
+        assert(!i2d_constant_get_by_macro(json_db, json_db->constants[i].macro.string, &json_constant));
+        assert(table_constant->value == json_constant->value && table_constant->macro.string == json_constant->macro.string);
+    }
+    assert(!i2d_constant_get_by_macro(table_db, "rc_demihuman", &table_constant) && 7 == table_constant->value);
+    assert(i2d_constant_get_by_macro(table_db, "RC_NOT_A_RACE", &table_constant));
+    for(key = -1; key < 64; key++) {
+        assert(i2d_constant_get_by_race(table_db, key, &table_constant) == i2d_constant_get_by_race(json_db, key, &json_constant));
+        assert(i2d_constant_get_by_element(table_db, key, &table_constant) == i2d_constant_get_by_element(json_db, key, &json_constant));
+        assert(i2d_constant_get_by_job(table_db, key, &table_constant) == i2d_constant_get_by_job(json_db, key, &json_constant));
+    }
+
+    assert(!i2d_data_map_load(&bonus_path, table_sections, i2d_size(table_sections)));
+    assert(!i2d_data_map_load(&bonus_copy, json_sections, i2d_size(json_sections)));
+    assert(!i2d_data_map_index(table_bonus, data_map_by_constant, table_db));
+    assert(!i2d_data_map_index(json_bonus, data_map_by_constant, json_db));
+    assert(table_bonus->size == json_bonus->size);
+    if(!i2d_json_table_get(&constants_path, &table))
+        assert(table_db->macros.index && table_bonus->index && !json_db->macros.index && !json_bonus->index);
+    for(i = 0; i < json_bonus->size; i++) {
+        assert(!i2d_data_map_get(table_bonus, &json_bonus->list[i].constant, &table_data));
+        assert(!i2d_data_map_get(json_bonus, &json_bonus->list[i].constant, &json_data));
+        assert(table_data->name.string == json_data->name.string && table_data->hash == json_data->hash);
+        assert(table_data->description.string == json_data->description.string);
+    }
+
+    i2d_zero(table_section);
+    if(i2d_json_table_get(&data_path, &table)) {
+        assert(!i2d_json_create(&table_json, &data_path));
+        table_section.json = json_object_get(table_json, "weapon_type");
+    } else {
+        assert(!i2d_json_table_get_section(table, "weapon_type", &table_section.table));
+    }
+    assert(!i2d_json_create(&json, &data_copy));
+    json_section.json = json_object_get(json, "weapon_type");
+    json_section.table = NULL;
+    assert(!i2d_value_map_init(&table_weapons, &table_section, i2d_value_string));
+    assert(!i2d_value_map_init(&json_weapons, &json_section, i2d_value_string));
+    for(key = -1; key < 64; key++) {
+        i2d_zero(table_string);
+        i2d_zero(json_string);
+        assert(!i2d_value_map_get_string(table_weapons, key, &table_string));
+        assert(!i2d_value_map_get_string(json_weapons, key, &json_string));
+        assert(table_string.string == json_string.string);
+    }
+
+    i2d_value_map_deit(&json_weapons);
+    i2d_value_map_deit(&table_weapons);
+    i2d_json_destroy(json);
+    i2d_json_destroy(table_json);
+    i2d_data_map_deit(&json_bonus);
+    i2d_data_map_deit(&table_bonus);
+    i2d_constant_db_deit(&json_db);
+    i2d_constant_db_deit(&table_db);
+    remove(data_copy.string);
+    remove(bonus_copy.string);
+    remove(constants_copy.string);
+    i2d_string_destroy(&data_copy);
+    i2d_string_destroy(&bonus_copy);
+    i2d_string_destroy(&constants_copy);
+    i2d_string_destroy(&data_path);
+    i2d_string_destroy(&bonus_path);
+    i2d_string_destroy(&constants_path);
+}
+
+static void i2d_json_table_test_copy(const char * path, i2d_string * result) {
+    i2d_buffer buffer;
+    i2d_string source;
+    char * string;
+    size_t length;
+
+    assert(!i2d_string_create(I2D_TAG_UTIL, &source, path, strlen(path)));
+    assert(!i2d_buffer_create(I2D_TAG_UTIL, &buffer, BUFFER_SIZE_LARGE));
+    assert(!i2d_fd_read_file(&source, &buffer));
+    assert(!i2d_buffer_putc(&buffer, '\n'));
+    assert(!i2d_buffer_putc(&buffer, 0));
+    i2d_buffer_get(&buffer, &string, &length);
+
+    assert(!i2d_string_vprintf(I2D_TAG_UTIL, result, "i2d_test_%s", strrchr(path, '/') + 1));
+    i2d_test_file(result->string, string);
+
+    i2d_buffer_destroy(&buffer);
+    i2d_string_destroy(&source);
+}
@@ -0,0 +1,243 @@
+#include "i2d_trace.h"
+
+#ifndef _WIN32
+#define i2d_thread_local __thread
+#else
+#define i2d_thread_local __declspec(thread)
+#endif
+
+static void i2d_trace_add(const char *, long, char, uint64_t);
+static i2d_trace_ring * i2d_trace_get(void);
+static size_t i2d_trace_position(uint64_t);
+static i2d_trace_event * i2d_trace_next(i2d_trace_ring *);
+static int i2d_trace_write_ring(FILE *, i2d_trace_ring *, int *);
+
+static int i2d_trace_active;
+static uint64_t i2d_trace_origin;
+static i2d_trace_ring * i2d_trace_rings[I2D_TRACE_THREADS];
+#ifndef _WIN32
+static size_t i2d_trace_count;
+#else
+static volatile LONG i2d_trace_count;
+#endif
+static i2d_thread_local i2d_trace_ring * i2d_trace_local;
+static i2d_thread_local int i2d_trace_is_claimed;
+
+/* monotonic time in microseconds */
+uint64_t i2d_trace_time(void) {
+#ifndef _WIN32
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000 + (uint64_t) time.tv_nsec / 1000;
+#else
+    LARGE_INTEGER count;
+    LARGE_INTEGER frequency;
+
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t) (count.QuadPart / frequency.QuadPart * 1000000 + count.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart);
+#endif
+}
+
+/*
+ * the trace path is part of the config, so the
+ * span that reads the config (i.e. i2d_json_init)
+ * is recorded once tracing is enabled from start
+ */
+int i2d_trace_init(const char * name, uint64_t start) {
+    int status = I2D_OK;
+
+    if(i2d_trace_active) {
+        status = i2d_panic("trace is already active");
+    } else {
+        i2d_trace_active = 1;
+        i2d_trace_origin = start;
+        i2d_trace_add(name, 0, 'B', start);
+        i2d_trace_add(name, 0, 'E', i2d_trace_time());
+    }
+
+    return status;
+}
+
+void i2d_trace_deit(void) {
+    size_t i;
+
+    for(i = 0; i < I2D_TRACE_THREADS; i++) {
+        if(i2d_trace_rings[i])
+            i2d_free(i2d_trace_rings[i]->list);
+        i2d_free(i2d_trace_rings[i]);
+    }
+
+    i2d_trace_active = 0;
+    i2d_trace_count = 0;
+    i2d_trace_local = NULL;
+    i2d_trace_is_claimed = 0;
+}
+
+void i2d_trace_begin(const char * name, long id) {
+    if(i2d_trace_active)
+        i2d_trace_add(name, id, 'B', i2d_trace_time());
+}
+
+void i2d_trace_end(const char * name) {
+    if(i2d_trace_active)
+        i2d_trace_add(name, 0, 'E', i2d_trace_time());
+}
+
+static void i2d_trace_add(const char * name, long id, char phase, uint64_t time) {
+    i2d_trace_ring * ring;
+    i2d_trace_event * event;
+
+    ring = i2d_trace_get();
+    if(ring) {
+        event = i2d_trace_next(ring);
+        if(event) {
+            if('B' == phase) {
+                if(ring->depth < I2D_TRACE_DEPTH)
+                    ring->stack[ring->depth] = ring->size;
+                ring->depth++;
+            } else if(ring->depth) {
+                ring->depth--;
+                id = (long) (ring->depth < I2D_TRACE_DEPTH ? ring->stack[ring->depth] : ring->size);
+            } else {
+                id = (long) ring->size;
+            }
+
+            event->name = name;
+            event->id = id;
+            event->time = time;
+            event->phase = phase;
+            ring->size++;
+        }
+    }
+}
+
+/*
+ * the head is followed by the ring of the latest
+ * events, which is overwritten once it is full
+ */
+static size_t i2d_trace_position(uint64_t index) {
+    return index < I2D_TRACE_HEAD ? (size_t) index : I2D_TRACE_HEAD + (size_t) ((index - I2D_TRACE_HEAD) & (I2D_TRACE_SIZE - 1));
+}
+
+static i2d_trace_event * i2d_trace_next(i2d_trace_ring * ring) {
+    i2d_trace_event * list;
+    size_t position;
+    size_t capacity;
+
+    position = i2d_trace_position(ring->size);
+    if(position >= ring->capacity) {
+        capacity = ring->capacity ? ring->capacity * 2 : BUFFER_SIZE_LARGE;
+        if(capacity > I2D_TRACE_HEAD + I2D_TRACE_SIZE)
+            capacity = I2D_TRACE_HEAD + I2D_TRACE_SIZE;
+
+        list = i2d_realloc(I2D_TAG_TRACE, ring->list, capacity * sizeof(*list));
+        if(list) {
+            ring->list = list;
+            ring->capacity = capacity;
+        }
+    }
+
+    return position < ring->capacity ? &ring->list[position] : NULL;
+}
+
+/*
+ * a thread claims a slot on its first event; the
+ * events of the threads past the last slot or of
+ * a thread that failed to allocate are dropped
+ */
+static i2d_trace_ring * i2d_trace_get(void) {
+    size_t tid;
+
+    if(!i2d_trace_is_claimed) {
+        i2d_trace_is_claimed = 1;
+#ifndef _WIN32
+        tid = __atomic_fetch_add(&i2d_trace_count, 1, __ATOMIC_RELAXED);
+#else
+        tid = (size_t) InterlockedIncrement(&i2d_trace_count) - 1;
+#endif
+        if(tid < I2D_TRACE_THREADS) {
+            i2d_trace_local = i2d_calloc(I2D_TAG_TRACE, 1, sizeof(*i2d_trace_local));
+            if(i2d_trace_local) {
+                i2d_trace_local->tid = tid;
+                i2d_trace_rings[tid] = i2d_trace_local;
+            }
+        }
+    }
+
+    return i2d_trace_local;
+}
+
+/*
+ * chrome trace event format; the events of a
+ * thread are already in time order, and an end
+ * whose begin was overwritten is skipped since
+ * it would close a span that was not opened, as
+ * is a begin in the head whose end was dropped
+ */
+static int i2d_trace_write_ring(FILE * file, i2d_trace_ring * ring, int * is_first) {
+    int status = I2D_OK;
+    uint64_t i;
+    uint64_t start;
+    i2d_trace_event * event;
+    unsigned char closed[I2D_TRACE_HEAD / 8];
+
+    if(fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}", *is_first ? "" : ",", (unsigned long) ring->tid, ring->tid ? "worker" : "main") < 0)
+        status = i2d_panic("failed to write trace");
+
+    *is_first = 0;
+
+    /* mark the begins in the head that have an end */
+    memset(closed, 0, sizeof(closed));
+    start = ring->size > I2D_TRACE_HEAD + I2D_TRACE_SIZE ? ring->size - I2D_TRACE_SIZE : I2D_TRACE_HEAD;
+    for(i = 0; i < ring->size; i = (i + 1 == I2D_TRACE_HEAD) ? start : i + 1) {
+        event = &ring->list[i2d_trace_position(i)];
+        if('E' == event->phase && (uint64_t) event->id < I2D_TRACE_HEAD)
+            closed[event->id / 8] |= (unsigned char) (1 << (event->id % 8));
+    }
+
+    for(i = 0; i < ring->size && !status; i = (i + 1 == I2D_TRACE_HEAD) ? start : i + 1) {
+        event = &ring->list[i2d_trace_position(i)];
+        if('E' == event->phase && (uint64_t) event->id >= I2D_TRACE_HEAD && (uint64_t) event->id < start) {
+            /* begin was overwritten */
+        } else if('B' == event->phase && i < I2D_TRACE_HEAD && start > I2D_TRACE_HEAD && !(closed[i / 8] & (1 << (i % 8)))) {
+            /* end was overwritten */
+        } else if(fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%lu,\"ts\":%" PRIu64, event->name, event->phase, (unsigned long) ring->tid, event->time - i2d_trace_origin) < 0) {
+            status = i2d_panic("failed to write trace");
+        } else if('B' == event->phase && event->id && fprintf(file, ",\"args\":{\"id\":%ld}", event->id) < 0) {
+            status = i2d_panic("failed to write trace");
+        } else if(fputc('}', file) == EOF) {
+            status = i2d_panic("failed to write trace");
+        }
+    }
+
+    return status;
+}
+
+int i2d_trace_write(i2d_string * path) {
+    int status = I2D_OK;
+    FILE * file;
+    size_t i;
+    int is_first = 1;
+
+    file = fopen(path->string, "w");
+    if(!file) {
+        status = i2d_panic("failed to open file -- %s", path->string);
+    } else {
+        if(fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file) == EOF)
+            status = i2d_panic("failed to write trace");
+
+        for(i = 0; i < I2D_TRACE_THREADS && !status; i++)
+            if(i2d_trace_rings[i] && i2d_trace_write_ring(file, i2d_trace_rings[i], &is_first))
+                status = i2d_panic("failed to write trace ring -- %lu", (unsigned long) i);
+
+        if(!status && fputs("\n]}\n", file) == EOF)
+            status = i2d_panic("failed to write trace");
+
+        if(fclose(file))
+            status = i2d_panic("failed to close file -- %s", path->string);
+    }
+
+    return status;
+}
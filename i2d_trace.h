@@ -0,0 +1,62 @@
+#ifndef i2d_trace_h
+#define i2d_trace_h
+
+#include "i2d_util.h"
+
+/*
+ * maximum number of threads that record events
+ */
+#define I2D_TRACE_THREADS 64
+
+/*
+ * number of events per thread that are kept
+ * from the start (i.e. the load phase) and the
+ * number of the latest events after them (power
+ * of two); the events in between are dropped
+ */
+#define I2D_TRACE_HEAD 4096
+#define I2D_TRACE_SIZE 65536
+
+/*
+ * maximum depth of the spans of a thread
+ */
+#define I2D_TRACE_DEPTH 64
+
+/*
+ * the id of an end event is the index of its
+ * begin event, to drop an end whose begin was
+ * overwritten
+ */
+struct i2d_trace_event {
+    const char * name;
+    long id;
+    uint64_t time;
+    char phase;
+};
+
+typedef struct i2d_trace_event i2d_trace_event;
+
+/*
+ * each thread owns a ring and is the only writer,
+ * so recording an event does not take a lock; the
+ * rings are read after the threads are joined and
+ * the list of events grows up to its maximum
+ */
+struct i2d_trace_ring {
+    size_t tid;
+    uint64_t size;
+    uint64_t stack[I2D_TRACE_DEPTH];
+    size_t depth;
+    i2d_trace_event * list;
+    size_t capacity;
+};
+
+typedef struct i2d_trace_ring i2d_trace_ring;
+
+uint64_t i2d_trace_time(void);
+int i2d_trace_init(const char *, uint64_t);
+void i2d_trace_deit(void);
+void i2d_trace_begin(const char *, long);
+void i2d_trace_end(const char *);
+int i2d_trace_write(i2d_string *);
+#endif
@@ -1,6 +1,68 @@
 #include "i2d_util.h"
 
 static int i2d_string_stack_cmp(const void *, const void *);
+static void * i2d_allocator_malloc(void *, size_t);
+static void * i2d_allocator_calloc(void *, size_t);
+static void * i2d_allocator_realloc(void *, void *, size_t, size_t);
+static void i2d_allocator_free(void *, void *, size_t);
+static int i2d_allocator_is_shared(void);
+static void i2d_allocator_add(size_t, size_t);
+static void i2d_allocator_sub(size_t, size_t);
+static size_t i2d_pool_class(size_t);
+static int i2d_pool_lock(i2d_pool *);
+static void i2d_pool_unlock(i2d_pool *, int);
+static void * i2d_pool_get(i2d_pool *, size_t);
+static void * i2d_pool_malloc(void *, size_t);
+static void * i2d_pool_calloc(void *, size_t);
+static void * i2d_pool_realloc(void *, void *, size_t, size_t);
+static void i2d_pool_free(void *, void *, size_t);
+static int i2d_rope_reserve(i2d_rope *, size_t, char **);
+
+/*
+ * each allocation is prefixed by its size and tag
+ * so that the counters of the tag are updated on
+ * free without asking the allocator for the size
+ */
+struct i2d_allocation {
+    size_t size;
+    size_t tag;
+};
+
+typedef struct i2d_allocation i2d_allocation;
+
+static i2d_allocator i2d_allocator_default = {
+    i2d_allocator_malloc,
+    i2d_allocator_calloc,
+    i2d_allocator_realloc,
+    i2d_allocator_free,
+    NULL
+};
+
+static i2d_allocator * allocator = &i2d_allocator_default;
+
+static i2d_allocator_stat i2d_allocator_stats[I2D_TAG_SIZE];
+
+/*
+ * number of i2d_task_run with worker threads
+ */
+static size_t i2d_allocator_threads;
+
+static const char * i2d_allocator_tags[] = {
+    "util",
+    "lexer",
+    "parser",
+    "range",
+    "logic",
+    "rbt",
+    "db",
+    "json",
+    "script",
+    "print",
+    "watch",
+    "trace",
+    "intern",
+    "depend"
+};
 
 int i2d_panic_print(const char * format, ...) {
     va_list args;
@@ -10,11 +72,372 @@ int i2d_panic_print(const char * format, ...) {
     return I2D_FAIL;
 }
 
-int i2d_string_copy(char ** result, const char * string, size_t length) {
+static void * i2d_allocator_malloc(void * data, size_t size) {
+    return malloc(size);
+}
+
+static void * i2d_allocator_calloc(void * data, size_t size) {
+    return calloc(1, size);
+}
+
+static void * i2d_allocator_realloc(void * data, void * pointer, size_t length, size_t size) {
+    return realloc(pointer, size);
+}
+
+static void i2d_allocator_free(void * data, void * pointer, size_t size) {
+    free(pointer);
+}
+
+static int i2d_allocator_is_shared(void) {
+#ifndef _WIN32
+    return __atomic_load_n(&i2d_allocator_threads, __ATOMIC_RELAXED) > 0;
+#else
+    return i2d_allocator_threads > 0;
+#endif
+}
+
+/*
+ * the counters are only updated atomically while
+ * the tasks run on more than one thread, since the
+ * compile runs on the main thread alone
+ */
+static void i2d_allocator_add(size_t tag, size_t size) {
+    i2d_allocator_stat * stat = &i2d_allocator_stats[tag];
+    size_t live;
+    size_t peak;
+
+    if(!i2d_allocator_is_shared()) {
+        stat->live += size;
+        stat->count++;
+        if(stat->peak < stat->live)
+            stat->peak = stat->live;
+    } else {
+#ifndef _WIN32
+        live = __atomic_add_fetch(&stat->live, size, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&stat->count, 1, __ATOMIC_RELAXED);
+        peak = __atomic_load_n(&stat->peak, __ATOMIC_RELAXED);
+        while(live > peak && !__atomic_compare_exchange_n(&stat->peak, &peak, live, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#else
+        live = (size_t) InterlockedExchangeAdd64((volatile LONG64 *) &stat->live, (LONG64) size) + size;
+        InterlockedIncrement64((volatile LONG64 *) &stat->count);
+        peak = stat->peak;
+        while(live > peak && (size_t) InterlockedCompareExchange64((volatile LONG64 *) &stat->peak, (LONG64) live, (LONG64) peak) != peak)
+            peak = stat->peak;
+#endif
+    }
+}
+
+static void i2d_allocator_sub(size_t tag, size_t size) {
+    if(!i2d_allocator_is_shared()) {
+        i2d_allocator_stats[tag].live -= size;
+    } else {
+#ifndef _WIN32
+        __atomic_sub_fetch(&i2d_allocator_stats[tag].live, size, __ATOMIC_RELAXED);
+#else
+        InterlockedExchangeAdd64((volatile LONG64 *) &i2d_allocator_stats[tag].live, -(LONG64) size);
+#endif
+    }
+}
+
+/*
+ * the allocator must be set before the first
+ * allocation, since the memory is returned to
+ * the allocator that allocated it; null is the
+ * default allocator (i.e. malloc and free)
+ */
+int i2d_allocator_init(i2d_allocator * object) {
+    int status = I2D_OK;
+    size_t i;
+
+    for(i = 0; i < I2D_TAG_SIZE && !status; i++)
+        if(i2d_allocator_stats[i].live)
+            status = i2d_panic("allocator is in use -- %s", i2d_allocator_tags[i]);
+
+    if(!status)
+        allocator = object ? object : &i2d_allocator_default;
+
+    return status;
+}
+
+void i2d_allocator_get(int tag, i2d_allocator_stat * result) {
+    *result = i2d_allocator_stats[tag];
+}
+
+int i2d_allocator_write(const char * path) {
+    int status = I2D_OK;
+    FILE * file;
+    i2d_allocator_stat stat;
+    size_t i;
+
+    file = fopen(path, "w");
+    if(!file) {
+        status = i2d_panic("failed to open file -- %s", path);
+    } else {
+        if(fprintf(file, "%-8s %12s %12s %12s\n", "tag", "live", "peak", "count") < 0)
+            status = i2d_panic("failed to write file -- %s", path);
+
+        for(i = 0; i < I2D_TAG_SIZE && !status; i++) {
+            i2d_allocator_get(i, &stat);
+            if(fprintf(file, "%-8s %12lu %12lu %12lu\n", i2d_allocator_tags[i], (unsigned long) stat.live, (unsigned long) stat.peak, (unsigned long) stat.count) < 0)
+                status = i2d_panic("failed to write file -- %s", path);
+        }
+
+        if(fclose(file))
+            status = i2d_panic("failed to close file -- %s", path);
+    }
+
+    return status;
+}
+
+void * i2d_malloc(int tag, size_t size) {
+    i2d_allocation * allocation = NULL;
+
+    if(size <= SIZE_MAX - sizeof(*allocation))
+        allocation = allocator->malloc(allocator->data, sizeof(*allocation) + size);
+
+    if(allocation) {
+        allocation->size = size;
+        allocation->tag = tag;
+        i2d_allocator_add(tag, size);
+        allocation++;
+    }
+
+    return allocation;
+}
+
+void * i2d_calloc(int tag, size_t count, size_t size) {
+    i2d_allocation * allocation = NULL;
+
+    if(!size || count <= (SIZE_MAX - sizeof(*allocation)) / size)
+        allocation = allocator->calloc(allocator->data, sizeof(*allocation) + count * size);
+
+    if(allocation) {
+        allocation->size = count * size;
+        allocation->tag = tag;
+        i2d_allocator_add(tag, count * size);
+        allocation++;
+    }
+
+    return allocation;
+}
+
+/* the tag of the allocation is kept */
+void * i2d_realloc(int tag, void * pointer, size_t size) {
+    i2d_allocation * allocation = NULL;
+    size_t length;
+
+    if(!pointer) {
+        allocation = i2d_malloc(tag, size);
+    } else if(size <= SIZE_MAX - sizeof(*allocation)) {
+        allocation = (i2d_allocation *) pointer - 1;
+        length = allocation->size;
+
+        allocation = allocator->realloc(allocator->data, allocation, sizeof(*allocation) + length, sizeof(*allocation) + size);
+        if(allocation) {
+            i2d_allocator_sub(allocation->tag, length);
+            i2d_allocator_add(allocation->tag, size);
+            allocation->size = size;
+            allocation++;
+        }
+    }
+
+    return allocation;
+}
+
+void i2d_dealloc(void * pointer) {
+    i2d_allocation * allocation;
+
+    if(pointer) {
+        allocation = (i2d_allocation *) pointer - 1;
+        i2d_allocator_sub(allocation->tag, allocation->size);
+        allocator->free(allocator->data, allocation, sizeof(*allocation) + allocation->size);
+    }
+}
+
+/*
+ * the pool is not allocated from itself, so it
+ * uses malloc like the default allocator
+ */
+int i2d_pool_init(i2d_pool ** result) {
+    int status = I2D_OK;
+    i2d_pool * object;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = calloc(1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            object->allocator.malloc = i2d_pool_malloc;
+            object->allocator.calloc = i2d_pool_calloc;
+            object->allocator.realloc = i2d_pool_realloc;
+            object->allocator.free = i2d_pool_free;
+            object->allocator.data = object;
+#ifndef _WIN32
+            if(pthread_mutex_init(&object->mutex, NULL))
+                status = i2d_panic("failed to create mutex");
+#endif
+            if(status)
+                free(object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+void i2d_pool_deit(i2d_pool ** result) {
+    i2d_pool * object;
+    void * slab;
+
+    object = *result;
+    while(object->slabs) {
+        slab = object->slabs;
+        object->slabs = *(void **) slab;
+        free(slab);
+    }
+#ifndef _WIN32
+    pthread_mutex_destroy(&object->mutex);
+#endif
+    free(object);
+    *result = NULL;
+}
+
+static size_t i2d_pool_class(size_t size) {
+    size_t index = 0;
+
+    while(((size_t) I2D_POOL_MIN << index) < size)
+        index++;
+
+    return index;
+}
+
+/*
+ * the workers of i2d_task_run are the only other
+ * threads, so the lock is only taken while they
+ * are alive
+ */
+static int i2d_pool_lock(i2d_pool * pool) {
+    int is_locked = 0;
+
+#ifndef _WIN32
+    if(i2d_allocator_is_shared()) {
+        pthread_mutex_lock(&pool->mutex);
+        is_locked = 1;
+    }
+#endif
+
+    return is_locked;
+}
+
+static void i2d_pool_unlock(i2d_pool * pool, int is_locked) {
+#ifndef _WIN32
+    if(is_locked)
+        pthread_mutex_unlock(&pool->mutex);
+#endif
+}
+
+/*
+ * the first block of a slab links it to the
+ * previous slab, which keeps the blocks aligned
+ * to I2D_POOL_MIN
+ */
+static void * i2d_pool_get(i2d_pool * pool, size_t index) {
+    void * block;
+    char * slab;
+    size_t size;
+
+    size = (size_t) I2D_POOL_MIN << index;
+    block = pool->list[index];
+    if(block) {
+        pool->list[index] = *(void **) block;
+    } else {
+        if(!pool->slab || pool->offset + size > I2D_POOL_SLAB) {
+            slab = malloc(I2D_POOL_SLAB);
+            if(slab) {
+                *(void **) slab = pool->slabs;
+                pool->slabs = slab;
+                pool->slab = slab;
+                pool->offset = I2D_POOL_MIN;
+            }
+        }
+
+        if(pool->slab && pool->offset + size <= I2D_POOL_SLAB) {
+            block = pool->slab + pool->offset;
+            pool->offset += size;
+        }
+    }
+
+    return block;
+}
+
+static void * i2d_pool_malloc(void * data, size_t size) {
+    i2d_pool * pool = data;
+    void * block;
+    int is_locked;
+
+    if(size > I2D_POOL_MAX) {
+        block = malloc(size);
+    } else {
+        is_locked = i2d_pool_lock(pool);
+        block = i2d_pool_get(pool, i2d_pool_class(size));
+        i2d_pool_unlock(pool, is_locked);
+    }
+
+    return block;
+}
+
+static void * i2d_pool_calloc(void * data, size_t size) {
+    void * block;
+
+    block = i2d_pool_malloc(data, size);
+    if(block)
+        memset(block, 0, size);
+
+    return block;
+}
+
+static void * i2d_pool_realloc(void * data, void * pointer, size_t length, size_t size) {
+    void * block;
+
+    if(length > I2D_POOL_MAX && size > I2D_POOL_MAX) {
+        block = realloc(pointer, size);
+    } else if(length <= I2D_POOL_MAX && size <= I2D_POOL_MAX && i2d_pool_class(length) == i2d_pool_class(size)) {
+        block = pointer;
+    } else {
+        block = i2d_pool_malloc(data, size);
+        if(block) {
+            memcpy(block, pointer, min(length, size));
+            i2d_pool_free(data, pointer, length);
+        }
+    }
+
+    return block;
+}
+
+static void i2d_pool_free(void * data, void * pointer, size_t size) {
+    i2d_pool * pool = data;
+    size_t index;
+    int is_locked;
+
+    if(size > I2D_POOL_MAX) {
+        free(pointer);
+    } else {
+        index = i2d_pool_class(size);
+        is_locked = i2d_pool_lock(pool);
+        *(void **) pointer = pool->list[index];
+        pool->list[index] = pointer;
+        i2d_pool_unlock(pool, is_locked);
+    }
+}
+
+int i2d_string_copy(int tag, char ** result, const char * string, size_t length) {
     int status = I2D_OK;
     char * buffer;
 
-    buffer = calloc(length + 1, sizeof(*string));
+    buffer = i2d_calloc(tag, length + 1, sizeof(*string));
     if(!buffer) {
         status = i2d_panic("out of memory");
     } else {
@@ -26,10 +449,10 @@ int i2d_string_copy(char ** result, const char * string, size_t length) {
     return status;
 }
 
-int i2d_string_create(i2d_string * result, const char * string, size_t length) {
+int i2d_string_create(int tag, i2d_string * result, const char * string, size_t length) {
     int status = I2D_OK;
 
-    if(i2d_string_copy(&result->string, string, length)) {
+    if(i2d_string_copy(tag, &result->string, string, length)) {
         status = i2d_panic("failed to copy string object");
     } else {
         result->length = length;
@@ -39,24 +462,24 @@ int i2d_string_create(i2d_string * result, const char * string, size_t length) {
 }
 
 void i2d_string_destroy(i2d_string * result) {
-    free(result->string);
+    i2d_dealloc(result->string);
 }
 
-int i2d_string_vprintf(i2d_string * result, const char * format, ...) {
+int i2d_string_vprintf(int tag, i2d_string * result, const char * format, ...) {
     int status = I2D_OK;
     va_list vl;
     i2d_buffer buffer;
     i2d_string output;
 
     va_start(vl, format);
-    if(i2d_buffer_create(&buffer, BUFFER_SIZE_SMALL)) {
+    if(i2d_buffer_create(tag, &buffer, BUFFER_SIZE_SMALL)) {
         status = i2d_panic("failed to create buffer object");
     } else {
         if(i2d_buffer_vprintf(&buffer, format, vl)) {
             status = i2d_panic("failed to write buffer object");
         } else {
             i2d_buffer_get(&buffer, &output.string, &output.length);
-            status = i2d_string_create(result, output.string, output.length);
+            status = i2d_string_create(tag, result, output.string, output.length);
         }
         i2d_buffer_destroy(&buffer);
     }
@@ -65,18 +488,28 @@ int i2d_string_vprintf(i2d_string * result, const char * format, ...) {
     return status;
 }
 
-int i2d_buffer_init(i2d_buffer ** result, size_t size) {
+/*
+ * path extension, i.e. db/re/item_db.yml, where
+ * a match in the middle (item_db.yml.bak) is not
+ */
+int i2d_string_suffix(i2d_string * string, const char * suffix) {
+    size_t length = strlen(suffix);
+
+    return string->length >= length && !memcmp(string->string + string->length - length, suffix, length);
+}
+
+int i2d_buffer_init(int tag, i2d_buffer ** result, size_t size) {
     int status = I2D_OK;
     i2d_buffer * object;
 
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(tag, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_buffer_create(object, size)) {
+            if(i2d_buffer_create(tag, object, size)) {
                 status = i2d_panic("failed to create buffer object");
             } else {
                 object->next = object;
@@ -131,14 +564,19 @@ void i2d_buffer_remove(i2d_buffer * x) {
     x->prev = x;
 }
 
-int i2d_buffer_create(i2d_buffer * result, size_t length) {
+/*
+ * the tag is kept to charge the buffer to the
+ * same subsystem when it grows
+ */
+int i2d_buffer_create(int tag, i2d_buffer * result, size_t length) {
     int status = I2D_OK;
 
     if(!length) {
         status = i2d_panic("invalid buffer length");
     } else {
+        result->tag = tag;
         result->length = length;
-        result->buffer = calloc(result->length, sizeof(*result->buffer));
+        result->buffer = i2d_calloc(tag, result->length, sizeof(*result->buffer));
         if(!result->buffer) {
             status = i2d_panic("out of memory");
         } else {
@@ -150,9 +588,14 @@ int i2d_buffer_create(i2d_buffer * result, size_t length) {
 }
 
 void i2d_buffer_destroy(i2d_buffer * result) {
-    free(result->buffer);
+    i2d_dealloc(result->buffer);
 }
 
+/*
+ * grow to at least twice the length so that a
+ * buffer that is written in small pieces is not
+ * reallocated on every write
+ */
 int i2d_buffer_adapt(i2d_buffer * result, size_t length) {
     int status = I2D_OK;
     size_t avail;
@@ -160,8 +603,8 @@ int i2d_buffer_adapt(i2d_buffer * result, size_t length) {
 
     avail = result->length - result->offset;
     if(avail < length) {
-        length = result->length + (length - avail);
-        buffer = realloc(result->buffer, length);
+        length = max(result->length * 2, result->offset + length);
+        buffer = i2d_realloc(result->tag, result->buffer, length);
         if(!buffer) {
             status = i2d_panic("out of memory");
         } else {
@@ -175,7 +618,7 @@ int i2d_buffer_adapt(i2d_buffer * result, size_t length) {
 
 void i2d_buffer_clear(i2d_buffer * result) {
     if(result->offset) {
-        memset(result->buffer, 0, result->offset);
+        result->buffer[0] = 0;
         result->offset = 0;
     }
 }
@@ -183,8 +626,7 @@ void i2d_buffer_clear(i2d_buffer * result) {
 int i2d_buffer_putc(i2d_buffer * result, char character) {
     int status = I2D_OK;
 
-    if( result->length == result->offset + 1 &&
-        i2d_buffer_adapt(result, result->length + 1) ) {
+    if(i2d_buffer_adapt(result, 2)) {
         status = I2D_FAIL;
     } else {
         result->buffer[result->offset] = character;
@@ -205,26 +647,30 @@ int i2d_buffer_printf(i2d_buffer * result, const char * format, ...) {
     return status;
 }
 
+/*
+ * print into the space that is left and only
+ * print again if the space was not enough
+ */
 int i2d_buffer_vprintf(i2d_buffer * result, const char * format, va_list vl) {
     int status = I2D_OK;
     va_list vl_copy;
 
     int length;
-    char * string;
+    size_t avail;
 
     va_copy(vl_copy, vl);
-    length = vsnprintf(NULL, 0, format, vl);
+    avail = result->length - result->offset;
+    length = vsnprintf(result->buffer + result->offset, avail, format, vl);
     if(0 > length) {
         status = i2d_panic("invalid print format specification");
+    } else if((size_t) length < avail) {
+        result->offset += length;
     } else if(i2d_buffer_adapt(result, length + 1)) {
         status = I2D_FAIL;
+    } else if(length != vsnprintf(result->buffer + result->offset, length + 1, format, vl_copy)) {
+        status = i2d_panic("failed to print format");
     } else {
-        string = result->buffer + result->offset;
-        if(length != vsnprintf(string, length + 1, format, vl_copy)) {
-            status = i2d_panic("failed to print format");
-        } else {
-            result->offset += length;
-        }
+        result->offset += length;
     }
 
     va_end(vl_copy);
@@ -245,23 +691,62 @@ int i2d_buffer_memcpy(i2d_buffer * result, const char * string, size_t length) {
     return status;
 }
 
+int i2d_buffer_puts(i2d_buffer * result, const char * string) {
+    return i2d_buffer_memcpy(result, string, strlen(string));
+}
+
+int i2d_buffer_putl(i2d_buffer * result, long number, int flag) {
+    char string[32];
+    char * start;
+    char * end;
+    unsigned long value;
+
+    /*
+     * write the digits backward from the end and
+     * leave space for the percent sign
+     */
+    end = string + sizeof(string) - 1;
+    start = end;
+    value = is_negative(number) ? 0UL - (unsigned long) number : (unsigned long) number;
+    do {
+        *--start = (char) ('0' + value % 10);
+        value /= 10;
+    } while(value);
+
+    if(is_negative(number))
+        *--start = '-';
+    else if(flag & I2D_BUFFER_SIGN)
+        *--start = '+';
+
+    if(flag & I2D_BUFFER_PERCENT)
+        *end++ = '%';
+
+    return i2d_buffer_memcpy(result, start, (size_t) (end - start));
+}
+
+int i2d_buffer_putr(i2d_buffer * result, long min, long max, int flag) {
+    return  i2d_buffer_putl(result, min, flag) ||
+            (min != max && (i2d_buffer_memcpy(result, " ~ ", 3) || i2d_buffer_putl(result, max, flag)));
+}
+
 void i2d_buffer_get(i2d_buffer * result, char ** string, size_t * length) {
     *string = result->buffer;
     *length = result->offset;
 }
 
-int i2d_buffer_cache_init(i2d_buffer_cache ** result) {
+int i2d_buffer_cache_init(int tag, i2d_buffer_cache ** result) {
     int status = I2D_OK;
     i2d_buffer_cache * object;
 
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(tag, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_buffer_init(&object->list, BUFFER_SIZE_SMALL))
+            object->tag = tag;
+            if(i2d_buffer_init(tag, &object->list, BUFFER_SIZE_SMALL))
                 status = i2d_panic("failed to create buffer object");
 
             if(status)
@@ -307,7 +792,7 @@ int i2d_buffer_cache_get(i2d_buffer_cache * cache, i2d_buffer ** result) {
         i2d_buffer_clear(buffer);
         *result = buffer;
     } else {
-        status = i2d_buffer_init(result, BUFFER_SIZE_SMALL);
+        status = i2d_buffer_init(cache->tag, result, BUFFER_SIZE_SMALL);
     }
 
     return status;
@@ -325,18 +810,18 @@ int i2d_buffer_cache_put(i2d_buffer_cache * cache, i2d_buffer ** result) {
     return status;
 }
 
-int i2d_string_stack_init(i2d_string_stack ** result, size_t size) {
+int i2d_string_stack_init(int tag, i2d_string_stack ** result, size_t size) {
     int status = I2D_OK;
     i2d_string_stack * object;
 
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(tag, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_string_stack_create(object, size)) {
+            if(i2d_string_stack_create(tag, object, size)) {
                 status = i2d_panic("failed to create string stack object");
             } else {
                 object->next = object;
@@ -391,7 +876,7 @@ void i2d_string_stack_remove(i2d_string_stack * x) {
     x->prev = x;
 }
 
-int i2d_string_stack_create(i2d_string_stack * result, size_t size) {
+int i2d_string_stack_create(int tag, i2d_string_stack * result, size_t size) {
     int status = I2D_OK;
 
     if(!size) {
@@ -399,14 +884,14 @@ int i2d_string_stack_create(i2d_string_stack * result, size_t size) {
     } else {
         result->size = size;
         result->top = 0;
-        if(i2d_buffer_create(&result->buffer, BUFFER_SIZE_LARGE)) {
+        if(i2d_buffer_create(tag, &result->buffer, BUFFER_SIZE_LARGE)) {
             status = I2D_FAIL;
         } else {
-            result->list = calloc(result->size, sizeof(*result->list));
+            result->list = i2d_calloc(tag, result->size, sizeof(*result->list));
             if(!result->list) {
                 status = i2d_panic("out of memory");
             } else {
-                result->offset = calloc(result->size, sizeof(*result->offset));
+                result->offset = i2d_calloc(tag, result->size, sizeof(*result->offset));
                 if(!result->offset)
                     status = i2d_panic("out of memory");
                 if(status)
@@ -530,8 +1015,8 @@ int i2d_string_stack_dump_buffer(i2d_string_stack * stack, i2d_buffer * buffer,
     } else {
         for(i = 0, last = 0; i < size && !status; i++) {
             if(list[i].length) {
-                if( (i && list[last].length && i2d_buffer_printf(buffer, delimit)) ||
-                    i2d_buffer_printf(buffer, "%s", list[i].string) ) {
+                if( (i && list[last].length && i2d_buffer_puts(buffer, delimit)) ||
+                    i2d_buffer_memcpy(buffer, list[i].string, list[i].length) ) {
                     status = i2d_panic("failed to write buffer object");
                 } else {
                     last = i;
@@ -559,7 +1044,7 @@ int i2d_string_stack_format(i2d_string_stack * stack, i2d_string * format, i2d_b
 
     if(i2d_string_stack_get(stack, &list, &size)) {
         status = i2d_panic("failed to get string stack");
-    } else if(i2d_buffer_create(&buffer, BUFFER_SIZE_SMALL)) {
+    } else if(i2d_buffer_create(result->tag, &buffer, BUFFER_SIZE_SMALL)) {
         status = i2d_panic("failed to create buffere object");
     } else {
         for(i = 0; i < format->length && !status; i++) {
@@ -583,7 +1068,7 @@ int i2d_string_stack_format(i2d_string_stack * stack, i2d_string * format, i2d_b
                             status = i2d_panic("invalid number string -- %s", string.string);
                         } else if(position < 0 || (size_t) position >= size) {
                             status = i2d_panic("invalid position on string stack");
-                        } else if(i2d_buffer_printf(result, "%s", list[position].string)) {
+                        } else if(i2d_buffer_memcpy(result, list[position].string, list[position].length)) {
                             status = i2d_panic("failed to write buffer");
                         }
                         i2d_buffer_clear(&buffer);
@@ -605,18 +1090,19 @@ int i2d_string_stack_format(i2d_string_stack * stack, i2d_string * format, i2d_b
     return status;
 }
 
-int i2d_string_stack_cache_init(i2d_string_stack_cache ** result) {
+int i2d_string_stack_cache_init(int tag, i2d_string_stack_cache ** result) {
     int status = I2D_OK;
     i2d_string_stack_cache * object;
 
     if(i2d_is_invalid(result)) {
         status = i2d_panic("invalid paramater");
     } else {
-        object = calloc(1, sizeof(*object));
+        object = i2d_calloc(tag, 1, sizeof(*object));
         if(!object) {
             status = i2d_panic("out of memory");
         } else {
-            if(i2d_string_stack_init(&object->list, MAX_STACK))
+            object->tag = tag;
+            if(i2d_string_stack_init(tag, &object->list, MAX_STACK))
                 status = i2d_panic("failed to create stack object");
 
             if(status)
@@ -648,7 +1134,7 @@ int i2d_string_stack_cache_get(i2d_string_stack_cache * cache, i2d_string_stack
         i2d_string_stack_clear(stack);
         *result = stack;
     } else {
-        status = i2d_string_stack_init(result, MAX_STACK);
+        status = i2d_string_stack_init(cache->tag, result, MAX_STACK);
     }
 
     return status;
@@ -666,14 +1152,465 @@ int i2d_string_stack_cache_put(i2d_string_stack_cache * cache, i2d_string_stack
     return status;
 }
 
+int i2d_rope_create(i2d_rope * result) {
+    int status = I2D_OK;
+
+    i2d_zero(*result);
+
+    return status;
+}
+
+void i2d_rope_destroy(i2d_rope * result) {
+    if(result->blocks)
+        i2d_buffer_list_deit(&result->blocks);
+    i2d_free(result->list);
+}
+
+void i2d_rope_clear(i2d_rope * result) {
+    i2d_buffer * block;
+
+    result->size = 0;
+    result->length = 0;
+
+    if(result->blocks) {
+        block = result->blocks;
+        do {
+            block->offset = 0;
+            block = block->next;
+        } while(block != result->blocks);
+        result->block = result->blocks;
+    }
+}
+
+int i2d_rope_add(i2d_rope * rope, const char * string, size_t length) {
+    int status = I2D_OK;
+    i2d_rope_segment * list;
+    size_t capacity;
+
+    if(length) {
+        if(rope->size == rope->capacity) {
+            capacity = rope->capacity ? rope->capacity * 2 : 64;
+            list = i2d_realloc(I2D_TAG_UTIL, rope->list, capacity * sizeof(*rope->list));
+            if(!list) {
+                status = i2d_panic("out of memory");
+            } else {
+                rope->list = list;
+                rope->capacity = capacity;
+            }
+        }
+
+        if(!status) {
+            rope->list[rope->size].string = string;
+            rope->list[rope->size].length = length;
+            rope->size++;
+            rope->length += length;
+        }
+    }
+
+    return status;
+}
+
+/*
+ * a block is never reallocated, so the strings
+ * in it can be referred to until the rope is
+ * cleared
+ */
+static int i2d_rope_reserve(i2d_rope * rope, size_t length, char ** result) {
+    int status = I2D_OK;
+    i2d_buffer * block = NULL;
+
+    if(!rope->block || rope->block->length - rope->block->offset < length) {
+        if(rope->block && rope->block->next != rope->blocks && rope->block->next->length >= length) {
+            rope->block = rope->block->next;
+        } else if(i2d_buffer_init(I2D_TAG_UTIL, &block, max(BUFFER_SIZE_LARGE, length))) {
+            status = i2d_panic("failed to create buffer object");
+        } else {
+            if(rope->block)
+                i2d_buffer_append(rope->block, block);
+            else
+                rope->blocks = block;
+            rope->block = block;
+        }
+    }
+
+    if(!status) {
+        block = rope->block;
+        *result = block->buffer + block->offset;
+        block->offset += length;
+    }
+
+    return status;
+}
+
+/* copy a string that does not outlive the rope */
+int i2d_rope_store(i2d_rope * rope, const char * string, size_t length, i2d_string * result) {
+    int status = I2D_OK;
+
+    if(i2d_rope_reserve(rope, length, &result->string)) {
+        status = i2d_panic("failed to reserve rope block");
+    } else {
+        result->length = length;
+        memcpy(result->string, string, length);
+    }
+
+    return status;
+}
+
+/*
+ * replace the segments from start to the end of
+ * the rope with a copy of them in one string
+ */
+int i2d_rope_join(i2d_rope * rope, size_t start, i2d_string * result) {
+    int status = I2D_OK;
+    size_t length = 0;
+    size_t i;
+
+    for(i = start; i < rope->size; i++)
+        length += rope->list[i].length;
+
+    if(i2d_rope_reserve(rope, length, &result->string)) {
+        status = i2d_panic("failed to reserve rope block");
+    } else {
+        result->length = 0;
+        for(i = start; i < rope->size; i++) {
+            memcpy(result->string + result->length, rope->list[i].string, rope->list[i].length);
+            result->length += rope->list[i].length;
+        }
+        rope->size = start;
+        rope->length -= length;
+    }
+
+    return status;
+}
+
+/*
+ * same as i2d_string_stack_dump_buffer except
+ * that the strings are added as segments
+ */
+int i2d_rope_dump(i2d_rope * rope, i2d_string * list, size_t size, const char * delimit) {
+    int status = I2D_OK;
+    size_t i;
+    size_t last;
+
+    for(i = 0, last = 0; i < size && !status; i++) {
+        if(list[i].length) {
+            if( (i && list[last].length && i2d_rope_add(rope, delimit, strlen(delimit))) ||
+                i2d_rope_add(rope, list[i].string, list[i].length) ) {
+                status = i2d_panic("failed to add rope segment");
+            } else {
+                last = i;
+            }
+        }
+    }
+
+    return status;
+}
+
+/*
+ * same as i2d_string_stack_format except that
+ * the text of the format and the strings of the
+ * list are added as segments instead of copied
+ */
+int i2d_rope_format(i2d_rope * rope, i2d_string * format, i2d_string * list, size_t size) {
+    int status = I2D_OK;
+    size_t i;
+    size_t start = 0;
+    long position;
+    int level = 0;
+
+    for(i = 0; i < format->length && !status; i++) {
+        switch(format->string[i]) {
+            case '{':
+                if(level) {
+                    status = i2d_panic("invalid starting curly");
+                } else if(i2d_rope_add(rope, format->string + start, i - start)) {
+                    status = i2d_panic("failed to add rope segment");
+                } else {
+                    level++;
+                    start = i + 1;
+                }
+                break;
+            case '}':
+                if(!level) {
+                    status = i2d_panic("invalid ending curly");
+                } else {
+                    level--;
+
+                    if(i2d_strtol(&position, format->string + start, i - start, 10)) {
+                        status = i2d_panic("invalid number string -- %s", format->string);
+                    } else if(position < 0 || (size_t) position >= size) {
+                        status = i2d_panic("invalid position on string list");
+                    } else if(i2d_rope_add(rope, list[position].string, list[position].length)) {
+                        status = i2d_panic("failed to add rope segment");
+                    } else {
+                        start = i + 1;
+                    }
+                }
+                break;
+        }
+    }
+
+    if(!status && !level && i2d_rope_add(rope, format->string + start, format->length - start))
+        status = i2d_panic("failed to add rope segment");
+
+    return status;
+}
+
+#ifndef _WIN32
+/*
+ * flatten the rope with one system call per
+ * IOV_MAX segments; the file is flushed first
+ * to keep the order of earlier buffered output
+ * and a short or interrupted write is resumed
+ * from the first byte that was not written
+ */
+int i2d_rope_write(i2d_rope * rope, FILE * file) {
+    int status = I2D_OK;
+    struct iovec vector[I2D_ROPE_IOV];
+    size_t i = 0;
+    size_t j;
+    size_t size;
+    size_t offset = 0;
+    ssize_t result;
+
+    if(fflush(file)) {
+        status = i2d_panic("failed to flush file");
+    } else {
+        while(i < rope->size && !status) {
+            for(j = i, size = 0; j < rope->size && size < I2D_ROPE_IOV; j++, size++) {
+                vector[size].iov_base = (void *) (rope->list[j].string + (j == i ? offset : 0));
+                vector[size].iov_len = rope->list[j].length - (j == i ? offset : 0);
+            }
+
+            result = writev(fileno(file), vector, (int) size);
+            if(0 > result) {
+                if(errno != EINTR)
+                    status = i2d_panic("failed on writev");
+            } else if(!result) {
+                status = i2d_panic("failed on writev");
+            } else {
+                /* skip the segments that were written */
+                offset += (size_t) result;
+                while(i < rope->size && offset >= rope->list[i].length) {
+                    offset -= rope->list[i].length;
+                    i++;
+                }
+            }
+        }
+        i2d_rope_clear(rope);
+    }
+
+    return status;
+}
+#else
+int i2d_rope_write(i2d_rope * rope, FILE * file) {
+    int status = I2D_OK;
+    size_t i;
+
+    for(i = 0; i < rope->size && !status; i++)
+        if(rope->list[i].length != fwrite(rope->list[i].string, 1, rope->list[i].length, file))
+            status = i2d_panic("failed to write file");
+    i2d_rope_clear(rope);
+
+    return status;
+}
+#endif
+
+void i2d_table_destroy(i2d_table * result) {
+    size_t i;
+
+    for(i = 0; i < result->size; i++)
+        i2d_free(result->list[i]);
+    i2d_free(result->list);
+}
+
+int i2d_table_insert(i2d_table * table, long id, void * data) {
+    int status = I2D_OK;
+    void *** list;
+    size_t page;
+    size_t size;
+
+    if(!i2d_table_range(id)) {
+        status = i2d_panic("invalid table id -- %ld", id);
+    } else {
+        page = (size_t) id >> I2D_TABLE_PAGE_BITS;
+        if(page >= table->size) {
+            size = max(table->size * 2, page + 1);
+            list = i2d_realloc(I2D_TAG_UTIL, table->list, size * sizeof(*table->list));
+            if(!list) {
+                status = i2d_panic("out of memory");
+            } else {
+                memset(list + table->size, 0, (size - table->size) * sizeof(*list));
+                table->list = list;
+                table->size = size;
+            }
+        }
+
+        if(!status && !table->list[page]) {
+            table->list[page] = i2d_calloc(I2D_TAG_UTIL, I2D_TABLE_PAGE_SIZE, sizeof(**table->list));
+            if(!table->list[page])
+                status = i2d_panic("out of memory");
+        }
+
+        /* keep the first of the entries with the same
+         * id like the static red black tree does */
+        if(!status && !table->list[page][id & (I2D_TABLE_PAGE_SIZE - 1)])
+            table->list[page][id & (I2D_TABLE_PAGE_SIZE - 1)] = data;
+    }
+
+    return status;
+}
+
+int i2d_table_search(i2d_table * table, long id, void ** result) {
+    int status = I2D_FAIL;
+    void ** page;
+
+    if(i2d_table_range(id) && ((size_t) id >> I2D_TABLE_PAGE_BITS) < table->size) {
+        page = table->list[id >> I2D_TABLE_PAGE_BITS];
+        if(page && page[id & (I2D_TABLE_PAGE_SIZE - 1)]) {
+            *result = page[id & (I2D_TABLE_PAGE_SIZE - 1)];
+            status = I2D_OK;
+        }
+    }
+
+    return status;
+}
+
+enum i2d_split_class {
+    i2d_split_plain,
+    i2d_split_comma,
+    i2d_split_quote,
+    i2d_split_open,
+    i2d_split_close,
+    i2d_split_slash,
+    i2d_split_space,
+    i2d_split_tab,
+    i2d_split_blank
+};
+
+static const unsigned char i2d_split_classes[256] = {
+    [','] = i2d_split_comma,
+    ['"'] = i2d_split_quote,
+    ['{'] = i2d_split_open,
+    ['}'] = i2d_split_close,
+    ['/'] = i2d_split_slash,
+    [' '] = i2d_split_space,
+    ['\t'] = i2d_split_tab,
+    ['\n'] = i2d_split_blank,
+    ['\v'] = i2d_split_blank,
+    ['\f'] = i2d_split_blank,
+    ['\r'] = i2d_split_blank
+};
+
+void i2d_split_create(i2d_split * split, char * string, size_t length, int flags) {
+    i2d_zero(*split);
+    split->string = string;
+    split->length = length;
+    split->flags = flags;
+}
+
+/*
+ * the field is nul terminated in place; a line
+ * comment cannot start before the field since a
+ * field starts after a comma
+ */
+int i2d_split_next(i2d_split * split, char ** result, size_t * extent) {
+    int status = I2D_FAIL;
+    char * string = split->string;
+    size_t i;
+    int type;
+
+    for(i = split->offset; i < split->length && status && !split->last; i++) {
+        type = i2d_split_classes[(unsigned char) string[i]];
+        if(i2d_split_plain == type) {
+            /* not a delimiter */
+        } else if(i2d_split_quote == type && (split->flags & I2D_SPLIT_QUOTE)) {
+            split->quote = !split->quote;
+        } else if(i2d_split_open == type && (split->flags & I2D_SPLIT_BRACE)) {
+            split->brace++;
+        } else if(i2d_split_close == type && (split->flags & I2D_SPLIT_BRACE)) {
+            split->brace--;
+        } else {
+            if(i2d_split_blank == type) {
+                split->last = 1;
+            } else if(i2d_split_space == type && (split->flags & I2D_SPLIT_SPACE)) {
+                split->last = 1;
+            } else if(i2d_split_tab == type && !(split->flags & I2D_SPLIT_TAB)) {
+                split->last = 1;
+            } else if(i2d_split_slash == type && i > 0 && '/' == string[i - 1]) {
+                i -= 1;
+                split->last = 1;
+            }
+
+            if((i2d_split_comma == type || split->last) && !split->quote && !split->brace) {
+                string[i] = 0;
+                *result = string + split->offset;
+                *extent = i - split->offset;
+                split->offset = i + 1;
+                status = I2D_OK;
+            }
+        }
+    }
+
+    return status;
+}
+
+/*
+ * value of a digit plus one, i.e. zero is not a
+ * digit of any base
+ */
+static const unsigned char i2d_digit_values[256] = {
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+    ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16
+};
+
+/*
+ * digits without a sign, prefix, or whitespace;
+ * size is the number of digits that cannot
+ * overflow the result type, otherwise the libc
+ * conversion is used
+ */
+static int i2d_strtoull_fast(unsigned long long * result, const char * string, size_t length, int base, size_t size) {
+    int status = I2D_OK;
+    unsigned long long number = 0;
+    unsigned int digit;
+    size_t i;
+
+    if(!length || length > size || (10 != base && 16 != base)) {
+        status = I2D_FAIL;
+    } else {
+        for(i = 0; i < length && !status; i++) {
+            digit = i2d_digit_values[(unsigned char) string[i]];
+            if(!digit || digit > (unsigned int) base) {
+                status = I2D_FAIL;
+            } else {
+                number = number * (unsigned int) base + digit - 1;
+            }
+        }
+
+        if(!status)
+            *result = number;
+    }
+
+    return status;
+}
+
 int i2d_strtol(long * result, const char * string, size_t length, int base) {
     int status = I2D_OK;
 
     long number;
     char * end = NULL;
+    unsigned long long digits;
+    size_t sign;
+
+    sign = length && ('-' == *string || '+' == *string);
 
     if(!length) {
         *result = 0;
+    } else if(!i2d_strtoull_fast(&digits, string + sign, length - sign, base, 16 == base ? 7 : 9)) {
+        *result = '-' == *string ? -(long) digits : (long) digits;
     } else {
         number = strtol(string, &end, base);
         if(string + length != end) {
@@ -691,9 +1628,15 @@ int i2d_strtoll(long long * result, const char * string, size_t length, int base
 
     long long number;
     char * end = NULL;
+    unsigned long long digits;
+    size_t sign;
+
+    sign = length && ('-' == *string || '+' == *string);
 
     if(!length) {
         *result = 0;
+    } else if(!i2d_strtoull_fast(&digits, string + sign, length - sign, base, 16 == base ? 15 : 18)) {
+        *result = '-' == *string ? -(long long) digits : (long long) digits;
     } else {
         number = strtoll(string, &end, base);
         if(string + length != end) {
@@ -711,9 +1654,12 @@ int i2d_strtoul(unsigned long * result, const char * string, size_t length, int
 
     unsigned long number;
     char * end = NULL;
+    unsigned long long digits;
 
     if(!length) {
         *result = 0;
+    } else if(!i2d_strtoull_fast(&digits, string, length, base, 16 == base ? 8 : 9)) {
+        *result = (unsigned long) digits;
     } else {
         number = strtoul(string, &end, base);
         if(string + length != end) {
@@ -758,7 +1704,7 @@ int i2d_fd_load(i2d_string * path, i2d_by_line_cb cb, void * data) {
     if(0 > fd) {
         status = i2d_panic("failed to open file -- %s", path->string);
     } else {
-        if(i2d_buffer_create(&buffer, BUFFER_SIZE_LARGE * 2)) {
+        if(i2d_buffer_create(I2D_TAG_UTIL, &buffer, BUFFER_SIZE_LARGE * 2)) {
             status = i2d_panic("failed to create buffer object");
         } else {
             result = i2d_fd_read(fd, BUFFER_SIZE_LARGE, &buffer);
@@ -788,7 +1734,7 @@ int i2d_fd_load(i2d_string * path, i2d_by_line_cb cb, void * data) {
     if(INVALID_HANDLE_VALUE == hFile) {
         status = i2d_panic("failed to open file -- %s", path->string);
     } else {
-        if(i2d_buffer_create(&buffer, BUFFER_SIZE_LARGE * 2)) {
+        if(i2d_buffer_create(I2D_TAG_UTIL, &buffer, BUFFER_SIZE_LARGE * 2)) {
             status = i2d_panic("failed to create buffer object");
         } else {
             result = i2d_fd_read(hFile, BUFFER_SIZE_LARGE, &buffer);
@@ -857,6 +1803,51 @@ int i2d_fd_read(HANDLE hFile, size_t size, i2d_buffer * buffer) {
 }
 #endif
 
+/*
+ * the buffer is sized once from the size of a
+ * regular file, with a spare byte so that the
+ * first read is short at the end of the file
+ */
+int i2d_fd_read_file(i2d_string * path, i2d_buffer * buffer) {
+    int status = I2D_OK;
+    FILE * file;
+    long length;
+    size_t size = 0;
+    size_t result = 0;
+
+    file = fopen(path->string, "rb");
+    if(!file) {
+        status = i2d_panic("failed to open file -- %s", path->string);
+    } else {
+        if(!fseek(file, 0, SEEK_END)) {
+            length = ftell(file);
+            if(fseek(file, 0, SEEK_SET)) {
+                status = i2d_panic("failed to seek file -- %s", path->string);
+            } else if(0 < length && i2d_buffer_adapt(buffer, (size_t) length + 2)) {
+                status = i2d_panic("failed to adapt buffer object");
+            }
+        }
+
+        while(!status && result == size) {
+            if(buffer->length - buffer->offset <= BUFFER_SIZE_LARGE && i2d_buffer_adapt(buffer, BUFFER_SIZE_LARGE + 1)) {
+                status = i2d_panic("failed to adapt buffer object");
+            } else {
+                size = buffer->length - buffer->offset - 1;
+                result = fread(buffer->buffer + buffer->offset, 1, size, file);
+                buffer->offset += result;
+                buffer->buffer[buffer->offset] = 0;
+            }
+        }
+
+        if(!status && ferror(file))
+            status = i2d_panic("failed to read file -- %s", path->string);
+
+        fclose(file);
+    }
+
+    return status;
+}
+
 int i2d_by_line(i2d_buffer * buffer, i2d_by_line_cb cb, void * data) {
     int status = I2D_OK;
     char * anchor;
@@ -910,19 +1901,41 @@ int i2d_by_line(i2d_buffer * buffer, i2d_by_line_cb cb, void * data) {
 
 int i2d_by_bit64(uint64_t flag, i2d_by_bit_cb cb, void * context) {
     int status = I2D_OK;
-    uint64_t bit = 1;
+    uint64_t bit;
 
-    while(bit && !status) {
-        if(flag & bit) {
-            status = cb(bit, context);
-            flag &= ~bit;
-        }
-        bit <<= 1;
+    /* isolate the lowest set bit instead of testing all 64 */
+    while(flag && !status) {
+        bit = flag & (~flag + 1);
+        status = cb(bit, context);
+        flag &= flag - 1;
     }
 
     return status;
 }
 
+uint64_t i2d_fnv1a(uint64_t hash, const char * string, size_t length) {
+    size_t i;
+
+    for(i = 0; i < length; i++) {
+        hash ^= (unsigned char) string[i];
+        hash *= I2D_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/* monotonic time in milliseconds */
+uint64_t i2d_time(void) {
+#ifndef _WIN32
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000 + (uint64_t) time.tv_nsec / 1000000;
+#else
+    return (uint64_t) GetTickCount64();
+#endif
+}
+
 int i2d_is_number(i2d_string * string) {
     int status = I2D_OK;
     size_t i = 0;
@@ -936,3 +1949,95 @@ int i2d_is_number(i2d_string * string) {
 
     return status;
 }
+
+#ifndef _WIN32
+struct i2d_task_queue {
+    pthread_mutex_t mutex;
+    i2d_task * list;
+    size_t size;
+    size_t next;
+};
+
+typedef struct i2d_task_queue i2d_task_queue;
+
+static void * i2d_task_worker(void * data) {
+    i2d_task_queue * queue = data;
+    i2d_task * task;
+
+    do {
+        task = NULL;
+
+        pthread_mutex_lock(&queue->mutex);
+        if(queue->next < queue->size)
+            task = &queue->list[queue->next++];
+        pthread_mutex_unlock(&queue->mutex);
+
+        if(task)
+            task->status = task->cb(task->data);
+    } while(task);
+
+    return NULL;
+}
+
+int i2d_task_run(i2d_task * list, size_t size) {
+    int status = I2D_OK;
+    i2d_task_queue queue;
+    pthread_t * threads;
+    long cpu;
+    size_t count;
+    size_t i;
+
+    cpu = sysconf(_SC_NPROCESSORS_ONLN);
+    count = (0 < cpu && (size_t) cpu < size) ? (size_t) cpu : size;
+
+    queue.list = list;
+    queue.size = size;
+    queue.next = 0;
+
+    /*
+     * the calling thread is always a worker so
+     * a failure to spawn only reduces the width
+     */
+    threads = count > 1 ? i2d_calloc(I2D_TAG_UTIL, count - 1, sizeof(*threads)) : NULL;
+    if(!threads || pthread_mutex_init(&queue.mutex, NULL)) {
+        for(i = 0; i < size; i++)
+            list[i].status = list[i].cb(list[i].data);
+    } else {
+        __atomic_add_fetch(&i2d_allocator_threads, 1, __ATOMIC_RELAXED);
+
+        for(i = 0; i < count - 1; i++)
+            if(pthread_create(&threads[i], NULL, i2d_task_worker, &queue))
+                break;
+
+        count = i;
+        i2d_task_worker(&queue);
+
+        for(i = 0; i < count; i++)
+            pthread_join(threads[i], NULL);
+
+        __atomic_sub_fetch(&i2d_allocator_threads, 1, __ATOMIC_RELAXED);
+
+        pthread_mutex_destroy(&queue.mutex);
+    }
+    i2d_free(threads);
+
+    for(i = 0; i < size; i++)
+        if(list[i].status)
+            status = I2D_FAIL;
+
+    return status;
+}
+#else
+int i2d_task_run(i2d_task * list, size_t size) {
+    int status = I2D_OK;
+    size_t i;
+
+    for(i = 0; i < size; i++) {
+        list[i].status = list[i].cb(list[i].data);
+        if(list[i].status)
+            status = I2D_FAIL;
+    }
+
+    return status;
+}
+#endif
@@ -4,6 +4,7 @@
 #include "math.h"
 #include "ctype.h"
 #include "stdio.h"
+#include "errno.h"
 #include "fcntl.h"
 #include "stdlib.h"
 #include "stdarg.h"
@@ -13,7 +14,10 @@
 #include "inttypes.h"
 #ifndef _WIN32
 #include "unistd.h"
+#include "pthread.h"
+#include "sys/uio.h"
 #include "sys/time.h"
+#include "time.h"
 #else
 #include "windows.h"
 #endif
@@ -35,6 +39,15 @@
  */
 #define MAX_STACK 256
 
+/*
+ * maximum number of segments per write
+ */
+#ifdef IOV_MAX
+#define I2D_ROPE_IOV IOV_MAX
+#else
+#define I2D_ROPE_IOV 1024
+#endif
+
 /*
  * default buffer size
  */
@@ -47,8 +60,95 @@
 #define i2d_panic(format, ...) i2d_panic_print("%s (%s:%zu): " format ".\n", __FILE__, __func__, __LINE__, ## __VA_ARGS__)
 int i2d_panic_print(const char *, ...);
 
+/*
+ * the subsystem that owns an allocation
+ */
+enum i2d_tag {
+    I2D_TAG_UTIL,
+    I2D_TAG_LEXER,
+    I2D_TAG_PARSER,
+    I2D_TAG_RANGE,
+    I2D_TAG_LOGIC,
+    I2D_TAG_RBT,
+    I2D_TAG_DB,
+    I2D_TAG_JSON,
+    I2D_TAG_SCRIPT,
+    I2D_TAG_PRINT,
+    I2D_TAG_WATCH,
+    I2D_TAG_TRACE,
+    I2D_TAG_INTERN,
+    I2D_TAG_DEPEND,
+    I2D_TAG_SIZE
+};
+
+typedef void * (* i2d_allocator_malloc_cb) (void *, size_t);
+typedef void * (* i2d_allocator_calloc_cb) (void *, size_t);
+typedef void * (* i2d_allocator_realloc_cb) (void *, void *, size_t, size_t);
+typedef void (* i2d_allocator_free_cb) (void *, void *, size_t);
+
+/*
+ * data is passed to each callback (i.e. a pool);
+ * the callbacks are called from the load threads
+ * and must be thread safe, i.e. lock or use the
+ * memory of the calling thread; realloc and free
+ * are given the size that was allocated
+ */
+struct i2d_allocator {
+    i2d_allocator_malloc_cb malloc;
+    i2d_allocator_calloc_cb calloc;
+    i2d_allocator_realloc_cb realloc;
+    i2d_allocator_free_cb free;
+    void * data;
+};
+
+typedef struct i2d_allocator i2d_allocator;
+
+struct i2d_allocator_stat {
+    size_t live;
+    size_t peak;
+    size_t count;
+};
+
+typedef struct i2d_allocator_stat i2d_allocator_stat;
+
+int i2d_allocator_init(i2d_allocator *);
+void i2d_allocator_get(int, i2d_allocator_stat *);
+int i2d_allocator_write(const char *);
+void * i2d_malloc(int, size_t);
+void * i2d_calloc(int, size_t, size_t);
+void * i2d_realloc(int, void *, size_t);
+void i2d_dealloc(void *);
+
+/*
+ * a pool hands out blocks of a power of two size
+ * up to I2D_POOL_MAX from slabs that are only
+ * returned when the pool is freed; a freed block
+ * is kept on the list of its size for the next
+ * allocation and larger allocations use malloc
+ */
+#define I2D_POOL_MIN 16
+#define I2D_POOL_MAX 2048
+#define I2D_POOL_CLASSES 8
+#define I2D_POOL_SLAB 65536
+
+struct i2d_pool {
+    i2d_allocator allocator;
+    void * list[I2D_POOL_CLASSES];
+    char * slab;
+    size_t offset;
+    void * slabs;
+#ifndef _WIN32
+    pthread_mutex_t mutex;
+#endif
+};
+
+typedef struct i2d_pool i2d_pool;
+
+int i2d_pool_init(i2d_pool **);
+void i2d_pool_deit(i2d_pool **);
+
 #define i2d_is_invalid(ptr) (!(ptr) || *(ptr))
-#define i2d_free(ptr) if(ptr) { free(ptr); (ptr) = NULL; }
+#define i2d_free(ptr) if(ptr) { i2d_dealloc(ptr); (ptr) = NULL; }
 #define i2d_deit(ptr, deit) if(ptr) { deit(&(ptr)); }
 #define i2d_zero(str) memset(&str, 0, sizeof(str))
 #define i2d_size(ptr) (sizeof(ptr) / sizeof(ptr[0]))
@@ -64,7 +164,7 @@ int i2d_panic_print(const char *, ...);
 #define max(x, y) ((x < y) ? y : x)
 #endif
 
-int i2d_string_copy(char **, const char *, size_t);
+int i2d_string_copy(int, char **, const char *, size_t);
 
 struct i2d_string {
     char * string;
@@ -73,11 +173,13 @@ struct i2d_string {
 
 typedef struct i2d_string i2d_string;
 
-int i2d_string_create(i2d_string *, const char *, size_t);
+int i2d_string_create(int, i2d_string *, const char *, size_t);
 void i2d_string_destroy(i2d_string *);
-int i2d_string_vprintf(i2d_string *, const char *, ...);
+int i2d_string_vprintf(int, i2d_string *, const char *, ...);
+int i2d_string_suffix(i2d_string *, const char *);
 
 struct i2d_buffer {
+    int tag;
     char * buffer;
     size_t length;
     size_t offset;
@@ -87,12 +189,12 @@ struct i2d_buffer {
 
 typedef struct i2d_buffer i2d_buffer;
 
-int i2d_buffer_init(i2d_buffer **, size_t);
+int i2d_buffer_init(int, i2d_buffer **, size_t);
 void i2d_buffer_deit(i2d_buffer **);
 void i2d_buffer_list_deit(i2d_buffer **);
 void i2d_buffer_append(i2d_buffer *, i2d_buffer *);
 void i2d_buffer_remove(i2d_buffer *);
-int i2d_buffer_create(i2d_buffer *, size_t);
+int i2d_buffer_create(int, i2d_buffer *, size_t);
 void i2d_buffer_destroy(i2d_buffer *);
 int i2d_buffer_adapt(i2d_buffer *, size_t);
 void i2d_buffer_clear(i2d_buffer *);
@@ -100,16 +202,24 @@ int i2d_buffer_putc(i2d_buffer *, char);
 int i2d_buffer_printf(i2d_buffer *, const char *, ...);
 int i2d_buffer_vprintf(i2d_buffer *, const char *, va_list);
 int i2d_buffer_memcpy(i2d_buffer *, const char *, size_t);
+
+#define I2D_BUFFER_SIGN 0x1
+#define I2D_BUFFER_PERCENT 0x2
+
+int i2d_buffer_puts(i2d_buffer *, const char *);
+int i2d_buffer_putl(i2d_buffer *, long, int);
+int i2d_buffer_putr(i2d_buffer *, long, long, int);
 void i2d_buffer_get(i2d_buffer *, char **, size_t *);
 int i2d_buffer_copy(i2d_buffer *, i2d_buffer *);
 
 struct i2d_buffer_cache {
+    int tag;
     i2d_buffer * list;
 };
 
 typedef struct i2d_buffer_cache i2d_buffer_cache;
 
-int i2d_buffer_cache_init(i2d_buffer_cache **);
+int i2d_buffer_cache_init(int, i2d_buffer_cache **);
 void i2d_buffer_cache_deit(i2d_buffer_cache **);
 int i2d_buffer_cache_get(i2d_buffer_cache *, i2d_buffer **);
 int i2d_buffer_cache_put(i2d_buffer_cache *, i2d_buffer **);
@@ -126,12 +236,12 @@ struct i2d_string_stack {
 
 typedef struct i2d_string_stack i2d_string_stack;
 
-int i2d_string_stack_init(i2d_string_stack **, size_t);
+int i2d_string_stack_init(int, i2d_string_stack **, size_t);
 void i2d_string_stack_deit(i2d_string_stack **);
 void i2d_string_stack_list_deit(i2d_string_stack **);
 void i2d_string_stack_append(i2d_string_stack *, i2d_string_stack *);
 void i2d_string_stack_remove(i2d_string_stack *);
-int i2d_string_stack_create(i2d_string_stack *, size_t);
+int i2d_string_stack_create(int, i2d_string_stack *, size_t);
 void i2d_string_stack_destroy(i2d_string_stack *);
 int i2d_string_stack_push(i2d_string_stack *, const char *, size_t);
 int i2d_string_stack_push_buffer(i2d_string_stack *, i2d_buffer *);
@@ -143,16 +253,105 @@ int i2d_string_stack_dump_buffer(i2d_string_stack *, i2d_buffer *, const char *)
 int i2d_string_stack_format(i2d_string_stack *, i2d_string *, i2d_buffer *);
 
 struct i2d_string_stack_cache {
+    int tag;
     i2d_string_stack * list;
 };
 
 typedef struct i2d_string_stack_cache i2d_string_stack_cache;
 
-int i2d_string_stack_cache_init(i2d_string_stack_cache **);
+int i2d_string_stack_cache_init(int, i2d_string_stack_cache **);
 void i2d_string_stack_cache_deit(i2d_string_stack_cache **);
 int i2d_string_stack_cache_get(i2d_string_stack_cache *, i2d_string_stack **);
 int i2d_string_stack_cache_put(i2d_string_stack_cache *, i2d_string_stack **);
 
+/*
+ * a rope is a list of segments that refer to
+ * strings which outlive the rope (i.e. item and
+ * value map strings); a string that does not is
+ * stored in a block that is not moved until the
+ * rope is cleared, so the output is copied once
+ * when the rope is written
+ */
+struct i2d_rope_segment {
+    const char * string;
+    size_t length;
+};
+
+typedef struct i2d_rope_segment i2d_rope_segment;
+
+struct i2d_rope {
+    i2d_rope_segment * list;
+    size_t size;
+    size_t capacity;
+    size_t length;
+    i2d_buffer * blocks;
+    i2d_buffer * block;
+};
+
+typedef struct i2d_rope i2d_rope;
+
+int i2d_rope_create(i2d_rope *);
+void i2d_rope_destroy(i2d_rope *);
+void i2d_rope_clear(i2d_rope *);
+int i2d_rope_add(i2d_rope *, const char *, size_t);
+int i2d_rope_store(i2d_rope *, const char *, size_t, i2d_string *);
+int i2d_rope_join(i2d_rope *, size_t, i2d_string *);
+int i2d_rope_dump(i2d_rope *, i2d_string *, size_t, const char *);
+int i2d_rope_format(i2d_rope *, i2d_string *, i2d_string *, size_t);
+int i2d_rope_write(i2d_rope *, FILE *);
+
+/*
+ * two level table of pointers by id; an id is
+ * split into a page and a slot in the page and
+ * pages are only allocated for ids that are in
+ * use, so mostly dense ids take two loads; ids
+ * outside of the range are not in the table
+ */
+#define I2D_TABLE_PAGE_BITS 10
+#define I2D_TABLE_PAGE_SIZE (1L << I2D_TABLE_PAGE_BITS)
+#define I2D_TABLE_MAX (1L << 24)
+
+#define i2d_table_range(x) ((x) >= 0 && (x) < I2D_TABLE_MAX)
+
+struct i2d_table {
+    void *** list;
+    size_t size;
+};
+
+typedef struct i2d_table i2d_table;
+
+void i2d_table_destroy(i2d_table *);
+int i2d_table_insert(i2d_table *, long, void *);
+int i2d_table_search(i2d_table *, long, void **);
+
+/*
+ * a field of a line of a txt database ends at a
+ * comma and the line ends at a line comment or
+ * a whitespace other than a space; with quote or
+ * brace set, a comma in quotes or braces does not
+ * end the field and a line that ends in them has
+ * no last field
+ */
+#define I2D_SPLIT_QUOTE 0x1
+#define I2D_SPLIT_BRACE 0x2
+#define I2D_SPLIT_SPACE 0x4 /* space ends the line */
+#define I2D_SPLIT_TAB 0x8 /* tab does not end the line */
+
+struct i2d_split {
+    char * string;
+    size_t length;
+    size_t offset;
+    int flags;
+    int quote;
+    int brace;
+    int last;
+};
+
+typedef struct i2d_split i2d_split;
+
+void i2d_split_create(i2d_split *, char *, size_t, int);
+int i2d_split_next(i2d_split *, char **, size_t *);
+
 int i2d_strtol(long *, const char *, size_t, int);
 int i2d_strtoll(long long *, const char *, size_t, int);
 int i2d_strtoul(unsigned long *, const char *, size_t, int);
@@ -166,10 +365,29 @@ int i2d_fd_read(int, size_t, i2d_buffer *);
 #else
 int i2d_fd_read(HANDLE, size_t, i2d_buffer *);
 #endif
+int i2d_fd_read_file(i2d_string *, i2d_buffer *);
 int i2d_by_line(i2d_buffer *, i2d_by_line_cb, void *);
 
 typedef int (* i2d_by_bit_cb) (uint64_t, void *);
 
 int i2d_by_bit64(uint64_t, i2d_by_bit_cb, void *);
 int i2d_is_number(i2d_string *);
+
+#define I2D_FNV_OFFSET 14695981039346656037ULL
+#define I2D_FNV_PRIME 1099511628211ULL
+
+uint64_t i2d_fnv1a(uint64_t, const char *, size_t);
+uint64_t i2d_time(void);
+
+typedef int (* i2d_task_cb) (void *);
+
+struct i2d_task {
+    i2d_task_cb cb;
+    void * data;
+    int status;
+};
+
+typedef struct i2d_task i2d_task;
+
+int i2d_task_run(i2d_task *, size_t);
 #endif
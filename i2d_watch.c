@@ -0,0 +1,367 @@
+#include "i2d_watch.h"
+
+#ifndef _WIN32
+static int i2d_watch_add(i2d_watch *, i2d_string *);
+static int i2d_watch_read(i2d_watch *, int *);
+#endif
+static void i2d_watch_unload(i2d_json **, i2d_script **, i2d_print **);
+static int i2d_watch_load(i2d_watch *, i2d_string *, i2d_json **, i2d_script **, i2d_print **);
+static int i2d_watch_update(i2d_watch *, i2d_json *, i2d_script *, i2d_print *, int *);
+static int i2d_watch_compile(i2d_script *, i2d_print *, i2d_item **, size_t);
+static void i2d_watch_save(i2d_watch *, i2d_depend **);
+
+#ifndef _WIN32
+int i2d_watch_init(i2d_watch ** result, i2d_config * config) {
+    int status = I2D_OK;
+    i2d_watch * object;
+    i2d_string * paths[] = {
+        &config->arguments_path,
+        &config->bonus_path,
+        &config->constants_path,
+        &config->data_path,
+        &config->functions_path,
+        &config->print_path,
+        &config->sc_start_path,
+        &config->statements_path,
+        &config->item_db_path,
+        &config->skill_db_path,
+        &config->mob_db_path,
+        &config->mob_race2_db_path,
+        &config->produce_db_path,
+        &config->mercenary_db_path,
+        &config->pet_db_path,
+        &config->item_combo_db_path,
+        &config->locale_path
+    };
+    size_t i;
+
+    if(i2d_is_invalid(result)) {
+        status = i2d_panic("invalid paramater");
+    } else {
+        object = i2d_calloc(I2D_TAG_WATCH, 1, sizeof(*object));
+        if(!object) {
+            status = i2d_panic("out of memory");
+        } else {
+            object->fd = -1;
+
+            if(i2d_buffer_create(I2D_TAG_WATCH, &object->buffer, BUFFER_SIZE_SMALL)) {
+                status = i2d_panic("failed to create buffer object");
+            } else if(i2d_depend_init(&object->depend)) {
+                status = i2d_panic("failed to create depend object");
+            } else if(i2d_depend_load(object->depend, config)) {
+                status = i2d_panic("failed to load depend");
+            } else {
+                object->fd = inotify_init();
+                if(0 > object->fd) {
+                    status = i2d_panic("failed to create inotify instance");
+                } else {
+                    for(i = 0; i < i2d_size(paths) && !status; i++)
+                        if(paths[i]->string && i2d_watch_add(object, paths[i]))
+                            status = i2d_panic("failed to watch file -- %s", paths[i]->string);
+                }
+            }
+
+            if(status)
+                i2d_watch_deit(&object);
+            else
+                *result = object;
+        }
+    }
+
+    return status;
+}
+
+void i2d_watch_deit(i2d_watch ** result) {
+    i2d_watch * object;
+    size_t i;
+
+    object = *result;
+    if(0 <= object->fd)
+        close(object->fd);
+    for(i = 0; i < object->size; i++)
+        i2d_string_destroy(&object->list[i].path);
+    i2d_deit(object->depend, i2d_depend_deit);
+    i2d_buffer_destroy(&object->buffer);
+    i2d_free(object);
+    *result = NULL;
+}
+
+static int i2d_watch_add(i2d_watch * watch, i2d_string * path) {
+    int status = I2D_OK;
+    i2d_watch_file * file;
+    char * name;
+    size_t length;
+
+    if(watch->size >= I2D_WATCH_SIZE) {
+        status = i2d_panic("too many files to watch");
+    } else {
+        file = &watch->list[watch->size];
+
+        name = strrchr(path->string, '/');
+        length = name ? (size_t) name - (size_t) path->string : 0;
+
+        i2d_buffer_clear(&watch->buffer);
+
+        if(i2d_buffer_printf(&watch->buffer, "%.*s", (int) length, path->string)) {
+            status = i2d_panic("failed to write buffer object");
+        } else if(!watch->buffer.offset && i2d_buffer_printf(&watch->buffer, name ? "/" : ".")) {
+            status = i2d_panic("failed to write buffer object");
+        } else if(i2d_string_create(I2D_TAG_WATCH, &file->path, path->string, path->length)) {
+            status = i2d_panic("failed to create string object");
+        } else {
+            file->name = file->path.string + (name ? length + 1 : 0);
+            file->wd = inotify_add_watch(watch->fd, watch->buffer.buffer, IN_CLOSE_WRITE | IN_MOVED_TO);
+            if(0 > file->wd) {
+                status = i2d_panic("failed to watch directory -- %s", watch->buffer.buffer);
+                i2d_string_destroy(&file->path);
+            } else {
+                watch->size++;
+            }
+        }
+    }
+
+    return status;
+}
+
+/*
+ * changed is set if any of the events is for a
+ * watched file or if events were dropped
+ */
+static int i2d_watch_read(i2d_watch * watch, int * changed) {
+    int status = I2D_OK;
+    union {
+        struct inotify_event event;
+        char buffer[4096];
+    } events;
+    struct inotify_event * event;
+    ssize_t length;
+    ssize_t offset;
+    size_t i;
+
+    length = read(watch->fd, events.buffer, sizeof(events.buffer));
+    if(0 >= length) {
+        status = i2d_panic("failed to read inotify events");
+    } else {
+        for(offset = 0; offset < length; offset += (ssize_t) (sizeof(*event) + event->len)) {
+            event = (struct inotify_event *) (events.buffer + offset);
+            if(event->mask & IN_Q_OVERFLOW) {
+                *changed = 1;
+            } else if(event->len) {
+                for(i = 0; i < watch->size && !*changed; i++)
+                    if(watch->list[i].wd == event->wd && !strcmp(watch->list[i].name, event->name))
+                        *changed = 1;
+            }
+        }
+    }
+
+    return status;
+}
+
+/*
+ * block until a watched file is changed and the
+ * events of the change settle, i.e. an editor may
+ * write a file several times on save
+ */
+int i2d_watch_wait(i2d_watch * watch) {
+    int status = I2D_OK;
+    struct pollfd pollfd;
+    int changed = 0;
+    int settle = 1;
+    int result;
+
+    while(!changed && !status)
+        if(i2d_watch_read(watch, &changed))
+            status = i2d_panic("failed to read watch");
+
+    pollfd.fd = watch->fd;
+    pollfd.events = POLLIN;
+
+    while(settle && !status) {
+        result = poll(&pollfd, 1, I2D_WATCH_DELAY);
+        if(0 > result) {
+            status = i2d_panic("failed to poll inotify instance");
+        } else if(!result) {
+            settle = 0;
+        } else if(i2d_watch_read(watch, &changed)) {
+            status = i2d_panic("failed to read watch");
+        }
+    }
+
+    return status;
+}
+#else
+int i2d_watch_init(i2d_watch ** result, i2d_config * config) {
+    return i2d_panic("watch is not supported");
+}
+
+void i2d_watch_deit(i2d_watch ** result) {
+    i2d_watch * object;
+
+    object = *result;
+    i2d_deit(object->depend, i2d_depend_deit);
+    i2d_buffer_destroy(&object->buffer);
+    i2d_free(object);
+    *result = NULL;
+}
+
+int i2d_watch_wait(i2d_watch * watch) {
+    return i2d_panic("watch is not supported");
+}
+#endif
+
+static void i2d_watch_unload(i2d_json ** json, i2d_script ** script, i2d_print ** print) {
+    i2d_deit(*print, i2d_print_deit);
+    i2d_deit(*script, i2d_script_deit);
+    i2d_deit(*json, i2d_json_deit);
+}
+
+/*
+ * load the config, the databases, and the data
+ * files again and compile every item
+ */
+static int i2d_watch_load(i2d_watch * watch, i2d_string * path, i2d_json ** json, i2d_script ** script, i2d_print ** print) {
+    int status = I2D_OK;
+    i2d_depend * depend = NULL;
+
+    i2d_watch_unload(json, script, print);
+
+    if(i2d_json_init(json, path)) {
+        status = i2d_panic("failed to create json object");
+    } else if(i2d_depend_init(&depend)) {
+        status = i2d_panic("failed to create depend object");
+    } else {
+        if(i2d_depend_load(depend, (*json)->config)) {
+            status = i2d_panic("failed to load depend");
+        } else if(i2d_script_init(script, *json)) {
+            status = i2d_panic("failed to create script object");
+        } else if(i2d_print_init(print, *json)) {
+            status = i2d_panic("failed to create print object");
+        } else if(i2d_watch_compile(*script, *print, (*script)->db->item_db->store.items, (*script)->db->item_db->store.size)) {
+            status = i2d_panic("failed to compile items");
+        } else {
+            i2d_watch_save(watch, &depend);
+        }
+        i2d_deit(depend, i2d_depend_deit);
+    }
+
+    return status;
+}
+
+/*
+ * reload the data files whose entries changed and
+ * compile the items that refer to those entries;
+ * reload is set if a file that is not tracked per
+ * entry changed instead
+ */
+static int i2d_watch_update(i2d_watch * watch, i2d_json * json, i2d_script * script, i2d_print * print, int * reload) {
+    int status = I2D_OK;
+    i2d_depend * depend = NULL;
+    i2d_select * select = NULL;
+    const char * kinds[] = { "bonus", "sc_start", "statement", "function", "argument" };
+    int changed;
+    size_t i;
+
+    if(i2d_depend_init(&depend)) {
+        status = i2d_panic("failed to create depend object");
+    } else {
+        if(i2d_depend_load(depend, json->config)) {
+            status = i2d_panic("failed to load depend");
+        } else if(i2d_depend_changed(depend, watch->depend, "file:", reload)) {
+            status = i2d_panic("failed to diff depend");
+        } else if(*reload) {
+            /* load everything */
+        } else {
+            for(i = 0; i < i2d_size(kinds) && !status; i++) {
+                changed = 0;
+                i2d_buffer_clear(&watch->buffer);
+
+                if(i2d_buffer_printf(&watch->buffer, "%s:", kinds[i])) {
+                    status = i2d_panic("failed to write buffer object");
+                } else if(i2d_depend_changed(depend, watch->depend, watch->buffer.buffer, &changed)) {
+                    status = i2d_panic("failed to diff depend");
+                } else if(changed && i2d_script_reload(script, json, kinds[i])) {
+                    status = i2d_panic("failed to reload -- %s", kinds[i]);
+                }
+            }
+
+            if(status) {
+                /* script is not usable */
+            } else if(i2d_depend_diff(depend, watch->depend, script->index, script->db->item_db, &select)) {
+                status = i2d_panic("failed to select items");
+            } else if(!select) {
+                *reload = 1;
+            } else {
+                if(i2d_select_resolve(select, script->db->item_db, script->db->item_combo_db)) {
+                    status = i2d_panic("failed to select items");
+                } else {
+                    i2d_index_remove(script->index, select->list, select->size);
+
+                    if(i2d_watch_compile(script, print, select->list, select->size)) {
+                        status = i2d_panic("failed to compile items");
+                    } else {
+                        i2d_watch_save(watch, &depend);
+                    }
+                }
+                i2d_select_deit(&select);
+            }
+        }
+        i2d_deit(depend, i2d_depend_deit);
+    }
+
+    return status;
+}
+
+static int i2d_watch_compile(i2d_script * script, i2d_print * print, i2d_item ** list, size_t size) {
+    int status = I2D_OK;
+    size_t i;
+
+    for(i = 0; i < size && !status; i++) {
+        if(i2d_script_compile_item(script, list[i])) {
+            status = i2d_panic("failed to get compile item -- %ld", list[i]->id);
+        } else if(i2d_print_format(print, list[i])) {
+            status = i2d_panic("failed to print item -- %ld", list[i]->id);
+        }
+    }
+
+    if(i2d_print_flush(print))
+        status = i2d_panic("failed to write items");
+
+    return status;
+}
+
+/*
+ * the depend of the compiled items replaces the
+ * depend of the watch; the index and depend files
+ * are not written since the watch only writes the
+ * items that changed
+ */
+static void i2d_watch_save(i2d_watch * watch, i2d_depend ** depend) {
+    i2d_depend_deit(&watch->depend);
+    watch->depend = *depend;
+    *depend = NULL;
+}
+
+/*
+ * compile the items whose inputs changed until a
+ * watch error; the json, script, and print are
+ * loaded again after an error in the files, so
+ * they may be NULL on return
+ */
+int i2d_watch_run(i2d_watch * watch, i2d_string * path, i2d_json ** json, i2d_script ** script, i2d_print ** print) {
+    int status = I2D_OK;
+    int reload;
+
+    while(!status) {
+        reload = !*script;
+
+        if(i2d_watch_wait(watch)) {
+            status = i2d_panic("failed to wait for watch");
+        } else if(!reload && i2d_watch_update(watch, *json, *script, *print, &reload)) {
+            i2d_watch_unload(json, script, print);
+        } else if(reload && i2d_watch_load(watch, path, json, script, print)) {
+            i2d_watch_unload(json, script, print);
+        }
+    }
+
+    return status;
+}
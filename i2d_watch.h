@@ -0,0 +1,50 @@
+#ifndef i2d_watch_h
+#define i2d_watch_h
+
+#include "i2d_util.h"
+#include "i2d_json.h"
+#include "i2d_script.h"
+#include "i2d_print.h"
+#include "i2d_depend.h"
+#ifndef _WIN32
+#include "poll.h"
+#include "sys/inotify.h"
+#endif
+
+#define I2D_WATCH_SIZE 32
+#define I2D_WATCH_DELAY 100
+
+/*
+ * the directory of a file is watched instead of
+ * the file, since editors tend to replace a file
+ * on save rather than write it in place
+ */
+struct i2d_watch_file {
+    int wd;
+    i2d_string path;
+    char * name;
+};
+
+typedef struct i2d_watch_file i2d_watch_file;
+
+/*
+ * depend is the state of the files for the items
+ * that are compiled, which is compared against the
+ * files on each change to select the items that
+ * need to be compiled again
+ */
+struct i2d_watch {
+    int fd;
+    i2d_watch_file list[I2D_WATCH_SIZE];
+    size_t size;
+    i2d_depend * depend;
+    i2d_buffer buffer;
+};
+
+typedef struct i2d_watch i2d_watch;
+
+int i2d_watch_init(i2d_watch **, i2d_config *);
+void i2d_watch_deit(i2d_watch **);
+int i2d_watch_wait(i2d_watch *);
+int i2d_watch_run(i2d_watch *, i2d_string *, i2d_json **, i2d_script **, i2d_print **);
+#endif
@@ -1,44 +1,148 @@
 #include "i2d_yaml.h"
 
-static int i2d_yaml_reader(void * context, unsigned char * buffer, size_t length, size_t * result) {
-    int status = I2D_OK;
-    int * fd = context;
-    ssize_t bytes;
+/*
+ * maximum depth of nested mappings and sequences
+ */
+#define MAX_YAML_DEPTH 32
 
-    bytes = read(*fd, buffer, length);
-    if(bytes < 0) {
-        status = i2d_panic("failed to read file");
-    } else {
-        *result = (size_t) bytes;
-    }
+/*
+ * maximum length of the key path of a field
+ */
+#define MAX_YAML_KEY 256
 
-    return status ? 0 : 1; 
-}
+/*
+ * maximum depth of nested Footer.Imports files
+ */
+#define MAX_YAML_IMPORT 8
+
+struct i2d_yaml_frame {
+    int sequence;
+    int value;
+    size_t length;
+    size_t index;
+};
+
+typedef struct i2d_yaml_frame i2d_yaml_frame;
+
+struct i2d_yaml_mapper {
+    i2d_yaml_frame frames[MAX_YAML_DEPTH];
+    size_t depth;
+    char key[MAX_YAML_KEY];
+    size_t length;
+    size_t record;
+    i2d_string import;
+    int import_skip;
+    i2d_string_stack imports;
+    i2d_yaml_record_cb cb;
+    void * data;
+};
+
+typedef struct i2d_yaml_mapper i2d_yaml_mapper;
+
+enum i2d_yaml_token_type {
+    i2d_yaml_token_scalar,
+    i2d_yaml_token_mapping,
+    i2d_yaml_token_sequence,
+    i2d_yaml_token_end
+};
+
+/*
+ * a scalar is the offset and length of a nul
+ * terminated string in the scanned buffer
+ */
+struct i2d_yaml_token {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t type;
+};
+
+typedef struct i2d_yaml_token i2d_yaml_token;
 
+struct i2d_yaml_block {
+    size_t indent;
+    int sequence;
+};
+
+typedef struct i2d_yaml_block i2d_yaml_block;
+
+/*
+ * the rAthena databases are written in block
+ * style, which is scanned line by line into a
+ * list of tokens that is mapped once the whole
+ * file is scanned; a file outside the subset,
+ * i.e. flow collections, anchors, tags, folded
+ * multi-line plain and quoted scalars, is left
+ * to libyaml before any record is mapped
+ */
+struct i2d_yaml_scanner {
+    char * string;
+    size_t length;
+    size_t position;
+    i2d_yaml_block blocks[MAX_YAML_DEPTH];
+    size_t depth;
+    int pending;
+    int started;
+    i2d_yaml_token * list;
+    size_t size;
+    size_t capacity;
+};
+
+typedef struct i2d_yaml_scanner i2d_yaml_scanner;
+
+static int i2d_yaml_map_file(i2d_string *, i2d_yaml_record_cb, void *, size_t);
+static int i2d_yaml_map_parse(i2d_string *, i2d_yaml_mapper *);
+static int i2d_yaml_map_event(yaml_event_t *, void *);
+static int i2d_yaml_map_push(i2d_yaml_mapper *, int);
+static int i2d_yaml_map_pop(i2d_yaml_mapper *);
+static int i2d_yaml_map_scalar(i2d_yaml_mapper *, const char *, size_t);
+static int i2d_yaml_map_value(i2d_yaml_mapper *, const char *, size_t);
+static void i2d_yaml_map_next(i2d_yaml_mapper *);
+static int i2d_yaml_map_emit(i2d_yaml_mapper *, enum i2d_yaml_type, const char *, size_t);
+static int i2d_yaml_map_import(i2d_yaml_mapper *);
+static int i2d_yaml_resolve(i2d_string *, i2d_string *, i2d_string *);
+static int i2d_yaml_scan(i2d_yaml_scanner *);
+static int i2d_yaml_scan_node(i2d_yaml_scanner *, char *, size_t, char *);
+static int i2d_yaml_scan_key(char *, char *, char **, size_t *, char **);
+static int i2d_yaml_scan_value(i2d_yaml_scanner *, char *, char *, size_t);
+static int i2d_yaml_scan_plain(i2d_yaml_scanner *, char *, char *);
+static int i2d_yaml_scan_quoted(char *, char *, char **, size_t *);
+static int i2d_yaml_scan_escape(char **, char *, char **);
+static int i2d_yaml_scan_block(i2d_yaml_scanner *, char *, char *, size_t, int);
+static int i2d_yaml_scan_open(i2d_yaml_scanner *, size_t, int);
+static int i2d_yaml_scan_close(i2d_yaml_scanner *);
+static int i2d_yaml_scan_token(i2d_yaml_scanner *, enum i2d_yaml_token_type, char *, size_t);
+static int i2d_yaml_replay(i2d_yaml_scanner *, i2d_yaml_mapper *);
+
+/*
+ * the whole file is read into memory so that
+ * libyaml can scan the string without calling
+ * back into a reader for every few kilobytes
+ */
 int i2d_yaml_parse(i2d_string * path, i2d_yaml_parse_cb handler, void * context) {
     int status = I2D_OK;
     int sentry = 0;
 
-    int fd = -1;
+    i2d_buffer buffer;
     yaml_parser_t parser;
     yaml_event_t event;
 
-    fd = open(path->string, O_RDONLY);
-    if(fd < 0) {
-        status = i2d_panic("failed to open file -- %s", path->string);
+    if(i2d_buffer_create(I2D_TAG_DB, &buffer, BUFFER_SIZE_LARGE * 2)) {
+        status = i2d_panic("failed to create buffer object");
     } else {
-        if(!yaml_parser_initialize(&parser)) {
+        if(i2d_fd_read_file(path, &buffer)) {
+            status = i2d_panic("failed to read yaml file -- %s", path->string);
+        } else if(!yaml_parser_initialize(&parser)) {
             status = i2d_panic("failed to create yaml parser object");
         } else {
-            yaml_parser_set_input(&parser, i2d_yaml_reader, &fd);
+            yaml_parser_set_input_string(&parser, (unsigned char *) buffer.buffer, buffer.offset);
             while(!status && !sentry) {
                 if(!yaml_parser_parse(&parser, &event)) {
-                    status = i2d_panic("failed to create yaml event object");
+                    status = i2d_panic("failed to parse yaml file -- %s (%s at line %zu)", path->string, parser.problem, parser.problem_mark.line + 1);
                 } else {
                     if(event.type == YAML_STREAM_END_EVENT)
                         sentry = 1;
 
-                    if(handler(&event, context)) 
+                    if(handler(&event, context))
                         status = i2d_panic("failed on yaml handler");
 
                     yaml_event_delete(&event);
@@ -46,8 +150,980 @@ int i2d_yaml_parse(i2d_string * path, i2d_yaml_parse_cb handler, void * context)
             }
             yaml_parser_delete(&parser);
         }
-        close(fd);
+        i2d_buffer_destroy(&buffer);
+    }
+
+    return status;
+}
+
+int i2d_yaml_map(i2d_string * path, i2d_yaml_record_cb cb, void * data) {
+    return i2d_yaml_map_file(path, cb, data, 0);
+}
+
+static int i2d_yaml_map_file(i2d_string * path, i2d_yaml_record_cb cb, void * data, size_t level) {
+    int status = I2D_OK;
+    i2d_yaml_mapper * mapper;
+
+    size_t i;
+    i2d_string * list;
+    size_t size;
+    i2d_string import;
+
+    if(level >= MAX_YAML_IMPORT) {
+        status = i2d_panic("yaml imports are nested too deeply -- %s", path->string);
+    } else {
+        mapper = i2d_calloc(I2D_TAG_DB, 1, sizeof(*mapper));
+        if(!mapper) {
+            status = i2d_panic("out of memory");
+        } else {
+            if(i2d_string_stack_create(I2D_TAG_DB, &mapper->imports, MAX_STACK)) {
+                status = i2d_panic("failed to create string stack object");
+            } else {
+                mapper->cb = cb;
+                mapper->data = data;
+
+                if(i2d_yaml_map_parse(path, mapper)) {
+                    status = i2d_panic("failed to map yaml file -- %s", path->string);
+                } else if(i2d_string_stack_get(&mapper->imports, &list, &size)) {
+                    status = i2d_panic("failed to get string stack");
+                } else {
+                    /*
+                     * imported files are mapped after the
+                     * file that imports them, in order
+                     */
+                    for(i = 0; i < size && !status; i++) {
+                        i2d_zero(import);
+
+                        if(i2d_yaml_resolve(path, &list[i], &import)) {
+                            status = i2d_panic("failed to resolve yaml import -- %s", list[i].string);
+                        } else if(i2d_yaml_map_file(&import, cb, data, level + 1)) {
+                            status = i2d_panic("failed to map yaml import -- %s", import.string);
+                        }
+
+                        i2d_string_destroy(&import);
+                    }
+                }
+                i2d_string_stack_destroy(&mapper->imports);
+            }
+            i2d_free(mapper->import.string);
+            i2d_free(mapper);
+        }
+    }
+
+    return status;
+}
+
+/*
+ * the scanner is tried first and the file is
+ * parsed by libyaml when it is not in the subset
+ */
+static int i2d_yaml_map_parse(i2d_string * path, i2d_yaml_mapper * mapper) {
+    int status = I2D_OK;
+    i2d_buffer buffer;
+    i2d_yaml_scanner scanner;
+
+    if(i2d_buffer_create(I2D_TAG_DB, &buffer, BUFFER_SIZE_LARGE * 2)) {
+        status = i2d_panic("failed to create buffer object");
+    } else {
+        if(i2d_fd_read_file(path, &buffer)) {
+            status = i2d_panic("failed to read yaml file -- %s", path->string);
+        } else {
+            i2d_zero(scanner);
+            scanner.string = buffer.buffer;
+            scanner.length = buffer.offset;
+
+            if(i2d_yaml_scan(&scanner)) {
+                if(i2d_yaml_parse(path, i2d_yaml_map_event, mapper))
+                    status = i2d_panic("failed to parse yaml file -- %s", path->string);
+            } else if(i2d_yaml_replay(&scanner, mapper)) {
+                status = i2d_panic("failed to replay yaml file -- %s", path->string);
+            }
+
+            i2d_free(scanner.list);
+        }
+        i2d_buffer_destroy(&buffer);
+    }
+
+    return status;
+}
+
+static int i2d_yaml_map_event(yaml_event_t * event, void * data) {
+    int status = I2D_OK;
+    i2d_yaml_mapper * mapper = data;
+
+    switch(event->type) {
+        case YAML_NO_EVENT:
+        case YAML_STREAM_START_EVENT:
+        case YAML_STREAM_END_EVENT:
+        case YAML_DOCUMENT_START_EVENT:
+        case YAML_DOCUMENT_END_EVENT:
+            break;
+        case YAML_SCALAR_EVENT:
+            status = i2d_yaml_map_scalar(mapper, (const char *) event->data.scalar.value, event->data.scalar.length);
+            break;
+        case YAML_SEQUENCE_START_EVENT:
+            status = i2d_yaml_map_push(mapper, 1);
+            break;
+        case YAML_MAPPING_START_EVENT:
+            status = i2d_yaml_map_push(mapper, 0);
+            break;
+        case YAML_SEQUENCE_END_EVENT:
+        case YAML_MAPPING_END_EVENT:
+            status = i2d_yaml_map_pop(mapper);
+            break;
+        default:
+            status = i2d_panic("unsupport event type -- %d", event->type);
+            break;
+    }
+
+    return status;
+}
+
+static int i2d_yaml_map_push(i2d_yaml_mapper * mapper, int sequence) {
+    int status = I2D_OK;
+    i2d_yaml_frame * frame;
+
+    if(mapper->depth >= MAX_YAML_DEPTH) {
+        status = i2d_panic("yaml is nested too deeply -- %s", mapper->key);
+    } else if(mapper->depth && !mapper->frames[mapper->depth - 1].sequence && !mapper->frames[mapper->depth - 1].value) {
+        status = i2d_panic("unsupport complex key -- %s", mapper->key);
+    } else {
+        frame = &mapper->frames[mapper->depth];
+        frame->sequence = sequence;
+        frame->value = 0;
+        frame->length = mapper->length;
+        frame->index = 0;
+        mapper->depth++;
+
+        /*
+         * a mapping in the Body sequence of the
+         * root mapping is the start of a record
+         */
+        if( !sequence && 3 == mapper->depth && !mapper->record &&
+            mapper->frames[1].sequence && !strcmp(mapper->key, "Body") ) {
+            mapper->record = mapper->depth;
+            status = i2d_yaml_map_emit(mapper, i2d_yaml_record_start, NULL, 0);
+        }
+    }
+
+    return status;
+}
+
+static int i2d_yaml_map_pop(i2d_yaml_mapper * mapper) {
+    int status = I2D_OK;
+    i2d_yaml_frame * frame;
+
+    if(!mapper->depth) {
+        status = i2d_panic("yaml is unbalanced");
+    } else {
+        frame = &mapper->frames[mapper->depth - 1];
+        mapper->depth--;
+        mapper->length = frame->length;
+        mapper->key[mapper->length] = 0;
+
+        if(mapper->record && mapper->record == mapper->depth + 1) {
+            status = i2d_yaml_map_emit(mapper, i2d_yaml_record_end, NULL, 0);
+            mapper->record = 0;
+        } else if(!frame->sequence && 3 == mapper->depth && !strcmp(mapper->key, "Footer.Imports")) {
+            status = i2d_yaml_map_import(mapper);
+        }
+
+        if(mapper->depth)
+            i2d_yaml_map_next(mapper);
+    }
+
+    return status;
+}
+
+static int i2d_yaml_map_scalar(i2d_yaml_mapper * mapper, const char * string, size_t length) {
+    int status = I2D_OK;
+    i2d_yaml_frame * frame;
+
+    if(mapper->depth) {
+        frame = &mapper->frames[mapper->depth - 1];
+        if(!frame->sequence && !frame->value) {
+            if(mapper->length + length + 2 > MAX_YAML_KEY) {
+                status = i2d_panic("yaml key is too long -- %s", mapper->key);
+            } else {
+                if(mapper->length)
+                    mapper->key[mapper->length++] = '.';
+                memcpy(&mapper->key[mapper->length], string, length);
+                mapper->length += length;
+                mapper->key[mapper->length] = 0;
+                frame->value = 1;
+            }
+        } else {
+            status = i2d_yaml_map_value(mapper, string, length);
+            i2d_yaml_map_next(mapper);
+        }
+    }
+
+    return status;
+}
+
+static int i2d_yaml_map_value(i2d_yaml_mapper * mapper, const char * string, size_t length) {
+    int status = I2D_OK;
+
+    if(mapper->record) {
+        status = i2d_yaml_map_emit(mapper, i2d_yaml_record_field, string, length);
+    } else if(!strcmp(mapper->key, "Footer.Imports.Path")) {
+        i2d_free(mapper->import.string);
+        if(i2d_string_create(I2D_TAG_DB, &mapper->import, string, length))
+            status = i2d_panic("failed to create string object");
+    } else if(!strcmp(mapper->key, "Footer.Imports.Mode")) {
+        /*
+         * the item descriptions are written
+         * for renewal so skip pre-renewal db
+         */
+        mapper->import_skip = strcmp(string, "Renewal") ? 1 : 0;
+    }
+
+    return status;
+}
+
+static void i2d_yaml_map_next(i2d_yaml_mapper * mapper) {
+    i2d_yaml_frame * frame;
+
+    frame = &mapper->frames[mapper->depth - 1];
+    if(frame->sequence) {
+        frame->index++;
+    } else {
+        frame->value = 0;
+        mapper->length = frame->length;
+        mapper->key[mapper->length] = 0;
+    }
+}
+
+static int i2d_yaml_map_emit(i2d_yaml_mapper * mapper, enum i2d_yaml_type type, const char * string, size_t length) {
+    int status = I2D_OK;
+    i2d_yaml_record record;
+    size_t offset;
+    size_t i;
+
+    /*
+     * skip the record's key path and separator
+     */
+    offset = mapper->frames[mapper->record - 1].length;
+    if(mapper->length > offset)
+        offset++;
+
+    record.type = type;
+    record.key = &mapper->key[offset];
+    record.value = string;
+    record.length = length;
+    record.index = 0;
+
+    for(i = mapper->depth; i > mapper->record; i--) {
+        if(mapper->frames[i - 1].sequence) {
+            record.index = mapper->frames[i - 1].index;
+            break;
+        }
+    }
+
+    if(mapper->cb(&record, mapper->data))
+        status = i2d_panic("failed on yaml record handler -- %s", record.key);
+
+    return status;
+}
+
+static int i2d_yaml_map_import(i2d_yaml_mapper * mapper) {
+    int status = I2D_OK;
+
+    if(!mapper->import.string) {
+        status = i2d_panic("yaml import is missing path");
+    } else if(!mapper->import_skip) {
+        if(i2d_string_stack_push(&mapper->imports, mapper->import.string, mapper->import.length))
+            status = i2d_panic("failed to push string stack");
+    }
+
+    i2d_free(mapper->import.string);
+    mapper->import_skip = 0;
+
+    return status;
+}
+
+/*
+ * import paths are relative to the server root,
+ * i.e. db/re/item_db_equip.yml, so the root is
+ * taken from where the first directory of the
+ * import occurs in the path of the parent file
+ */
+static int i2d_yaml_resolve(i2d_string * parent, i2d_string * import, i2d_string * result) {
+    int status = I2D_OK;
+    char * slash;
+    size_t length;
+    size_t i;
+    size_t root = 0;
+    int found = 0;
+
+    slash = strchr(import->string, '/');
+    if('/' == import->string[0] || !slash) {
+        status = i2d_string_create(I2D_TAG_DB, result, import->string, import->length);
+    } else {
+        length = (size_t) (slash - import->string) + 1;
+        for(i = 0; i + length <= parent->length; i++) {
+            if( (!i || '/' == parent->string[i - 1]) &&
+                !strncmp(&parent->string[i], import->string, length) ) {
+                root = i;
+                found = 1;
+            }
+        }
+
+        if(!found) {
+            status = i2d_string_create(I2D_TAG_DB, result, import->string, import->length);
+        } else {
+            status = i2d_string_vprintf(I2D_TAG_DB, result, "%.*s%s", (int) root, parent->string, import->string);
+        }
+    }
+
+    return status;
+}
+
+/*
+ * scan errors are not reported since the file
+ * is given to libyaml, which reports the error
+ */
+static int i2d_yaml_scan(i2d_yaml_scanner * scanner) {
+    int status = I2D_OK;
+    char * line;
+    char * next;
+    char * end;
+    char * string;
+    size_t indent;
+
+    if(scanner->length > UINT32_MAX) {
+        status = I2D_FAIL;
+    } else if(scanner->length >= 3 && !memcmp(scanner->string, "\xEF\xBB\xBF", 3)) {
+        scanner->position = 3;
+    }
+
+    while(!status && scanner->position < scanner->length) {
+        line = scanner->string + scanner->position;
+        next = memchr(line, '\n', scanner->length - scanner->position);
+        end = next ? next : scanner->string + scanner->length;
+        if(end > line && '\r' == end[-1])
+            end--;
+        scanner->position = next ? (size_t) (next - scanner->string) + 1 : scanner->length;
+
+        for(string = line; string < end && ' ' == *string; string++);
+        indent = (size_t) (string - line);
+
+        if(string == end || '#' == *string) {
+            /* empty line or comment */
+        } else if('\t' == *string || '%' == *string) {
+            status = I2D_FAIL;
+        } else if(!indent && end - string >= 3 && (end - string == 3 || ' ' == string[3]) && !memcmp(string, "---", 3)) {
+            /* the subset is a single document */
+            for(string += 3; string < end && ' ' == *string; string++);
+            if(scanner->started || (string < end && '#' != *string))
+                status = I2D_FAIL;
+        } else if(!indent && end - string >= 3 && (end - string == 3 || ' ' == string[3]) && !memcmp(string, "...", 3)) {
+            /* end of the document */
+        } else {
+            status = i2d_yaml_scan_node(scanner, string, indent, end);
+        }
+    }
+
+    if(!status && scanner->pending) {
+        scanner->pending = 0;
+        status = i2d_yaml_scan_token(scanner, i2d_yaml_token_scalar, NULL, 0);
+    }
+
+    while(!status && scanner->depth)
+        status = i2d_yaml_scan_close(scanner);
+
+    return status;
+}
+
+/*
+ * a node is a sequence entry, a mapping key or
+ * the value of the last key or entry; the entry
+ * on the same line as its dash is scanned as if
+ * the dash was indentation
+ */
+static int i2d_yaml_scan_node(i2d_yaml_scanner * scanner, char * string, size_t indent, char * end) {
+    int status = I2D_OK;
+    i2d_yaml_block * block;
+    int sequence;
+    char * key = NULL;
+    size_t length = 0;
+    char * value = NULL;
+
+    sequence = '-' == *string && (string + 1 == end || ' ' == string[1]);
+
+    /*
+     * the last key or entry is null unless the node
+     * is indented more or is a sequence indented as
+     * much as the key of a mapping (i.e. Body)
+     */
+    if(scanner->pending) {
+        block = &scanner->blocks[scanner->depth - 1];
+        if(indent < block->indent || (indent == block->indent && (block->sequence || !sequence))) {
+            scanner->pending = 0;
+            status = i2d_yaml_scan_token(scanner, i2d_yaml_token_scalar, NULL, 0);
+        }
+    }
+
+    while(!status && !scanner->pending && scanner->depth && scanner->blocks[scanner->depth - 1].indent > indent)
+        status = i2d_yaml_scan_close(scanner);
+
+    if( !status && !sequence && !scanner->pending && scanner->depth > 1 &&
+        scanner->blocks[scanner->depth - 1].sequence && scanner->blocks[scanner->depth - 1].indent == indent &&
+        !scanner->blocks[scanner->depth - 2].sequence && scanner->blocks[scanner->depth - 2].indent == indent )
+        status = i2d_yaml_scan_close(scanner);
+
+    if(status) {
+        /* node is not scanned */
+    } else if(!sequence && i2d_yaml_scan_key(string, end, &key, &length, &value)) {
+        status = I2D_FAIL;
+    } else if(sequence || key) {
+        block = scanner->depth ? &scanner->blocks[scanner->depth - 1] : NULL;
+        if(scanner->pending ? indent > block->indent || (indent == block->indent && sequence) : !scanner->started) {
+            scanner->pending = 0;
+            status = i2d_yaml_scan_open(scanner, indent, sequence);
+        } else if(scanner->pending || !block || block->indent != indent || block->sequence != sequence) {
+            status = I2D_FAIL;
+        }
+
+        if(status) {
+            /* entry or key is not scanned */
+        } else if(sequence) {
+            for(value = string + 1; value < end && ' ' == *value; value++);
+            scanner->pending = 1;
+            if(value < end && '#' != *value)
+                status = i2d_yaml_scan_node(scanner, value, indent + (size_t) (value - string), end);
+        } else if(i2d_yaml_scan_token(scanner, i2d_yaml_token_scalar, key, length)) {
+            status = I2D_FAIL;
+        } else if(value < end && '#' != *value) {
+            status = i2d_yaml_scan_value(scanner, value, end, indent);
+        } else {
+            scanner->pending = 1;
+        }
+    } else if(scanner->pending && indent > scanner->blocks[scanner->depth - 1].indent) {
+        scanner->pending = 0;
+        status = i2d_yaml_scan_value(scanner, string, end, scanner->blocks[scanner->depth - 1].indent);
+    } else {
+        status = I2D_FAIL;
     }
 
     return status;
-}
\ No newline at end of file
+}
+
+/*
+ * key is null when the node is not a key and
+ * value is the start of the rest of the line
+ */
+static int i2d_yaml_scan_key(char * string, char * end, char ** key, size_t * length, char ** value) {
+    int status = I2D_OK;
+    char * colon = NULL;
+    char * i;
+
+    if('\'' == *string || '"' == *string) {
+        /* '' is a quote in a single quoted scalar */
+        for(i = string + 1; i < end; i++) {
+            if('"' == *string && '\\' == *i) {
+                i++;
+            } else if(*string == *i) {
+                if('\'' == *string && i + 1 < end && '\'' == i[1]) {
+                    i++;
+                } else {
+                    break;
+                }
+            }
+        }
+
+        if(i < end)
+            for(i++; i < end && ' ' == *i; i++);
+
+        if(i < end && ':' == *i && (i + 1 == end || ' ' == i[1])) {
+            colon = i;
+            if(i2d_yaml_scan_quoted(string, end, &i, length))
+                status = I2D_FAIL;
+        }
+    } else if(!strchr("[]{},&*!|>%@`?:#", *string)) {
+        for(i = string; i < end && !colon; i++) {
+            if(':' == *i && (i + 1 == end || ' ' == i[1] || '\t' == i[1])) {
+                colon = i;
+            } else if('#' == *i && (' ' == i[-1] || '\t' == i[-1])) {
+                break;
+            }
+        }
+
+        if(colon) {
+            for(i = colon; i > string && (' ' == i[-1] || '\t' == i[-1]); i--);
+            *length = (size_t) (i - string);
+            *i = 0;
+        }
+    }
+
+    if(!status && colon) {
+        for(i = colon + 1; i < end && (' ' == *i || '\t' == *i); i++);
+        *key = string;
+        *value = i;
+    }
+
+    return status;
+}
+
+static int i2d_yaml_scan_value(i2d_yaml_scanner * scanner, char * string, char * end, size_t indent) {
+    int status = I2D_OK;
+    char * next;
+    size_t length;
+
+    switch(*string) {
+        case '|':
+        case '>':
+            status = i2d_yaml_scan_block(scanner, string + 1, end, indent, '>' == *string);
+            break;
+        case '\'':
+        case '"':
+            if(i2d_yaml_scan_quoted(string, end, &next, &length)) {
+                status = I2D_FAIL;
+            } else {
+                for(; next < end && (' ' == *next || '\t' == *next); next++);
+                if(next < end && '#' != *next) {
+                    status = I2D_FAIL;
+                } else {
+                    status = i2d_yaml_scan_token(scanner, i2d_yaml_token_scalar, string, length);
+                }
+            }
+            break;
+        case '-':
+        case '?':
+        case ':':
+            if(string + 1 == end || ' ' == string[1] || '\t' == string[1]) {
+                status = I2D_FAIL;
+            } else {
+                status = i2d_yaml_scan_plain(scanner, string, end);
+            }
+            break;
+        case '[': case ']': case '{': case '}': case ',':
+        case '&': case '*': case '!': case '%': case '@': case '`':
+            status = I2D_FAIL;
+            break;
+        default:
+            status = i2d_yaml_scan_plain(scanner, string, end);
+            break;
+    }
+
+    return status;
+}
+
+static int i2d_yaml_scan_plain(i2d_yaml_scanner * scanner, char * string, char * end) {
+    int status = I2D_OK;
+    char * last = string;
+    char * i;
+
+    for(i = string; i < end && !status; i++) {
+        if(' ' == *i || '\t' == *i) {
+            if(i + 1 < end && '#' == i[1])
+                break;
+        } else if(':' == *i && (i + 1 == end || ' ' == i[1] || '\t' == i[1])) {
+            status = I2D_FAIL;
+        } else {
+            last = i + 1;
+        }
+    }
+
+    if(!status) {
+        *last = 0;
+        status = i2d_yaml_scan_token(scanner, i2d_yaml_token_scalar, string, (size_t) (last - string));
+    }
+
+    return status;
+}
+
+/*
+ * the scalar is unescaped in place from the
+ * opening quote and must end on the same line
+ */
+static int i2d_yaml_scan_quoted(char * string, char * end, char ** next, size_t * length) {
+    int status = I2D_OK;
+    char * read = string + 1;
+    char * write = string;
+    char quote = *string;
+    int is_closed = 0;
+
+    while(!status && !is_closed) {
+        if(read >= end) {
+            status = I2D_FAIL;
+        } else if(quote == *read) {
+            if('\'' == quote && read + 1 < end && '\'' == read[1]) {
+                *write++ = '\'';
+                read += 2;
+            } else {
+                read++;
+                is_closed = 1;
+            }
+        } else if('"' == quote && '\\' == *read) {
+            status = i2d_yaml_scan_escape(&read, end, &write);
+        } else {
+            *write++ = *read++;
+        }
+    }
+
+    if(!status) {
+        *length = (size_t) (write - string);
+        *write = 0;
+        *next = read;
+    }
+
+    return status;
+}
+
+static int i2d_yaml_scan_escape(char ** read, char * end, char ** write) {
+    int status = I2D_OK;
+    char * string = *read + 1;
+    char * output = *write;
+    unsigned long code = 0;
+    size_t size = 0;
+    size_t count;
+    size_t i;
+
+    if(string >= end) {
+        status = I2D_FAIL;
+    } else {
+        switch(*string) {
+            case '0': code = 0x00; break;
+            case 'a': code = 0x07; break;
+            case 'b': code = 0x08; break;
+            case 't':
+            case '\t': code = 0x09; break;
+            case 'n': code = 0x0A; break;
+            case 'v': code = 0x0B; break;
+            case 'f': code = 0x0C; break;
+            case 'r': code = 0x0D; break;
+            case 'e': code = 0x1B; break;
+            case ' ':
+            case '"':
+            case '/':
+            case '\\': code = (unsigned char) *string; break;
+            case 'N': code = 0x85; break;
+            case '_': code = 0xA0; break;
+            case 'L': code = 0x2028; break;
+            case 'P': code = 0x2029; break;
+            case 'x': size = 2; break;
+            case 'u': size = 4; break;
+            case 'U': size = 8; break;
+            default: status = I2D_FAIL; break;
+        }
+
+        for(i = 0; i < size && !status; i++) {
+            string++;
+            if(string >= end || !isxdigit((unsigned char) *string)) {
+                status = I2D_FAIL;
+            } else {
+                code = code * 16 + (unsigned long) (i2d_isdigit(*string) ? *string - '0' : tolower((unsigned char) *string) - 'a' + 10);
+            }
+        }
+
+        count = 0x80 > code ? 1 : 0x800 > code ? 2 : 0x10000 > code ? 3 : 4;
+
+        /*
+         * surrogates are not characters and the
+         * output must not overtake the input
+         */
+        if(status) {
+            /* escape is not valid */
+        } else if((0xD800 <= code && 0xDFFF >= code) || 0x10FFFF < code || output + count > string + 1) {
+            status = I2D_FAIL;
+        } else {
+            if(1 == count) {
+                *output++ = (char) code;
+            } else if(2 == count) {
+                *output++ = (char) (0xC0 | (code >> 6));
+                *output++ = (char) (0x80 | (code & 0x3F));
+            } else if(3 == count) {
+                *output++ = (char) (0xE0 | (code >> 12));
+                *output++ = (char) (0x80 | ((code >> 6) & 0x3F));
+                *output++ = (char) (0x80 | (code & 0x3F));
+            } else {
+                *output++ = (char) (0xF0 | (code >> 18));
+                *output++ = (char) (0x80 | ((code >> 12) & 0x3F));
+                *output++ = (char) (0x80 | ((code >> 6) & 0x3F));
+                *output++ = (char) (0x80 | (code & 0x3F));
+            }
+            *read = string + 1;
+            *write = output;
+        }
+    }
+
+    return status;
+}
+
+/*
+ * literal or folded block scalar; indentation of
+ * the first line that is not empty is stripped
+ * from every line, and the chomping indicator
+ * keeps one (clip), none (-) or all (+) of the
+ * final line breaks; folding turns the break
+ * between two lines that are not indented more
+ * into a space, and the lines are moved in place
+ */
+static int i2d_yaml_scan_block(i2d_yaml_scanner * scanner, char * string, char * end, size_t parent, int is_folded) {
+    int status = I2D_OK;
+    int chomp = 0;
+    char * start;
+    char * write;
+    char * line;
+    char * next;
+    char * last;
+    char * text;
+    size_t indent = 0;
+    size_t breaks = 0;
+    int is_content = 0;
+    int is_spaced = 0;
+    int is_end = 0;
+
+    if(string < end && '-' == *string) {
+        chomp = -1;
+        string++;
+    } else if(string < end && '+' == *string) {
+        chomp = 1;
+        string++;
+    }
+
+    for(; string < end && (' ' == *string || '\t' == *string); string++);
+    if(string < end && '#' != *string)
+        status = I2D_FAIL;
+
+    start = scanner->string + scanner->position;
+    write = start;
+
+    while(!status && !is_end && scanner->position < scanner->length) {
+        line = scanner->string + scanner->position;
+        next = memchr(line, '\n', scanner->length - scanner->position);
+        last = next ? next : scanner->string + scanner->length;
+        if(last > line && '\r' == last[-1])
+            last--;
+
+        for(text = line; text < last && ' ' == *text; text++);
+
+        if(text == last && (!indent || (size_t) (text - line) <= indent)) {
+            /* empty line */
+        } else if((size_t) (text - line) <= parent || (indent && (size_t) (text - line) < indent)) {
+            is_end = 1;
+        } else {
+            if(!indent)
+                indent = (size_t) (text - line);
+
+            if(is_folded && is_content && !is_spaced && ' ' != line[indent] && '\t' != line[indent]) {
+                if(1 == breaks) {
+                    *write++ = ' ';
+                    breaks = 0;
+                } else {
+                    breaks--;
+                }
+            }
+            is_spaced = ' ' == line[indent] || '\t' == line[indent];
+
+            for(; breaks > 0; breaks--)
+                *write++ = '\n';
+
+            memmove(write, line + indent, (size_t) (last - line) - indent);
+            write += (size_t) (last - line) - indent;
+            is_content = 1;
+        }
+
+        if(!is_end) {
+            if(next)
+                breaks++;
+            scanner->position = next ? (size_t) (next - scanner->string) + 1 : scanner->length;
+        }
+    }
+
+    if(status) {
+        /* block is not scanned */
+    } else if(!is_content) {
+        status = i2d_yaml_scan_token(scanner, i2d_yaml_token_scalar, NULL, 0);
+    } else {
+        if(0 > chomp) {
+            breaks = 0;
+        } else if(!chomp && breaks) {
+            breaks = 1;
+        }
+
+        for(; breaks > 0; breaks--)
+            *write++ = '\n';
+
+        *write = 0;
+        status = i2d_yaml_scan_token(scanner, i2d_yaml_token_scalar, start, (size_t) (write - start));
+    }
+
+    return status;
+}
+
+static int i2d_yaml_scan_open(i2d_yaml_scanner * scanner, size_t indent, int sequence) {
+    int status = I2D_OK;
+    i2d_yaml_block * block;
+
+    if(scanner->depth >= MAX_YAML_DEPTH) {
+        status = I2D_FAIL;
+    } else {
+        block = &scanner->blocks[scanner->depth];
+        block->indent = indent;
+        block->sequence = sequence;
+        scanner->depth++;
+        scanner->started = 1;
+        status = i2d_yaml_scan_token(scanner, sequence ? i2d_yaml_token_sequence : i2d_yaml_token_mapping, NULL, 0);
+    }
+
+    return status;
+}
+
+static int i2d_yaml_scan_close(i2d_yaml_scanner * scanner) {
+    scanner->depth--;
+
+    return i2d_yaml_scan_token(scanner, i2d_yaml_token_end, NULL, 0);
+}
+
+static int i2d_yaml_scan_token(i2d_yaml_scanner * scanner, enum i2d_yaml_token_type type, char * string, size_t length) {
+    int status = I2D_OK;
+    i2d_yaml_token * list;
+    size_t capacity;
+
+    /*
+     * the records of the databases are about
+     * eight bytes per token, so the list is
+     * sized once from the length of the file
+     */
+    if(scanner->size == scanner->capacity) {
+        capacity = scanner->capacity ? scanner->capacity * 2 : scanner->length / 8 + BUFFER_SIZE_LARGE;
+        list = i2d_realloc(I2D_TAG_DB, scanner->list, capacity * sizeof(*list));
+        if(!list) {
+            status = i2d_panic("out of memory");
+        } else {
+            scanner->list = list;
+            scanner->capacity = capacity;
+        }
+    }
+
+    if(!status) {
+        list = &scanner->list[scanner->size++];
+        list->offset = string ? (uint32_t) (string - scanner->string) : 0;
+        list->length = (uint32_t) length;
+        list->type = type;
+    }
+
+    return status;
+}
+
+/*
+ * the tokens are given to the mapper as if they
+ * were the events of libyaml
+ */
+static int i2d_yaml_replay(i2d_yaml_scanner * scanner, i2d_yaml_mapper * mapper) {
+    int status = I2D_OK;
+    i2d_yaml_token * token;
+    size_t i;
+
+    for(i = 0; i < scanner->size && !status; i++) {
+        token = &scanner->list[i];
+        switch(token->type) {
+            case i2d_yaml_token_scalar:
+                status = i2d_yaml_map_scalar(mapper, token->length ? scanner->string + token->offset : "", token->length);
+                break;
+            case i2d_yaml_token_mapping:
+                status = i2d_yaml_map_push(mapper, 0);
+                break;
+            case i2d_yaml_token_sequence:
+                status = i2d_yaml_map_push(mapper, 1);
+                break;
+            case i2d_yaml_token_end:
+                status = i2d_yaml_map_pop(mapper);
+                break;
+        }
+    }
+
+    return status;
+}
+
+int i2d_yaml_get_string(i2d_yaml_record * record, i2d_string * result) {
+    int status = I2D_OK;
+
+    i2d_free(result->string);
+    if(i2d_string_create(I2D_TAG_DB, result, record->value, record->length))
+        status = i2d_panic("failed to create string object");
+
+    return status;
+}
+
+/*
+ * scripts in the txt databases are wrapped in
+ * braces and the compiler expects the braces
+ */
+int i2d_yaml_get_script(i2d_yaml_record * record, i2d_string * result) {
+    int status = I2D_OK;
+
+    i2d_free(result->string);
+    result->string = i2d_malloc(I2D_TAG_DB, record->length + 5);
+    if(!result->string) {
+        status = i2d_panic("out of memory");
+    } else {
+        memcpy(result->string, "{ ", 2);
+        memcpy(result->string + 2, record->value, record->length);
+        memcpy(result->string + 2 + record->length, " }", 3);
+        result->length = record->length + 4;
+    }
+
+    return status;
+}
+
+int i2d_yaml_get_number(i2d_yaml_record * record, long * result) {
+    int status = I2D_OK;
+
+    if(i2d_strtol(result, record->value, record->length, 10))
+        status = i2d_panic("invalid number -- %s (%s)", record->value, record->key);
+
+    return status;
+}
+
+int i2d_yaml_get_boolean(i2d_yaml_record * record, int * result) {
+    int status = I2D_OK;
+
+    if( !strcmp(record->value, "true") ||
+        !strcmp(record->value, "True") ||
+        !strcmp(record->value, "TRUE") ) {
+        *result = 1;
+    } else if(  !strcmp(record->value, "false") ||
+                !strcmp(record->value, "False") ||
+                !strcmp(record->value, "FALSE") ) {
+        *result = 0;
+    } else {
+        status = i2d_panic("invalid boolean -- %s (%s)", record->value, record->key);
+    }
+
+    return status;
+}
+
+int i2d_yaml_get_constant(i2d_yaml_constant * list, size_t size, const char * name, long * result) {
+    int status = I2D_OK;
+    size_t i;
+
+    for(i = 0; i < size; i++) {
+#ifndef _WIN32
+        if(!strcasecmp(list[i].name, name))
+#else
+        if(!_stricmp(list[i].name, name))
+#endif
+            break;
+    }
+
+    if(i < size) {
+        *result = list[i].value;
+    } else {
+        status = i2d_panic("invalid constant -- %s", name);
+    }
+
+    return status;
+}
+
+/*
+ * fold the key and value of a field into the hash
+ * of its record; the nul of the key separates the
+ * key from the value
+ */
+uint64_t i2d_yaml_hash(i2d_yaml_record * record, uint64_t hash) {
+    hash = i2d_fnv1a(hash, record->key, strlen(record->key) + 1);
+    return i2d_fnv1a(hash, record->value, record->length);
+}
@@ -6,4 +6,46 @@
 
 typedef int (* i2d_yaml_parse_cb)(yaml_event_t *, void *);
 int i2d_yaml_parse(i2d_string *, i2d_yaml_parse_cb, void *);
+
+enum i2d_yaml_type {
+    i2d_yaml_record_start,
+    i2d_yaml_record_field,
+    i2d_yaml_record_end
+};
+
+/*
+ * a record is a mapping in the Body sequence;
+ * key is the dot separated path of the field
+ * relative to the record (i.e. Jobs.Novice),
+ * index is the position of the field in the
+ * innermost sequence of the record, and value
+ * is only valid for the duration of callback
+ */
+struct i2d_yaml_record {
+    enum i2d_yaml_type type;
+    const char * key;
+    const char * value;
+    size_t length;
+    size_t index;
+};
+
+typedef struct i2d_yaml_record i2d_yaml_record;
+
+typedef int (* i2d_yaml_record_cb)(i2d_yaml_record *, void *);
+
+int i2d_yaml_map(i2d_string *, i2d_yaml_record_cb, void *);
+
+struct i2d_yaml_constant {
+    const char * name;
+    long value;
+};
+
+typedef struct i2d_yaml_constant i2d_yaml_constant;
+
+int i2d_yaml_get_string(i2d_yaml_record *, i2d_string *);
+int i2d_yaml_get_script(i2d_yaml_record *, i2d_string *);
+int i2d_yaml_get_number(i2d_yaml_record *, long *);
+int i2d_yaml_get_boolean(i2d_yaml_record *, int *);
+int i2d_yaml_get_constant(i2d_yaml_constant *, size_t, const char *, long *);
+uint64_t i2d_yaml_hash(i2d_yaml_record *, uint64_t);
 #endif